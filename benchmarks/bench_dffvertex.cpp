@@ -0,0 +1,92 @@
+#include "benchmark.hpp"
+#include <data/Model.hpp>
+
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+
+namespace
+{
+const std::size_t kRings = 64;
+const std::size_t kSegments = 128;
+
+float unpack10(uint32_t v)
+{
+	int32_t i = v & 0x3FF;
+	if (i & 0x200) {
+		i -= 0x400;
+	}
+	return std::max(i / 511.f, -1.f);
+}
+
+float unpackHalf(uint16_t h)
+{
+	float sign = (h & 0x8000) ? -1.f : 1.f;
+	int exponent = (h >> 10) & 0x1F;
+	int mantissa = h & 0x3FF;
+	if (exponent == 0) {
+		return sign * std::ldexp(float(mantissa), -24);
+	}
+	return sign * std::ldexp(float(mantissa | 0x400), exponent - 25);
+}
+
+/**
+ * A UV sphere with tiling texture coordinates, about the size of a vehicle
+ */
+std::vector<Model::GeometryVertex> makeSphere()
+{
+	std::vector<Model::GeometryVertex> verts;
+	for (std::size_t r = 0; r <= kRings; ++r) {
+		float phi = glm::pi<float>() * r / kRings;
+		for (std::size_t s = 0; s <= kSegments; ++s) {
+			float theta = glm::two_pi<float>() * s / kSegments;
+			glm::vec3 n(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+			verts.push_back({n * 2.5f, n, glm::vec2(s * 8.f / kSegments, r * 4.f / kRings),
+							 glm::u8vec4(255, 255, 255, 255)});
+		}
+	}
+	return verts;
+}
+}
+
+/**
+ * Bytes per vertex and per index uploaded for DFF geometry, with the full
+ * float vertex and 32 bit indices against the compact vertex and 16 bit
+ * indices, and the error the quantization introduces.
+ */
+RW_BENCHMARK(dff_vertex_formats)
+{
+	auto verts = makeSphere();
+	std::size_t indices = kRings * kSegments * 6;
+
+	std::vector<Model::CompactGeometryVertex> compact;
+	double packTime = bench::measure(20, [&]() {
+		compact.clear();
+		for (auto& v : verts) {
+			compact.push_back(Model::CompactGeometryVertex::pack(v));
+		}
+		bench::consume(compact.size());
+	});
+
+	float normalError = 0.f, uvError = 0.f;
+	for (std::size_t v = 0; v < verts.size(); ++v) {
+		auto& c = compact[v];
+		glm::vec3 n(unpack10(c.normal), unpack10(c.normal >> 10), unpack10(c.normal >> 20));
+		glm::vec2 uv(unpackHalf(c.texcoord[0]), unpackHalf(c.texcoord[1]));
+		normalError = std::max(normalError, glm::length(n - verts[v].normal));
+		uvError = std::max(uvError, glm::length(uv - verts[v].texcoord));
+	}
+
+	std::size_t fullBytes = verts.size() * sizeof(Model::GeometryVertex) + indices * sizeof(uint32_t);
+	std::size_t compactBytes = verts.size() * sizeof(Model::CompactGeometryVertex) + indices * sizeof(uint16_t);
+
+	bench::report("vertices", verts.size(), "");
+	bench::report("full vertex", sizeof(Model::GeometryVertex), "bytes/vertex");
+	bench::report("compact vertex", sizeof(Model::CompactGeometryVertex), "bytes/vertex");
+	bench::report("index", sizeof(uint32_t), "bytes before");
+	bench::report("index", sizeof(uint16_t), "bytes after");
+	bench::report("mesh upload before", fullBytes / 1024.0, "KiB");
+	bench::report("mesh upload after", compactBytes / 1024.0, "KiB");
+	bench::report("max normal error", normalError, "");
+	bench::report("max texcoord error", uvError, "");
+	bench::report("pack", packTime / verts.size(), "ns/vertex");
+}
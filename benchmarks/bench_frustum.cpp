@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+#include <render/ViewCamera.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+
+namespace
+{
+const std::size_t kSpheres = 1000000;
+const std::size_t kIterations = 20;
+}
+
+/**
+ * Culls a million bounding spheres scattered around the camera, the size
+ * of a dense map's instances and their frames, one at a time and in packed
+ * batches.
+ */
+RW_BENCHMARK(frustum_culling_1m)
+{
+	ViewCamera camera(glm::vec3(0.f, 0.f, 20.f),
+					  glm::angleAxis(0.6f, glm::vec3(0.f, 0.f, 1.f)));
+	camera.frustum.far = 1000.f;
+	camera.frustum.update(camera.frustum.projection() * camera.getView());
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> position(-2000.f, 2000.f);
+	std::uniform_real_distribution<float> height(0.f, 100.f);
+	std::uniform_real_distribution<float> radius(0.5f, 30.f);
+
+	PackedSpheres spheres;
+	for (std::size_t i = 0; i < kSpheres; ++i) {
+		spheres.add(glm::vec3(position(rng), position(rng), height(rng)), radius(rng));
+	}
+
+	std::size_t scalarVisible = 0;
+	double scalarTime = bench::measure(kIterations, [&]() {
+		scalarVisible = 0;
+		for (std::size_t i = 0; i < spheres.size(); ++i) {
+			glm::vec3 center(spheres.x[i], spheres.y[i], spheres.z[i]);
+			if (camera.frustum.intersects(center, spheres.radius[i])) {
+				scalarVisible++;
+			}
+		}
+		bench::consume(scalarVisible);
+	});
+
+	ViewFrustum::VisibilityMask mask;
+	double packedTime = bench::measure(kIterations, [&]() {
+		camera.frustum.intersects(spheres, mask);
+		bench::consume(mask.back());
+	});
+
+	std::size_t packedVisible = 0;
+	for (std::size_t i = 0; i < spheres.size(); ++i) {
+		packedVisible += ViewFrustum::isVisible(mask, i) ? 1 : 0;
+	}
+
+	bench::report("visible", 100.0 * scalarVisible / kSpheres, "%");
+	bench::report("packed results differing", double(packedVisible) - double(scalarVisible), "");
+	bench::report("scalar", scalarTime / kSpheres, "ns/sphere");
+	bench::report("packed", packedTime / kSpheres, "ns/sphere");
+	bench::report("speedup", scalarTime / packedTime, "x");
+}
@@ -0,0 +1,136 @@
+#include "benchmark.hpp"
+#include <data/GameTexts.hpp>
+#include <loaders/LoaderGXT.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+const std::size_t kEntries = 8000;
+const std::size_t kLookups = 100000;
+
+/**
+ * Builds a GXT file with kEntries sorted keys
+ */
+FileHandle makeGXT(std::vector<std::string>& keys)
+{
+	std::vector<char> tkey, tdat;
+	for (std::size_t e = 0; e < kEntries; ++e) {
+		char key[9];
+		std::snprintf(key, sizeof(key), "K%06u", unsigned(e));
+		keys.push_back(key);
+
+		uint32_t offset = tdat.size();
+		tkey.insert(tkey.end(), reinterpret_cast<char*>(&offset), reinterpret_cast<char*>(&offset) + 4);
+		tkey.insert(tkey.end(), key, key + 8);
+
+		std::string text = "~g~Take the car to the ~y~garage~g~ for a respray, entry " + std::to_string(e);
+		for (char c : text) {
+			tdat.push_back(c);
+			tdat.push_back(0);
+		}
+		tdat.push_back(0);
+		tdat.push_back(0);
+	}
+
+	std::vector<char> file;
+	auto append = [&](const void* p, std::size_t n) {
+		file.insert(file.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n);
+	};
+	uint32_t tkeySize = tkey.size(), tdatSize = tdat.size();
+	append("TKEY", 4);
+	append(&tkeySize, 4);
+	append(tkey.data(), tkey.size());
+	append("TDAT", 4);
+	append(&tdatSize, 4);
+	append(tdat.data(), tdat.size());
+
+	auto contents = new FileContentsInfo;
+	contents->data = new char[file.size()];
+	contents->length = file.size();
+	std::memcpy(contents->data, file.data(), file.size());
+	return FileHandle(contents);
+}
+
+/**
+ * The old loader's conversion into a stack buffer and a map of strings
+ */
+void legacyLoad(std::unordered_map<std::string, std::string>& texts, FileHandle& file)
+{
+	auto data = file->data + 4;
+	std::uint32_t blocksize = *(std::uint32_t*)data;
+	data += 4;
+	auto tdata = data + blocksize + 8;
+
+	for (size_t t = 0; t < blocksize / 12; ++t) {
+		size_t offset = *(std::uint32_t*)(data + (t * 12 + 0));
+		std::string id(data + (t * 12 + 4), strnlen(data + (t * 12 + 4), 8));
+
+		char u8buff[1024];
+		size_t len = 0;
+		for (const char* c = tdata + offset; (c[0] || c[1]) && len < 1023; c += 2) {
+			u8buff[len++] = c[0];
+		}
+		u8buff[len] = '\0';
+
+		texts.insert({ id, std::string(u8buff) });
+	}
+}
+
+/**
+ * Rough heap usage of the old map: nodes, buckets and both strings
+ */
+std::size_t legacyMemory(const std::unordered_map<std::string, std::string>& texts)
+{
+	std::size_t bytes = texts.bucket_count() * sizeof(void*);
+	for (auto& t : texts) {
+		bytes += sizeof(t) + sizeof(void*) * 2;
+		if (t.first.capacity() > 15) bytes += t.first.capacity() + 1;
+		if (t.second.capacity() > 15) bytes += t.second.capacity() + 1;
+	}
+	return bytes;
+}
+}
+
+/**
+ * Loading a GXT file with 8k entries and fetching texts from it, as the
+ * script's print opcodes do, against the map of strings it replaced.
+ */
+RW_BENCHMARK(gxt_load_and_lookup_8k)
+{
+	std::vector<std::string> keys;
+	auto file = makeGXT(keys);
+
+	GameTexts texts;
+	double loadTime = bench::measure(1, [&]() {
+		LoaderGXT loader;
+		loader.load(texts, file);
+	});
+	bench::report("load", loadTime / 1e6, "ms");
+	bench::report("resident", texts.getMemoryUsage() / 1024.0, "KiB");
+
+	std::unordered_map<std::string, std::string> legacy;
+	double legacyLoadTime = bench::measure(1, [&]() {
+		legacyLoad(legacy, file);
+	});
+	bench::report("legacy load", legacyLoadTime / 1e6, "ms");
+	bench::report("legacy resident (estimate)", legacyMemory(legacy) / 1024.0, "KiB");
+
+	std::size_t l = 0;
+	double lookupTime = bench::measure(kLookups, [&]() {
+		auto text = texts.text(keys[(l++ * 7919) % kEntries]);
+		bench::consume(text.size());
+	});
+	bench::report("lookup", lookupTime, "ns/lookup");
+
+	l = 0;
+	double legacyLookupTime = bench::measure(kLookups, [&]() {
+		auto& id = keys[(l++ * 7919) % kEntries];
+		auto it = legacy.find(id);
+		std::string text = it != legacy.end() ? it->second : id;
+		bench::consume(text.size());
+	});
+	bench::report("legacy lookup (copy)", legacyLookupTime, "ns/lookup");
+}
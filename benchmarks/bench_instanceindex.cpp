@@ -0,0 +1,115 @@
+#include "benchmark.hpp"
+#include <engine/InstanceIndex.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <objects/InstanceObject.hpp>
+#include <data/Model.hpp>
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+
+#include <memory>
+#include <random>
+
+namespace
+{
+const std::size_t kInstances = 50000;
+const std::size_t kModels = 500;
+const float kArea = 2000.f;
+const float kVolumeSize = 20.f;
+const float kRadius = 50.f;
+}
+
+/**
+ * The instance opcodes over a map sized world: "is area occupied" volume
+ * checks, and the model + radius searches behind changing and hiding nearby
+ * objects, against the scans of every object they replaced.
+ */
+RW_BENCHMARK(instanceindex_script_queries_50k)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> coord(-kArea, kArea);
+	auto randomPosition = [&]() { return glm::vec3(coord(rng), coord(rng), 10.f); };
+
+	std::vector<std::string> models;
+	for (std::size_t m = 0; m < kModels; ++m) {
+		models.push_back("model" + std::to_string(m));
+	}
+
+	std::vector<std::unique_ptr<InstanceObject>> instances;
+	std::vector<GameObject*> allObjects;
+	InstanceIndex index;
+	for (std::size_t i = 0; i < kInstances; ++i) {
+		auto model = std::make_shared<ResourceHandle<Model>>(models[i % kModels]);
+		instances.emplace_back(new InstanceObject(&world, randomPosition(), glm::quat(), model,
+												  glm::vec3(1.f), nullptr, nullptr, nullptr));
+		allObjects.push_back(instances.back().get());
+		index.insert(instances.back().get());
+	}
+	bench::report("instances", kInstances, "");
+
+	std::vector<glm::vec3> points;
+	for (std::size_t i = 0; i < 1000; ++i) {
+		points.push_back(randomPosition());
+	}
+
+	double buildTime = bench::measure(1, [&]() {
+		bench::consume(index.anyInBox(glm::vec3(0.f), glm::vec3(0.f)));
+	});
+	bench::report("build", buildTime / 1e6, "ms");
+
+	std::size_t q = 0;
+	double volumeTime = bench::measure(10000, [&]() {
+		auto& p = points[q++ % points.size()];
+		bench::consume(index.anyInBox(p - glm::vec3(kVolumeSize), p + glm::vec3(kVolumeSize)));
+	});
+	bench::report("objects in volume", volumeTime, "ns/query");
+
+	q = 0;
+	double legacyVolumeTime = bench::measure(200, [&]() {
+		auto& p = points[q++ % points.size()];
+		auto min = p - glm::vec3(kVolumeSize), max = p + glm::vec3(kVolumeSize);
+		bool found = false;
+		for (auto object : allObjects) {
+			if (object->type() != GameObject::Instance) continue;
+			auto pp = object->getPosition();
+			if (pp.x >= min.x && pp.y >= min.y && pp.z >= min.z &&
+				pp.x <= max.x && pp.y <= max.y && pp.z <= max.z) {
+				found = true;
+				break;
+			}
+		}
+		bench::consume(found);
+	});
+	bench::report("legacy objects in volume", legacyVolumeTime, "ns/query");
+
+	q = 0;
+	std::vector<InstanceObject*> found;
+	double modelTime = bench::measure(10000, [&]() {
+		auto& p = points[q % points.size()];
+		found.clear();
+		index.findByModel(models[q++ % kModels], p, kRadius, found);
+		bench::consume(found.size());
+	});
+	bench::report("nearest model", modelTime, "ns/query");
+
+	q = 0;
+	double legacyModelTime = bench::measure(200, [&]() {
+		auto& p = points[q % points.size()];
+		auto& model = models[q++ % kModels];
+		std::size_t count = 0;
+		for (auto& o : instances) {
+			if (!o->model) continue;
+			if (o->model->name != model) continue;
+			if (glm::distance(p, o->getPosition()) < kRadius) {
+				count++;
+			}
+		}
+		bench::consume(count);
+	});
+	bench::report("legacy nearest model", legacyModelTime, "ns/query");
+}
@@ -0,0 +1,100 @@
+#include "benchmark.hpp"
+#include <render/NullRenderer.hpp>
+#include <render/ObjectRenderer.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+namespace
+{
+const std::size_t kInstances = 30000;
+const std::size_t kModels = 400;
+
+/// The depth first key that ObjectRenderer used before instancing
+RenderKey legacyKey(bool transparent, float normalizedDepth, const Renderer::Textures& textures)
+{
+	return ((transparent?0x1:0x0) << 31)
+			| uint32_t(0x7FFFFF * (transparent? 1.f - normalizedDepth : normalizedDepth)) << 8
+			| uint8_t(0xFF & (textures.size() > 0 ? textures[0] : 0)) << 0;
+}
+
+void sortList(RenderList& list)
+{
+	std::sort(list.begin(), list.end(),
+			  [](const Renderer::RenderInstruction& a,
+				 const Renderer::RenderInstruction& b) {
+				  return a.sortKey < b.sortKey;
+			  });
+}
+}
+
+/**
+ * The world render list for a map sized set of IPL instances, where a few
+ * models (street lights, trees, fences) account for most of them. Compares
+ * the draw calls of the depth sorted list against the list sorted to keep
+ * copies of a model together and drawn instanced.
+ */
+RW_BENCHMARK(instancing_render_list_30k)
+{
+	DrawBuffer arenaBuffer;
+
+	// Model popularity falls off like IPL data, with 1 - 3 subgeometries each
+	std::mt19937 rng(1234);
+	std::vector<double> weights;
+	for (std::size_t m = 0; m < kModels; ++m) {
+		weights.push_back(1.0 / (m + 1));
+	}
+	std::discrete_distribution<std::size_t> model(weights.begin(), weights.end());
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+	RenderList legacyList, list;
+	for (std::size_t i = 0; i < kInstances; ++i) {
+		auto m = model(rng);
+		float depth = unit(rng);
+		glm::mat4 matrix = glm::translate(glm::mat4(), glm::vec3(unit(rng), unit(rng), 0.f) * 2000.f);
+		for (std::size_t sg = 0; sg < 1 + m % 3; ++sg) {
+			Renderer::DrawParameters dp;
+			dp.start = sg * 300;
+			dp.count = 300;
+			dp.baseVertex = m * 500;
+			dp.textures = {GLuint(m * 3 + sg + 1)};
+			dp.colour = {255, 255, 255, 255};
+			legacyList.emplace_back(legacyKey(false, depth * depth, dp.textures), matrix, &arenaBuffer, dp);
+			list.emplace_back(ObjectRenderer::createKey(false, depth * depth, &arenaBuffer, dp), matrix, &arenaBuffer, dp);
+		}
+	}
+	sortList(legacyList);
+	sortList(list);
+	bench::report("instructions", list.size(), "");
+
+	NullRenderer renderer;
+	std::unique_ptr<Renderer::ShaderProgram> instancedProgram(renderer.createShader("", ""));
+
+	renderer.swap();
+	renderer.drawBatched(legacyList);
+	double legacyDraws = renderer.getDrawCount();
+	bench::report("legacy draw calls", legacyDraws, "");
+
+	renderer.setInstancedProgram(instancedProgram.get());
+	renderer.swap();
+	renderer.invalidate();
+	renderer.drawBatched(list);
+	double draws = renderer.getDrawCount();
+	bench::report("instanced draw calls", draws, "");
+	bench::report("draw call reduction", 100.0 * (1.0 - draws / legacyDraws), "%");
+
+	Renderer::DrawBatches batches;
+	double legacyBatchTime = bench::measure(20, [&]() {
+		Renderer::batchRenderList(legacyList, batches);
+		bench::consume(batches.size());
+	});
+	bench::report("legacy batching", legacyBatchTime / 1e3, "us/frame");
+
+	double batchTime = bench::measure(20, [&]() {
+		Renderer::batchRenderList(list, batches, kInstances);
+		bench::consume(batches.size());
+	});
+	bench::report("instanced batching", batchTime / 1e3, "us/frame");
+}
@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+#include <data/CutsceneData.hpp>
+
+#include <map>
+
+namespace
+{
+const std::size_t kKeys = 10000;
+const float kKeySpacing = 0.1f;
+const float kFrameTime = 1.f / 60.f;
+
+/**
+ * The map walk the cutscene tracks used to do for each sample
+ */
+template <class T>
+T legacySample(const std::map<float, T>& track, float time)
+{
+	T p = track.rbegin()->second;
+	for (auto it = track.begin(); it != track.end(); ++it) {
+		if (it->first <= time) {
+			auto a = it->second;
+			auto b = it->second;
+			auto nextIt = it;
+			float t = it->first;
+			if (++nextIt != track.end()) {
+				b = nextIt->second;
+				t = nextIt->first;
+			}
+			float tdiff = t - it->first;
+			p = b;
+			if (tdiff > 0.f) {
+				p = glm::mix(a, b, (time - it->first) / tdiff);
+			}
+		}
+	}
+	return p;
+}
+}
+
+/**
+ * Sampling the four camera tracks of a cutscene with 10k keys each, once per
+ * frame from start to end, against walking a std::map per track.
+ */
+RW_BENCHMARK(keyframes_cutscene_10k)
+{
+	CutsceneTracks tracks;
+	std::map<float, float> zoom, rotation;
+	std::map<float, glm::vec3> position, target;
+	for (std::size_t k = 0; k < kKeys; ++k) {
+		float t = k * kKeySpacing;
+		float f = float(k);
+		tracks.zoom.insert(t, 60.f + (k % 7));
+		tracks.rotation.insert(t, f);
+		tracks.position.insert(t, glm::vec3(f, 0.f, 1.f));
+		tracks.target.insert(t, glm::vec3(0.f, f, 1.f));
+		zoom[t] = 60.f + (k % 7);
+		rotation[t] = f;
+		position[t] = glm::vec3(f, 0.f, 1.f);
+		target[t] = glm::vec3(0.f, f, 1.f);
+	}
+	float duration = kKeys * kKeySpacing;
+	std::size_t frames = std::size_t(duration / kFrameTime);
+
+	bench::report("keys per track", kKeys, "");
+
+	float time = 0.f;
+	double cursorTime = bench::measure(frames, [&]() {
+		auto camera = tracks.getCameraAt(time);
+		bench::consume(std::size_t(camera.position.x + camera.zoom));
+		time += kFrameTime;
+	});
+	bench::report("playback", cursorTime, "ns/frame");
+
+	// Seeking to unrelated times binary searches every track
+	std::size_t seeks = 10000;
+	std::size_t seek = 0;
+	double searchTime = bench::measure(seeks, [&]() {
+		float t = ((seek++ * 7919) % kKeys) * kKeySpacing + 0.05f;
+		auto camera = tracks.getCameraAt(t);
+		bench::consume(std::size_t(camera.position.x + camera.zoom));
+	});
+	bench::report("random seek", searchTime, "ns/frame");
+
+	// The map walk is slow enough that a slice of the cutscene will do
+	std::size_t legacyFrames = 200;
+	time = 0.f;
+	double legacyTime = bench::measure(legacyFrames, [&]() {
+		auto p = legacySample(position, time);
+		auto t = legacySample(target, time);
+		auto z = legacySample(zoom, time);
+		auto r = legacySample(rotation, time);
+		bench::consume(std::size_t(p.x + t.y + z + r));
+		time += duration / legacyFrames;
+	});
+	bench::report("legacy map walk", legacyTime, "ns/frame");
+}
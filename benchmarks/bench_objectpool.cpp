@@ -0,0 +1,86 @@
+#include "benchmark.hpp"
+#include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+
+#include <map>
+#include <memory>
+#include <random>
+
+namespace
+{
+
+class BenchObject : public GameObject
+{
+public:
+	BenchObject(GameWorld* engine)
+		: GameObject(engine, glm::vec3(), glm::quat(), nullptr)
+	{}
+
+	void tick(float) {}
+};
+
+const std::size_t kObjectCount = 10000;
+const std::size_t kLookups = 1000000;
+
+}
+
+/**
+ * Compares ObjectPool against the std::map it replaced, for lookups by ID and
+ * for iterating every object.
+ */
+RW_BENCHMARK(objectpool_lookup_iterate)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	std::vector<std::unique_ptr<BenchObject>> objects;
+	GameWorld::ObjectPool pool;
+	std::map<GameObjectID, GameObject*> reference;
+	std::vector<GameObjectID> ids;
+
+	for (std::size_t i = 0; i < kObjectCount; ++i) {
+		objects.emplace_back(new BenchObject(&world));
+		pool.insert(objects.back().get());
+		reference[objects.back()->getGameObjectID()] = objects.back().get();
+		ids.push_back(objects.back()->getGameObjectID());
+	}
+
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<std::size_t> pick(0, ids.size() - 1);
+	std::vector<GameObjectID> queries;
+	for (std::size_t i = 0; i < kLookups; ++i) {
+		queries.push_back(ids[pick(rng)]);
+	}
+
+	std::size_t q = 0;
+	double poolLookup = bench::measure(kLookups, [&]() {
+		bench::consume(reinterpret_cast<std::size_t>(pool.find(queries[q++])));
+	});
+	q = 0;
+	double mapLookup = bench::measure(kLookups, [&]() {
+		auto it = reference.find(queries[q++]);
+		bench::consume(reinterpret_cast<std::size_t>(it->second));
+	});
+
+	const std::size_t passes = 1000;
+	double poolIterate = bench::measure(passes, [&]() {
+		for (GameObject* object : pool.objects) {
+			bench::consume(object->getGameObjectID());
+		}
+	});
+	double mapIterate = bench::measure(passes, [&]() {
+		for (auto& p : reference) {
+			bench::consume(p.second->getGameObjectID());
+		}
+	});
+
+	bench::report("objects", kObjectCount, "");
+	bench::report("ObjectPool find", poolLookup, "ns/op");
+	bench::report("std::map find", mapLookup, "ns/op");
+	bench::report("ObjectPool iterate", poolIterate / 1000.0, "us/pass");
+	bench::report("std::map iterate", mapIterate / 1000.0, "us/pass");
+}
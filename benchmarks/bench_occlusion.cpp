@@ -0,0 +1,180 @@
+#include "benchmark.hpp"
+#include <render/OcclusionBuffer.hpp>
+#include <render/OcclusionCuller.hpp>
+#include <render/ViewCamera.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <random>
+
+namespace
+{
+const float kBlockSize = 40.f;
+/// Buildings are left out of blocks this close to the camera path
+const float kStreetWidth = 25.f;
+const std::size_t kPropsPerBlock = 6;
+const float kFarPlane = 800.f;
+/// Distance between samples along the path
+const float kSampleSpacing = 5.f;
+
+struct Bounds
+{
+	glm::vec3 min;
+	glm::vec3 max;
+	glm::vec3 center() const { return (min + max) * 0.5f; }
+	float radius() const { return glm::length(max - min) * 0.5f; }
+};
+
+struct TrackPoint
+{
+	glm::vec3 position;
+	glm::quat angle;
+};
+
+/**
+ * Reads a camera path in the format BenchmarkState uses
+ */
+std::vector<TrackPoint> loadTrack(const std::string& path)
+{
+	std::ifstream stream(path);
+	std::string clock;
+	stream >> clock;
+
+	std::vector<TrackPoint> track;
+	float time;
+	TrackPoint point;
+	while (stream >> time >> point.position.x >> point.position.y >> point.position.z
+				  >> point.angle.x >> point.angle.y >> point.angle.z >> point.angle.w) {
+		track.push_back(point);
+	}
+	return track;
+}
+
+float distanceToSegment(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b)
+{
+	auto ab = b - a;
+	float t = glm::clamp(glm::dot(p - a, ab) / std::max(glm::dot(ab, ab), 1e-6f), 0.f, 1.f);
+	return glm::length(p - (a + ab * t));
+}
+}
+
+/**
+ * Flies the Staunton benchmark camera path through a synthetic downtown:
+ * a grid of blocks with a building on each, except where the path runs, and
+ * street furniture around them. The buildings near the camera are drawn
+ * into the occlusion buffer the way OcclusionCuller picks them, then every
+ * object in the frustum is tested against it.
+ */
+RW_BENCHMARK(occlusion_staunton_path)
+{
+	auto track = loadTrack(RW_BENCHMARK_DATA_DIR "/staunton.txt");
+	if (track.size() < 2) {
+		bench::report("missing camera path", 0, "");
+		return;
+	}
+
+	glm::vec3 pathMin(std::numeric_limits<float>::max());
+	glm::vec3 pathMax(std::numeric_limits<float>::lowest());
+	for (auto& point : track) {
+		pathMin = glm::min(pathMin, point.position);
+		pathMax = glm::max(pathMax, point.position);
+	}
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+	std::vector<Bounds> buildings;
+	std::vector<Bounds> objects;
+	for (float x = pathMin.x - 400.f; x < pathMax.x + 400.f; x += kBlockSize) {
+		for (float y = pathMin.y - 400.f; y < pathMax.y + 400.f; y += kBlockSize) {
+			glm::vec2 centre(x + kBlockSize * 0.5f, y + kBlockSize * 0.5f);
+			float street = std::numeric_limits<float>::max();
+			for (std::size_t p = 0; p + 1 < track.size(); ++p) {
+				street = std::min(street, distanceToSegment(centre, glm::vec2(track[p].position),
+															glm::vec2(track[p + 1].position)));
+			}
+
+			if (street > kStreetWidth) {
+				float half = 11.f + unit(rng) * 5.f;
+				float height = 10.f + unit(rng) * 50.f;
+				buildings.push_back({glm::vec3(centre - glm::vec2(half), 0.f),
+									 glm::vec3(centre + glm::vec2(half), height)});
+				objects.push_back(buildings.back());
+			}
+
+			for (std::size_t i = 0; i < kPropsPerBlock; ++i) {
+				glm::vec3 position(x + unit(rng) * kBlockSize, y + unit(rng) * kBlockSize, 0.f);
+				objects.push_back({position - glm::vec3(1.f, 1.f, 0.f), position + glm::vec3(1.f, 1.f, 4.f)});
+			}
+		}
+	}
+	bench::report("buildings", buildings.size(), "");
+	bench::report("objects", objects.size(), "");
+
+	// Samples evenly spaced along the path
+	std::vector<ViewCamera> cameras;
+	for (std::size_t p = 0; p + 1 < track.size(); ++p) {
+		auto& a = track[p];
+		auto& b = track[p + 1];
+		int steps = std::max(1, int(glm::distance(a.position, b.position) / kSampleSpacing));
+		for (int s = 0; s < steps; ++s) {
+			float alpha = float(s) / steps;
+			cameras.emplace_back(glm::mix(a.position, b.position, alpha),
+								 glm::slerp(a.angle, b.angle, alpha));
+			cameras.back().frustum.far = kFarPlane;
+		}
+	}
+	bench::report("camera samples", cameras.size(), "");
+
+	OcclusionBuffer buffer;
+	std::vector<std::pair<float, const Bounds*>> candidates;
+	std::size_t inFrustum = 0;
+	std::size_t occluded = 0;
+	double buildTime = 0.0;
+	double testTime = 0.0;
+
+	for (auto& camera : cameras) {
+		auto viewProjection = camera.frustum.projection() * camera.getView();
+		camera.frustum.update(viewProjection);
+
+		buildTime += bench::measure(1, [&]() {
+			buffer.begin(viewProjection);
+			candidates.clear();
+			for (auto& building : buildings) {
+				float distance = glm::distance(building.center(), camera.position) - building.radius();
+				if (distance < OcclusionCuller::kOccluderRange &&
+					camera.frustum.intersects(building.center(), building.radius())) {
+					candidates.emplace_back(distance, &building);
+				}
+			}
+			std::sort(candidates.begin(), candidates.end());
+			for (auto& candidate : candidates) {
+				if (buffer.getTriangleCount() >= OcclusionCuller::kTriangleBudget) {
+					break;
+				}
+				buffer.drawBox(glm::mat4(), candidate.second->min, candidate.second->max);
+			}
+		});
+
+		std::size_t frameTested = 0;
+		testTime += bench::measure(1, [&]() {
+			for (auto& object : objects) {
+				if (!camera.frustum.intersects(object.center(), object.radius())) {
+					continue;
+				}
+				frameTested++;
+				if (!buffer.isVisible(object.min, object.max)) {
+					occluded++;
+				}
+			}
+		});
+		inFrustum += frameTested;
+	}
+
+	bench::report("objects in frustum", double(inFrustum) / cameras.size(), "per frame");
+	bench::report("occlusion culled", 100.0 * occluded / std::max<std::size_t>(inFrustum, 1), "%");
+	bench::report("occluder rasterization", buildTime / cameras.size() / 1e3, "us/frame");
+	bench::report("frustum and occlusion tests", testTime / std::max<std::size_t>(inFrustum, 1), "ns/object");
+}
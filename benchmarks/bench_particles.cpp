@@ -0,0 +1,128 @@
+#include "benchmark.hpp"
+#include <render/ParticleSystem.hpp>
+#include <engine/RandomService.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+const std::size_t kParticles = 100000;
+const std::uint32_t kTextures = 8;
+const float kArea = 500.f;
+const float kTimestep = 1.f / 30.f;
+
+/**
+ * Stand in for the old one-object-per-particle effects
+ */
+struct LegacyParticle
+{
+	glm::vec3 position;
+	glm::vec3 direction;
+	glm::vec2 size;
+};
+}
+
+/**
+ * Simulation and draw preparation for 100k particles spread over a few
+ * textures, against sorting and building matrices for individually
+ * allocated particles as the renderer used to.
+ */
+RW_BENCHMARK(particles_100k)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> coord(-kArea, kArea);
+	std::uniform_real_distribution<float> life(1.f, 3.f);
+	std::uniform_int_distribution<std::uint32_t> tex(1, kTextures);
+
+	ParticleSystem particles;
+	RandomStream random(1234);
+
+	// Emitters replace what expires, keeping the count near kParticles
+	const std::size_t emitterCount = 1000;
+	for (std::size_t e = 0; e < emitterCount; ++e) {
+		EmitterInfo emitter;
+		emitter.position = glm::vec3(coord(rng), coord(rng), 10.f);
+		emitter.rate = kParticles / (emitterCount * 2.f);
+		emitter.spread = 1.f;
+		emitter.particle.lifetime = 2.f;
+		emitter.particle.orientation = ParticleInfo::Camera;
+		emitter.particle.texture = tex(rng);
+		emitter.particle.growth = glm::vec2(0.5f);
+		particles.createEmitter(emitter, 0.f);
+	}
+
+	float time = 0.f;
+	while (time < 2.5f) {
+		time += kTimestep;
+		particles.update(time, kTimestep, random);
+	}
+	bench::report("particles", particles.getParticleCount(), "");
+
+	double updateTime = bench::measure(100, [&]() {
+		time += kTimestep;
+		particles.update(time, kTimestep, random);
+	});
+	bench::report("update", updateTime * 1e-6, "ms");
+
+	glm::vec3 camera(0.f, 0.f, 20.f);
+	glm::vec3 forward(0.f, 1.f, 0.f);
+	double batchTime = bench::measure(100, [&]() {
+		particles.buildBatches(camera, forward);
+		bench::consume(particles.getBatches().size());
+	});
+	bench::report("sort and batch", batchTime * 1e-6, "ms");
+	bench::report("draw calls", particles.getBatches().size(), "");
+
+	// Particles spawned and expired in bulk
+	ParticleSystem bulk;
+	double expiryTime = bench::measure(10, [&]() {
+		ParticleInfo info;
+		for (std::size_t i = 0; i < kParticles; ++i) {
+			info.lifetime = life(rng);
+			bulk.spawn(info, 0.f);
+		}
+		bulk.update(2.f, 0.f, random);
+		bulk.update(3.f, 0.f, random);
+		bench::consume(bulk.getParticleCount());
+	});
+	bench::report("spawn and expire 100k", expiryTime * 1e-6, "ms");
+
+	std::vector<std::unique_ptr<LegacyParticle>> legacy;
+	for (std::size_t i = 0; i < kParticles; ++i) {
+		legacy.emplace_back(new LegacyParticle{
+			glm::vec3(coord(rng), coord(rng), 10.f), glm::vec3(0.f, 0.f, 1.f), glm::vec2(1.f)});
+	}
+	std::vector<LegacyParticle*> effects;
+	for (auto& p : legacy) {
+		effects.push_back(p.get());
+	}
+	std::vector<glm::mat4> matrices(kParticles);
+	double legacyTime = bench::measure(10, [&]() {
+		std::sort(effects.begin(), effects.end(),
+				  [&](const LegacyParticle* a, const LegacyParticle* b) {
+			return glm::distance(a->position, camera) > glm::distance(b->position, camera);
+		});
+		for (std::size_t i = 0; i < effects.size(); ++i) {
+			auto& p = effects[i]->position;
+			glm::vec3 f = glm::normalize(effects[i]->direction);
+			glm::vec3 s = glm::cross(f, glm::normalize(camera - p));
+			glm::vec3 u = glm::cross(s, f);
+			glm::mat4 m(1.f);
+			m[0][0] = s.x; m[1][0] = s.y; m[2][0] = s.z;
+			m[0][1] =-f.x; m[1][1] =-f.y; m[2][1] =-f.z;
+			m[0][2] = u.x; m[1][2] = u.y; m[2][2] = u.z;
+			m[3][0] =-glm::dot(s, p);
+			m[3][1] = glm::dot(f, p);
+			m[3][2] =-glm::dot(u, p);
+			matrices[i] = glm::scale(glm::inverse(m), glm::vec3(effects[i]->size, 1.f));
+		}
+		bench::consume(std::size_t(matrices[0][3][0]));
+	});
+	bench::report("legacy sort and matrices", legacyTime * 1e-6, "ms");
+	bench::report("legacy draw calls", kParticles, "");
+}
@@ -0,0 +1,146 @@
+#include "benchmark.hpp"
+#include <dynamics/PhysicsWorld.hpp>
+#include <core/WorkerPool.hpp>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int kTerrainSize = 64;
+const float kTerrainSpacing = 4.f;
+const int kVehicles = 256;
+const float kTimestep = 1.f / 60.f;
+
+/**
+ * Vehicles dropped onto a bumpy triangle mesh, stepped on its own
+ * dynamics world.
+ */
+struct VehicleScene
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher;
+	btDbvtBroadphase broadphase;
+	PhysicsWorld physics;
+
+	btTriangleMesh terrainMesh;
+	std::unique_ptr<btBvhTriangleMeshShape> terrainShape;
+	std::unique_ptr<btRigidBody> terrain;
+
+	btBoxShape chassisShape;
+	btRaycastVehicle::btVehicleTuning tuning;
+	std::unique_ptr<btVehicleRaycaster> raycaster;
+	std::vector<std::unique_ptr<btRigidBody>> chassis;
+	std::vector<std::unique_ptr<btRaycastVehicle>> vehicles;
+
+	VehicleScene(WorkerPool* workers)
+		: dispatcher(&config)
+		, physics(&dispatcher, &broadphase, &config, workers)
+		, chassisShape(btVector3(1.f, 2.2f, 0.6f))
+	{
+		auto world = physics.getDynamicsWorld();
+		world->setGravity(btVector3(0.f, 0.f, -9.81f));
+
+		auto height = [](int x, int y) {
+			return std::sin(x * 0.3f) * std::cos(y * 0.2f) * 1.5f;
+		};
+		for (int x = 0; x < kTerrainSize; ++x) {
+			for (int y = 0; y < kTerrainSize; ++y) {
+				btVector3 a(x * kTerrainSpacing, y * kTerrainSpacing, height(x, y));
+				btVector3 b((x + 1) * kTerrainSpacing, y * kTerrainSpacing, height(x + 1, y));
+				btVector3 c(x * kTerrainSpacing, (y + 1) * kTerrainSpacing, height(x, y + 1));
+				btVector3 d((x + 1) * kTerrainSpacing, (y + 1) * kTerrainSpacing, height(x + 1, y + 1));
+				terrainMesh.addTriangle(a, b, c);
+				terrainMesh.addTriangle(b, d, c);
+			}
+		}
+		terrainShape.reset(new btBvhTriangleMeshShape(&terrainMesh, true));
+		terrain.reset(new btRigidBody(0.f, nullptr, terrainShape.get()));
+		world->addRigidBody(terrain.get());
+
+		raycaster.reset(new btDefaultVehicleRaycaster(world));
+
+		btVector3 inertia;
+		chassisShape.calculateLocalInertia(1200.f, inertia);
+		int perRow = int(std::sqrt(float(kVehicles)));
+		float spread = (kTerrainSize * kTerrainSpacing) / (perRow + 1);
+		for (int i = 0; i < kVehicles; ++i) {
+			btTransform t;
+			t.setIdentity();
+			t.setOrigin(btVector3((i % perRow + 1) * spread, (i / perRow + 1) * spread, 5.f));
+
+			btRigidBody::btRigidBodyConstructionInfo info(1200.f, nullptr, &chassisShape, inertia);
+			info.m_startWorldTransform = t;
+			chassis.emplace_back(new btRigidBody(info));
+			auto body = chassis.back().get();
+			body->setActivationState(DISABLE_DEACTIVATION);
+			world->addRigidBody(body);
+
+			vehicles.emplace_back(new btRaycastVehicle(tuning, body, raycaster.get()));
+			auto vehicle = vehicles.back().get();
+			vehicle->setCoordinateSystem(0, 2, 1);
+			for (int w = 0; w < 4; ++w) {
+				btVector3 point(w % 2 ? 0.9f : -0.9f, w < 2 ? 1.6f : -1.6f, 0.f);
+				vehicle->addWheel(point, btVector3(0.f, 0.f, -1.f), btVector3(1.f, 0.f, 0.f),
+								  0.5f, 0.4f, tuning, w < 2);
+			}
+			world->addAction(vehicle);
+		}
+	}
+
+	~VehicleScene()
+	{
+		auto world = physics.getDynamicsWorld();
+		for (auto& vehicle : vehicles) {
+			world->removeAction(vehicle.get());
+		}
+		for (auto& body : chassis) {
+			world->removeRigidBody(body.get());
+		}
+		world->removeRigidBody(terrain.get());
+	}
+
+	void step()
+	{
+		physics.getDynamicsWorld()->stepSimulation(kTimestep, 1, kTimestep);
+	}
+};
+}
+
+/**
+ * Physics step time for vehicles settling on a triangle mesh, for each
+ * worker thread count. Only differs between thread counts when built with
+ * ENABLE_BULLET_THREADS.
+ */
+RW_BENCHMARK(physics_vehicles)
+{
+	const std::size_t settleSteps = 60;
+	const std::size_t steps = 300;
+
+	bench::report("vehicles", kVehicles, "");
+
+	unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int threads = 1; threads <= hardware; threads *= 2) {
+		WorkerPool workers(threads);
+		VehicleScene scene(&workers);
+
+		for (std::size_t i = 0; i < settleSteps; ++i) {
+			scene.step();
+		}
+
+		double stepTime = bench::measure(steps, [&]() {
+			scene.step();
+		});
+		bench::consume(std::size_t(scene.chassis[0]->getWorldTransform().getOrigin().z() * 1000.f));
+
+		bench::report(std::to_string(threads) + " thread(s)" +
+					  (scene.physics.isThreaded() ? "" : " (serial solver)"),
+					  stepTime * 1e-6, "ms/step");
+	}
+}
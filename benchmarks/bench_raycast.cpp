@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+#include <dynamics/RaycastService.hpp>
+#include <core/WorkerPool.hpp>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace
+{
+const int kGridSize = 100;
+const float kGridSpacing = 8.f;
+const std::size_t kRaysPerTick = 4096;
+}
+
+/**
+ * Ray throughput against a 100x100 grid of boxes: Bullet's own rayTest, one
+ * ray at a time through RaycastService, and RaycastService batches.
+ */
+RW_BENCHMARK(raycast_throughput)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btCollisionWorld world(&dispatcher, &broadphase, &config);
+	btBoxShape box(btVector3(2.f, 2.f, 2.f));
+	btStaticPlaneShape ground(btVector3(0.f, 0.f, 1.f), 0.f);
+
+	std::vector<std::unique_ptr<btCollisionObject>> objects;
+	objects.emplace_back(new btCollisionObject);
+	objects.back()->setCollisionShape(&ground);
+	world.addCollisionObject(objects.back().get());
+	for (int x = 0; x < kGridSize; ++x) {
+		for (int y = 0; y < kGridSize; ++y) {
+			objects.emplace_back(new btCollisionObject);
+			objects.back()->setCollisionShape(&box);
+			objects.back()->getWorldTransform().setOrigin(
+						btVector3(x * kGridSpacing, y * kGridSpacing, 2.f));
+			world.addCollisionObject(objects.back().get());
+		}
+	}
+
+	// A mix of ground probes and short horizontal shots
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> coord(0.f, kGridSize * kGridSpacing);
+	std::uniform_real_distribution<float> direction(-50.f, 50.f);
+	std::vector<RaycastService::Ray> rays;
+	for (std::size_t i = 0; i < kRaysPerTick; ++i) {
+		glm::vec3 origin(coord(rng), coord(rng), 1.f);
+		if (i % 2) {
+			rays.push_back({ origin + glm::vec3(0.f, 0.f, 100.f),
+							 origin - glm::vec3(0.f, 0.f, 100.f) });
+		}
+		else {
+			rays.push_back({ origin,
+							 origin + glm::vec3(direction(rng), direction(rng), 0.f) });
+		}
+	}
+	std::vector<RaycastService::Hit> hits(rays.size());
+
+	const std::size_t ticks = 20;
+
+	double bullet = bench::measure(ticks, [&]() {
+		std::size_t count = 0;
+		for (auto& ray : rays) {
+			btVector3 from(ray.from.x, ray.from.y, ray.from.z);
+			btVector3 to(ray.to.x, ray.to.y, ray.to.z);
+			btCollisionWorld::ClosestRayResultCallback cb(from, to);
+			world.rayTest(from, to, cb);
+			count += cb.hasHit() ? 1 : 0;
+		}
+		bench::consume(count);
+	});
+
+	bench::report("rays per tick", kRaysPerTick, "");
+	bench::report("btCollisionWorld::rayTest", kRaysPerTick / (bullet * 1e-9) / 1e6, "Mrays/s");
+
+	unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int threads = 1; threads <= hardware; threads *= 2) {
+		WorkerPool workers(threads);
+		RaycastService service(&broadphase, &workers);
+		double batched = bench::measure(ticks, [&]() {
+			service.castBatch(rays.data(), hits.data(), rays.size());
+			bench::consume(hits[0].hit ? 1 : 0);
+		});
+		bench::report("RaycastService, " + std::to_string(threads) + " thread(s)",
+					  kRaysPerTick / (batched * 1e-9) / 1e6, "Mrays/s");
+	}
+
+	for (auto& object : objects) {
+		world.removeCollisionObject(object.get());
+	}
+}
@@ -0,0 +1,125 @@
+#include "benchmark.hpp"
+#include <ai/RoutePlanner.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace
+{
+
+/// A city-sized grid of vehicle nodes, four-way connected
+const int kGridWidth = 150;
+const float kNodeSpacing = 20.f;
+const std::size_t kQueries = 5000;
+/// Fraction of nodes disabled, as roadblocks and closed roads
+const float kDisabledFraction = 0.05f;
+
+AIGraph::NodeIndex gridNode(int x, int y)
+{
+	return x * kGridWidth + y;
+}
+
+void createGridGraph(AIGraph& graph, std::mt19937& rng)
+{
+	for (int x = 0; x < kGridWidth; ++x) {
+		for (int y = 0; y < kGridWidth; ++y) {
+			PathData path {
+				PathData::PATH_CAR,
+				0, "",
+				{
+					{ PathNode::INTERNAL, -1, { 0.f, 0.f, 0.f }, 1.f, 0, 0 },
+				}
+			};
+			glm::vec3 position((x - kGridWidth / 2) * kNodeSpacing,
+			                   (y - kGridWidth / 2) * kNodeSpacing, 0.f);
+			graph.createPathNodes(position, glm::quat(), path);
+		}
+	}
+
+	for (int x = 0; x < kGridWidth; ++x) {
+		for (int y = 0; y < kGridWidth; ++y) {
+			if (x + 1 < kGridWidth) {
+				graph.connect(gridNode(x, y), gridNode(x + 1, y));
+			}
+			if (y + 1 < kGridWidth) {
+				graph.connect(gridNode(x, y), gridNode(x, y + 1));
+			}
+		}
+	}
+
+	std::uniform_real_distribution<float> chance(0.f, 1.f);
+	for (std::size_t n = 0; n < graph.nodes.size(); ++n) {
+		if (chance(rng) < kDisabledFraction) {
+			graph.setNodeDisabled(n, true);
+		}
+	}
+}
+
+}
+
+/**
+ * Plans routes between random pairs of nodes on a synthetic city grid,
+ * reporting throughput through the planning thread, the latency of single
+ * searches, and the cost of answering the same requests from the cache.
+ */
+RW_BENCHMARK(routeplanner_city_grid)
+{
+	typedef std::chrono::steady_clock clock;
+
+	std::mt19937 rng(1234);
+	AIGraph graph;
+	createGridGraph(graph, rng);
+
+	std::uniform_int_distribution<AIGraph::NodeIndex> node(0, graph.nodes.size() - 1);
+	std::vector<std::pair<AIGraph::NodeIndex, AIGraph::NodeIndex>> queries;
+	for (std::size_t i = 0; i < kQueries; ++i) {
+		queries.push_back({ node(rng), node(rng) });
+	}
+
+	RoutePlanner planner(graph, kQueries * 2);
+
+	// Latency of individual searches on this thread
+	std::vector<double> latencies;
+	std::size_t found = 0;
+	for (auto& q : queries) {
+		auto start = clock::now();
+		auto route = planner.planRoute(q.first, q.second, AIGraphNode::Vehicle);
+		auto end = clock::now();
+		latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+		found += route->found() ? 1 : 0;
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	// Throughput through the planning thread
+	std::vector<RouteRequestRef> requests;
+	requests.reserve(queries.size());
+	auto asyncStart = clock::now();
+	for (auto& q : queries) {
+		requests.push_back(planner.requestRoute(q.first, q.second, AIGraphNode::Vehicle));
+	}
+	for (auto& request : requests) {
+		while (! request->isReady()) {
+			std::this_thread::yield();
+		}
+	}
+	double asyncSeconds = std::chrono::duration<double>(clock::now() - asyncStart).count();
+
+	// The same requests again, all answered by the cache
+	std::size_t cached = 0;
+	double cachedTime = bench::measure(10, [&]() {
+		for (auto& q : queries) {
+			cached += planner.requestRoute(q.first, q.second, AIGraphNode::Vehicle)->isReady() ? 1 : 0;
+		}
+	});
+	bench::consume(cached);
+
+	bench::report("nodes", graph.nodes.size(), "");
+	bench::report("queries", kQueries, "");
+	bench::report("routes found", found, "");
+	bench::report("search latency p50", latencies[latencies.size() / 2], "us");
+	bench::report("search latency p99", latencies[latencies.size() * 99 / 100], "us");
+	bench::report("planning thread throughput", kQueries / asyncSeconds, "queries/s");
+	bench::report("cached throughput", kQueries / (cachedTime * 1e-9), "queries/s");
+}
@@ -0,0 +1,158 @@
+#include "benchmark.hpp"
+#include <engine/SpatialHash.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+
+#include <glm/gtx/norm.hpp>
+
+#include <memory>
+#include <random>
+
+namespace
+{
+
+class BenchObject : public GameObject
+{
+public:
+	BenchObject(GameWorld* engine, const glm::vec3& position)
+		: GameObject(engine, position, glm::quat(), nullptr)
+	{}
+
+	void tick(float) {}
+};
+
+const std::size_t kPedestrians = 500;
+const std::size_t kVehicles = 200;
+const std::size_t kNodes = 200;
+const float kArea = 400.f;
+
+}
+
+/**
+ * Times the proximity queries used by traffic spawning and cleanup, against
+ * the linear scans over the object pools they replaced.
+ */
+RW_BENCHMARK(spatialhash_traffic_queries)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> coord(-kArea, kArea);
+	auto randomPosition = [&]() { return glm::vec3(coord(rng), coord(rng), 10.f); };
+
+	std::vector<std::unique_ptr<BenchObject>> peds, vehicles;
+	SpatialHash pedHash, vehicleHash;
+	for (std::size_t i = 0; i < kPedestrians; ++i) {
+		peds.emplace_back(new BenchObject(&world, randomPosition()));
+		pedHash.insert(peds.back().get(), peds.back()->getPosition());
+	}
+	for (std::size_t i = 0; i < kVehicles; ++i) {
+		vehicles.emplace_back(new BenchObject(&world, randomPosition()));
+		vehicleHash.insert(vehicles.back().get(), vehicles.back()->getPosition());
+	}
+
+	std::vector<glm::vec3> nodes;
+	for (std::size_t i = 0; i < kNodes; ++i) {
+		nodes.push_back(randomPosition());
+	}
+
+	const std::size_t passes = 1000;
+	const float blockRadius = 10.f;
+
+	// Spawn node blocking, as in TrafficDirector::findAvailableNodes
+	double nodesLinear = bench::measure(passes, [&]() {
+		std::size_t blocked = 0;
+		for (auto& node : nodes) {
+			for (auto& ped : peds) {
+				if (glm::distance2(node, ped->getPosition()) <= blockRadius * blockRadius) {
+					blocked++;
+					break;
+				}
+			}
+		}
+		bench::consume(blocked);
+	});
+	double nodesHash = bench::measure(passes, [&]() {
+		std::size_t blocked = 0;
+		for (auto& node : nodes) {
+			blocked += pedHash.anyWithin(node, blockRadius) ? 1 : 0;
+		}
+		bench::consume(blocked);
+	});
+
+	// Distant traffic, as in GameWorld::cleanupTraffic
+	const float cleanupRadius = 125.f;
+	std::vector<GameObject*> distant;
+	double cleanupLinear = bench::measure(passes, [&]() {
+		distant.clear();
+		for (auto& ped : peds) {
+			if (glm::distance(glm::vec3(), ped->getPosition()) >= cleanupRadius) {
+				distant.push_back(ped.get());
+			}
+		}
+		for (auto& vehicle : vehicles) {
+			if (glm::distance(glm::vec3(), vehicle->getPosition()) >= cleanupRadius) {
+				distant.push_back(vehicle.get());
+			}
+		}
+		bench::consume(distant.size());
+	});
+	double cleanupHash = bench::measure(passes, [&]() {
+		distant.clear();
+		pedHash.queryOutside(glm::vec3(), cleanupRadius, distant);
+		vehicleHash.queryOutside(glm::vec3(), cleanupRadius, distant);
+		bench::consume(distant.size());
+	});
+
+	// Nearest vehicle to every pedestrian, as in enterNearestVehicle
+	std::vector<GameObject*> nearest;
+	double nearestLinear = bench::measure(passes / 10, [&]() {
+		for (auto& ped : peds) {
+			GameObject* found = nullptr;
+			float d = 10.f;
+			for (auto& vehicle : vehicles) {
+				float vd = glm::length(ped->getPosition() - vehicle->getPosition());
+				if (vd < d) {
+					d = vd;
+					found = vehicle.get();
+				}
+			}
+			bench::consume(reinterpret_cast<std::size_t>(found));
+		}
+	});
+	double nearestHash = bench::measure(passes / 10, [&]() {
+		for (auto& ped : peds) {
+			nearest.clear();
+			vehicleHash.queryNearest(ped->getPosition(), 1, 10.f, nearest);
+			bench::consume(nearest.size());
+		}
+	});
+
+	// Keeping the hash current after every object has moved a little
+	std::uniform_real_distribution<float> step(-1.f, 1.f);
+	std::vector<glm::vec3> positions;
+	for (auto& ped : peds) {
+		positions.push_back(ped->getPosition());
+	}
+	double update = bench::measure(passes, [&]() {
+		for (std::size_t i = 0; i < peds.size(); ++i) {
+			positions[i] += glm::vec3(step(rng), step(rng), 0.f);
+			pedHash.update(peds[i].get(), positions[i]);
+		}
+	});
+
+	bench::report("pedestrians", kPedestrians, "");
+	bench::report("vehicles", kVehicles, "");
+	bench::report("node blocking, linear", nodesLinear / 1000.0, "us/pass");
+	bench::report("node blocking, hash", nodesHash / 1000.0, "us/pass");
+	bench::report("cleanup, linear", cleanupLinear / 1000.0, "us/pass");
+	bench::report("cleanup, hash", cleanupHash / 1000.0, "us/pass");
+	bench::report("nearest vehicle per ped, linear", nearestLinear / 1000.0, "us/pass");
+	bench::report("nearest vehicle per ped, hash", nearestHash / 1000.0, "us/pass");
+	bench::report("update all peds", update / 1000.0, "us/pass");
+}
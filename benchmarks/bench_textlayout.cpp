@@ -0,0 +1,141 @@
+#include "benchmark.hpp"
+#include <render/TextLayout.hpp>
+#include <render/TextRenderer.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+const std::size_t kStaticStrings = 30;
+const std::size_t kFrames = 2000;
+
+struct LegacyVertex
+{
+	glm::vec2 position;
+	glm::vec2 texcoord;
+	glm::vec3 colour;
+};
+
+/**
+ * The per-call work renderText used to do before drawing: copy the text,
+ * strip markup in place, scan ahead for wrapping and build fresh vertices.
+ */
+std::size_t legacyLayout(const TextRenderer::TextInfo& ti)
+{
+	glm::vec2 coord(0.f, 0.f);
+	auto lineLength = 0;
+	glm::vec2 ss(ti.size);
+	glm::vec3 colour = glm::vec3(ti.baseColour) * (1/255.f);
+	std::vector<LegacyVertex> geo;
+
+	auto text = ti.text;
+	for (size_t i = 0; i < text.length(); ++i) {
+		char c = text[i];
+		if (c == '~' && text.length() > i + 1) {
+			switch (text[i+1]) {
+			case 'r':
+				text.erase(text.begin()+i, text.begin()+i+3);
+				colour = glm::vec3(1.f, 0.f, 0.f);
+				break;
+			case 'h':
+				text.erase(text.begin()+i, text.begin()+i+3);
+				colour = glm::vec3(1.f);
+				break;
+			}
+			c = text[i];
+		}
+
+		int glyph = TextLayoutCache::charToIndex(c);
+		if (ti.wrapX > 0 && coord.x > 0.f && !std::isspace(c)) {
+			auto wend = std::find_if(std::begin(text)+i, std::end(text),
+									 [](char x) { return std::isspace(x); });
+			if (wend != std::end(text)) {
+				auto word = std::distance(std::begin(text)+i, wend);
+				if (lineLength + word >= ti.wrapX) {
+					coord.x = 0;
+					coord.y += ss.y;
+					lineLength = 0;
+				}
+			}
+		}
+
+		ss.x = ti.size * 0.7f;
+		if (c == '\n') {
+			coord.x = 0.f;
+			coord.y += ss.y;
+			lineLength = 0;
+			continue;
+		}
+		lineLength++;
+
+		glm::vec2 p = coord;
+		coord.x += ss.x;
+		glm::vec2 t(glyph % 16, glyph / 16);
+		for (int v = 0; v < 6; ++v) {
+			geo.push_back({p, t, colour});
+		}
+	}
+	return geo.size();
+}
+}
+
+/**
+ * A HUD's worth of text each frame: mostly unchanging labels plus a money
+ * counter and a timer that change every frame. Laying out through the cache
+ * into one shared vertex batch, against the old per-string layout.
+ */
+RW_BENCHMARK(textlayout_hud_frame)
+{
+	std::vector<TextRenderer::TextInfo> hud;
+	for (std::size_t i = 0; i < kStaticStrings; ++i) {
+		TextRenderer::TextInfo ti;
+		ti.font = i % GAME_FONTS;
+		ti.size = 20.f;
+		ti.wrapX = i % 3 ? 0 : 40;
+		ti.text = "~h~Mission objective " + std::to_string(i) +
+				  ": drive the ~r~car~h~ to the marked location before time runs out";
+		hud.push_back(ti);
+	}
+	TextRenderer::TextInfo money, timer;
+	money.size = timer.size = 25.f;
+
+	bench::report("strings per frame", hud.size() + 2, "");
+
+	TextLayoutCache cache;
+	std::vector<TextRenderer::TextVertex> vertices;
+	std::size_t frame = 0;
+	double cachedTime = bench::measure(kFrames, [&]() {
+		vertices.clear();
+		money.text = "$" + std::to_string(10000 + frame);
+		timer.text = std::to_string(frame / 60) + ":" + std::to_string(frame % 60);
+		for (auto& ti : hud) {
+			TextRenderer::buildVertices(ti, cache.layout(ti.text, ti.font, ti.size, ti.wrapX),
+										false, vertices);
+		}
+		TextRenderer::buildVertices(money, cache.layout(money.text, money.font, money.size, money.wrapX),
+									false, vertices);
+		TextRenderer::buildVertices(timer, cache.layout(timer.text, timer.font, timer.size, timer.wrapX),
+									false, vertices);
+		cache.nextFrame();
+		frame++;
+		bench::consume(vertices.size());
+	});
+	bench::report("cached layout, one batch", cachedTime, "ns/frame");
+	bench::report("cached layouts", cache.size(), "");
+
+	frame = 0;
+	double legacyTime = bench::measure(kFrames, [&]() {
+		std::size_t total = 0;
+		money.text = "$" + std::to_string(10000 + frame);
+		timer.text = std::to_string(frame / 60) + ":" + std::to_string(frame % 60);
+		for (auto& ti : hud) {
+			total += legacyLayout(ti);
+		}
+		total += legacyLayout(money);
+		total += legacyLayout(timer);
+		frame++;
+		bench::consume(total);
+	});
+	bench::report("legacy per-string layout", legacyTime, "ns/frame");
+}
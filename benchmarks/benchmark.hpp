@@ -0,0 +1,77 @@
+#pragma once
+#ifndef _RWBENCHMARKS_BENCHMARK_HPP_
+#define _RWBENCHMARKS_BENCHMARK_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal harness for engine micro benchmarks.
+ *
+ * Benchmarks are declared with RW_BENCHMARK and run by run_benchmarks,
+ * which accepts an optional substring to select which ones to run.
+ */
+namespace bench
+{
+
+struct Case
+{
+	const char* name;
+	void (*run)();
+};
+
+inline std::vector<Case>& registry()
+{
+	static std::vector<Case> cases;
+	return cases;
+}
+
+struct Registration
+{
+	Registration(const char* name, void (*run)())
+	{
+		registry().push_back({name, run});
+	}
+};
+
+/**
+ * Results are accumulated here so the optimiser can't discard the work
+ * being measured.
+ */
+extern volatile std::size_t sink;
+
+inline void consume(std::size_t value)
+{
+	sink = sink + value;
+}
+
+/**
+ * Calls fn iterations times, returning the mean time per call in nanoseconds.
+ */
+template <class F>
+double measure(std::size_t iterations, F fn)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i) {
+		fn();
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+inline void report(const std::string& label, double value, const std::string& unit)
+{
+	std::cout << "  " << label << ": " << value << " " << unit << std::endl;
+}
+
+}
+
+#define RW_BENCHMARK(name) \
+	static void name(); \
+	static bench::Registration name##_registration(#name, &name); \
+	static void name()
+
+#endif
@@ -0,0 +1,20 @@
+#include "benchmark.hpp"
+
+#include <cstring>
+
+volatile std::size_t bench::sink = 0;
+
+int main(int argc, char* argv[])
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	for (auto& c : bench::registry()) {
+		if (filter && std::strstr(c.name, filter) == nullptr) {
+			continue;
+		}
+		std::cout << c.name << std::endl;
+		c.run();
+	}
+
+	return 0;
+}
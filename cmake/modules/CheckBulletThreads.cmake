@@ -0,0 +1,101 @@
+#
+# Checks that the Bullet found by FindBullet was built thread safe, which
+# Bullet's BULLET2_MULTITHREADING option (BULLET2_USE_THREAD_LOCKS before
+# 2.87) does by defining BT_THREADSAFE. The definitions come from Bullet's
+# own BulletConfig.cmake or pkg-config file, and the library must run
+# btParallelFor on the installed task scheduler. Stops the configure if
+# either check fails.
+#
+# This script defines the following variables:
+# - BULLET_THREAD_DEFINITIONS: Bullet's BT_ compile definitions, including
+#                              BT_THREADSAFE, to build against it with
+#
+
+include(CheckCXXSourceCompiles)
+include(CheckCXXSourceRuns)
+
+function(_rw_bullet_config_definitions out)
+	find_file(BULLET_CONFIG_FILE BulletConfig.cmake
+		PATHS ${BULLET_ROOT} $ENV{BULLET_ROOT} /usr/local /usr /opt/local
+		PATH_SUFFIXES lib/cmake/bullet lib64/cmake/bullet share/bullet)
+	set(definitions)
+	if(BULLET_CONFIG_FILE)
+		# Only this function's scope sees what the config file sets
+		include(${BULLET_CONFIG_FILE})
+		set(definitions ${BULLET_DEFINITIONS})
+	endif()
+
+	find_package(PkgConfig QUIET)
+	if(PKG_CONFIG_FOUND)
+		pkg_check_modules(BULLET_PC QUIET bullet)
+		list(APPEND definitions ${BULLET_PC_CFLAGS_OTHER})
+	endif()
+	set(${out} ${definitions} PARENT_SCOPE)
+endfunction()
+
+_rw_bullet_config_definitions(_bullet_definitions)
+
+set(BULLET_THREAD_DEFINITIONS)
+foreach(definition ${_bullet_definitions})
+	if(definition MATCHES "^(-D)?(BT_[A-Za-z0-9_]+(=.*)?)$")
+		list(APPEND BULLET_THREAD_DEFINITIONS "-D${CMAKE_MATCH_2}")
+	endif()
+endforeach()
+if(BULLET_THREAD_DEFINITIONS)
+	list(REMOVE_DUPLICATES BULLET_THREAD_DEFINITIONS)
+endif()
+
+if(NOT BULLET_THREAD_DEFINITIONS MATCHES "-DBT_THREADSAFE(=1)?(;|$)")
+	message(FATAL_ERROR "ENABLE_BULLET_THREADS: Bullet's BulletConfig.cmake "
+		"and pkg-config file don't define BT_THREADSAFE. Build Bullet with "
+		"BULLET2_MULTITHREADING, or set BULLET_ROOT to one that was.")
+endif()
+
+set(_bullet_parallel_for_source "
+#include <LinearMath/btThreads.h>
+struct Scheduler : public btITaskScheduler
+{
+	bool used;
+	Scheduler() : btITaskScheduler(\"check\"), used(false) {}
+	int getMaxNumThreads() const { return 2; }
+	int getNumThreads() const { return 2; }
+	void setNumThreads(int) {}
+	void parallelFor(int b, int e, int, const btIParallelForBody& body)
+		{ used = true; body.forLoop(b, e); }
+#if BT_BULLET_VERSION >= 288
+	btScalar parallelSum(int b, int e, int, const btIParallelSumBody& body)
+		{ used = true; return body.sumLoop(b, e); }
+#endif
+};
+struct Body : public btIParallelForBody
+{
+	void forLoop(int, int) const {}
+};
+int main()
+{
+	Scheduler scheduler;
+	btSetTaskScheduler(&scheduler);
+	btParallelFor(0, 8, 1, Body());
+	btSetTaskScheduler(0);
+	return scheduler.used ? 0 : 1;
+}
+")
+
+set(CMAKE_REQUIRED_DEFINITIONS ${BULLET_THREAD_DEFINITIONS})
+set(CMAKE_REQUIRED_INCLUDES ${BULLET_INCLUDE_DIRS})
+set(CMAKE_REQUIRED_LIBRARIES ${BULLET_LIBRARIES})
+if(CMAKE_CROSSCOMPILING)
+	check_cxx_source_compiles("${_bullet_parallel_for_source}" BULLET_PARALLEL_FOR)
+else()
+	# A library built without BT_THREADSAFE runs the loop itself
+	check_cxx_source_runs("${_bullet_parallel_for_source}" BULLET_PARALLEL_FOR)
+endif()
+unset(CMAKE_REQUIRED_DEFINITIONS)
+unset(CMAKE_REQUIRED_INCLUDES)
+unset(CMAKE_REQUIRED_LIBRARIES)
+
+if(NOT BULLET_PARALLEL_FOR)
+	message(FATAL_ERROR "ENABLE_BULLET_THREADS: the Bullet library at "
+		"${BULLET_LIBRARIES} doesn't run parallel loops on a task scheduler. "
+		"Build Bullet with BULLET2_MULTITHREADING.")
+endif()
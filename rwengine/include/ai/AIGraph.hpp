@@ -4,34 +4,124 @@
 #include <vector>
 #include <glm/gtc/quaternion.hpp>
 #include <data/PathData.hpp>
+#include <ai/AIGraphNode.hpp>
 #include <array>
 #include <rw/types.hpp>
 
-struct AIGraphNode;
-
+/**
+ * @brief The network of pedestrian and vehicle path nodes.
+ *
+ * Nodes are stored contiguously and referred to by index; pointers to them
+ * are only valid until more paths are loaded. Connections are kept in a
+ * single edge array, each node heading a linked list of its own edges.
+ *
+ * Every node is also filed in a grid over the world so that nearest,
+ * radius and box queries only look at the cells they overlap.
+ */
 class AIGraph
 {
 public:
+	typedef int32_t NodeIndex;
+
+	static constexpr NodeIndex NoNode = -1;
+
+	struct Edge
+	{
+		/// The connected node
+		NodeIndex node;
+		/// The next edge from the same node, or -1
+		int32_t next;
+	};
 
-	~AIGraph();
+	std::vector<AIGraphNode> nodes;
 
-	std::vector<AIGraphNode*> nodes;
+	std::vector<Edge> edges;
 
 	/**
 	 * List of external nodes, which are links between each
 	 * Instance's paths and where new pedestrians and vehicles
 	 * are spawned
 	 */
-	std::vector<AIGraphNode*> externalNodes;
+	std::vector<NodeIndex> externalNodes;
+
+	void createPathNodes(const glm::vec3& position, const glm::quat& rotation, PathData& path);
+
+	/**
+	 * Adds a connection in both directions between a and b
+	 */
+	void connect(NodeIndex a, NodeIndex b);
 
 	/**
-	 * Stores the external AI Grid Nodes organised by world grid cell
+	 * Enables or disables a node for traffic and route planning
 	 */
-	std::array<std::vector<AIGraphNode*>,WORLD_GRID_CELLS> gridNodes;
+	void setNodeDisabled(NodeIndex node, bool disabled);
 
-	void createPathNodes(const glm::vec3& position, const glm::quat& rotation, PathData& path);
+	/**
+	 * @return A number that changes whenever nodes or connections are added,
+	 * or a node is enabled or disabled
+	 */
+	uint32_t getRevision() const { return revision; }
+
+	/**
+	 * @return A number that changes whenever nodes or connections are added,
+	 * but not when nodes are enabled or disabled
+	 */
+	uint32_t getTopologyRevision() const { return topologyRevision; }
+
+	/**
+	 * Calls function with the index of every node connected to node
+	 */
+	template <class F>
+	void forEachConnection(NodeIndex node, F function) const
+	{
+		for (int32_t e = nodes[node].firstEdge; e != -1; e = edges[e].next) {
+			function(edges[e].node);
+		}
+	}
+
+	/**
+	 * @return The n-th node connected to node, or NoNode
+	 */
+	NodeIndex getConnection(NodeIndex node, uint32_t n) const;
+
+	/**
+	 * Appends every external node within radius of center to out
+	 */
+	void gatherExternalNodesNear(const glm::vec3& center, float radius, std::vector<NodeIndex>& out) const;
+
+	/**
+	 * Appends every node within radius of center to out
+	 */
+	void gatherNodesNear(const glm::vec3& center, float radius, std::vector<NodeIndex>& out) const;
+
+	/**
+	 * Appends every node inside the box [min, max] to out
+	 */
+	void gatherNodesInBox(const glm::vec3& min, const glm::vec3& max, std::vector<NodeIndex>& out) const;
+
+	/**
+	 * @return The closest node to position, or NoNode if there are none
+	 */
+	NodeIndex findNearestNode(const glm::vec3& position) const;
+
+	/**
+	 * @return The closest node of type to position, or NoNode if there are none
+	 */
+	NodeIndex findNearestNode(const glm::vec3& position, AIGraphNode::NodeType type) const;
+
+private:
+	typedef std::array<std::vector<NodeIndex>, WORLD_GRID_CELLS> NodeGrid;
+
+	uint32_t revision = 0;
+	uint32_t topologyRevision = 0;
+
+	/// All nodes by grid cell
+	NodeGrid gridNodes;
+	/// External nodes by grid cell
+	NodeGrid gridExternalNodes;
 
-	void gatherExternalNodesNear(const glm::vec3& center, const float radius, std::vector<AIGraphNode*>& nodes);
+	template <class F>
+	NodeIndex findNearest(const glm::vec3& position, F accept) const;
 };
 
 #endif
@@ -3,7 +3,6 @@
 #define _AIGRAPHNODE_HPP_
 #include <glm/glm.hpp>
 #include <cstdint>
-#include <vector>
 
 struct AIGraphNode
 {
@@ -28,8 +27,10 @@ struct AIGraphNode
     int32_t nextIndex;
 	
 	bool disabled;
-	
-	std::vector<AIGraphNode*> connections;
+
+	/// First of this node's entries in AIGraph::edges, or -1
+	int32_t firstEdge;
+	uint32_t connectionCount;
 };
 
 #endif
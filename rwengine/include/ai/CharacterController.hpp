@@ -3,6 +3,8 @@
 #define _CHARACTERCONTROLLER_HPP_
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <core/PoolAllocator.hpp>
+#include <cstdint>
 #include <string>
 
 struct AIGraphNode;
@@ -51,7 +53,10 @@ public:
 		/**
 		 * Wander randomly around the map
 		 */
-		TrafficWander
+		TrafficWander,
+
+		/// Number of goals
+		GoalCount
 	};
 
 protected:
@@ -72,7 +77,8 @@ protected:
 	// Goal related variables
 	Goal currentGoal;
 	CharacterObject* leader;
-	AIGraphNode* targetNode;
+	/// Index of the path node being walked to, or -1
+	int32_t targetNode;
 
 public:
 	
@@ -82,6 +88,11 @@ public:
 
 	Activity* getCurrentActivity() const { return _currentActivity; }
 
+	/**
+	 * @return Index of the path node being walked to, or -1
+	 */
+	int32_t getTargetNode() const { return targetNode; }
+
 	Activity* getNextActivity() const { return _nextActivity; }
 
 	/**
@@ -129,9 +140,18 @@ public:
 	CharacterObject* getTargetCharacter() const { return leader; }
 };
 
+/**
+ * Declares an activity's name, and makes it allocated from its own
+ * PoolAllocator so that controllers can switch activities every tick without
+ * going to the heap.
+ */
 #define DECL_ACTIVITY( activity_name ) \
 	static constexpr auto ActivityName = #activity_name; \
-	std::string name() const { return ActivityName; }
+	std::string name() const { return ActivityName; } \
+	static void* operator new(std::size_t size) \
+		{ return PoolAllocator<activity_name, 64>::allocateObject(size); } \
+	static void operator delete(void* p, std::size_t size) \
+		{ PoolAllocator<activity_name, 64>::deallocateObject(p, size); }
 
 // TODO: Refactor this with an ugly macro to reduce code dup.
 class WeaponItem;
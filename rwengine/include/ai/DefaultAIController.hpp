@@ -2,12 +2,30 @@
 #ifndef _DEFAULTAICONTROLLER_HPP_
 #define _DEFAULTAICONTROLLER_HPP_
 #include <ai/CharacterController.hpp>
+#include <ai/RoutePlanner.hpp>
 #include <random>
+#include <vector>
 
 struct AIGraphNode;
 class DefaultAIController : public CharacterController
 {
 	glm::vec3 gotoPos;
+
+	/// Route being planned to the next wander destination
+	RouteRequestRef routeRequest;
+	/// Route being followed, and the index of the next node on it
+	RouteRef route;
+	std::size_t routeStep = 0;
+
+	/// Scratch space for choosing wander destinations, kept between calls
+	/// to avoid allocating on every choice
+	std::vector<AIGraph::NodeIndex> nearbyNodes;
+
+	/**
+	 * @return The node to walk to after reaching current
+	 */
+	AIGraph::NodeIndex nextWanderNode(AIGraph::NodeIndex current);
+
 public:
 	
 	DefaultAIController(CharacterObject* character)
@@ -0,0 +1,166 @@
+#pragma once
+#ifndef _RWENGINE_ROUTEPLANNER_HPP_
+#define _RWENGINE_ROUTEPLANNER_HPP_
+#include <ai/AIGraph.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A path through the AIGraph, from the start node to the goal inclusive.
+ * Empty if the goal can't be reached.
+ */
+struct Route
+{
+	std::vector<AIGraph::NodeIndex> nodes;
+
+	bool found() const { return ! nodes.empty(); }
+};
+
+typedef std::shared_ptr<const Route> RouteRef;
+
+/**
+ * A route that has been asked for. The planner fills in route and then sets
+ * ready; until then route must not be read.
+ */
+struct RouteRequest
+{
+	AIGraph::NodeIndex start;
+	AIGraph::NodeIndex goal;
+	AIGraphNode::NodeType type;
+
+	std::atomic<bool> ready;
+	RouteRef route;
+
+	RouteRequest(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type)
+		: start(start), goal(goal), type(type), ready(false)
+	{ }
+
+	bool isReady() const { return ready.load(std::memory_order_acquire); }
+};
+
+typedef std::shared_ptr<RouteRequest> RouteRequestRef;
+
+/**
+ * @brief Plans routes over the AIGraph with A* on a background thread.
+ *
+ * The planner searches its own copy of the graph, so the graph can be edited
+ * while routes are planned. Nodes and connections are only copied when they
+ * change; enabling or disabling nodes only copies their flags.
+ * Routes only pass through enabled nodes of the requested type.
+ *
+ * Finished routes are cached by endpoints, and requests for a route that is
+ * already being planned share the same RouteRequest, so a crowd heading the
+ * same way only costs one search.
+ */
+class RoutePlanner
+{
+public:
+	/**
+	 * @param cacheSize Maximum number of routes to remember
+	 */
+	RoutePlanner(const AIGraph& graph, std::size_t cacheSize = 4096);
+	~RoutePlanner();
+
+	RoutePlanner(const RoutePlanner&) = delete;
+	RoutePlanner& operator=(const RoutePlanner&) = delete;
+
+	/**
+	 * Asks for a route from start to goal. The request is ready immediately
+	 * if the route is cached, otherwise it is queued for the planning thread.
+	 *
+	 * Must be called from the thread that modifies the graph.
+	 */
+	RouteRequestRef requestRoute(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type);
+
+	/**
+	 * @return The cached route from start to goal, or nullptr if it hasn't
+	 * been planned yet. Unlike requestRoute this never allocates.
+	 */
+	RouteRef findCachedRoute(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type);
+
+	/**
+	 * Plans a route on the calling thread, bypassing the queue and cache.
+	 */
+	RouteRef planRoute(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type);
+
+	/**
+	 * @return The number of requests waiting for the planning thread
+	 */
+	std::size_t getPendingCount();
+
+	std::size_t getCachedCount();
+
+private:
+	/**
+	 * Immutable copy of the graph's nodes and connections, with the
+	 * connections flattened into one array per node.
+	 */
+	struct GraphTopology
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<AIGraphNode::NodeType> types;
+		/// Connections of node n are edges[firstEdge[n]] to edges[firstEdge[n+1]]
+		std::vector<uint32_t> firstEdge;
+		std::vector<AIGraph::NodeIndex> edges;
+	};
+
+	/**
+	 * Immutable copy of the parts of the graph searches need. Snapshots
+	 * share their topology until nodes or connections are added.
+	 */
+	struct GraphSnapshot
+	{
+		std::shared_ptr<const GraphTopology> topology;
+		std::vector<bool> disabled;
+	};
+
+	/**
+	 * Per-thread search state, sized to the graph and reused between searches.
+	 * Entries are only valid where visited matches the current search.
+	 */
+	struct SearchState
+	{
+		std::vector<float> cost;
+		std::vector<AIGraph::NodeIndex> cameFrom;
+		std::vector<uint32_t> visited;
+		uint32_t search = 0;
+	};
+
+	typedef uint64_t RouteKey;
+
+	const AIGraph& graph;
+	std::size_t cacheSize;
+
+	std::shared_ptr<const GraphSnapshot> snapshot;
+	uint32_t snapshotRevision;
+	uint32_t snapshotTopologyRevision;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<RouteRequestRef> queue;
+	std::unordered_map<RouteKey, RouteRequestRef> pending;
+	std::unordered_map<RouteKey, RouteRef> cache;
+	bool stopping;
+
+	/// Started by the first request that isn't cached
+	std::thread worker;
+
+	void updateSnapshot();
+
+	static RouteKey makeKey(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type);
+
+	static RouteRef search(const GraphSnapshot& current, SearchState& state,
+						   AIGraph::NodeIndex start, AIGraph::NodeIndex goal,
+						   AIGraphNode::NodeType type);
+
+	void workerMain();
+};
+
+#endif
@@ -3,11 +3,13 @@
 #include <data/PathData.hpp>
 #include "AIGraph.hpp"
 #include "AIGraphNode.hpp"
+#include <render/ViewFrustum.hpp>
 
 #include <glm/glm.hpp>
 #include <vector>
 
 class GameObject;
+struct VehicleGenerator;
 class GameWorld;
 class ViewCamera;
 
@@ -17,7 +19,11 @@ public:
 	
 	TrafficDirector(AIGraph* graph, GameWorld* world);
 	
-	std::vector< AIGraphNode* > findAvailableNodes(AIGraphNode::NodeType type, const ViewCamera& camera, float radius);
+	/**
+	 * @return The external nodes within radius of the camera that traffic
+	 * can be spawned at, valid until the next call
+	 */
+	const std::vector<AIGraph::NodeIndex>& findAvailableNodes(AIGraphNode::NodeType type, const ViewCamera& camera, float radius);
 	
 	void setDensity(AIGraphNode::NodeType type, float density);
 
@@ -41,4 +47,13 @@ private:
 	float carDensity;
 	int maximumPedestrians;
 	int maximumCars;
+
+	/// Scratch space reused by every call, so steady traffic doesn't allocate
+	std::vector<AIGraph::NodeIndex> availableNodes;
+	std::vector<VehicleGenerator*> nearbyGenerators;
+	std::vector<glm::vec3> groundPositions;
+
+	/// Scratch space for testing spawn points against the view frustum
+	PackedSpheres spawnSpheres;
+	ViewFrustum::VisibilityMask spawnMask;
 };
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef _RWENGINE_POOLALLOCATOR_HPP_
+#define _RWENGINE_POOLALLOCATOR_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed size block allocator for objects of type T.
+ *
+ * Blocks are reserved ChunkSize at a time so objects of the same type end up
+ * next to each other in memory. Freed blocks go onto an intrusive free list
+ * and are handed out again by the next allocation; chunks are never returned
+ * to the system.
+ *
+ * Not thread safe, objects are only created and destroyed on the game thread.
+ */
+template <class T, std::size_t ChunkSize = 256>
+class PoolAllocator
+{
+	union Block
+	{
+		Block* next;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+	std::vector<std::unique_ptr<Block[]>> chunks;
+	Block* freeList;
+	std::size_t liveBlocks;
+
+	void grow()
+	{
+		std::unique_ptr<Block[]> chunk(new Block[ChunkSize]);
+		for (std::size_t i = 0; i < ChunkSize; ++i) {
+			chunk[i].next = (i + 1 < ChunkSize) ? &chunk[i + 1] : freeList;
+		}
+		freeList = &chunk[0];
+		chunks.push_back(std::move(chunk));
+	}
+
+public:
+
+	PoolAllocator()
+		: freeList(nullptr)
+		, liveBlocks(0)
+	{ }
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	void* allocate()
+	{
+		if (freeList == nullptr) {
+			grow();
+		}
+		Block* block = freeList;
+		freeList = block->next;
+		liveBlocks++;
+		return block;
+	}
+
+	void deallocate(void* p)
+	{
+		if (p == nullptr) {
+			return;
+		}
+		Block* block = static_cast<Block*>(p);
+		block->next = freeList;
+		freeList = block;
+		liveBlocks--;
+	}
+
+	/**
+	 * Implementation of a class-specific operator new for T. Derived types
+	 * don't fit the pool's blocks and come from the global heap instead.
+	 */
+	static void* allocateObject(std::size_t size)
+	{
+		if (size != sizeof(T)) {
+			return ::operator new(size);
+		}
+		return get().allocate();
+	}
+
+	/**
+	 * Counterpart to allocateObject, for a sized operator delete.
+	 */
+	static void deallocateObject(void* p, std::size_t size)
+	{
+		if (size != sizeof(T)) {
+			::operator delete(p);
+			return;
+		}
+		get().deallocate(p);
+	}
+
+	std::size_t getLiveCount() const { return liveBlocks; }
+	std::size_t getCapacity() const { return chunks.size() * ChunkSize; }
+
+	/**
+	 * The shared allocator for T. It is deliberately never destroyed so that
+	 * objects deleted during static destruction still have somewhere to go.
+	 */
+	static PoolAllocator& get()
+	{
+		static PoolAllocator* pool = new PoolAllocator;
+		return *pool;
+	}
+};
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _RWENGINE_WORKERPOOL_HPP_
+#define _RWENGINE_WORKERPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of threads for splitting loops across cores.
+ *
+ * The calling thread always takes part in the work, so a pool of one thread
+ * runs everything inline. Worker threads are only started by the first loop
+ * big enough to need them.
+ */
+class WorkerPool
+{
+public:
+	typedef std::function<void(std::size_t first, std::size_t last)> RangeFunction;
+
+	/**
+	 * @param threads Threads to run work on, including the calling thread.
+	 * 0 picks one per hardware thread.
+	 */
+	explicit WorkerPool(unsigned int threads = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	unsigned int getThreadCount() const { return threadCount; }
+
+	/**
+	 * Calls function on chunks of [first, last) no larger than grainSize,
+	 * spread across the pool's threads, and returns when all are done.
+	 *
+	 * Loops started from inside another loop, or while another thread is
+	 * running one, are run on the calling thread instead.
+	 */
+	void parallelFor(std::size_t first, std::size_t last, std::size_t grainSize, const RangeFunction& function);
+
+private:
+	unsigned int threadCount;
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable batchStart;
+	std::condition_variable batchDone;
+	uint64_t batchNumber;
+	unsigned int busyWorkers;
+	bool stopping;
+
+	/// Held by the thread whose loop is running
+	std::mutex batchOwner;
+
+	const RangeFunction* batchFunction;
+	std::size_t batchLast;
+	std::size_t batchGrain;
+	std::atomic<std::size_t> nextIndex;
+
+	void startWorkers();
+	void workerMain();
+	void runBatch();
+};
+
+#endif
@@ -2,6 +2,7 @@
 #ifndef _CUTSCENEDATA_HPP_
 #define _CUTSCENEDATA_HPP_
 #include <glm/glm.hpp>
+#include <data/KeyframeTrack.hpp>
 #include <map>
 #include <vector>
 #include <string>
@@ -29,113 +30,70 @@ struct CutsceneMetadata
 	std::map<float, TextEntry> texts;
 };
 
+/**
+ * @brief The camera's placement at one point in a cutscene
+ */
+struct CutsceneCamera
+{
+	glm::vec3 position;
+	glm::vec3 target;
+	float zoom;
+	float rotation;
+};
+
 /**
  * @brief Stores the Camera animation data from .DAT files
+ *
+ * Each track remembers where it was last sampled, so playing the cutscene
+ * forwards only steps over the keys passed since the previous frame.
  */
 struct CutsceneTracks
 {
-	std::map<float, float> zoom;
-	std::map<float, float> rotation;
-	std::map<float, glm::vec3> position;
-	std::map<float, glm::vec3> target; /// Rotation is around the direction to this vector
+	KeyframeTrack<float> zoom;
+	KeyframeTrack<float> rotation;
+	KeyframeTrack<glm::vec3> position;
+	KeyframeTrack<glm::vec3> target; /// Rotation is around the direction to this vector
 
 	float duration { 0.f };
 
+	/**
+	 * Samples every track at time
+	 */
+	CutsceneCamera getCameraAt(float time)
+	{
+		return {
+			position.sample(time, &positionCursor),
+			target.sample(time, &targetCursor),
+			zoom.sample(time, &zoomCursor),
+			rotation.sample(time, &rotationCursor)
+		};
+	}
+
 	glm::vec3 getPositionAt(float time)
 	{
-		glm::vec3 p = position.end()->second;
-		for(auto it = position.begin(); it != position.end(); ++it) {
-			if( it->first <= time ) {
-				auto a = it->second;
-				auto b = it->second;
-				auto nextIt = it;
-				float t = it->first;
-				if( ++nextIt != position.end() ) {
-					b = nextIt->second;
-					t = nextIt->first;
-				}
-				float tdiff = t - it->first;
-				p = b;
-				if( tdiff > 0.f ) {
-					float fac = (time - it->first) / tdiff;
-					p = glm::mix(a, b, fac);
-				}
-			}
-		}
-		return p;
+		return position.sample(time, &positionCursor);
 	}
 
 	glm::vec3 getTargetAt(float time)
 	{
-		glm::vec3 p = position.end()->second;
-		for(auto it = target.begin(); it != target.end(); ++it) {
-			if( it->first <= time ) {
-				auto a = it->second;
-				auto b = it->second;
-				auto nextIt = it;
-				float t = it->first;
-				if( ++nextIt != target.end() ) {
-					b = nextIt->second;
-					t = nextIt->first;
-				}
-				float tdiff = t - it->first;
-				p = b;
-				if( tdiff > 0.f ) {
-					float fac = (time - it->first) / tdiff;
-					p = glm::mix(a, b, fac);
-				}
-			}
-		}
-		return p;
+		return target.sample(time, &targetCursor);
 	}
 
 	float getZoomAt(float time)
 	{
-		float r = zoom.end()->second;
-		for(auto it = zoom.begin(); it != zoom.end(); ++it) {
-			if( it->first <= time ) {
-				auto a = it->second;
-				auto b = it->second;
-				auto nextIt = it;
-				float t = it->first;
-				if( ++nextIt != zoom.end() ) {
-					b = nextIt->second;
-					t = nextIt->first;
-				}
-				float tdiff = t - it->first;
-				r = b;
-				if( tdiff > 0.f ) {
-					float fac = (time - it->first) / tdiff;
-					r = glm::mix(a, b, fac);
-				}
-			}
-		}
-		return r;
+		return zoom.sample(time, &zoomCursor);
 	}
 
 	float getRotationAt(float time)
 	{
-		float r = rotation.end()->second;
-		for(auto it = rotation.begin(); it != rotation.end(); ++it) {
-			if( it->first <= time ) {
-				auto a = it->second;
-				auto b = it->second;
-				auto nextIt = it;
-				float t = it->first;
-				if( ++nextIt != rotation.end() ) {
-					b = nextIt->second;
-					t = nextIt->first;
-				}
-				float tdiff = t - it->first;
-				r = b;
-				if( tdiff > 0.f ) {
-					float fac = (time - it->first) / tdiff;
-					r = glm::mix(a, b, fac);
-				}
-			}
-		}
-		return r;
+		return rotation.sample(time, &rotationCursor);
 	}
+
+private:
+	KeyframeCursor zoomCursor;
+	KeyframeCursor rotationCursor;
+	KeyframeCursor positionCursor;
+	KeyframeCursor targetCursor;
 };
 
 struct CutsceneData
@@ -1,26 +1,123 @@
 #pragma once
 #ifndef _GAMETEXTS_HPP_
 #define _GAMETEXTS_HPP_
+#include <cstdint>
+#include <cstring>
+#include <ostream>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+/**
+ * @brief Stores the game's text in one UTF-8 buffer, indexed by GXT key.
+ *
+ * Keys are at most 8 characters, so they're packed into integers and kept
+ * in a sorted table. Lookups return views into the buffer rather than
+ * copies.
+ */
 class GameTexts
 {
-	std::unordered_map<std::string, std::string> _textDB;
 public:
+	/**
+	 * @brief Refers to text owned by something else, without copying it.
+	 */
+	class TextView
+	{
+	public:
+		TextView()
+			: ptr(""), len(0) { }
 
-	void addText(const std::string& id, const std::string& text) {
-		_textDB.insert({ id, text });
-	}
+		TextView(const char* data, std::size_t size)
+			: ptr(data), len(size) { }
+
+		const char* data() const { return ptr; }
+		std::size_t size() const { return len; }
+		bool empty() const { return len == 0; }
+
+		const char* begin() const { return ptr; }
+		const char* end() const { return ptr + len; }
+
+		std::string str() const { return std::string(ptr, len); }
+		operator std::string() const { return str(); }
+
+		bool operator==(const TextView& other) const
+		{
+			return len == other.len && std::memcmp(ptr, other.ptr, len) == 0;
+		}
+		bool operator!=(const TextView& other) const { return !(*this == other); }
 
-	std::string text(const std::string& id) {
-		auto a = _textDB.find(id);
-		if( a != _textDB.end() ) {
-			return a->second;
+		bool operator==(const std::string& other) const
+		{
+			return *this == TextView(other.data(), other.size());
 		}
-		return id;
+		bool operator==(const char* other) const
+		{
+			return *this == TextView(other, std::strlen(other));
+		}
+
+	private:
+		const char* ptr;
+		std::size_t len;
+	};
+
+	/// A GXT key packed into an integer, 0 for invalid keys
+	typedef uint64_t Key;
+
+	/**
+	 * Packs a key so that keys sort in the same order as their strings.
+	 * Returns 0 for keys that are empty or longer than 8 characters.
+	 */
+	static Key makeKey(const char* id, std::size_t length);
+
+	/**
+	 * Adds text, unless there is already text for id. Adding keys in
+	 * sorted order, as they are stored in GXT files, appends them.
+	 */
+	void addText(const std::string& id, const std::string& text);
+	void addText(const char* id, std::size_t idLength, const char* text, std::size_t textLength);
+
+	/**
+	 * Returns the text for id, or id itself if there isn't any. In that
+	 * case the view refers to id, so it mustn't outlive it.
+	 */
+	TextView text(const std::string& id) const;
+
+	bool hasText(const std::string& id) const;
+
+	void reserve(std::size_t count, std::size_t bytes);
+
+	void clear();
+
+	/**
+	 * @return The number of texts
+	 */
+	std::size_t size() const { return entries.size(); }
+
+	/**
+	 * @return The memory used to store the texts and their keys
+	 */
+	std::size_t getMemoryUsage() const
+	{
+		return blob.capacity() + entries.capacity() * sizeof(Entry);
 	}
 
+private:
+	struct Entry
+	{
+		Key key;
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	std::vector<Entry> entries;
+	/// Every text, each followed by a null terminator
+	std::string blob;
+
+	const Entry* find(const std::string& id) const;
 };
 
+inline std::ostream& operator<<(std::ostream& os, const GameTexts::TextView& text)
+{
+	return os.write(text.data(), text.size());
+}
+
 #endif
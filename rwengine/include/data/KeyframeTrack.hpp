@@ -0,0 +1,134 @@
+#pragma once
+#ifndef _RWENGINE_KEYFRAMETRACK_HPP_
+#define _RWENGINE_KEYFRAMETRACK_HPP_
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Remembers where the last keyframe lookup ended, so that playing a track
+ * forwards finds each key by stepping from the previous one.
+ */
+struct KeyframeCursor
+{
+	std::size_t index;
+
+	KeyframeCursor()
+		: index(0) { }
+};
+
+/**
+ * Finds the last of count keys, sorted by time, whose time is at or before
+ * time. Returns 0 if time is before every key.
+ *
+ * With a cursor, a lookup a few keys after the previous one walks forward
+ * from it; anything else falls back to a binary search.
+ *
+ * @param timeOf returns the time of a key
+ */
+template <class Key, class TimeOf>
+std::size_t findKeyframe(const Key* keys, std::size_t count, float time, TimeOf timeOf,
+						 KeyframeCursor* cursor = nullptr)
+{
+	const std::size_t kMaxSteps = 4;
+
+	std::size_t first = 0, last = count;
+	if (cursor && cursor->index < count) {
+		std::size_t i = cursor->index;
+		if (timeOf(keys[i]) <= time) {
+			for (std::size_t s = 0; s < kMaxSteps; ++s) {
+				if (i + 1 == count || timeOf(keys[i + 1]) > time) {
+					cursor->index = i;
+					return i;
+				}
+				++i;
+			}
+			first = i;
+		}
+		else {
+			last = i;
+		}
+	}
+
+	auto it = std::upper_bound(keys + first, keys + last, time,
+							   [&](float t, const Key& key) { return t < timeOf(key); });
+	std::size_t index = it == keys ? 0 : (it - keys) - 1;
+	if (cursor) {
+		cursor->index = index;
+	}
+	return index;
+}
+
+/**
+ * @brief Values keyed by time in one sorted, contiguous array.
+ *
+ * Samples interpolate linearly between the surrounding keys and hold the
+ * first and last values outside them.
+ */
+template <class T>
+class KeyframeTrack
+{
+public:
+	struct Key
+	{
+		float time;
+		T value;
+	};
+
+	/**
+	 * Adds a key, replacing any existing key at the same time. Keys
+	 * added in order are appended.
+	 */
+	void insert(float time, const T& value)
+	{
+		if (keys.empty() || keys.back().time < time) {
+			keys.push_back({time, value});
+			return;
+		}
+		auto it = std::lower_bound(keys.begin(), keys.end(), time,
+								   [](const Key& key, float t) { return key.time < t; });
+		if (it != keys.end() && it->time == time) {
+			it->value = value;
+		}
+		else {
+			keys.insert(it, {time, value});
+		}
+	}
+
+	/**
+	 * @return true if there is a key at exactly time
+	 */
+	bool hasKey(float time) const
+	{
+		auto it = std::lower_bound(keys.begin(), keys.end(), time,
+								   [](const Key& key, float t) { return key.time < t; });
+		return it != keys.end() && it->time == time;
+	}
+
+	T sample(float time, KeyframeCursor* cursor = nullptr) const
+	{
+		if (keys.empty()) {
+			return T();
+		}
+		auto i = findKeyframe(keys.data(), keys.size(), time,
+							  [](const Key& key) { return key.time; }, cursor);
+		auto& a = keys[i];
+		if (i + 1 == keys.size() || time <= a.time) {
+			return a.value;
+		}
+		auto& b = keys[i + 1];
+		return glm::mix(a.value, b.value, (time - a.time) / (b.time - a.time));
+	}
+
+	const std::vector<Key>& getKeys() const { return keys; }
+	std::size_t size() const { return keys.size(); }
+	bool empty() const { return keys.empty(); }
+
+private:
+	std::vector<Key> keys;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef _RWENGINE_BUOYANCYSYSTEM_HPP_
+#define _RWENGINE_BUOYANCYSYSTEM_HPP_
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+class GameObject;
+class GameWorld;
+class InstanceObject;
+class VehicleObject;
+
+/**
+ * @brief Keeps dynamic objects afloat.
+ *
+ * Once per tick, updateCandidates() collects the vehicles and dynamic
+ * instances that are over a water cell of GameData::realWater and either
+ * awake or already floating. Only those are tested against the water each
+ * step, with wave heights for all of them evaluated in one batch.
+ *
+ * Sleeping bodies are skipped until something wakes them, and static
+ * instances that haven't been knocked loose are never considered.
+ */
+class BuoyancySystem
+{
+public:
+	BuoyancySystem(GameWorld* world);
+
+	/**
+	 * @return The height of the waves above the water table at ws
+	 */
+	static float getWaveHeight(float time, const glm::vec3& ws);
+
+	/**
+	 * Writes getWaveHeight(time, points[i]) to heights[i] for each point
+	 */
+	static void getWaveHeights(float time, const glm::vec3* points, float* heights, std::size_t count);
+
+	/**
+	 * Rebuilds the lists of objects that may be in water. Objects that are
+	 * over dry cells have their water state cleared.
+	 */
+	void updateCandidates();
+
+	/**
+	 * Updates the water state of candidate vehicles and applies buoyancy
+	 * impulses. Called every physics step.
+	 */
+	void tickVehicles();
+	void tickVehicles(VehicleObject* const* vehicles, std::size_t count);
+
+	/**
+	 * Updates the water state of candidate instances and applies buoyancy
+	 * forces. Called every tick.
+	 */
+	void tickInstances();
+	void tickInstances(InstanceObject* const* instances, std::size_t count);
+
+	/**
+	 * Forgets an object that is about to be destroyed.
+	 */
+	void removeObject(GameObject* object);
+
+	const std::vector<VehicleObject*>& getVehicleCandidates() const { return vehicleCandidates; }
+	const std::vector<InstanceObject*>& getInstanceCandidates() const { return instanceCandidates; }
+
+private:
+	GameWorld* world;
+
+	std::vector<VehicleObject*> vehicleCandidates;
+	std::vector<InstanceObject*> instanceCandidates;
+
+	/// Scratch space for batched wave heights
+	std::vector<glm::vec3> points;
+	std::vector<float> heights;
+	std::vector<float> levels;
+	std::vector<float> bottoms;
+	std::vector<glm::vec3> offsets;
+	std::vector<std::size_t> owners;
+
+	/**
+	 * @return the realWater cell at ws, or -1 if it's outside the water grid
+	 */
+	static int getCell(const glm::vec3& ws);
+};
+
+#endif
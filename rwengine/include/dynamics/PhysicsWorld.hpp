@@ -0,0 +1,51 @@
+#pragma once
+#ifndef _RWENGINE_PHYSICSWORLD_HPP_
+#define _RWENGINE_PHYSICSWORLD_HPP_
+
+#include <btBulletDynamicsCommon.h>
+
+#include <memory>
+
+class WorkerPool;
+class PhysicsTaskScheduler;
+
+/**
+ * @brief Owns the Bullet dynamics world and its constraint solver.
+ *
+ * When built with ENABLE_BULLET_THREADS against a Bullet with BT_THREADSAFE,
+ * and given a WorkerPool with more than one thread, this creates a
+ * btDiscreteDynamicsWorldMt that solves simulation islands and integrates
+ * bodies across the pool. Otherwise it's a plain btDiscreteDynamicsWorld.
+ *
+ * Collision dispatch always stays on the calling thread, as contact
+ * callbacks touch game objects.
+ *
+ * Islands are independent and split into the same chunks for a given thread
+ * count, so stepping the same scene with the same thread count gives the
+ * same results.
+ */
+class PhysicsWorld
+{
+public:
+	PhysicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* broadphase,
+	             btCollisionConfiguration* collisionConfig, WorkerPool* workers = nullptr);
+	~PhysicsWorld();
+
+	PhysicsWorld(const PhysicsWorld&) = delete;
+	PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+	btDiscreteDynamicsWorld* getDynamicsWorld() const { return world; }
+
+	/**
+	 * @return True if islands are solved across several threads
+	 */
+	bool isThreaded() const { return scheduler != nullptr; }
+
+private:
+	std::unique_ptr<PhysicsTaskScheduler> scheduler;
+	btConstraintSolver* solver;
+	btConstraintSolver* solverPool;
+	btDiscreteDynamicsWorld* world;
+};
+
+#endif
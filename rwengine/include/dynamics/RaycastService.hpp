@@ -0,0 +1,82 @@
+#pragma once
+#ifndef _RWENGINE_RAYCASTSERVICE_HPP_
+#define _RWENGINE_RAYCASTSERVICE_HPP_
+
+#include <glm/glm.hpp>
+#include <btBulletDynamicsCommon.h>
+
+#include <vector>
+
+class WorkerPool;
+
+/**
+ * @brief Executes ray and radius queries against a collision world's broadphase.
+ *
+ * Rays can be cast one at a time, or in batches with castBatch(), which
+ * spreads them across worker threads. Rays are
+ * traced by walking the broadphase trees directly rather than through
+ * btCollisionWorld::rayTest, whose broadphase traversal keeps shared scratch
+ * state, so any number of them may run at once. The world must not be
+ * modified while a batch is executing.
+ */
+class RaycastService
+{
+public:
+	struct Ray
+	{
+		glm::vec3 from;
+		glm::vec3 to;
+		/// Object the ray should pass through, e.g. the one casting it
+		const btCollisionObject* ignore = nullptr;
+		short filterGroup = btBroadphaseProxy::DefaultFilter;
+		short filterMask = btBroadphaseProxy::AllFilter;
+
+		Ray() = default;
+		Ray(const glm::vec3& from, const glm::vec3& to, const btCollisionObject* ignore = nullptr)
+			: from(from), to(to), ignore(ignore)
+		{ }
+	};
+
+	struct Hit
+	{
+		bool hit = false;
+		glm::vec3 point;
+		glm::vec3 normal;
+		float fraction = 1.f;
+		const btCollisionObject* object = nullptr;
+	};
+
+	/**
+	 * @param workers Threads to spread batches across, or nullptr to cast
+	 * everything on the calling thread
+	 */
+	RaycastService(btDbvtBroadphase* broadphase, WorkerPool* workers = nullptr);
+
+	RaycastService(const RaycastService&) = delete;
+	RaycastService& operator=(const RaycastService&) = delete;
+
+	/**
+	 * Casts a single ray immediately on the calling thread.
+	 */
+	Hit cast(const Ray& ray) const;
+
+	/**
+	 * Casts count rays, splitting the work between the worker threads.
+	 * Returns once every result has been written.
+	 */
+	void castBatch(const Ray* rays, Hit* hits, std::size_t count);
+
+	/**
+	 * Appends every collision object whose bounds come within radius of
+	 * centre to out.
+	 */
+	void queryRadius(const glm::vec3& centre, float radius, std::vector<const btCollisionObject*>& out) const;
+
+	unsigned int getThreadCount() const;
+
+private:
+	btDbvtBroadphase* broadphase;
+	WorkerPool* workers;
+};
+
+#endif
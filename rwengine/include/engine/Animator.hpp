@@ -31,6 +31,7 @@ class Animator
 	struct BoneInstanceData
 	{
 		unsigned int frameIndex;
+		KeyframeCursor cursor;
 	};
 
 	/**
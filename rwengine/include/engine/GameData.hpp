@@ -17,10 +17,12 @@ class Logger;
 #include <data/ZoneData.hpp>
 
 #include <audio/MADStream.hpp>
+#include <gl/GeometryArena.hpp>
 #include <gl/TextureData.hpp>
 #include <platform/FileIndex.hpp>
 
 #include <memory>
+#include <unordered_map>
 
 struct DynamicObjectData;
 struct WeaponData;
@@ -154,9 +156,40 @@ public:
 
 	FileHandle openFile(const std::string& name);
 
-	TextureData::Handle findTexture( const std::string& name, const std::string& alpha = "" )
+	/**
+	 * Returns the named texture, or null if it isn't loaded. Names that
+	 * have never been interned can't be loaded, and aren't interned here;
+	 * prefer looking up IDs that are already known.
+	 */
+	TextureData::Handle findTexture( const std::string& name, const std::string& alpha = "" ) const
 	{
-		return textures[{name, alpha}];
+		auto nameID = findAssetName(name);
+		auto alphaID = findAssetName(alpha);
+		if (nameID == kUnknownAssetName || alphaID == kUnknownAssetName) {
+			return nullptr;
+		}
+		return findTexture(nameID, alphaID);
+	}
+
+	TextureData::Handle findTexture( AssetID name, AssetID alpha = 0 ) const
+	{
+		auto it = textures.find(makeTextureID(name, alpha));
+		return it != textures.end() ? it->second : nullptr;
+	}
+
+	/**
+	 * Returns the named model, or null if it hasn't been requested.
+	 */
+	ResourceHandle<Model>::Ref findModel( const std::string& name ) const
+	{
+		auto id = findAssetName(name);
+		return id != kUnknownAssetName ? findModel(id) : nullptr;
+	}
+
+	ResourceHandle<Model>::Ref findModel( AssetID name ) const
+	{
+		auto it = models.find(name);
+		return it != models.end() ? it->second : nullptr;
 	}
 	
 	FileIndex index;
@@ -226,15 +259,21 @@ public:
 	 */
 	WeatherLoader weatherLoader;
 
+	/**
+	 * Shared vertex and index storage for the loaded models, declared
+	 * first so that it outlives them
+	 */
+	GeometryArenas geometryArenas;
+
 	/**
 	 * Loaded models
 	 */
-	std::map<std::string, ResourceHandle<Model>::Ref> models;
+	std::unordered_map<AssetID, ResourceHandle<Model>::Ref> models;
 
 	/**
 	 * Loaded textures (Textures are ID by name and alpha pairs)
 	 */
-	std::map<std::pair<std::string, std::string>, TextureData::Handle> textures;
+	TextureArchive textures;
 
 	/**
 	 * Texture atlases.
@@ -10,6 +10,7 @@
 #include <objects/ObjectTypes.hpp>
 #include <engine/ScreenText.hpp>
 #include <data/VehicleGenerator.hpp>
+#include <data/AssetName.hpp>
 
 class GameWorld;
 class GameObject;
@@ -187,8 +188,8 @@ struct BlipData
 	// If target is null then use coord
 	glm::vec3 coord;
 	
-	/* Texture for use in the radar */
-	std::string texture;
+	/* Texture for use in the radar, interned when the blip is created */
+	AssetID texture;
 	
 	enum DisplayMode
 	{
@@ -201,7 +202,7 @@ struct BlipData
 	DisplayMode display;
 	
 	BlipData()
-	: id(-1), type(Location), target(0), display(Show)
+	: id(-1), type(Location), target(0), texture(0), display(Show)
 	{ }
 };
 
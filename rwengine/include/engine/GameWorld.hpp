@@ -10,6 +10,7 @@ class GameState;
 
 #include <ai/AIGraphNode.hpp>
 #include <ai/AIGraph.hpp>
+#include <ai/CharacterController.hpp>
 #include <audio/SoundManager.hpp>
 
 class CutsceneObject;
@@ -23,15 +24,26 @@ class VehicleObject;
 class PickupObject;
 
 class ViewCamera;
-#include <render/VisualFX.hpp>
+#include <render/ParticleSystem.hpp>
 #include <data/ObjectData.hpp>
+#include <engine/TransformStore.hpp>
+#include <engine/SpatialHash.hpp>
+#include <engine/InstanceIndex.hpp>
+#include <engine/RandomService.hpp>
+#include <engine/SimulationLOD.hpp>
 
 struct BlipData;
 class InventoryItem;
-struct WeaponScan;
 struct VehicleGenerator;
+class RaycastService;
+class RoutePlanner;
+class TrafficDirector;
+class WorkerPool;
+class PhysicsWorld;
+class BuoyancySystem;
 
 #include <data/Chase.hpp>
+#include <data/WeaponData.hpp>
 
 #include <glm/glm.hpp>
 
@@ -67,7 +79,11 @@ class GameWorld
 {
 public:
 
-	GameWorld(Logger* log, WorkContext* work, GameData* dat);
+	/**
+	 * @param workerThreads Threads to use for physics and batched queries,
+	 * 0 for one per hardware thread
+	 */
+	GameWorld(Logger* log, WorkContext* work, GameData* dat, unsigned int workerThreads = 0);
 
 	~GameWorld();
 
@@ -140,20 +156,71 @@ public:
 	 */
 	void destroyQueuedObjects();
 
+	/**
+	 * @brief Updates every active object in the world's pools by dt.
+	 *
+	 * Each pool is walked in its own loop, so the per-object update binds
+	 * directly to the concrete type instead of going through the vtable.
+	 */
+	void tickObjects(float dt);
+
+	/**
+	 * @brief Updates the controllers of every active character, called by
+	 * tickObjects before the characters themselves are ticked.
+	 *
+	 * Controllers are grouped by goal first so that each goal's behaviour is
+	 * run for all of its characters at once.
+	 */
+	void updateControllers(float dt);
+
+	/**
+	 * Sets the position that simulation detail is measured from, usually
+	 * the camera. Defaults to the player's position when never set.
+	 */
+	void setSimulationFocus(const glm::vec3& focus);
+
+	/**
+	 * Goes back to measuring simulation detail from the player
+	 */
+	void clearSimulationFocus() { hasSimulationFocus = false; }
+
+	/**
+	 * @brief Moves characters and vehicles between simulation tiers based on
+	 * their distance from the simulation focus. Called by tickObjects.
+	 */
+	void updateSimulationTiers();
+
+	/**
+	 * @return true if object, when simulated at SimulationReduced, should
+	 * do its full update on this tick
+	 */
+	bool isSimulationUpdateTick(const GameObject* object) const;
+
+	/**
+	 * Distances and rates used to choose simulation tiers
+	 */
+	SimulationLOD simulationLOD;
+
+	/**
+	 * @return The number of objects that are ticked by tickObjects
+	 */
+	size_t getActiveObjectCount() const;
+
 	/**
 	 * Performs a weapon scan against things in the world
 	 */
 	void doWeaponScan(const WeaponScan &scan );
 
 	/**
-	 * Allocates a new VisualFX of the given type
+	 * Queues a weapon scan to be performed at the end of the tick, along with
+	 * every other scan queued during it
 	 */
-	VisualFX* createEffect(VisualFX::EffectType type);
-	
+	void queueWeaponScan(const WeaponScan& scan);
+
 	/**
-	 * Immediately destoys the given effect
+	 * Performs all queued weapon scans, casting their rays as one batch
 	 */
-	void destroyEffect(VisualFX* effect);
+	void doQueuedWeaponScans();
 
 	/**
 	 * Returns the current hour
@@ -167,6 +234,11 @@ public:
 
 	glm::vec3 getGroundAtPosition(const glm::vec3& pos) const;
 
+	/**
+	 * Replaces each position with the ground below it, probing them together
+	 */
+	void getGroundAtPositions(std::vector<glm::vec3>& positions) const;
+
 	float getGameTime() const;
 
 	/**
@@ -199,14 +271,26 @@ public:
 	/**
 	 * Each object type is allocated from a pool. This object helps manage
 	 * the individual pools.
+	 *
+	 * Objects are looked up through a slot table indexed by the low bits of
+	 * their GameObjectID, and stored densely for iteration.
 	 */
 	struct ObjectPool
 	{
-		std::map<GameObjectID, GameObject*> objects;
+		/**
+		 * All objects in this pool, in no particular order
+		 */
+		std::vector<GameObject*> objects;
+
+		/**
+		 * The subset of objects that are active and need ticking, in no
+		 * particular order
+		 */
+		std::vector<GameObject*> activeObjects;
 		
 		/**
 		 * Allocates the game object a GameObjectID and inserts it into
-		 * the pool
+		 * the pool. Objects that already have an ID keep it.
 		 */
 		void insert(GameObject* object);
 
@@ -219,6 +303,35 @@ public:
 		 * Finds a game object if it exists in this pool
 		 */
 		GameObject* find(GameObjectID id) const;
+
+		/**
+		 * Adds or removes object from activeObjects to match its state
+		 */
+		void updateActive(GameObject* object);
+
+	private:
+		static constexpr uint32_t kInactive = 0xFFFFFFFF;
+
+		struct Slot
+		{
+			/// Generation of the current occupant, or the next one
+			uint32_t generation = 1;
+			/// Position of the occupant in objects
+			uint32_t index = 0;
+			/// Position of the occupant in activeObjects, or kInactive
+			uint32_t activeIndex = kInactive;
+			bool used = false;
+		};
+
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeSlots;
+
+		void addActive(Slot& slot, GameObject* object);
+
+		/**
+		 * Fills the slot's place in activeObjects with the last active object
+		 */
+		void removeActive(Slot& slot);
 	};
 
 	/**
@@ -226,6 +339,11 @@ public:
 	 */
 	std::vector<GameObject*> allObjects;
 
+	/**
+	 * Last-tick transforms of every object, used for render interpolation.
+	 */
+	TransformStore transforms;
+
 	ObjectPool pedestrianPool;
 	ObjectPool instancePool;
 	ObjectPool vehiclePool;
@@ -235,6 +353,19 @@ public:
 
 	ObjectPool& getTypeObjectPool(GameObject* object);
 
+	/**
+	 * Positions of pedestrians and vehicles for proximity queries, refreshed
+	 * every tick and whenever one is moved directly.
+	 */
+	SpatialHash pedestrianHash;
+	SpatialHash vehicleHash;
+
+	/**
+	 * @return The spatial hash tracking object, or nullptr if its type isn't
+	 * tracked
+	 */
+	SpatialHash* getTypeSpatialHash(GameObject* object);
+
 	std::vector<PlayerController*> players;
 
 	/**
@@ -275,21 +406,36 @@ public:
 	 */
 	std::map<std::string, InstanceObject*> modelInstances;
 
+	/**
+	 * Every instance, for location and model name queries
+	 */
+	InstanceIndex instanceIndex;
+
 	/**
 	 * AI Graph
 	 */
 	AIGraph aigraph;
+
+	/**
+	 * Plans routes over aigraph in the background
+	 */
+	RoutePlanner* routePlanner;
+
+	/**
+	 * Spawns traffic for createTraffic, keeping its scratch space between
+	 * ticks
+	 */
+	TrafficDirector* trafficDirector;
 	
 	/**
-	 * Visual Effects
-	 * @todo Consider using lighter handing mechanism
+	 * Every particle in the world, updated by tickObjects
 	 */
-	std::vector<VisualFX*> effects;
+	ParticleSystem particles;
 
 	/**
-	 * Randomness Engine
+	 * Seeded random number streams for each subsystem
 	 */
-	std::default_random_engine randomEngine;
+	RandomService random;
 	
 	/**
 	 * Bullet 
@@ -297,9 +443,25 @@ public:
 	btDefaultCollisionConfiguration* collisionConfig;
 	btCollisionDispatcher* collisionDispatcher;
 	btBroadphaseInterface* broadphase;
-	btSequentialImpulseConstraintSolver* solver;
+	/// Owns dynamicsWorld and its solver
+	PhysicsWorld* physics;
 	btDiscreteDynamicsWorld* dynamicsWorld;
 
+	/**
+	 * Threads shared by physics and batched raycasts
+	 */
+	WorkerPool* workers;
+
+	/**
+	 * Ray and radius queries against dynamicsWorld
+	 */
+	RaycastService* raycasts;
+
+	/**
+	 * Floats vehicles and dynamic instances that are in water
+	 */
+	BuoyancySystem* buoyancy;
+
 	/**
 	 * @brief physicsNearCallback
 	 * Used to implement uprooting and other physics oddities.
@@ -361,6 +523,34 @@ private:
 	 */
 	std::set<GameObject*> deletionQueue;
 
+	/**
+	 * Scratch copy of a pool's active objects, filled by tickObjects.
+	 */
+	std::vector<GameObject*> tickList;
+
+	/**
+	 * Scratch list of traffic that may be cleaned up, filled by
+	 * cleanupTraffic.
+	 */
+	std::vector<GameObject*> distantTraffic;
+
+	/// Number of times tickObjects has run
+	uint32_t simulationTick = 0;
+
+	glm::vec3 simulationFocus;
+	bool hasSimulationFocus = false;
+
+	/**
+	 * Controllers of the active characters grouped by goal, filled by
+	 * updateControllers
+	 */
+	std::array<std::vector<CharacterController*>, CharacterController::GoalCount> controllerBuckets;
+
+	/**
+	 * Weapon scans waiting for doQueuedWeaponScans
+	 */
+	std::vector<WeaponScan> weaponScanQueue;
+
 	std::vector<AreaIndicatorInfo> areaIndicators;
 
 	/**
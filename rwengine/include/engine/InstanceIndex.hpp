@@ -0,0 +1,155 @@
+#pragma once
+#ifndef _RWENGINE_INSTANCEINDEX_HPP_
+#define _RWENGINE_INSTANCEINDEX_HPP_
+
+#include <engine/SpatialHash.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class InstanceObject;
+
+/**
+ * @brief Finds world instances by location or model without scanning them
+ * all.
+ *
+ * Instances that can't move on their own (those without dynamics) are kept
+ * in a bounding volume hierarchy over their bounds, which cover both the
+ * model and the collision model, so instances whose model is still loading
+ * keep their extent. The tree is built
+ * in one go and never refitted: instances added or moved since the last
+ * build are kept in a short list that is tested directly, and the tree is
+ * rebuilt on the next query once that list grows too long. Instances with
+ * dynamics can be moved at any time, so they are kept in a SpatialHash by
+ * position instead.
+ *
+ * Instances are also indexed by the name of their model.
+ */
+class InstanceIndex
+{
+public:
+	InstanceIndex();
+
+	void insert(InstanceObject* instance);
+
+	void remove(InstanceObject* instance);
+
+	/**
+	 * Must be called after an instance is moved or its model is changed.
+	 * Instances that were never inserted are ignored.
+	 */
+	void update(InstanceObject* instance);
+
+	bool contains(InstanceObject* instance) const;
+
+	std::size_t size() const { return entries.size(); }
+
+	void clear();
+
+	/**
+	 * Appends every instance positioned inside the box [min, max] to out.
+	 */
+	void queryBox(const glm::vec3& min, const glm::vec3& max, std::vector<InstanceObject*>& out);
+
+	/**
+	 * Returns true if any instance is positioned inside the box [min, max].
+	 */
+	bool anyInBox(const glm::vec3& min, const glm::vec3& max);
+
+	/**
+	 * Appends every instance whose bounds overlap the box [min, max] to out.
+	 */
+	void queryBounds(const glm::vec3& min, const glm::vec3& max, std::vector<InstanceObject*>& out);
+
+	/**
+	 * Appends every instance using the named model to out.
+	 * @param model lower case model name
+	 */
+	void findByModel(const std::string& model, std::vector<InstanceObject*>& out) const;
+
+	/**
+	 * Appends every instance using the named model that is closer than
+	 * radius to centre.
+	 */
+	void findByModel(const std::string& model, const glm::vec3& centre, float radius,
+					 std::vector<InstanceObject*>& out) const;
+
+	/**
+	 * @return The number of instances waiting to be added to the tree
+	 */
+	std::size_t getLooseCount() const { return loose.size(); }
+
+private:
+	struct Item
+	{
+		/// null once removed from the tree
+		InstanceObject* instance;
+		glm::vec3 position;
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	struct Node
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+		/// First item of a leaf, or the right child of an inner node; the
+		/// left child always follows its parent.
+		uint32_t index;
+		/// Number of items in a leaf, 0 for inner nodes
+		uint32_t count;
+	};
+
+	struct Entry
+	{
+		std::string model;
+		/// Kept in dynamicHash rather than the tree
+		bool dynamic;
+		bool inTree;
+		/// Index into items or loose
+		uint32_t index;
+	};
+
+	std::vector<Item> items;
+	std::vector<Node> nodes;
+	std::vector<InstanceObject*> loose;
+	SpatialHash dynamicHash;
+	/// Largest bounding radius of any dynamic instance inserted since clear()
+	float dynamicRadius;
+	/// Reused by queries for the dynamic instances they find
+	std::vector<GameObject*> dynamicResults;
+	std::unordered_map<InstanceObject*, Entry> entries;
+	std::unordered_multimap<std::string, InstanceObject*> models;
+
+	/// Removed items still taking up space in the tree
+	std::size_t removedItems;
+
+	static bool isStatic(InstanceObject* instance);
+	static std::string modelName(InstanceObject* instance);
+	static Item makeItem(InstanceObject* instance);
+
+	void addDynamic(InstanceObject* instance);
+	void addLoose(InstanceObject* instance, Entry& entry);
+	void removeLoose(Entry& entry);
+	void removeModel(const std::string& model, InstanceObject* instance);
+
+	/**
+	 * Rebuilds the tree if enough has changed since it was built
+	 */
+	void refresh();
+	void rebuild();
+	uint32_t build(uint32_t first, uint32_t last);
+
+	/**
+	 * Calls itemTest for the instances that may lie in the box [min, max],
+	 * counting dynamic instances whose bounds reach padding into it, until
+	 * it returns true.
+	 */
+	template <class ItemTest>
+	bool query(const glm::vec3& min, const glm::vec3& max, float padding, ItemTest itemTest);
+};
+
+#endif
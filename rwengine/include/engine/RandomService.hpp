@@ -0,0 +1,114 @@
+#pragma once
+#ifndef _RWENGINE_RANDOMSERVICE_HPP_
+#define _RWENGINE_RANDOMSERVICE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief A small, fast seedable random number generator (PCG32).
+ *
+ * Each stream id selects an independent sequence for the same seed. Meets
+ * the requirements of a uniform random bit generator, so it can drive the
+ * standard library distributions.
+ */
+class RandomStream
+{
+public:
+	typedef uint32_t result_type;
+
+	RandomStream(uint64_t seed = 0, uint64_t stream = 0)
+	{
+		this->seed(seed, stream);
+	}
+
+	void seed(uint64_t seed, uint64_t stream = 0)
+	{
+		state = 0;
+		increment = (stream << 1) | 1;
+		(*this)();
+		state += seed;
+		(*this)();
+	}
+
+	result_type operator()()
+	{
+		uint64_t old = state;
+		state = old * 6364136223846793005ULL + increment;
+		uint32_t xorshifted = uint32_t(((old >> 18) ^ old) >> 27);
+		uint32_t rotation = uint32_t(old >> 59);
+		return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	/**
+	 * @return A uniformly distributed integer in [0, bound)
+	 */
+	uint32_t below(uint32_t bound)
+	{
+		// Widening multiply; the bias is negligible for the small bounds used
+		return uint32_t((uint64_t((*this)()) * bound) >> 32);
+	}
+
+	/**
+	 * @return A uniformly distributed float in [0, 1)
+	 */
+	float unit()
+	{
+		return ((*this)() >> 8) * (1.f / 16777216.f);
+	}
+
+private:
+	uint64_t state;
+	uint64_t increment;
+};
+
+/**
+ * @brief The world's source of randomness.
+ *
+ * Every subsystem draws from its own stream, so the numbers one subsystem
+ * uses don't depend on how many another has taken, and a run can be
+ * reproduced by seeding the world with the same value.
+ */
+class RandomService
+{
+public:
+	enum Stream
+	{
+		General,
+		Traffic,
+		AI,
+		Script,
+		Effects,
+
+		StreamCount
+	};
+
+	static constexpr uint64_t DefaultSeed = 0x853c49e6748fea9bULL;
+
+	RandomService(uint64_t seed = DefaultSeed);
+
+	/**
+	 * Restarts every stream from seed
+	 */
+	void seed(uint64_t seed);
+
+	uint64_t getSeed() const { return seedValue; }
+
+	RandomStream& stream(Stream s) { return streams[s]; }
+
+	/**
+	 * Creates a stream independent from the subsystem streams and any other
+	 * stream with a different id, for use by worker threads.
+	 */
+	RandomStream makeStream(uint64_t id) const;
+
+private:
+	uint64_t seedValue;
+	std::array<RandomStream, StreamCount> streams;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef _RWENGINE_SIMULATIONLOD_HPP_
+#define _RWENGINE_SIMULATIONLOD_HPP_
+
+#include <objects/ObjectTypes.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * How much of an object's simulation is run, from most to least detailed.
+ */
+enum SimulationTier
+{
+	/// Everything, every tick
+	SimulationFull,
+	/// Physics every tick, animation and other upkeep every few ticks
+	SimulationReduced,
+	/// Moved along its path without physics or animation
+	SimulationKinematic
+};
+
+/**
+ * @brief Chooses simulation tiers by distance from the simulation focus.
+ *
+ * Each boundary is widened by hysteresis in the direction of the object's
+ * current tier, so objects moving along a boundary don't switch every tick.
+ */
+struct SimulationLOD
+{
+	/// Objects further than this are simulated at a reduced rate
+	float reducedDistance = 40.f;
+	/// Objects further than this are moved kinematically
+	float kinematicDistance = 80.f;
+	float hysteresis = 5.f;
+	/// Reduced objects do their full update once every this many ticks
+	uint32_t reducedInterval = 4;
+
+	/**
+	 * @param coarsest The least detailed tier the object supports
+	 */
+	SimulationTier selectTier(SimulationTier current, float distance,
+							  SimulationTier coarsest = SimulationKinematic) const
+	{
+		float reducedAt = reducedDistance + (current == SimulationFull ? hysteresis : -hysteresis);
+		float kinematicAt = kinematicDistance + (current == SimulationKinematic ? -hysteresis : hysteresis);
+
+		SimulationTier tier = SimulationKinematic;
+		if (distance < reducedAt) {
+			tier = SimulationFull;
+		}
+		else if (distance < kinematicAt) {
+			tier = SimulationReduced;
+		}
+		return std::min(tier, coarsest);
+	}
+
+	/**
+	 * @return If a reduced object should do its full update on tick. Objects
+	 * are staggered by ID so that they don't all update on the same tick.
+	 */
+	bool isUpdateTick(uint32_t tick, GameObjectID object) const
+	{
+		return reducedInterval <= 1 || (tick + object) % reducedInterval == 0;
+	}
+};
+
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _RWENGINE_SPATIALHASH_HPP_
+#define _RWENGINE_SPATIALHASH_HPP_
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class GameObject;
+
+/**
+ * @brief Uniform hash grid of moving objects for proximity queries.
+ *
+ * Objects are bucketed by the cubic cell containing the position they were
+ * last inserted or updated with. Moving an object within its cell only
+ * updates the stored position; crossing into another cell is a swap-remove
+ * and a push. Queries test the stored positions, so they are only as fresh
+ * as the last update().
+ */
+class SpatialHash
+{
+public:
+	explicit SpatialHash(float cellSize = 32.f);
+
+	void insert(GameObject* object, const glm::vec3& position);
+
+	/**
+	 * Moves object to position. Objects that were never inserted are ignored.
+	 */
+	void update(GameObject* object, const glm::vec3& position);
+
+	void remove(GameObject* object);
+
+	bool contains(GameObject* object) const;
+
+	std::size_t size() const { return locations.size(); }
+
+	void clear();
+
+	/**
+	 * Appends every object within radius of centre to out.
+	 */
+	void queryRadius(const glm::vec3& centre, float radius, std::vector<GameObject*>& out) const;
+
+	/**
+	 * Returns true if at least one object is within radius of centre.
+	 */
+	bool anyWithin(const glm::vec3& centre, float radius) const;
+
+	/**
+	 * Appends every object inside the box [min, max] to out.
+	 */
+	void queryBox(const glm::vec3& min, const glm::vec3& max, std::vector<GameObject*>& out) const;
+
+	/**
+	 * Appends up to k objects within maxRadius of centre to out, nearest first.
+	 */
+	void queryNearest(const glm::vec3& centre, std::size_t k, float maxRadius, std::vector<GameObject*>& out) const;
+
+	/**
+	 * Appends every object at least radius away from centre to out. Cells that
+	 * lie entirely within the radius are skipped without testing their objects.
+	 */
+	void queryOutside(const glm::vec3& centre, float radius, std::vector<GameObject*>& out) const;
+
+private:
+	typedef uint64_t CellKey;
+
+	struct Entry
+	{
+		GameObject* object;
+		glm::vec3 position;
+	};
+
+	struct Location
+	{
+		CellKey cell;
+		uint32_t index;
+	};
+
+	float cellSize;
+	float inverseCellSize;
+
+	/// Cells are left in place when they empty, objects tend to come back.
+	std::unordered_map<CellKey, std::vector<Entry>> cells;
+	std::unordered_map<GameObject*, Location> locations;
+
+	glm::ivec3 cellCoord(const glm::vec3& position) const;
+	static CellKey cellKey(const glm::ivec3& coord);
+	static glm::ivec3 keyCoord(CellKey key);
+
+	void removeFromCell(const Location& location);
+
+	template <class F>
+	void forEachCell(const glm::ivec3& lo, const glm::ivec3& hi, F function) const;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef _RWENGINE_TRANSFORMSTORE_HPP_
+#define _RWENGINE_TRANSFORMSTORE_HPP_
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class GameObject;
+
+/**
+ * @brief Structure-of-arrays storage for per-object interpolation state.
+ *
+ * Holds the transform each object had at the start of the current tick so
+ * the renderer can blend towards the live transform. Every GameObject owns a
+ * slot for its whole lifetime, and slots are kept densely packed: removing
+ * one moves the last entry into the hole and updates its owner.
+ */
+class TransformStore
+{
+public:
+	typedef uint32_t Slot;
+
+	/**
+	 * Allocates a slot for object with the given initial transform.
+	 */
+	Slot add(GameObject* object, const glm::vec3& position, const glm::quat& rotation);
+
+	/**
+	 * Releases slot, the last slot is moved into its place.
+	 */
+	void remove(Slot slot);
+
+	void setLastTransform(Slot slot, const glm::vec3& position, const glm::quat& rotation)
+	{
+		lastPositions[slot] = position;
+		lastRotations[slot] = rotation;
+	}
+
+	void setLastPosition(Slot slot, const glm::vec3& position)
+	{
+		lastPositions[slot] = position;
+	}
+
+	const glm::vec3& getLastPosition(Slot slot) const { return lastPositions[slot]; }
+	const glm::quat& getLastRotation(Slot slot) const { return lastRotations[slot]; }
+
+	std::size_t size() const { return owners.size(); }
+
+private:
+	std::vector<glm::vec3> lastPositions;
+	std::vector<glm::quat> lastRotations;
+	std::vector<GameObject*> owners;
+};
+
+#endif
@@ -12,8 +12,12 @@ template<class T, class L> class BackgroundLoaderJob : public WorkJob
 public:
 	typedef typename ResourceHandle<T>::Ref TypeRef;
 
-	BackgroundLoaderJob(WorkContext* context, FileIndex* index, const std::string& file, const TypeRef& ref)
-	:WorkJob(context), index(index), filename(file), resourceRef(ref)
+	/**
+	 * @param loader Copied and used to load the resource, for loaders that
+	 * need configuring
+	 */
+	BackgroundLoaderJob(WorkContext* context, FileIndex* index, const std::string& file, const TypeRef& ref, const L& loader = L())
+	:WorkJob(context), index(index), filename(file), resourceRef(ref), loader(loader)
 	{ }
 
 	void work()
@@ -26,8 +30,6 @@ public:
 	{
 		if( data )
 		{
-			L loader;
-			
 			resourceRef->resource = loader.loadFromMemory(data);
 			resourceRef->state = RW::Loaded;
 		}
@@ -37,4 +39,5 @@ private:
 	std::string filename;
 	FileHandle data;
 	TypeRef resourceRef;
+	L loader;
 };
@@ -7,6 +7,7 @@
 #include <map>
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <data/KeyframeTrack.hpp>
 
 struct AnimationKeyframe
 {
@@ -33,7 +34,10 @@ struct AnimationBone
     Data type;
     std::vector<AnimationKeyframe> frames;
 
-    AnimationKeyframe getInterpolatedKeyframe(float time);
+    /**
+     * @param cursor speeds up sampling when time only moves forwards
+     */
+    AnimationKeyframe getInterpolatedKeyframe(float time, KeyframeCursor* cursor = nullptr);
 	AnimationKeyframe getKeyframe(float time);
 };
 
@@ -114,7 +114,16 @@ private:
 
 	bool motionBlockedByActivity;
 
+	/// Time the animator is behind by, while updated at a reduced rate
+	float pendingAnimationTime;
+
 	glm::vec3 updateMovementAnimation(float dt);
+
+	/**
+	 * Moves the character in its movement direction without physics or
+	 * animation, for SimulationKinematic
+	 */
+	void tickKinematic(float dt);
 public:
 
 	static const float DefaultJumpSpeed;
@@ -139,10 +148,22 @@ public:
 
 	~CharacterObject();
 
+	/// Allocated from PoolAllocator<CharacterObject>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	Type type() { return Character; }
 
 	void tick(float dt);
 
+	/**
+	 * Updates everything but the controller, for when controllers are updated
+	 * separately by GameWorld::tickObjects
+	 */
+	void tickSimulation(float dt);
+
+	void setSimulationTier(SimulationTier tier) override;
+
 	const CharacterState& getCurrentState() const { return currentState; }
 	CharacterState& getCurrentState(){ return currentState; }
 
@@ -16,6 +16,10 @@ public:
 	CutsceneObject(GameWorld* engine, const glm::vec3& pos, const glm::quat& rot, const ModelRef& model);
 	~CutsceneObject();
 
+	/// Allocated from PoolAllocator<CutsceneObject>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	Type type() { return Cutscene; }
 
 	void tick(float dt);
@@ -7,6 +7,8 @@
 #include <loaders/LoaderIDE.hpp>
 #include <loaders/LoaderIPL.hpp>
 #include <data/Model.hpp>
+#include <engine/TransformStore.hpp>
+#include <engine/SimulationLOD.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
@@ -25,9 +27,11 @@ class GameWorld;
  */
 class GameObject
 {
-	glm::vec3 _lastPosition;
-	glm::quat _lastRotation;
 	GameObjectID objectID;
+
+	/// Slot holding this object's last transform in GameWorld::transforms
+	TransformStore::Slot transformSlot;
+	friend class TransformStore;
 public:
     glm::vec3 position;
     glm::quat rotation;
@@ -52,22 +56,8 @@ public:
 	 */
 	bool visible;
 
-	GameObject(GameWorld* engine, const glm::vec3& pos, const glm::quat& rot, ModelRef model)
-		: _lastPosition(pos)
-		, _lastRotation(rot)
-		, objectID(0)
-		, position(pos)
-		, rotation(rot)
-		, model(model)
-		, engine(engine)
-		, animator(nullptr)
-		, skeleton(nullptr)
-		, inWater(false)
-		, _lastHeight(std::numeric_limits<float>::max())
-		, visible(true)
-		, lifetime(GameObject::UnknownLifetime)
-	{}
-		
+	GameObject(GameWorld* engine, const glm::vec3& pos, const glm::quat& rot, ModelRef model);
+
 	virtual ~GameObject();
 
 	GameObjectID getGameObjectID() const { return objectID; }
@@ -99,7 +89,7 @@ public:
 	virtual void setPosition(const glm::vec3& pos);
 
 	virtual glm::vec3 getPosition() const { return position; }
-	const glm::vec3& getLastPosition() const { return _lastPosition; }
+	const glm::vec3& getLastPosition() const;
 
 	virtual glm::quat getRotation() const;
 	virtual void setRotation(const glm::quat &orientation);
@@ -158,18 +148,11 @@ public:
 	 * @brief Function used to modify the last transform
 	 * @param newPos
 	 */
-	void _updateLastTransform()
-	{
-		_lastPosition = getPosition();
-		_lastRotation = getRotation();
-	}
-
-	glm::mat4 getTimeAdjustedTransform(float alpha) const {
-		glm::mat4 t;
-		t = glm::translate(t, glm::mix(_lastPosition, getPosition(), alpha));
-		t = t * glm::mat4_cast(glm::slerp(_lastRotation, getRotation(), alpha));
-		return t;
-	}
+	void _updateLastTransform();
+
+	TransformStore::Slot getTransformSlot() const { return transformSlot; }
+
+	glm::mat4 getTimeAdjustedTransform(float alpha) const;
 	
 	enum ObjectLifetime
 	{
@@ -185,9 +168,30 @@ public:
 	
 	void setLifetime(ObjectLifetime ol) { lifetime = ol; }
 	ObjectLifetime getLifetime() const { return lifetime; }
+
+	/**
+	 * @brief Whether the object has anything to simulate.
+	 *
+	 * Only active objects are ticked by GameWorld::tickObjects, objects
+	 * should deactivate themselves when their tick would do nothing.
+	 */
+	bool isActive() const { return active; }
+	void setActive(bool enable);
+
+	SimulationTier getSimulationTier() const { return simulationTier; }
+
+	/**
+	 * @brief Changes how much of the object is simulated, see SimulationLOD.
+	 *
+	 * Subclasses override this to hand their bodies to or from the physics
+	 * world when moving in or out of SimulationKinematic.
+	 */
+	virtual void setSimulationTier(SimulationTier tier) { simulationTier = tier; }
 	
 private:
 	ObjectLifetime lifetime;
+	bool active;
+	SimulationTier simulationTier;
 };
 
 #endif // __GAMEOBJECTS_HPP__
@@ -25,6 +25,10 @@ public:
 			);
 	~InstanceObject();
 
+	/// Allocated from PoolAllocator<InstanceObject>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	Type type() { return Instance; }
 
 	void tick(float dt);
@@ -34,6 +38,7 @@ public:
 	glm::vec3 getPosition() const override;
 	glm::quat getRotation() const override;
 
+	void setPosition(const glm::vec3& pos) override;
 	virtual void setRotation(const glm::quat& r);
 	
 	virtual bool takeDamage(const DamageInfo& damage);
@@ -41,6 +46,11 @@ public:
 	void setSolid(bool solid);
 
 	float getHealth() const { return health; }
+
+	/**
+	 * Activates the instance only if it has dynamics or animation to update
+	 */
+	void updateActive();
 };
 
 
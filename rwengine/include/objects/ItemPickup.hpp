@@ -17,6 +17,10 @@ public:
 
 	ItemPickup(GameWorld* world, const glm::vec3& position, PickupType type, InventoryItem* item);
 
+	/// Allocated from PoolAllocator<ItemPickup>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	bool onCharacterTouch(CharacterObject* character);
 };
 
@@ -4,5 +4,32 @@
 
 /**
  * all wordly GameObjects are associated with a 32-bit identifier
+ *
+ * Identifiers are generational handles: the low bits index a slot in the
+ * object's pool, the high bits count how many times that slot has been
+ * reused, so a stale identifier never resolves to a newer object.
+ * 0 is never a valid identifier, and the top bit is always clear so scripts
+ * see identifiers as positive integers.
  */
-typedef uint32_t GameObjectID;
\ No newline at end of file
+typedef uint32_t GameObjectID;
+
+constexpr uint32_t kGameObjectIndexBits = 20;
+constexpr uint32_t kGameObjectIndexMask = (1u << kGameObjectIndexBits) - 1u;
+constexpr uint32_t kGameObjectGenerationBits = 31 - kGameObjectIndexBits;
+constexpr uint32_t kGameObjectGenerationMask = (1u << kGameObjectGenerationBits) - 1u;
+
+inline uint32_t gameObjectIndex(GameObjectID id)
+{
+	return id & kGameObjectIndexMask;
+}
+
+inline uint32_t gameObjectGeneration(GameObjectID id)
+{
+	return (id >> kGameObjectIndexBits) & kGameObjectGenerationMask;
+}
+
+inline GameObjectID makeGameObjectID(uint32_t index, uint32_t generation)
+{
+	return ((generation & kGameObjectGenerationMask) << kGameObjectIndexBits)
+			| (index & kGameObjectIndexMask);
+}
\ No newline at end of file
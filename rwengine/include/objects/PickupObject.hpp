@@ -5,8 +5,8 @@
 #include <bullet/btBulletCollisionCommon.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <glm/glm.hpp>
+#include <render/ParticleSystem.hpp>
 
-class VisualFX;
 class CharacterObject;
 
 /**
@@ -45,6 +45,10 @@ public:
 
 	~PickupObject();
 
+	/// Allocated from PoolAllocator<PickupObject>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	int getModelID() const { return m_model; }
 
 	Type type() { return Pickup; }
@@ -71,7 +75,7 @@ private:
 	float m_enableTimer;
 	bool m_collected;
 	int m_model;
-	VisualFX* m_corona;
+	ParticleID m_corona;
 
 	PickupType m_type;
 };
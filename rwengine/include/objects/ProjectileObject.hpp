@@ -56,6 +56,10 @@ public:
 
 	~ProjectileObject();
 
+	/// Allocated from PoolAllocator<ProjectileObject>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
+
 	void tick(float dt);
 
 	Type type() { return Projectile; }
@@ -6,6 +6,8 @@
 #include <objects/VehicleInfo.hpp>
 #include <dynamics/CollisionInstance.hpp>
 
+class RaycastService;
+
 /**
  * @class VehicleObject
  * Implements Vehicle behaviours.
@@ -49,6 +51,10 @@ public:
 	VehicleObject(GameWorld* engine, const glm::vec3& pos, const glm::quat& rot, const ModelRef& model, VehicleDataHandle data, VehicleInfoHandle info, const glm::u8vec3& prim, const glm::u8vec3& sec);
 	
 	virtual ~VehicleObject();
+
+	/// Allocated from PoolAllocator<VehicleObject>
+	static void* operator new(std::size_t size);
+	static void operator delete(void* p, std::size_t size);
 	
 	void setPosition(const glm::vec3& pos);
 
@@ -60,6 +66,13 @@ public:
 
 	Type type() { return Vehicle; }
 
+	void setSimulationTier(SimulationTier tier) override;
+
+	/**
+	 * @return true if any seat is occupied
+	 */
+	bool isOccupied() const { return ! seatOccupants.empty(); }
+
 	void setSteeringAngle(float);
 
 	float getSteeringAngle() const;
@@ -127,8 +140,6 @@ public:
 
 	Part* getPart(const std::string& name);
 
-	void applyWaterFloat(const glm::vec3& relPt);
-
 	void setPrimaryColour(uint8_t color);
 	void setSecondaryColour(uint8_t color);
 
@@ -151,11 +162,11 @@ private:
  */
 class VehicleRaycaster : public btVehicleRaycaster
 {
-	btDynamicsWorld* _world;
+	RaycastService* _raycasts;
 	VehicleObject* _vehicle;
 public:
-	VehicleRaycaster(VehicleObject* vehicle, btDynamicsWorld* world)
-		: _world(world), _vehicle(vehicle) {}
+	VehicleRaycaster(VehicleObject* vehicle, RaycastService* raycasts)
+		: _raycasts(raycasts), _vehicle(vehicle) {}
 
 	void* castRay(const btVector3 &from, const btVector3 &to, btVehicleRaycasterResult &result);
 };
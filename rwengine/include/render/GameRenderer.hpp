@@ -10,8 +10,12 @@ class Logger;
 #include <vector>
 
 #include <render/ViewCamera.hpp>
+#include <data/AssetName.hpp>
+#include <data/ResourceHandle.hpp>
+#include <gl/TextureData.hpp>
 
 #include <render/OpenGLRenderer.hpp>
+#include <render/OcclusionCuller.hpp>
 #include "MapRenderer.hpp"
 #include "TextRenderer.hpp"
 #include "WaterRenderer.hpp"
@@ -85,6 +89,14 @@ class GameRenderer
 	ViewCamera _camera;
 	ViewCamera cullingCamera;
 	bool cullOverride;
+
+	/** Hides instances behind large static geometry */
+	OcclusionCuller occlusionCuller;
+	bool occlusionCulling;
+
+	/** Scratch space for culling world objects in renderWorld() */
+	PackedSpheres cullSpheres;
+	ViewFrustum::VisibilityMask cullMask;
 	
 	GLuint framebufferName;
 	GLuint fbTextures[2];
@@ -94,18 +106,29 @@ class GameRenderer
 	/// Texture used to replace textures missing from the data
 	GLuint m_missingTexture;
 
+	/// Assets drawn every frame, looked up until they have loaded
+	std::shared_ptr<ResourceHandle<Model>> arrowModel;
+	TextureData::Handle arrowTexture;
+	TextureData::Handle areaIndicatorTexture;
+	std::string splashName;
+	AssetID splashID;
+	TextureData::Handle splashTexture;
+
 public:
 	
 	GameRenderer(Logger* log, GameData* data);
 	~GameRenderer();
 	
-	/** Number of culling events */
+	/** Number of culling events, including objects found to be occluded */
 	size_t culled;
 
 	/** @todo Clean up all these shader program and location variables */
 	Renderer::ShaderProgram* worldProg;
+	/** Draws instanced batches of world objects */
+	Renderer::ShaderProgram* worldInstancedProg;
 	Renderer::ShaderProgram* skyProg;
 	Renderer::ShaderProgram* particleProg;
+	Renderer::ShaderProgram* particleBatchProg;
 
 	GLuint ssRectProgram;
 	GLint ssRectTexture, ssRectColour, ssRectSize, ssRectOffset;
@@ -181,6 +204,16 @@ public:
 		cullingCamera = cullCamera;
 		cullOverride = override;
 	}
+
+	void setOcclusionCulling(bool enable)
+	{
+		occlusionCulling = enable;
+	}
+
+	bool getOcclusionCulling() const
+	{
+		return occlusionCulling;
+	}
 	
 	MapRenderer map;
 	WaterRenderer water;
@@ -33,11 +33,25 @@ struct WorldObject {
 	static const char* FragmentShader;
 };
 
+/**
+ * @brief WorldObject with a per-instance transform, for instanced batches.
+ * Uses WorldObject::FragmentShader
+ */
+struct WorldObjectInstanced {
+	static const char* VertexShader;
+};
+
 /** @brief Particle effect shaders, uses WorldObject::VertexShader */
 struct Particle {
 	static const char* FragmentShader;
 };
 
+/**
+ * @brief Draws many particles in one call, with each particle's placement
+ * and colour as per-instance attributes.
+ */
+SHADER_VF(ParticleBatch);
+
 /**
  * @brief The ScreenSpaceRect shader
  *
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <render/OpenGLRenderer.hpp>
+#include <data/AssetName.hpp>
 class GameData;
 class GameWorld;
 
@@ -44,6 +45,12 @@ private:
 	DrawBuffer circle;
 	
 	Renderer::ShaderProgram* rectProg;
+
+	/// Names of the radar tile textures, radar00 onwards
+	AssetID radarTiles[MAP_BLOCK_SIZE];
 	
-	void drawBlip(const glm::vec2& map, const glm::mat4& view, const MapInfo& mi, const std::string& texture, float heading = 0.f, float size = 18.f);
+	/**
+	 * @param texture the blip sprite, or 0 to draw a plain square
+	 */
+	void drawBlip(const glm::vec2& map, const glm::mat4& view, const MapInfo& mi, AssetID texture, float heading = 0.f, float size = 18.f);
 };
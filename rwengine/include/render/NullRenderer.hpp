@@ -0,0 +1,57 @@
+#pragma once
+#ifndef _RWENGINE_NULLRENDERER_HPP_
+#define _RWENGINE_NULLRENDERER_HPP_
+
+#include <render/OpenGLRenderer.hpp>
+
+/**
+ * @brief Renderer that doesn't draw anything.
+ *
+ * It tracks the same state as OpenGLRenderer and counts draws, buffer binds
+ * and texture binds the same way, so it can measure how a render list would
+ * be submitted without a GL context.
+ */
+class NullRenderer : public Renderer
+{
+public:
+	NullRenderer();
+
+	std::string getIDString() const override;
+
+	ShaderProgram* createShader(const std::string& vert, const std::string& frag) override;
+	void useProgram(ShaderProgram* p) override;
+
+	void setProgramBlockBinding(ShaderProgram* p, const std::string& name, GLint point) override;
+	void setUniformTexture(ShaderProgram* p, const std::string& name, GLint tex) override;
+	void setUniform(ShaderProgram* p, const std::string& name, const glm::mat4& m) override;
+	void setUniform(ShaderProgram* p, const std::string& name, const glm::vec4& v) override;
+	void setUniform(ShaderProgram* p, const std::string& name, const glm::vec3& v) override;
+	void setUniform(ShaderProgram* p, const std::string& name, const glm::vec2& v) override;
+	void setUniform(ShaderProgram* p, const std::string& name, float f) override;
+
+	void clear(const glm::vec4& colour, bool clearColour, bool clearDepth) override;
+
+	void setSceneParameters(const SceneUniformData& data) override;
+
+	void draw(const glm::mat4& model, DrawBuffer* draw, const DrawParameters& p) override;
+	void drawArrays(const glm::mat4& model, DrawBuffer* draw, const DrawParameters& p) override;
+	void drawArraysInstanced(DrawBuffer* draw, const DrawParameters& p, unsigned int instances) override;
+
+	void drawBatched(const RenderList& list) override;
+
+	void invalidate() override;
+
+	void pushDebugGroup(const std::string& title) override;
+	const ProfileInfo& popDebugGroup() override;
+
+private:
+	DrawBuffer* currentDbuff;
+	GLuint currentTextures[MAX_TEXTURE_UNITS];
+
+	DrawBatches batches;
+	ProfileInfo profileInfo;
+
+	void setDrawState(DrawBuffer* draw, const DrawParameters& p);
+};
+
+#endif
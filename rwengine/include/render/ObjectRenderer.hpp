@@ -5,6 +5,7 @@
 #include <rw/types.hpp>
 #include <render/ViewCamera.hpp>
 #include <render/OpenGLRenderer.hpp>
+#include <render/OcclusionBuffer.hpp>
 #include <objects/GameObject.hpp>
 #include <engine/GameWorld.hpp>
 #include <gl/DrawBuffer.hpp>
@@ -16,7 +17,8 @@ class PickupObject;
  * @brief The ObjectRenderer class handles object -> renderer transformation
  *
  * Determines what parts of an object are within a camera frustum and exports
- * a list of things to render for the object.
+ * a list of things to render for the object. Instances can also be tested
+ * against an occlusion buffer.
  */
 class ObjectRenderer
 {
@@ -24,11 +26,14 @@ public:
 	ObjectRenderer(GameWorld* world,
 				   const ViewCamera& camera,
 				   float renderAlpha,
-				   GLuint errorTexture)
+				   GLuint errorTexture,
+				   const OcclusionBuffer* occlusion = nullptr)
 		: m_world (world)
 		, m_camera(camera)
 		, m_renderAlpha(renderAlpha)
 		, m_errorTexture(errorTexture)
+		, m_occlusion(occlusion)
+		, m_occluded(0)
 	{ }
 
 	/**
@@ -38,11 +43,32 @@ public:
 	 */
 	void buildRenderList(GameObject* object, RenderList& outList);
 
+	/**
+	 * @return The number of instances skipped because they were occluded
+	 */
+	size_t getOccludedCount() const { return m_occluded; }
+
+	/**
+	 * @brief createKey
+	 *
+	 * Makes the sort key for an instruction. Transparent instructions are
+	 * drawn after opaque ones, back to front. Opaque instructions are grouped
+	 * by texture and then by geometry range, so that copies of the same
+	 * model are adjacent and can be instanced, and are front to back within
+	 * those groups.
+	 */
+	static RenderKey createKey(bool transparent,
+							   float normalizedDepth,
+							   const DrawBuffer* dbuff,
+							   const Renderer::DrawParameters& dp);
+
 private:
 	GameWorld* m_world;
 	const ViewCamera& m_camera;
 	float m_renderAlpha;
 	GLuint m_errorTexture;
+	const OcclusionBuffer* m_occlusion;
+	size_t m_occluded;
 
 	void renderInstance(InstanceObject *instance, RenderList& outList);
 	void renderCharacter(CharacterObject *pedestrian, RenderList& outList);
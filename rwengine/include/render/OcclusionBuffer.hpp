@@ -0,0 +1,90 @@
+#pragma once
+#ifndef _RWENGINE_OCCLUSIONBUFFER_HPP_
+#define _RWENGINE_OCCLUSIONBUFFER_HPP_
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A low resolution depth buffer of large occluders, rasterized on
+ * the CPU, that the bounds of objects can be tested against.
+ *
+ * It errs towards visible: occluders write the farthest depth they have in
+ * each pixel whose centre they cover, and bounds are hidden only when their
+ * nearest point is behind every pixel within one of them. Rows are filled
+ * and tested four pixels at a time, with SSE where it's available.
+ */
+class OcclusionBuffer
+{
+public:
+	/**
+	 * @param width Rounded up to a multiple of 4
+	 */
+	OcclusionBuffer(int width = 256, int height = 128);
+
+	/**
+	 * Clears the buffer to draw occluders for a new view.
+	 */
+	void begin(const glm::mat4& viewProjection);
+
+	/**
+	 * Rasterizes a model space triangle list.
+	 */
+	void drawTriangles(const glm::mat4& model,
+					   const glm::vec3* vertices,
+					   std::size_t vertexCount,
+					   const uint32_t* indices,
+					   std::size_t indexCount);
+
+	/**
+	 * Rasterizes a solid model space box.
+	 */
+	void drawBox(const glm::mat4& model, const glm::vec3& min, const glm::vec3& max);
+
+	/**
+	 * @return false if the world space box is certainly hidden
+	 */
+	bool isVisible(const glm::vec3& min, const glm::vec3& max) const;
+
+	bool isVisible(const glm::vec3& center, float radius) const
+		{ return isVisible(center - glm::vec3(radius), center + glm::vec3(radius)); }
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	/**
+	 * @return The normalized device depth at a pixel, 1 where nothing has
+	 * been drawn
+	 */
+	float getDepth(int x, int y) const { return depth[y * width + x]; }
+
+	/**
+	 * @return The number of triangles drawn since begin()
+	 */
+	std::size_t getTriangleCount() const { return triangles; }
+
+private:
+	int width;
+	int height;
+	glm::mat4 viewProjection;
+	std::vector<float> depth;
+	std::size_t triangles;
+
+	/// Scratch space for transformed vertices
+	std::vector<glm::vec4> clipVertices;
+
+	/**
+	 * Clips a triangle against the near plane and rasterizes what's left
+	 */
+	void drawClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+	/**
+	 * Rasterizes a triangle in pixel coordinates, with normalized device
+	 * depth in z
+	 */
+	void rasterize(glm::vec3 a, glm::vec3 b, glm::vec3 c);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _RWENGINE_OCCLUSIONCULLER_HPP_
+#define _RWENGINE_OCCLUSIONCULLER_HPP_
+
+#include <render/OcclusionBuffer.hpp>
+#include <render/ViewCamera.hpp>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+class GameWorld;
+class InstanceObject;
+struct CollisionModel;
+struct ObjectData;
+
+/**
+ * @brief Chooses occluders for a view and draws them into an OcclusionBuffer.
+ *
+ * Occluders are the collision models of large static instances near the
+ * camera, nearest first, up to a budget of triangles per frame.
+ */
+class OcclusionCuller
+{
+public:
+	OcclusionCuller();
+
+	/**
+	 * Rebuilds the buffer for a view of the world.
+	 */
+	void build(GameWorld* world,
+			   const ViewCamera& camera,
+			   const glm::mat4& viewProjection,
+			   float alpha);
+
+	const OcclusionBuffer& getBuffer() const { return buffer; }
+
+	/**
+	 * @return The number of instances drawn as occluders by the last build
+	 */
+	std::size_t getOccluderCount() const { return occluderCount; }
+
+	/// Occluders must have a collision bounding radius of at least this
+	static const float kMinOccluderRadius;
+	/// Occluders must be closer to the camera than this
+	static const float kOccluderRange;
+	/// Occluders stop being added once this many triangles have been drawn
+	static const std::size_t kTriangleBudget;
+
+private:
+	OcclusionBuffer buffer;
+	std::size_t occluderCount;
+
+	/// Collision model for each object type, or nullptr if it can't occlude
+	std::unordered_map<const ObjectData*, const CollisionModel*> occluderModels;
+
+	struct Candidate
+	{
+		/// From the camera to the occluder's bounds
+		float distance;
+		InstanceObject* instance;
+		const CollisionModel* model;
+	};
+
+	// Scratch space for build
+	std::vector<InstanceObject*> nearby;
+	std::vector<Candidate> candidates;
+
+	const CollisionModel* findOccluderModel(GameWorld* world, const ObjectData* object);
+};
+
+#endif
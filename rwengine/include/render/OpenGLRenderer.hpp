@@ -5,6 +5,7 @@
 #include <rw/types.hpp>
 #include <gl/DrawBuffer.hpp>
 #include <gl/GeometryBuffer.hpp>
+#include <render/RingAllocator.hpp>
 #include <glm/vec2.hpp>
 
 typedef uint64_t RenderKey;
@@ -12,6 +13,9 @@ typedef uint64_t RenderKey;
 // Maximum depth of debug group stack
 #define MAX_DEBUG_DEPTH 5
 
+// Texture units whose bindings are cached
+#define MAX_TEXTURE_UNITS 8
+
 typedef std::uint32_t RenderIndex;
 
 struct VertexP3
@@ -57,6 +61,8 @@ public:
 		size_t count;
 		/// Start index.
 		unsigned int start;
+		/// Added to each index, for geometry in a shared buffer
+		int baseVertex;
 		/// Textures to use
 		Textures textures;
 		/// Alpha blending state
@@ -74,7 +80,8 @@ public:
 
 		// Default state -- should be moved to materials
 		DrawParameters()
-			: blend(false)
+			: baseVertex(0)
+			, blend(false)
 			, depthWrite(true)
 			, ambient(1.f)
 			, diffuse(1.f)
@@ -111,6 +118,30 @@ public:
 	};
 	typedef std::vector<RenderInstruction> RenderList;
 
+	/**
+	 * @brief A run of instructions that can be submitted as one draw call
+	 *
+	 * They share a draw buffer, textures and material. Either they also share
+	 * a transform and only their index ranges differ, or they draw the same
+	 * range and the batch is instanced with one transform per instruction.
+	 */
+	struct DrawBatch
+	{
+		/// Index of the first instruction in the list
+		size_t first;
+		size_t count;
+		/// Draw count instances of the first instruction's range
+		bool instanced;
+	};
+	typedef std::vector<DrawBatch> DrawBatches;
+
+	/**
+	 * Splits a list into batches of consecutive instructions, in order.
+	 * @param maxInstances The most instructions in an instanced batch, or 0
+	 * to never instance
+	 */
+	static void batchRenderList(const RenderList& list, DrawBatches& batches, size_t maxInstances = 0);
+
 
 	struct ObjectUniformData {
 		glm::mat4 model;
@@ -156,9 +187,28 @@ public:
 
 	virtual void draw(const glm::mat4& model, DrawBuffer* draw, const DrawParameters& p) = 0;
 	virtual void drawArrays(const glm::mat4& model, DrawBuffer* draw, const DrawParameters& p) = 0;
+	/**
+	 * Draws instances copies of p.count vertices. Per-instance data comes
+	 * from attributes in draw with a non-zero divisor.
+	 */
+	virtual void drawArraysInstanced(DrawBuffer* draw, const DrawParameters& p, unsigned int instances) = 0;
 
+	/**
+	 * Draws a sorted list, merging instructions that only differ in their
+	 * index ranges into single draw calls. If there's an instanced program,
+	 * runs that only differ in their transforms are drawn with it as one
+	 * instanced draw call.
+	 */
 	virtual void drawBatched(const RenderList& list) = 0;
 
+	/**
+	 * Sets the program used for instanced batches, which should read the
+	 * instance's transform from a mat4 at the ATRS_Instance0 location and
+	 * otherwise match the program drawBatched is called with.
+	 */
+	void setInstancedProgram(ShaderProgram* p) { instancedProgram = p; }
+	ShaderProgram* getInstancedProgram() const { return instancedProgram; }
+
 	void setViewport(const glm::ivec2& vp);
 	const glm::ivec2& getViewport() const { return viewport; }
 
@@ -169,12 +219,16 @@ public:
 	/**
 	 * Resets all per-frame counters.
 	 */
-	void swap();
+	virtual void swap();
 	
 	/**
 	 * Returns the number of draw calls issued for the current frame.
 	 */
 	int getDrawCount();
+	/**
+	 * Returns the number of texture and vertex array binds for the current
+	 * frame, counting only those that changed state.
+	 */
 	int getTextureCount();
 	int getBufferCount();
 	
@@ -215,6 +269,7 @@ protected:
 	int textureCounter;
 	int bufferCounter;
 	SceneUniformData lastSceneData;
+	ShaderProgram* instancedProgram = nullptr;
 };
 
 class OpenGLRenderer : public Renderer
@@ -246,6 +301,7 @@ public:
 	};
 
 	OpenGLRenderer();
+	~OpenGLRenderer();
 
 	std::string getIDString() const;
 
@@ -267,11 +323,18 @@ public:
 
 	void draw(const glm::mat4& model, DrawBuffer* draw, const DrawParameters& p);
 	void drawArrays(const glm::mat4& model, DrawBuffer* draw, const DrawParameters& p);
+	void drawArraysInstanced(DrawBuffer* draw, const DrawParameters& p, unsigned int instances);
 
 	void drawBatched(const RenderList& list) override;
 
 	void invalidate();
 
+	/**
+	 * Also moves the uniform and instance rings on to the next frame's
+	 * region.
+	 */
+	void swap() override;
+
 	virtual void pushDebugGroup(const std::string& title);
 	virtual const ProfileInfo& popDebugGroup();
 
@@ -280,19 +343,60 @@ private:
 
 	void useDrawBuffer(DrawBuffer* dbuff);
 
-	std::map<GLuint,GLuint> currentTextures;
+	GLuint currentTextures[MAX_TEXTURE_UNITS];
 	void useTexture(GLuint unit, GLuint tex);
 
 	OpenGLShaderProgram* currentProgram;
 
-	GLuint currentUBO;
-	template<class T> void uploadUBO(GLuint buffer, const T& data)
+	// Scratch space for drawBatched
+	DrawBatches batches;
+	std::vector<GLsizei> batchCounts;
+	std::vector<const GLvoid*> batchOffsets;
+	std::vector<GLint> batchBaseVertices;
+
+	/**
+	 * Draws an instanced batch, with its transforms at instanceOffset in
+	 * the instance buffer
+	 */
+	void drawInstanced(const RenderList& list, const DrawBatch& batch, std::size_t instanceOffset);
+
+	/**
+	 * Sets everything but the object uniforms
+	 */
+	void applyDrawState(DrawBuffer* draw, const DrawParameters& p);
+
+	/// Holds the scene and object uniforms, written through uniformRing
+	GLuint uniformBuffer;
+	RingAllocator uniformRing;
+
+	/// Holds instance transforms, written through instanceRing
+	GLuint instanceBuffer;
+	RingAllocator instanceRing;
+
+	/**
+	 * Reserves space in a ring, retiring the current region early if it's
+	 * full.
+	 */
+	std::size_t allocateRing(RingAllocator& ring, std::size_t size);
+
+	/**
+	 * Fences the current region of a ring and waits until the GPU is done
+	 * with the next, so it can be written without synchronization.
+	 */
+	void retireRegion(RingAllocator& ring);
+
+	/**
+	 * Writes size bytes of data through an unsynchronized mapping of the
+	 * ring and binds them to a uniform block binding
+	 */
+	void writeUniforms(GLuint point, const void* data, std::size_t size);
+
+	/**
+	 * Writes data into the ring and binds it to a uniform block binding
+	 */
+	template<class T> void bindUniforms(GLuint point, const T& data)
 	{
-		if( currentUBO != buffer ) {
-			glBindBuffer(GL_UNIFORM_BUFFER, buffer);
-			currentUBO = buffer;
-		}
-		glBufferData(GL_UNIFORM_BUFFER, sizeof(T), &data, GL_DYNAMIC_DRAW);
+		writeUniforms(point, &data, sizeof(T));
 #if RW_PROFILER
 		if( currentDebugDepth > 0 )
 		{
@@ -301,12 +405,6 @@ private:
 #endif
 	}
 
-	GLuint UBOObject;
-	GLuint maxObjectEntries;
-	GLuint currentObjectEntry;
-	GLuint entryAlignment;
-	GLuint UBOScene;
-
 	// State Cache
 	bool blendEnabled;
 	bool depthWriteEnabled;
@@ -0,0 +1,223 @@
+#pragma once
+#ifndef _RWENGINE_PARTICLESYSTEM_HPP_
+#define _RWENGINE_PARTICLESYSTEM_HPP_
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class RandomStream;
+
+/**
+ * Identifies a live particle or emitter. Stays valid until it is destroyed
+ * or expires. Particle ids carry their slot's full 32 bit generation, so a
+ * stale id only matches again after its slot has been reused 2^32 times.
+ * 0 is never a valid id.
+ */
+typedef std::uint64_t ParticleID;
+typedef std::uint32_t EmitterID;
+
+/**
+ * Describes a particle to spawn
+ */
+struct ParticleInfo
+{
+	/** Particle orientation modes */
+	enum Orientation {
+		Free, /** faces direction using up */
+		Camera, /** Faces towards the camera */
+		UpCamera /** Face closes point in camera's look direction */
+	};
+
+	/** Initial world position */
+	glm::vec3 position;
+	/** World space velocity */
+	glm::vec3 velocity;
+	/** Direction of particle */
+	glm::vec3 direction;
+	/** Up direction (only used in Free mode) */
+	glm::vec3 up;
+	Orientation orientation;
+	/** Number of seconds particle should exist for, negative values = forever */
+	float lifetime;
+	/** GL name of the texture */
+	std::uint32_t texture;
+	/** Size of particle */
+	glm::vec2 size;
+	/** Change in size per second */
+	glm::vec2 growth;
+	/** Render tint colour */
+	glm::vec4 colour;
+
+	ParticleInfo()
+		: velocity(0.f), direction(0.f, 0.f, 1.f), up(0.f, 0.f, 1.f)
+		, orientation(Free), lifetime(-1.f), texture(0), size(1.f, 1.f)
+		, growth(0.f, 0.f), colour(1.f, 1.f, 1.f, 1.f) { }
+};
+
+/**
+ * Continuously spawns particles
+ */
+struct EmitterInfo
+{
+	/** Template for emitted particles, position is relative to the emitter */
+	ParticleInfo particle;
+	/** World position of the emitter */
+	glm::vec3 position;
+	/** Particles emitted per second */
+	float rate;
+	/** Random variation added to each component of the particle velocity */
+	float spread;
+	/** Seconds to keep emitting for, negative values = forever */
+	float duration;
+
+	EmitterInfo()
+		: position(0.f), rate(10.f), spread(0.f), duration(-1.f) { }
+};
+
+/**
+ * Per-instance data for drawing one particle: the quad spans
+ * origin ± axisX/2 ± axisY/2.
+ */
+struct ParticleInstance
+{
+	glm::vec3 origin;
+	glm::vec3 axisX;
+	glm::vec3 axisY;
+	glm::u8vec4 colour;
+};
+
+/**
+ * A run of instances that share a texture and can be drawn together
+ */
+struct ParticleBatch
+{
+	std::uint32_t texture;
+	std::size_t first;
+	std::size_t count;
+};
+
+/**
+ * @brief Simulates and sorts every particle in the world.
+ *
+ * Particles are kept in parallel arrays, so that each step of the
+ * simulation walks only the data it needs. Expired particles are removed in
+ * a single pass by moving the last particle into their place; ids are
+ * mapped to their current slot through a table so they stay valid.
+ *
+ * buildBatches() prepares the particles for drawing, ordered by texture and
+ * then back to front, using a key computed once per particle.
+ *
+ * Nothing here touches OpenGL, so it can be run and timed headlessly.
+ */
+class ParticleSystem
+{
+public:
+	ParticleSystem();
+
+	/**
+	 * Spawns a particle at the given game time
+	 */
+	ParticleID spawn(const ParticleInfo& info, float time);
+
+	/**
+	 * Immediately removes a particle, does nothing if it has expired
+	 */
+	void destroy(ParticleID id);
+
+	bool isAlive(ParticleID id) const;
+
+	void setPosition(ParticleID id, const glm::vec3& position);
+	void setSize(ParticleID id, const glm::vec2& size);
+	void setColour(ParticleID id, const glm::vec4& colour);
+
+	/**
+	 * Creates an emitter, starting at the given game time
+	 */
+	EmitterID createEmitter(const EmitterInfo& info, float time);
+
+	/**
+	 * Stops an emitter, the particles it has emitted live out their lifetime
+	 */
+	void destroyEmitter(EmitterID id);
+
+	void setEmitterPosition(EmitterID id, const glm::vec3& position);
+
+	/**
+	 * Runs the emitters, moves every particle and removes those that have
+	 * expired at time.
+	 */
+	void update(float time, float dt, RandomStream& random);
+
+	/**
+	 * Computes the draw data for every particle, grouped into one batch per
+	 * texture and sorted back to front within each batch.
+	 */
+	void buildBatches(const glm::vec3& cameraPosition, const glm::vec3& cameraForward);
+
+	const std::vector<ParticleInstance>& getInstances() const { return instances; }
+	const std::vector<ParticleBatch>& getBatches() const { return batches; }
+
+	std::size_t getParticleCount() const { return position.size(); }
+	std::size_t getEmitterCount() const { return emitters.size(); }
+
+	/**
+	 * Removes every particle and emitter
+	 */
+	void clear();
+
+private:
+	// Particle data, one entry per live particle
+	std::vector<glm::vec3> position;
+	std::vector<glm::vec3> velocity;
+	std::vector<glm::vec3> direction;
+	std::vector<glm::vec3> up;
+	std::vector<glm::vec2> size;
+	std::vector<glm::vec2> growth;
+	std::vector<glm::vec4> colour;
+	/// Game time to remove the particle at, infinite for permanent particles
+	std::vector<float> expiry;
+	std::vector<std::uint32_t> texture;
+	std::vector<std::uint8_t> orientation;
+	/// Entry in the id table pointing at each particle
+	std::vector<std::uint32_t> owner;
+
+	/// Particle slot for each id, with a generation to reject stale ids
+	struct IDSlot
+	{
+		std::uint32_t index;
+		std::uint32_t generation;
+	};
+	std::vector<IDSlot> particleIDs;
+	std::vector<std::uint32_t> freeParticleIDs;
+
+	struct Emitter
+	{
+		EmitterInfo info;
+		float start;
+		float accumulator;
+		EmitterID id;
+	};
+	std::vector<Emitter> emitters;
+	EmitterID nextEmitterID;
+
+	/// Scratch space for sorting
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> sortKeys;
+
+	std::vector<ParticleInstance> instances;
+	std::vector<ParticleBatch> batches;
+
+	/**
+	 * @return the slot of the particle, or -1 if the id isn't live
+	 */
+	std::ptrdiff_t find(ParticleID id) const;
+
+	void removeSlot(std::size_t slot);
+	void moveSlot(std::size_t from, std::size_t to);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _RWENGINE_RINGALLOCATOR_HPP_
+#define _RWENGINE_RINGALLOCATOR_HPP_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Sub-allocates a buffer that is split into regions used in turn,
+ * normally one per frame.
+ *
+ * The GPU may still be reading a region when the ring comes back round to
+ * it, so each region is guarded by a fence when it's left. Fences are opaque
+ * here, which keeps the allocator free of GL.
+ */
+class RingAllocator
+{
+public:
+	typedef void* Fence;
+
+	/**
+	 * @param alignment Every allocation starts on a multiple of this
+	 */
+	RingAllocator(std::size_t capacity, std::size_t alignment, std::size_t regions = 3);
+
+	/**
+	 * Reserves size bytes in the current region.
+	 * @return false if the region doesn't have room
+	 */
+	bool allocate(std::size_t size, std::size_t& offset);
+
+	/**
+	 * Guards the current region with fence and moves on to the next one.
+	 * @return The fence left on the next region last time round, which must
+	 * be waited on before writing to it, or nullptr if there isn't one
+	 */
+	Fence advance(Fence fence);
+
+	/**
+	 * Rounds size up to the alignment
+	 */
+	std::size_t align(std::size_t size) const
+		{ return (size + alignment - 1) / alignment * alignment; }
+
+	std::size_t getAlignment() const
+		{ return alignment; }
+
+	std::size_t getRegion() const
+		{ return region; }
+
+	std::size_t getRegionCount() const
+		{ return fences.size(); }
+
+	std::size_t getRegionSize() const
+		{ return regionSize; }
+
+	/**
+	 * @return The bytes used in the current region, including padding
+	 */
+	std::size_t getUsed() const
+		{ return used; }
+
+private:
+	std::size_t alignment;
+	std::size_t regionSize;
+	std::vector<Fence> fences;
+	std::size_t region;
+	std::size_t used;
+};
+
+#endif
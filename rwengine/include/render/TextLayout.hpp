@@ -0,0 +1,120 @@
+#pragma once
+#ifndef _RWENGINE_TEXTLAYOUT_HPP_
+#define _RWENGINE_TEXTLAYOUT_HPP_
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define GAME_FONTS 3
+#define GAME_GLYPHS 192
+
+/**
+ * @brief The glyphs of a string, positioned and with its markup resolved.
+ */
+struct TextLayout
+{
+	struct Glyph
+	{
+		/// Top left corner, relative to the text's origin
+		glm::vec2 position;
+		glm::vec2 size;
+		/// Font texture rectangle (left, top, right, bottom)
+		glm::vec4 texcoords;
+	};
+
+	/**
+	 * Glyphs from first up to the next run share a colour.
+	 */
+	struct Run
+	{
+		std::size_t first;
+		/// False for text before any colour markup, which uses the base colour
+		bool markup;
+		glm::vec3 colour;
+	};
+
+	std::vector<Glyph> glyphs;
+	std::vector<Run> runs;
+
+	/// Width of the widest line and the height below the first line
+	glm::vec2 extents;
+	/// Size of the last glyph, which pads the background
+	glm::vec2 lastGlyphSize;
+};
+
+/**
+ * @brief Lays out strings for the bitmap fonts and remembers the results.
+ *
+ * Doesn't need GL: the renderer turns the layouts into vertices. Layouts
+ * that haven't been used for a while are dropped by nextFrame().
+ */
+class TextLayoutCache
+{
+public:
+	/**
+	 * Stores the information for kerning a glyph
+	 */
+	struct GlyphInfo
+	{
+		float widthFrac;
+	};
+
+	TextLayoutCache();
+
+	/**
+	 * Returns the layout of text, creating it if it isn't cached. The
+	 * reference is valid until the next call.
+	 *
+	 * @param wrapX wrap width in characters, or 0 to not wrap
+	 */
+	const TextLayout& layout(const std::string& text, int font, float size, int wrapX);
+
+	/**
+	 * Lays out text without caching it.
+	 */
+	void layoutText(const std::string& text, int font, float size, int wrapX,
+					TextLayout& out) const;
+
+	/**
+	 * Advances the frame counter and drops stale layouts.
+	 */
+	void nextFrame();
+
+	/**
+	 * @return The number of cached layouts
+	 */
+	std::size_t size() const { return count; }
+
+	/**
+	 * @return The number of layouts created, including ones since dropped
+	 */
+	std::size_t getLayoutCount() const { return created; }
+
+	void clear();
+
+	static int charToIndex(char g);
+
+private:
+	struct Entry
+	{
+		int font;
+		float size;
+		int wrapX;
+		uint64_t lastUsed;
+		TextLayout layout;
+	};
+
+	GlyphInfo glyphData[GAME_GLYPHS];
+
+	/// Keyed by the text alone so lookups don't copy the string
+	std::unordered_map<std::string, std::vector<Entry>> layouts;
+	std::size_t count;
+	std::size_t created;
+	uint64_t frame;
+};
+
+#endif
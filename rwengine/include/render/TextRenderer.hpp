@@ -1,16 +1,15 @@
 #pragma once
 #include <engine/GameData.hpp>
+#include <render/TextLayout.hpp>
 #include "OpenGLRenderer.hpp"
 
-#define GAME_FONTS 3
-#define GAME_GLYPHS 192
-
 class GameRenderer;
 /**
  * @brief Handles rendering of bitmap font textures.
- * 
- * In future, strings textures might be cached to improve performance, but
- * for now, we just render each glyph on it's own quad
+ *
+ * Text is laid out through a TextLayoutCache, so unchanged strings are only
+ * measured once. renderText() queues the text; everything queued is drawn
+ * by flush() with one draw call, which samples the right font per glyph.
  */
 class TextRenderer
 {
@@ -49,23 +48,58 @@ public:
 	};
 	
 	/**
-	 * Stores the information for kerning a glyph
+	 * Vertices for the text batch. texcoord.z is the font index, or -1 for
+	 * solid background quads.
 	 */
-	struct GlyphInfo
+	struct TextVertex
 	{
-		float widthFrac;
+		glm::vec2 position;
+		glm::vec3 texcoord;
+		glm::vec4 colour;
+
+		static const AttributeList vertex_attributes() {
+			return {
+				{ATRS_Position, 2, sizeof(TextVertex),  0ul},
+				{ATRS_TexCoord, 3, sizeof(TextVertex),  0ul + sizeof(glm::vec2)},
+				{ATRS_Colour, 4, sizeof(TextVertex),  0ul + sizeof(glm::vec2) + sizeof(glm::vec3)},
+			};
+		}
 	};
-	
+
 	TextRenderer(GameRenderer* renderer);
 	~TextRenderer();
 	
 	void setFontTexture( int index, const std::string& font );
 	
+	/**
+	 * Queues text to be drawn by the next flush()
+	 */
 	void renderText( const TextInfo& ti, bool forceColour = false );
+
+	/**
+	 * Appends the vertices for ti to out. Doesn't need GL.
+	 */
+	static void buildVertices( const TextInfo& ti, const TextLayout& layout, bool forceColour,
+							   std::vector<TextVertex>& out );
+
+	/**
+	 * Draws all queued text
+	 */
+	void flush();
+
+	/**
+	 * Drops unused layouts, call once per frame
+	 */
+	void nextFrame() { layouts.nextFrame(); }
+
+	const TextLayoutCache& getLayoutCache() const { return layouts; }
 	
 private:
-	std::string fonts[GAME_FONTS];
-	GlyphInfo glyphData[GAME_GLYPHS];
+	AssetID fonts[GAME_FONTS];
+	TextLayoutCache layouts;
+
+	/// Text queued since the last flush
+	std::vector<TextVertex> vertices;
 
 	GameRenderer* renderer;
 	Renderer::ShaderProgram* textShader;
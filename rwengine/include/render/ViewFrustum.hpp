@@ -2,13 +2,48 @@
 #define _VIEWFRUSTUM_HPP_
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #ifdef RW_WINDOWS
 #include <rw_mingw.hpp>
 #endif
 
+/**
+ * @brief Bounding spheres with each component in its own array, so that
+ * many can be tested at once.
+ */
+struct PackedSpheres
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> radius;
+
+	void add(const glm::vec3& center, float r)
+	{
+		x.push_back(center.x);
+		y.push_back(center.y);
+		z.push_back(center.z);
+		radius.push_back(r);
+	}
+
+	void clear()
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		radius.clear();
+	}
+
+	std::size_t size() const { return x.size(); }
+};
+
 class ViewFrustum
 {
 public:
+	/// One bit per sphere, set if it intersects the frustum
+	typedef std::vector<uint32_t> VisibilityMask;
 	
 	class ViewPlane
 	{
@@ -54,16 +89,40 @@ public:
 	
 	bool intersects(glm::vec3 center, float radius) const
 	{
-		float d;
-		bool result = true;
-
 		for(size_t i = 0; i < 6; ++i)
 		{
-			d = glm::dot(planes[i].normal, center) + planes[i].distance;
-			if( d < -radius ) result = false;
+			float d = glm::dot(planes[i].normal, center) + planes[i].distance;
+			if( d < -radius ) return false;
 		}
 
-		return result;
+		return true;
+	}
+
+	/**
+	 * Tests count spheres from packed arrays, several at a time with SSE or
+	 * AVX where they're available. Bit i % 32 of visible[i / 32] is set if
+	 * sphere i intersects; the words are overwritten, not combined.
+	 */
+	void intersects(const float* x,
+					const float* y,
+					const float* z,
+					const float* radius,
+					std::size_t count,
+					uint32_t* visible) const;
+
+	/**
+	 * Tests every sphere in spheres, resizing visible to fit.
+	 */
+	void intersects(const PackedSpheres& spheres, VisibilityMask& visible) const
+	{
+		visible.resize((spheres.size() + 31) / 32);
+		intersects(spheres.x.data(), spheres.y.data(), spheres.z.data(),
+				   spheres.radius.data(), spheres.size(), visible.data());
+	}
+
+	static bool isVisible(const VisibilityMask& visible, std::size_t i)
+	{
+		return (visible[i / 32] >> (i % 32)) & 1;
 	}
 };
 
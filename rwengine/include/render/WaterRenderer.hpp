@@ -2,6 +2,7 @@
 
 #include <rw/types.hpp>
 #include <render/OpenGLRenderer.hpp>
+#include <gl/TextureData.hpp>
 
 class GameRenderer;
 class GameWorld;
@@ -45,4 +46,7 @@ private:
 	
 	GLuint fbOutput;
 	GLuint dataTexture;
+
+	/// Looked up until the water texture has loaded
+	TextureData::Handle waterTexture;
 };
@@ -2,115 +2,256 @@
 #include <objects/GameObject.hpp>
 #include <ai/AIGraphNode.hpp>
 #include <glm/gtx/norm.hpp>
-#include <iostream>
+#include <limits>
 
-AIGraph::~AIGraph()
+constexpr AIGraph::NodeIndex AIGraph::NoNode;
+
+namespace
 {
-	for( auto n : nodes ) {
-		delete n;
-	}
+/**
+ * Grid cell containing a world position. Positions outside of the grid are
+ * filed in the nearest edge cell.
+ */
+glm::ivec2 worldToGrid(const glm::vec2& world)
+{
+	static const float lowerCoord = -(WORLD_GRID_SIZE)/2.f;
+	auto coord = glm::ivec2(glm::floor((world - glm::vec2(lowerCoord)) / glm::vec2(WORLD_CELL_SIZE)));
+	return glm::clamp(coord, glm::ivec2(0), glm::ivec2(WORLD_GRID_WIDTH - 1));
+}
+
+int gridIndex(const glm::ivec2& coord)
+{
+	return (coord.x * WORLD_GRID_WIDTH) + coord.y;
+}
+
+/// Distance within which external nodes from different paths are merged
+constexpr float kExternalMergeDistance = 1.f;
 }
 
 void AIGraph::createPathNodes(const glm::vec3& position, const glm::quat& rotation, PathData& path)
 {
+	revision++;
+	topologyRevision++;
+
 	size_t startIndex = nodes.size();
-	std::vector<AIGraphNode*> pathNodes;
+	std::vector<NodeIndex> pathNodes;
 	pathNodes.reserve(path.nodes.size());
 
 	for( size_t n = 0; n < path.nodes.size(); ++n ) {
 		auto& node = path.nodes[n];
-		AIGraphNode* ainode = nullptr;
+		NodeIndex ainode = NoNode;
 		glm::vec3 nodePosition = position + (rotation * node.position);
 
 		if( node.type == PathNode::EXTERNAL ) {
-			for( size_t rn = 0; rn < externalNodes.size(); ++rn ) {
-				auto& realNode = externalNodes[rn];
-				auto d = glm::distance2(realNode->position, nodePosition);
-				if( d < 1.f ) {
-					pathNodes.push_back(realNode);
-					ainode = realNode;
-					break;
+			// Only the cells within merging distance can hold a match
+			auto minGrid = worldToGrid(glm::vec2(nodePosition) - glm::vec2(kExternalMergeDistance));
+			auto maxGrid = worldToGrid(glm::vec2(nodePosition) + glm::vec2(kExternalMergeDistance));
+			for( int x = minGrid.x; x <= maxGrid.x && ainode == NoNode; ++x ) {
+				for( int y = minGrid.y; y <= maxGrid.y && ainode == NoNode; ++y ) {
+					for( NodeIndex realNode : gridExternalNodes[gridIndex({x, y})] ) {
+						auto d = glm::distance2(nodes[realNode].position, nodePosition);
+						if( d < kExternalMergeDistance * kExternalMergeDistance ) {
+							ainode = realNode;
+							break;
+						}
+					}
 				}
 			}
 		}
-		
-		if( ainode == nullptr ) {
-			ainode = new AIGraphNode;
-			ainode->type = (path.type == PathData::PATH_PED ? AIGraphNode::Pedestrian : AIGraphNode::Vehicle);
-			ainode->nextIndex = node.next >= 0 ? startIndex + node.next : -1;
-			ainode->flags = AIGraphNode::None;
-			ainode->size = node.size;
-			ainode->other_thing = node.other_thing;
-			ainode->other_thing2 = node.other_thing2;
-			ainode->position = nodePosition;
-			ainode->external = node.type == PathNode::EXTERNAL;
-			ainode->disabled = false;
-
-			pathNodes.push_back(ainode);
-			nodes.push_back(ainode);
-
-			if( ainode->external )
+
+		if( ainode == NoNode ) {
+			ainode = nodes.size();
+			nodes.emplace_back();
+
+			auto& newNode = nodes.back();
+			newNode.type = (path.type == PathData::PATH_PED ? AIGraphNode::Pedestrian : AIGraphNode::Vehicle);
+			newNode.nextIndex = node.next >= 0 ? startIndex + node.next : -1;
+			newNode.flags = AIGraphNode::None;
+			newNode.size = node.size;
+			newNode.other_thing = node.other_thing;
+			newNode.other_thing2 = node.other_thing2;
+			newNode.position = nodePosition;
+			newNode.external = node.type == PathNode::EXTERNAL;
+			newNode.disabled = false;
+			newNode.firstEdge = -1;
+			newNode.connectionCount = 0;
+
+			auto cell = gridIndex(worldToGrid(glm::vec2(nodePosition)));
+			gridNodes[cell].push_back(ainode);
+
+			if( newNode.external )
 			{
 				externalNodes.push_back(ainode);
-				
-				// Determine which grid cell this node falls into
-				float lowerCoord = -(WORLD_GRID_SIZE)/2.f;
-				auto gridrel = glm::vec2(ainode->position) - glm::vec2(lowerCoord, lowerCoord);
-				auto gridcoord = glm::floor(gridrel / glm::vec2(WORLD_CELL_SIZE));
-				if( gridcoord.x < 0 || gridcoord.y < 0 || gridcoord.x >= WORLD_GRID_WIDTH || gridcoord.y >= WORLD_GRID_WIDTH )
-				{
-					std::cout << "Warning: Node outside of grid at coord " << gridcoord.x << " " << gridcoord.y << std::endl;
-				}
-				auto index = (gridcoord.x * WORLD_GRID_WIDTH) + gridcoord.y;
-				gridNodes[index].push_back(ainode);
+				gridExternalNodes[cell].push_back(ainode);
 			}
 		}
+
+		pathNodes.push_back(ainode);
 	}
 
 	for(size_t pn = 0; pn < path.nodes.size(); ++pn) {
 		if(path.nodes[pn].next >= 0 && (unsigned) path.nodes[pn].next < pathNodes.size()) {
-			auto node = pathNodes[pn];
-			auto next = pathNodes[path.nodes[pn].next];
-			
-			node->connections.push_back(next);
-			next->connections.push_back(node);
+			connect(pathNodes[pn], pathNodes[path.nodes[pn].next]);
 		}
 	}
 }
 
-glm::ivec2 worldToGrid(const glm::vec2& world)
+void AIGraph::connect(NodeIndex a, NodeIndex b)
 {
-	static const float lowerCoord = -(WORLD_GRID_SIZE)/2.f;
-	return glm::ivec2((world - glm::vec2(lowerCoord)) / glm::vec2(WORLD_CELL_SIZE));
+	revision++;
+	topologyRevision++;
+
+	edges.push_back({ b, nodes[a].firstEdge });
+	nodes[a].firstEdge = edges.size() - 1;
+	nodes[a].connectionCount++;
+
+	edges.push_back({ a, nodes[b].firstEdge });
+	nodes[b].firstEdge = edges.size() - 1;
+	nodes[b].connectionCount++;
+}
+
+void AIGraph::setNodeDisabled(NodeIndex node, bool disabled)
+{
+	if (nodes[node].disabled != disabled) {
+		nodes[node].disabled = disabled;
+		revision++;
+	}
+}
+
+AIGraph::NodeIndex AIGraph::getConnection(NodeIndex node, uint32_t n) const
+{
+	for (int32_t e = nodes[node].firstEdge; e != -1; e = edges[e].next) {
+		if (n-- == 0) {
+			return edges[e].node;
+		}
+	}
+	return NoNode;
 }
 
-void AIGraph::gatherExternalNodesNear(const glm::vec3& center, const float radius, std::vector< AIGraphNode* >& nodes)
+void AIGraph::gatherExternalNodesNear(const glm::vec3& center, float radius, std::vector<NodeIndex>& out) const
 {
 	// the bounds end up covering more than might fit
 	auto planecoords = glm::vec2(center);
-	auto minWorld = planecoords - glm::vec2(radius);
-	auto maxWorld = planecoords + glm::vec2(radius);
-	auto minGrid = worldToGrid(minWorld);
-	auto maxGrid = worldToGrid(maxWorld);
+	auto minGrid = worldToGrid(planecoords - glm::vec2(radius));
+	auto maxGrid = worldToGrid(planecoords + glm::vec2(radius));
 
 	for( int x = minGrid.x; x <= maxGrid.x; ++x )
 	{
 		for( int y = minGrid.y; y <= maxGrid.y; ++y )
 		{
-			int i = (x * WORLD_GRID_WIDTH) + y;
-			if( i < 0 || i >= (int)gridNodes.size() )
+			for ( NodeIndex node : gridExternalNodes[gridIndex({x, y})] )
 			{
-				continue;
+				if ( glm::distance2( center, nodes[node].position ) < radius*radius )
+				{
+					out.push_back( node );
+				}
 			}
-			auto& external = gridNodes[i];
-			for ( AIGraphNode* node : external )
+		}
+	}
+}
+
+void AIGraph::gatherNodesNear(const glm::vec3& center, float radius, std::vector<NodeIndex>& out) const
+{
+	auto planecoords = glm::vec2(center);
+	auto minGrid = worldToGrid(planecoords - glm::vec2(radius));
+	auto maxGrid = worldToGrid(planecoords + glm::vec2(radius));
+
+	for( int x = minGrid.x; x <= maxGrid.x; ++x )
+	{
+		for( int y = minGrid.y; y <= maxGrid.y; ++y )
+		{
+			for ( NodeIndex node : gridNodes[gridIndex({x, y})] )
 			{
-				if ( glm::distance2( center, node->position ) < radius*radius )
+				if ( glm::distance2( center, nodes[node].position ) < radius*radius )
 				{
-					nodes.push_back( node );
+					out.push_back( node );
 				}
 			}
 		}
 	}
 }
 
+void AIGraph::gatherNodesInBox(const glm::vec3& min, const glm::vec3& max, std::vector<NodeIndex>& out) const
+{
+	auto minGrid = worldToGrid(glm::vec2(min));
+	auto maxGrid = worldToGrid(glm::vec2(max));
+
+	for( int x = minGrid.x; x <= maxGrid.x; ++x )
+	{
+		for( int y = minGrid.y; y <= maxGrid.y; ++y )
+		{
+			for ( NodeIndex node : gridNodes[gridIndex({x, y})] )
+			{
+				auto& p = nodes[node].position;
+				if (p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+				    p.x <= max.x && p.y <= max.y && p.z <= max.z) {
+					out.push_back( node );
+				}
+			}
+		}
+	}
+}
+
+template <class F>
+AIGraph::NodeIndex AIGraph::findNearest(const glm::vec3& position, F accept) const
+{
+	NodeIndex nearest = NoNode;
+	float nearestDistance2 = std::numeric_limits<float>::max();
+
+	if (nodes.empty()) {
+		return nearest;
+	}
+
+	// Search rings of cells outwards from the one containing position. Every
+	// node in ring r is at least (r - 1) cells away along one axis, so once
+	// that is further than the best match there's nothing closer left.
+	auto origin = worldToGrid(glm::vec2(position));
+	for (int r = 0; r < WORLD_GRID_WIDTH; ++r) {
+		if (nearest != NoNode) {
+			float ringDistance = (r - 1) * float(WORLD_CELL_SIZE);
+			if (ringDistance > 0.f && ringDistance * ringDistance > nearestDistance2) {
+				break;
+			}
+		}
+
+		auto minCell = origin - glm::ivec2(r);
+		auto maxCell = origin + glm::ivec2(r);
+		for (int x = minCell.x; x <= maxCell.x; ++x) {
+			if (x < 0 || x >= WORLD_GRID_WIDTH) {
+				continue;
+			}
+			for (int y = minCell.y; y <= maxCell.y; ++y) {
+				if (y < 0 || y >= WORLD_GRID_WIDTH) {
+					continue;
+				}
+				// Only visit the ring's outline, the inside has been searched
+				if (x != minCell.x && x != maxCell.x && y != minCell.y && y != maxCell.y) {
+					continue;
+				}
+
+				for (NodeIndex node : gridNodes[gridIndex({x, y})]) {
+					if (! accept(nodes[node])) {
+						continue;
+					}
+					float d2 = glm::distance2(position, nodes[node].position);
+					if (d2 < nearestDistance2) {
+						nearestDistance2 = d2;
+						nearest = node;
+					}
+				}
+			}
+		}
+	}
+
+	return nearest;
+}
+
+AIGraph::NodeIndex AIGraph::findNearestNode(const glm::vec3& position) const
+{
+	return findNearest(position, [](const AIGraphNode&) { return true; });
+}
+
+AIGraph::NodeIndex AIGraph::findNearestNode(const glm::vec3& position, AIGraphNode::NodeType type) const
+{
+	return findNearest(position, [type](const AIGraphNode& node) { return node.type == type; });
+}
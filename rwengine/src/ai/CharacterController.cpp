@@ -16,7 +16,7 @@ CharacterController::CharacterController(CharacterObject* character)
 	, m_closeDoorTimer(0.f)
 	, currentGoal(None)
 	, leader(nullptr)
-	, targetNode(nullptr)
+	, targetNode(-1)
 {
 	character->controller = this;
 }
@@ -2,6 +2,8 @@
 #include <objects/CharacterObject.hpp>
 #include <engine/GameWorld.hpp>
 
+#include <algorithm>
+
 glm::vec3 DefaultAIController::getTargetPosition()
 {
 	/*if(targetNode) {
@@ -17,6 +19,69 @@ glm::vec3 DefaultAIController::getTargetPosition()
 
 const float followRadius = 5.f;
 
+/// How far away wandering characters pick their next destination
+const float wanderRouteRadius = 100.f;
+
+AIGraph::NodeIndex DefaultAIController::nextWanderNode(AIGraph::NodeIndex current)
+{
+	auto world = getCharacter()->engine;
+	auto& graph = world->aigraph;
+	auto& node = graph.nodes[current];
+
+	auto& random = world->random.stream(RandomService::AI);
+
+	if( ! route && ! routeRequest )
+	{
+		// Head for somewhere new, reachable through nodes of the same type
+		nearbyNodes.clear();
+		graph.gatherNodesNear(node.position, wanderRouteRadius, nearbyNodes);
+		nearbyNodes.erase(std::remove_if(nearbyNodes.begin(), nearbyNodes.end(),
+			[&](AIGraph::NodeIndex n) {
+				return n == current || graph.nodes[n].type != node.type || graph.nodes[n].disabled;
+			}), nearbyNodes.end());
+		if( ! nearbyNodes.empty() )
+		{
+			std::uniform_int_distribution<size_t> d(0, nearbyNodes.size()-1);
+			auto goal = nearbyNodes[d(random)];
+			route = world->routePlanner->findCachedRoute(current, goal, node.type);
+			if( route )
+			{
+				routeStep = 1;
+			}
+			else
+			{
+				routeRequest = world->routePlanner->requestRoute(current, goal, node.type);
+			}
+		}
+	}
+
+	if( routeRequest && routeRequest->isReady() )
+	{
+		// The route starts where it was requested, which may be behind us now
+		route = routeRequest->route;
+		routeRequest.reset();
+		auto it = std::find(route->nodes.begin(), route->nodes.end(), current);
+		routeStep = (it == route->nodes.end()) ? route->nodes.size() : (it - route->nodes.begin()) + 1;
+	}
+
+	if( route )
+	{
+		if( routeStep < route->nodes.size() && ! graph.nodes[route->nodes[routeStep]].disabled )
+		{
+			return route->nodes[routeStep++];
+		}
+		route.reset();
+	}
+
+	// Wander at random until there's a route to follow
+	if( node.connectionCount > 0 )
+	{
+		std::uniform_int_distribution<uint32_t> d(0, node.connectionCount-1);
+		return graph.getConnection(current, d(random));
+	}
+	return current;
+}
+
 void DefaultAIController::update(float dt)
 {
 	switch(currentGoal)
@@ -57,40 +122,26 @@ void DefaultAIController::update(float dt)
 		break;
 		case TrafficWander:
 		{
-			if( targetNode )
+			auto& graph = getCharacter()->engine->aigraph;
+			if( targetNode != AIGraph::NoNode )
 			{
-				auto targetDistance = glm::vec2(character->getPosition() - targetNode->position);
+				auto& target = graph.nodes[targetNode];
+				auto targetDistance = glm::vec2(character->getPosition() - target.position);
 				if( glm::length(targetDistance) <= 0.1f )
 				{
 					// Assign the next target node
-					auto lastTarget = targetNode;
-					std::random_device rd;
-					std::default_random_engine re(rd());
-					std::uniform_int_distribution<> d(0, lastTarget->connections.size()-1);
-					targetNode = lastTarget->connections.at(d(re));
-					setNextActivity(new Activities::GoTo(targetNode->position));
+					targetNode = nextWanderNode(targetNode);
+					setNextActivity(new Activities::GoTo(graph.nodes[targetNode].position));
 				}
 				else if ( getCurrentActivity() == nullptr )
 				{
-					setNextActivity(new Activities::GoTo(targetNode->position));
+					setNextActivity(new Activities::GoTo(target.position));
 				}
 			}
 			else
 			{
 				// We need to pick an initial node
-				auto& graph = getCharacter()->engine->aigraph;
-				AIGraphNode* node = nullptr;
-				float mindist = std::numeric_limits<float>::max();
-				for( auto n : graph.nodes )
-				{
-					float d = glm::distance( n->position, getCharacter()->getPosition() );
-					if( d < mindist )
-					{
-						node = n;
-						mindist = d;
-					}
-				}
-				targetNode = node;
+				targetNode = graph.findNearestNode(getCharacter()->getPosition());
 			}
 		}
 		break;
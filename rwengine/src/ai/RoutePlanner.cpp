@@ -0,0 +1,272 @@
+#include <ai/RoutePlanner.hpp>
+#include <ai/AIGraphNode.hpp>
+
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+RoutePlanner::RoutePlanner(const AIGraph& graph, std::size_t cacheSize)
+	: graph(graph)
+	, cacheSize(cacheSize)
+	, snapshotRevision(0)
+	, snapshotTopologyRevision(0)
+	, stopping(false)
+{
+}
+
+RoutePlanner::~RoutePlanner()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+RoutePlanner::RouteKey RoutePlanner::makeKey(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type)
+{
+	return (uint64_t(uint32_t(start)) << 33)
+			| (uint64_t(uint32_t(goal)) << 1)
+			| (type == AIGraphNode::Vehicle ? 1 : 0);
+}
+
+void RoutePlanner::updateSnapshot()
+{
+	if (snapshot && snapshotRevision == graph.getRevision()) {
+		return;
+	}
+
+	auto copy = std::make_shared<GraphSnapshot>();
+	auto count = graph.nodes.size();
+
+	if (snapshot && snapshotTopologyRevision == graph.getTopologyRevision()) {
+		// Only nodes have been enabled or disabled
+		copy->topology = snapshot->topology;
+	}
+	else {
+		auto topology = std::make_shared<GraphTopology>();
+		topology->positions.reserve(count);
+		topology->types.reserve(count);
+		topology->firstEdge.reserve(count + 1);
+		topology->edges.reserve(graph.edges.size());
+
+		for (std::size_t n = 0; n < count; ++n) {
+			auto& node = graph.nodes[n];
+			topology->positions.push_back(node.position);
+			topology->types.push_back(node.type);
+			topology->firstEdge.push_back(topology->edges.size());
+			graph.forEachConnection(n, [&](AIGraph::NodeIndex c) {
+				topology->edges.push_back(c);
+			});
+		}
+		topology->firstEdge.push_back(topology->edges.size());
+		copy->topology = topology;
+	}
+
+	copy->disabled.reserve(count);
+	for (auto& node : graph.nodes) {
+		copy->disabled.push_back(node.disabled);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	snapshot = copy;
+	snapshotRevision = graph.getRevision();
+	snapshotTopologyRevision = graph.getTopologyRevision();
+	// Routes planned on the old graph may no longer be valid
+	cache.clear();
+}
+
+RouteRequestRef RoutePlanner::requestRoute(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type)
+{
+	updateSnapshot();
+
+	auto key = makeKey(start, goal, type);
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	auto cached = cache.find(key);
+	if (cached != cache.end()) {
+		auto request = std::make_shared<RouteRequest>(start, goal, type);
+		request->route = cached->second;
+		request->ready.store(true, std::memory_order_release);
+		return request;
+	}
+
+	auto inFlight = pending.find(key);
+	if (inFlight != pending.end()) {
+		return inFlight->second;
+	}
+
+	auto request = std::make_shared<RouteRequest>(start, goal, type);
+	pending[key] = request;
+	queue.push_back(request);
+
+	if (! worker.joinable()) {
+		worker = std::thread(&RoutePlanner::workerMain, this);
+	}
+
+	lock.unlock();
+	wake.notify_one();
+
+	return request;
+}
+
+RouteRef RoutePlanner::findCachedRoute(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type)
+{
+	updateSnapshot();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto cached = cache.find(makeKey(start, goal, type));
+	return cached != cache.end() ? cached->second : nullptr;
+}
+
+RouteRef RoutePlanner::planRoute(AIGraph::NodeIndex start, AIGraph::NodeIndex goal, AIGraphNode::NodeType type)
+{
+	updateSnapshot();
+
+	std::shared_ptr<const GraphSnapshot> current;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		current = snapshot;
+	}
+
+	SearchState state;
+	return search(*current, state, start, goal, type);
+}
+
+std::size_t RoutePlanner::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.size();
+}
+
+std::size_t RoutePlanner::getCachedCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return cache.size();
+}
+
+void RoutePlanner::workerMain()
+{
+	SearchState state;
+
+	for (;;) {
+		RouteRequestRef request;
+		std::shared_ptr<const GraphSnapshot> current;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this]() { return stopping || ! queue.empty(); });
+			if (stopping) {
+				return;
+			}
+			request = queue.front();
+			queue.pop_front();
+			current = snapshot;
+		}
+
+		auto route = search(*current, state, request->start, request->goal, request->type);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto key = makeKey(request->start, request->goal, request->type);
+			pending.erase(key);
+
+			// Don't cache routes through a graph that has since changed
+			if (current == snapshot) {
+				// Crude, but cheap: start over once the cache is full
+				if (cache.size() >= cacheSize) {
+					cache.clear();
+				}
+				cache[key] = route;
+			}
+		}
+
+		request->route = route;
+		request->ready.store(true, std::memory_order_release);
+	}
+}
+
+RouteRef RoutePlanner::search(const GraphSnapshot& current, SearchState& state,
+							  AIGraph::NodeIndex start, AIGraph::NodeIndex goal,
+							  AIGraphNode::NodeType type)
+{
+	auto route = std::make_shared<Route>();
+	auto& graph = *current.topology;
+
+	auto count = AIGraph::NodeIndex(graph.positions.size());
+	auto usable = [&](AIGraph::NodeIndex n) {
+		return graph.types[n] == type && ! current.disabled[n];
+	};
+	if (start < 0 || goal < 0 || start >= count || goal >= count ||
+	        ! usable(start) || ! usable(goal)) {
+		return route;
+	}
+
+	if (state.visited.size() != graph.positions.size()) {
+		state.cost.assign(count, 0.f);
+		state.cameFrom.assign(count, AIGraph::NoNode);
+		state.visited.assign(count, 0);
+		state.search = 0;
+	}
+	state.search++;
+
+	// Open set entries are (estimated total cost, node). Nodes can be pushed
+	// more than once; stale entries are skipped when popped.
+	typedef std::pair<float, AIGraph::NodeIndex> OpenEntry;
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+
+	auto& goalPosition = graph.positions[goal];
+	state.cost[start] = 0.f;
+	state.cameFrom[start] = AIGraph::NoNode;
+	state.visited[start] = state.search;
+	open.push({ glm::distance(graph.positions[start], goalPosition), start });
+
+	bool found = false;
+	while (! open.empty()) {
+		auto entry = open.top();
+		open.pop();
+		auto node = entry.second;
+
+		if (node == goal) {
+			found = true;
+			break;
+		}
+
+		float estimate = state.cost[node] + glm::distance(graph.positions[node], goalPosition);
+		if (entry.first > estimate) {
+			continue;
+		}
+
+		for (auto e = graph.firstEdge[node]; e < graph.firstEdge[node + 1]; ++e) {
+			auto next = graph.edges[e];
+			if (! usable(next)) {
+				continue;
+			}
+
+			float cost = state.cost[node] + glm::distance(graph.positions[node], graph.positions[next]);
+			if (state.visited[next] == state.search && cost >= state.cost[next]) {
+				continue;
+			}
+
+			state.visited[next] = state.search;
+			state.cost[next] = cost;
+			state.cameFrom[next] = node;
+			open.push({ cost + glm::distance(graph.positions[next], goalPosition), next });
+		}
+	}
+
+	if (found) {
+		for (auto n = goal; n != AIGraph::NoNode; n = state.cameFrom[n]) {
+			route->nodes.push_back(n);
+		}
+		std::reverse(route->nodes.begin(), route->nodes.end());
+	}
+
+	return route;
+}
@@ -22,42 +22,43 @@ maximumPedestrians(20), maximumCars(10)
 
 }
 
-std::vector< AIGraphNode* > TrafficDirector::findAvailableNodes(AIGraphNode::NodeType type, const ViewCamera& camera, float radius)
+const std::vector<AIGraph::NodeIndex>& TrafficDirector::findAvailableNodes(AIGraphNode::NodeType type, const ViewCamera& camera, float radius)
 {
-	std::vector<AIGraphNode*> available;
-	available.reserve(20);
+	auto& available = availableNodes;
+	available.clear();
 
 	graph->gatherExternalNodesNear(camera.position, radius, available);
 
 	float density = type == AIGraphNode::Vehicle ? carDensity : pedDensity;
-	float minDist = (10.f / density) * (10.f / density);
+	float minDist = 10.f / density;
 	float halfRadius2 = std::pow(radius / 2.f, 2.f);
 
+	// Test whether the nodes are in the view frustum all at once
+	spawnSpheres.clear();
+	for (AIGraph::NodeIndex node : available) {
+		spawnSpheres.add(graph->nodes[node].position, 1.f);
+	}
+	camera.frustum.intersects(spawnSpheres, spawnMask);
+
 	// Check if any of the nearby nodes are blocked by a pedestrian standing on it
 	// or because it's inside the view frustum
-	for (auto it = available.begin(); it != available.end();) {
-		bool blocked = false;
-		float dist2 = glm::distance2(camera.position, (*it)->position);
-
-		for (auto& obj : world->pedestrianPool.objects) {
-			if (glm::distance2( (*it)->position, obj.second->getPosition() ) <= minDist) {
-				blocked = true;
-				break;
-			}
-		}
+	auto unblocked = available.begin();
+	for (std::size_t i = 0; i < available.size(); ++i) {
+		AIGraph::NodeIndex node = available[i];
+		auto& position = graph->nodes[node].position;
+		bool blocked = world->pedestrianHash.anyWithin(position, minDist);
+		float dist2 = glm::distance2(camera.position, position);
 
 		// Check that we're not going to spawn something right where the player is looking
-		if (dist2 <= halfRadius2 && camera.frustum.intersects((*it)->position, 1.f)) {
+		if (dist2 <= halfRadius2 && ViewFrustum::isVisible(spawnMask, i)) {
 			blocked = true;
 		}
-		
-		if (blocked) {
-			it = available.erase( it );
-		}
-		else {
-			it++;
+
+		if (!blocked) {
+			*unblocked++ = node;
 		}
 	}
+	available.erase(unblocked, available.end());
 
 	return available;
 }
@@ -89,46 +90,59 @@ std::vector<GameObject*> TrafficDirector::populateNearby(const ViewCamera& camer
 
 	// Spawn vehicles at vehicle generators
 	auto camera2D = glm::vec2(camera.position);
+	nearbyGenerators.clear();
+	groundPositions.clear();
 	for (auto& gen : world->state->vehicleGenerators) {
 		/// @todo verify how vehicle generator proximity is determined
 		auto gen2D = glm::vec2(gen.position);
-		float dist2 = glm::distance2(camera2D, gen2D);
-		if (dist2 < radius * radius) {
-			auto position = gen.position;
-			// Check that the on-ground position is not in view
+		if (glm::distance2(camera2D, gen2D) < radius * radius) {
+			nearbyGenerators.push_back(&gen);
 			if (gen.position.z < -90.f) {
-				position = world->getGroundAtPosition(position);
+				groundPositions.push_back(gen.position);
 			}
+		}
+	}
 
-			if (dist2 <= halfRadius2 &&
-			    camera.frustum.intersects(position, 1.f)) {
-				if (!gen.alwaysSpawn) {
-					// Don't spawn in the view frustum unless we're forced to
-					continue;
-				}
-			}
-			auto spawned = world->tryToSpawnVehicle(gen);
-			if (spawned) {
-				created.push_back(spawned);
+	// Probe for the ground under all of the generators that need it at once
+	world->getGroundAtPositions(groundPositions);
+
+	// Check that the on-ground positions are not in view
+	spawnSpheres.clear();
+	auto ground = groundPositions.begin();
+	for (VehicleGenerator* gen : nearbyGenerators) {
+		spawnSpheres.add(gen->position.z < -90.f ? *ground++ : gen->position, 1.f);
+	}
+	camera.frustum.intersects(spawnSpheres, spawnMask);
+
+	for (std::size_t i = 0; i < nearbyGenerators.size(); ++i) {
+		VehicleGenerator* gen = nearbyGenerators[i];
+		float dist2 = glm::distance2(camera2D, glm::vec2(gen->position));
+
+		if (dist2 <= halfRadius2 && ViewFrustum::isVisible(spawnMask, i)) {
+			if (!gen->alwaysSpawn) {
+				// Don't spawn in the view frustum unless we're forced to
+				continue;
 			}
 		}
+		auto spawned = world->tryToSpawnVehicle(*gen);
+		if (spawned) {
+			created.push_back(spawned);
+		}
 	}
 
-	auto type = AIGraphNode::Pedestrian;
-	auto available = findAvailableNodes(type, camera, radius);
-	
 	if( availablePeds <= 0 )
 	{
 		// We have already reached the limit of spawned traffic
-		return { };
+		return created;
 	}
+
+	auto type = AIGraphNode::Pedestrian;
+	auto& available = findAvailableNodes(type, camera, radius);
 	
 	/// Hardcoded cop Pedestrian
-	std::vector<uint16_t> validPeds = { 1 };
-	validPeds.insert(validPeds.end(), {20, 11, 19, 5});
-	std::random_device rd;
-	std::default_random_engine re(rd());
-	std::uniform_int_distribution<> d(0, validPeds.size()-1);
+	static const uint16_t validPeds[] = { 1, 20, 11, 19, 5 };
+	auto& random = world->random.stream(RandomService::Traffic);
+	std::uniform_int_distribution<> d(0, sizeof(validPeds) / sizeof(validPeds[0]) - 1);
 
 	int counter = availablePeds;
 	// maxSpawn can be -1 for "as many as possible"
@@ -137,9 +151,10 @@ std::vector<GameObject*> TrafficDirector::populateNearby(const ViewCamera& camer
 		counter = std::min( availablePeds, maxSpawn );
 	}
 
-	for ( AIGraphNode* spawn : available )
+	for ( AIGraph::NodeIndex node : available )
 	{
-		if( spawn->type != AIGraphNode::Pedestrian )
+		auto& spawn = graph->nodes[node];
+		if( spawn.type != AIGraphNode::Pedestrian )
 		{
 			continue;
 		}
@@ -153,7 +168,7 @@ std::vector<GameObject*> TrafficDirector::populateNearby(const ViewCamera& camer
 		}
 
 		// Spawn a pedestrian from the available pool
-		auto ped = world->createPedestrian(validPeds[d(re)], spawn->position + glm::vec3( 0.f, 0.f, 1.f ) );
+		auto ped = world->createPedestrian(validPeds[d(random)], spawn.position + glm::vec3( 0.f, 0.f, 1.f ) );
 		ped->setLifetime(GameObject::TrafficLifetime);
 		ped->controller->setGoal(CharacterController::TrafficWander);
 		created.push_back( ped );
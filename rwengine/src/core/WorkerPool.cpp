@@ -0,0 +1,115 @@
+#include <core/WorkerPool.hpp>
+
+#include <algorithm>
+
+namespace
+{
+/// Set while a thread is running part of a loop
+thread_local bool insideBatch = false;
+}
+
+WorkerPool::WorkerPool(unsigned int threads)
+	: threadCount(threads)
+	, batchNumber(0)
+	, busyWorkers(0)
+	, stopping(false)
+	, batchFunction(nullptr)
+	, batchLast(0)
+	, batchGrain(1)
+	, nextIndex(0)
+{
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	batchStart.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void WorkerPool::parallelFor(std::size_t first, std::size_t last, std::size_t grainSize, const RangeFunction& function)
+{
+	if (first >= last) {
+		return;
+	}
+	grainSize = std::max<std::size_t>(grainSize, 1);
+
+	if (threadCount < 2 || last - first <= grainSize || insideBatch || ! batchOwner.try_lock()) {
+		function(first, last);
+		return;
+	}
+	std::lock_guard<std::mutex> owner(batchOwner, std::adopt_lock);
+
+	if (workers.empty()) {
+		startWorkers();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		batchFunction = &function;
+		batchLast = last;
+		batchGrain = grainSize;
+		nextIndex = first;
+		busyWorkers = workers.size();
+		batchNumber++;
+	}
+	batchStart.notify_all();
+
+	// The calling thread takes a share of the work too
+	runBatch();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	batchDone.wait(lock, [this]() { return busyWorkers == 0; });
+	batchFunction = nullptr;
+}
+
+void WorkerPool::startWorkers()
+{
+	for (unsigned int i = 1; i < threadCount; ++i) {
+		workers.emplace_back(&WorkerPool::workerMain, this);
+	}
+}
+
+void WorkerPool::workerMain()
+{
+	uint64_t lastBatch = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			batchStart.wait(lock, [&]() { return stopping || batchNumber != lastBatch; });
+			if (stopping) {
+				return;
+			}
+			lastBatch = batchNumber;
+		}
+
+		runBatch();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busyWorkers--;
+		}
+		batchDone.notify_one();
+	}
+}
+
+void WorkerPool::runBatch()
+{
+	insideBatch = true;
+	for (;;) {
+		std::size_t first = nextIndex.fetch_add(batchGrain);
+		if (first >= batchLast) {
+			break;
+		}
+		(*batchFunction)(first, std::min(first + batchGrain, batchLast));
+	}
+	insideBatch = false;
+}
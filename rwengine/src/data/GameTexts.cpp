@@ -0,0 +1,87 @@
+#include <data/GameTexts.hpp>
+
+#include <algorithm>
+
+GameTexts::Key GameTexts::makeKey(const char* id, std::size_t length)
+{
+	if (length == 0 || length > 8) {
+		return 0;
+	}
+	Key key = 0;
+	for (std::size_t c = 0; c < 8; ++c) {
+		key <<= 8;
+		if (c < length) {
+			key |= static_cast<unsigned char>(id[c]);
+		}
+	}
+	return key;
+}
+
+void GameTexts::addText(const std::string& id, const std::string& text)
+{
+	addText(id.data(), id.size(), text.data(), text.size());
+}
+
+void GameTexts::addText(const char* id, std::size_t idLength, const char* text, std::size_t textLength)
+{
+	auto key = makeKey(id, idLength);
+	if (key == 0) {
+		return;
+	}
+
+	Entry entry { key, static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(textLength) };
+	if (entries.empty() || entries.back().key < key) {
+		entries.push_back(entry);
+	}
+	else {
+		auto it = std::lower_bound(entries.begin(), entries.end(), key,
+								   [](const Entry& e, Key k) { return e.key < k; });
+		if (it != entries.end() && it->key == key) {
+			return;
+		}
+		entries.insert(it, entry);
+	}
+
+	blob.append(text, textLength);
+	blob.push_back('\0');
+}
+
+const GameTexts::Entry* GameTexts::find(const std::string& id) const
+{
+	auto key = makeKey(id.data(), id.size());
+	if (key == 0) {
+		return nullptr;
+	}
+	auto it = std::lower_bound(entries.begin(), entries.end(), key,
+							   [](const Entry& e, Key k) { return e.key < k; });
+	if (it == entries.end() || it->key != key) {
+		return nullptr;
+	}
+	return &*it;
+}
+
+GameTexts::TextView GameTexts::text(const std::string& id) const
+{
+	auto entry = find(id);
+	if (entry) {
+		return TextView(blob.data() + entry->offset, entry->size);
+	}
+	return TextView(id.data(), id.size());
+}
+
+bool GameTexts::hasText(const std::string& id) const
+{
+	return find(id) != nullptr;
+}
+
+void GameTexts::reserve(std::size_t count, std::size_t bytes)
+{
+	entries.reserve(count);
+	blob.reserve(bytes);
+}
+
+void GameTexts::clear()
+{
+	entries.clear();
+	blob.clear();
+}
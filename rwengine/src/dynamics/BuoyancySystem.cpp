@@ -0,0 +1,304 @@
+#include <dynamics/BuoyancySystem.hpp>
+#include <dynamics/CollisionInstance.hpp>
+#include <engine/GameData.hpp>
+#include <engine/GameWorld.hpp>
+#include <objects/InstanceObject.hpp>
+#include <objects/VehicleObject.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+BuoyancySystem::BuoyancySystem(GameWorld* world)
+	: world(world)
+{
+}
+
+float BuoyancySystem::getWaveHeight(float time, const glm::vec3& ws)
+{
+	return (1.f + std::sin(time + (ws.x + ws.y) * WATER_SCALE)) * WATER_HEIGHT;
+}
+
+void BuoyancySystem::getWaveHeights(float time, const glm::vec3* points, float* heights, std::size_t count)
+{
+	// The phases are computed in one pass and the sines in a second, each
+	// over contiguous floats
+	for (std::size_t i = 0; i < count; ++i) {
+		heights[i] = time + (points[i].x + points[i].y) * WATER_SCALE;
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		heights[i] = (1.f + std::sin(heights[i])) * WATER_HEIGHT;
+	}
+}
+
+int BuoyancySystem::getCell(const glm::vec3& ws)
+{
+	auto wX = (int) ((ws.x + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
+	auto wY = (int) ((ws.y + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
+	if (wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 && wY < WATER_HQ_DATA_SIZE) {
+		return (wX*WATER_HQ_DATA_SIZE) + wY;
+	}
+	return -1;
+}
+
+void BuoyancySystem::updateCandidates()
+{
+	auto data = world->data;
+
+	vehicleCandidates.clear();
+	for (GameObject* object : world->vehiclePool.objects) {
+		auto vehicle = static_cast<VehicleObject*>(object);
+		if (! vehicle->physVehicle || vehicle->getSimulationTier() == SimulationKinematic) {
+			continue;
+		}
+
+		bool awake = vehicle->physBody->isActive();
+		int cell = getCell(vehicle->getPosition());
+		bool overWater = cell >= 0 && data->realWater[cell] < NO_WATER_INDEX;
+
+		if (cell >= 0 && ! overWater) {
+			vehicle->inWater = false;
+		}
+		if ((awake || vehicle->inWater) && (overWater || (cell < 0 && vehicle->inWater))) {
+			vehicleCandidates.push_back(vehicle);
+		}
+		else if (awake) {
+			// Keep the entry test from mistaking driving off a dry cell for
+			// surfacing in a tunnel
+			btVector3 bbmin, bbmax;
+			vehicle->physBody->getAabb(bbmin, bbmax);
+			vehicle->_lastHeight = bbmin.z();
+		}
+	}
+
+	instanceCandidates.clear();
+	for (GameObject* object : world->instancePool.activeObjects) {
+		auto instance = static_cast<InstanceObject*>(object);
+		if (! instance->dynamics || ! instance->body || instance->body->body->isStaticObject()) {
+			continue;
+		}
+
+		auto body = instance->body->body;
+		bool awake = body->isActive();
+		auto& origin = body->getWorldTransform().getOrigin();
+		glm::vec3 ws(origin.x(), origin.y(), origin.z());
+		int cell = getCell(ws);
+		bool overWater = cell >= 0 && data->realWater[cell] < NO_WATER_INDEX;
+
+		if (cell >= 0 && ! overWater) {
+			instance->inWater = false;
+		}
+		if ((awake || instance->inWater) && (overWater || (cell < 0 && instance->inWater))) {
+			instanceCandidates.push_back(instance);
+		}
+		else if (awake) {
+			instance->_lastHeight = ws.z;
+		}
+	}
+}
+
+void BuoyancySystem::tickVehicles()
+{
+	tickVehicles(vehicleCandidates.data(), vehicleCandidates.size());
+}
+
+void BuoyancySystem::tickVehicles(VehicleObject* const* vehicles, std::size_t count)
+{
+	auto data = world->data;
+	float time = world->getGameTime();
+
+	// Sample the water under each vehicle
+	points.clear();
+	levels.clear();
+	bottoms.clear();
+	owners.clear();
+	for (std::size_t v = 0; v < count; ++v) {
+		auto vehicle = vehicles[v];
+		if (! vehicle->physVehicle) {
+			continue;
+		}
+
+		btVector3 bbmin, bbmax;
+		// This is in world space.
+		vehicle->physBody->getAabb(bbmin, bbmax);
+		auto ws = vehicle->getPosition();
+
+		int cell = getCell(ws);
+		if (cell < 0) {
+			vehicle->_lastHeight = bbmin.z();
+			continue;
+		}
+
+		int hI = data->realWater[cell];
+		if (hI < NO_WATER_INDEX) {
+			points.push_back(ws);
+			levels.push_back(data->waterHeights[hI]);
+			bottoms.push_back(bbmin.z());
+			owners.push_back(v);
+		}
+		else {
+			vehicle->inWater = false;
+			vehicle->_lastHeight = bbmin.z();
+		}
+	}
+
+	heights.resize(points.size());
+	getWaveHeights(time, points.data(), heights.data(), points.size());
+
+	for (std::size_t s = 0; s < points.size(); ++s) {
+		auto vehicle = vehicles[owners[s]];
+		float wH = levels[s] + heights[s];
+		float vH = bottoms[s];
+		// If the vehicle is currently underwater
+		if (vH <= wH) {
+			// and was not underwater here in the last tick, we are for real
+			// underwater. Otherwise it's just a tunnel or something.
+			if (vehicle->_lastHeight >= wH) {
+				vehicle->inWater = true;
+			}
+		}
+		else {
+			// The water is beneath us
+			vehicle->inWater = false;
+		}
+		vehicle->_lastHeight = vH;
+	}
+
+	// Collect the float points of each vehicle in the water; these try to
+	// stay at the water level.
+	points.clear();
+	levels.clear();
+	offsets.clear();
+	owners.clear();
+	for (std::size_t v = 0; v < count; ++v) {
+		auto vehicle = vehicles[v];
+		if (! vehicle->physVehicle || ! vehicle->inWater) {
+			continue;
+		}
+
+		// Ensure that vehicles don't fall asleep at the top of a wave.
+		if (! vehicle->physBody->isActive()) {
+			vehicle->physBody->activate(true);
+		}
+
+		auto& handling = vehicle->info->handling;
+		float bbZ = handling.dimensions.z/2.f;
+		float oZ = -bbZ/2.f + (bbZ * (handling.percentSubmerged/120.f));
+		if (vehicle->vehicle->type == VehicleData::BOAT) {
+			oZ = 0.f;
+		}
+
+		auto position = vehicle->getPosition();
+		auto rotation = vehicle->getRotation();
+		const glm::vec3 floats[] = {
+			glm::vec3(0.f, handling.dimensions.y/2.f, oZ),
+			glm::vec3(0.f, -handling.dimensions.y/2.f, oZ),
+			glm::vec3(handling.dimensions.x/2.f, 0.f, oZ),
+			glm::vec3(-handling.dimensions.x/2.f, 0.f, oZ),
+		};
+		for (auto& f : floats) {
+			auto relPt = rotation * f;
+			auto ws = position + relPt;
+			int cell = getCell(ws);
+			int wi = cell >= 0 ? data->realWater[cell] : 0;
+			if (wi == NO_WATER_INDEX) {
+				continue;
+			}
+			points.push_back(ws);
+			offsets.push_back(relPt);
+			levels.push_back(data->waterHeights[wi]);
+			owners.push_back(v);
+		}
+	}
+
+	heights.resize(points.size());
+	getWaveHeights(time, points.data(), heights.data(), points.size());
+
+	// Impulses are applied in order, as each changes the velocity the next
+	// one damps against.
+	for (std::size_t s = 0; s < points.size(); ++s) {
+		float h = levels[s] + heights[s];
+		if (points[s].z <= h) {
+			auto body = vehicles[owners[s]]->physBody;
+			float x = (h - points[s].z);
+			float F = WATER_BUOYANCY_K * x + -WATER_BUOYANCY_C * body->getLinearVelocity().z();
+			auto& relPt = offsets[s];
+			body->applyImpulse(btVector3(0.f, 0.f, F),
+			                   btVector3(relPt.x, relPt.y, relPt.z));
+		}
+	}
+}
+
+void BuoyancySystem::tickInstances()
+{
+	tickInstances(instanceCandidates.data(), instanceCandidates.size());
+}
+
+void BuoyancySystem::tickInstances(InstanceObject* const* instances, std::size_t count)
+{
+	auto data = world->data;
+
+	points.clear();
+	levels.clear();
+	owners.clear();
+	for (std::size_t i = 0; i < count; ++i) {
+		auto instance = instances[i];
+		if (! instance->dynamics || ! instance->body) {
+			continue;
+		}
+
+		auto& origin = instance->body->body->getWorldTransform().getOrigin();
+		glm::vec3 ws(origin.x(), origin.y(), origin.z());
+		instance->_lastHeight = ws.z;
+
+		int cell = getCell(ws);
+		int wi = cell >= 0 ? data->realWater[cell] : 0;
+		if (wi == NO_WATER_INDEX) {
+			instance->inWater = false;
+			continue;
+		}
+		// Outside the water grid the water state is left as it is
+		if (cell < 0 && ! instance->inWater) {
+			continue;
+		}
+		points.push_back(ws);
+		levels.push_back(data->waterHeights[wi]);
+		owners.push_back(i);
+	}
+
+	heights.resize(points.size());
+	getWaveHeights(world->getGameTime(), points.data(), heights.data(), points.size());
+
+	for (std::size_t s = 0; s < points.size(); ++s) {
+		auto instance = instances[owners[s]];
+		auto& ws = points[s];
+		if (getCell(ws) >= 0) {
+			instance->inWater = ws.z <= levels[s] + heights[s];
+		}
+		if (! instance->inWater) {
+			continue;
+		}
+
+		auto body = instance->body->body;
+		float oZ = -(instance->body->collisionHeight * (instance->dynamics->bouancy/100.f));
+		body->activate(true);
+		// Damper motion
+		body->setDamping(0.95f, 0.9f);
+
+		float h = levels[s] + oZ + heights[s];
+		if (ws.z <= h) {
+			float x = (h - ws.z);
+			float F = WATER_BUOYANCY_K * x + -WATER_BUOYANCY_C * body->getLinearVelocity().z();
+			btVector3 forcePos = btVector3(0.f, 0.f, 2.f).rotate(
+						body->getOrientation().getAxis(), body->getOrientation().getAngle());
+			body->applyForce(btVector3(0.f, 0.f, F), forcePos);
+		}
+	}
+}
+
+void BuoyancySystem::removeObject(GameObject* object)
+{
+	vehicleCandidates.erase(std::remove(vehicleCandidates.begin(), vehicleCandidates.end(), object),
+	                        vehicleCandidates.end());
+	instanceCandidates.erase(std::remove(instanceCandidates.begin(), instanceCandidates.end(), object),
+	                         instanceCandidates.end());
+}
@@ -0,0 +1,140 @@
+#include <dynamics/PhysicsWorld.hpp>
+#include <core/WorkerPool.hpp>
+#include <rw/defines.hpp>
+
+#if RW_BULLET_THREADS
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
+#if BT_BULLET_VERSION >= 288
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#endif
+#include <LinearMath/btThreads.h>
+
+#include <algorithm>
+#include <vector>
+
+#if ! BT_THREADSAFE
+#error "ENABLE_BULLET_THREADS requires Bullet built with BT_THREADSAFE"
+#endif
+
+/**
+ * Runs Bullet's parallel loops on a WorkerPool.
+ */
+class PhysicsTaskScheduler : public btITaskScheduler
+{
+public:
+	PhysicsTaskScheduler(WorkerPool* workers)
+		: btITaskScheduler("OpenRW")
+		, workers(workers)
+		, threadCount(std::min<int>(workers->getThreadCount(), BT_MAX_THREAD_COUNT))
+		, previous(btGetTaskScheduler())
+		, older(newest)
+	{
+		btSetTaskScheduler(this);
+		newest = this;
+	}
+
+	~PhysicsTaskScheduler()
+	{
+		// Worlds may be destroyed in any order, so unlink this scheduler
+		// from wherever it is in the chain rather than only from the top,
+		// or Bullet could be left pointing at a destroyed scheduler
+		if (btGetTaskScheduler() == this) {
+			btSetTaskScheduler(previous);
+		}
+		for (auto s = newest; s != nullptr; s = s->older) {
+			if (s->previous == this) {
+				s->previous = previous;
+			}
+			if (s->older == this) {
+				s->older = older;
+			}
+		}
+		if (newest == this) {
+			newest = older;
+		}
+	}
+
+	int getMaxNumThreads() const override { return threadCount; }
+	int getNumThreads() const override { return threadCount; }
+	// The pool's size is fixed when it's created
+	void setNumThreads(int) override {}
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override
+	{
+		workers->parallelFor(iBegin, iEnd, grainSize, [&](std::size_t first, std::size_t last) {
+			body.forLoop(int(first), int(last));
+		});
+	}
+
+#if BT_BULLET_VERSION >= 288
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override
+	{
+		// Chunks are summed in order afterwards, so rounding doesn't depend on
+		// which thread finished first
+		grainSize = std::max(grainSize, 1);
+		std::vector<btScalar> sums((iEnd - iBegin + grainSize - 1) / grainSize, btScalar(0));
+		workers->parallelFor(iBegin, iEnd, grainSize, [&](std::size_t first, std::size_t last) {
+			sums[(first - iBegin) / grainSize] = body.sumLoop(int(first), int(last));
+		});
+
+		btScalar sum(0);
+		for (auto s : sums) {
+			sum += s;
+		}
+		return sum;
+	}
+#endif
+
+private:
+	WorkerPool* workers;
+	int threadCount;
+	/// The scheduler to put back once this one is gone
+	btITaskScheduler* previous;
+	/// The next older live scheduler, nullptr for the oldest
+	PhysicsTaskScheduler* older;
+	/// The most recently created live scheduler
+	static PhysicsTaskScheduler* newest;
+};
+
+PhysicsTaskScheduler* PhysicsTaskScheduler::newest = nullptr;
+#else
+class PhysicsTaskScheduler
+{
+};
+#endif
+
+PhysicsWorld::PhysicsWorld(btDispatcher* dispatcher, btBroadphaseInterface* broadphase,
+                           btCollisionConfiguration* collisionConfig, WorkerPool* workers)
+	: solver(nullptr)
+	, solverPool(nullptr)
+	, world(nullptr)
+{
+#if RW_BULLET_THREADS
+	if (workers && workers->getThreadCount() > 1) {
+		scheduler.reset(new PhysicsTaskScheduler(workers));
+
+		auto pool = new btConstraintSolverPoolMt(scheduler->getNumThreads());
+		solverPool = pool;
+#if BT_BULLET_VERSION >= 288
+		solver = new btSequentialImpulseConstraintSolverMt;
+		world = new btDiscreteDynamicsWorldMt(dispatcher, broadphase, pool, solver, collisionConfig);
+#else
+		world = new btDiscreteDynamicsWorldMt(dispatcher, broadphase, pool, collisionConfig);
+#endif
+		return;
+	}
+#else
+	RW_UNUSED(workers);
+#endif
+
+	solver = new btSequentialImpulseConstraintSolver;
+	world = new btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfig);
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+	delete world;
+	delete solver;
+	delete solverPool;
+}
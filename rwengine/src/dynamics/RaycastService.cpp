@@ -0,0 +1,131 @@
+#include <dynamics/RaycastService.hpp>
+#include <dynamics/RaycastCallbacks.hpp>
+#include <core/WorkerPool.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+
+#include <algorithm>
+
+namespace
+{
+/// Batches smaller than this aren't worth waking the workers for
+constexpr std::size_t kMinParallelRays = 64;
+/// Rays claimed by a thread at a time
+constexpr std::size_t kRayChunk = 16;
+
+/**
+ * Runs the narrowphase test for every broadphase leaf the ray passes through.
+ */
+struct RayLeafCollector : public btDbvt::ICollide
+{
+	btTransform from;
+	btTransform to;
+	btCollisionWorld::RayResultCallback& callback;
+
+	RayLeafCollector(const btVector3& rayFrom, const btVector3& rayTo,
+	                 btCollisionWorld::RayResultCallback& callback)
+		: callback(callback)
+	{
+		from.setIdentity();
+		from.setOrigin(rayFrom);
+		to.setIdentity();
+		to.setOrigin(rayTo);
+	}
+
+	void Process(const btDbvtNode* leaf)
+	{
+		auto proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+		auto object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+		if (callback.needsCollision(proxy)) {
+			btCollisionWorld::rayTestSingle(from, to, object,
+			                                object->getCollisionShape(),
+			                                object->getWorldTransform(),
+			                                callback);
+		}
+	}
+};
+
+struct RadiusCollector : public btBroadphaseAabbCallback
+{
+	btVector3 centre;
+	btScalar radius2;
+	std::vector<const btCollisionObject*>& out;
+
+	RadiusCollector(const btVector3& centre, btScalar radius,
+	                std::vector<const btCollisionObject*>& out)
+		: centre(centre), radius2(radius * radius), out(out)
+	{ }
+
+	bool process(const btBroadphaseProxy* proxy)
+	{
+		btVector3 closest = centre;
+		closest.setMax(proxy->m_aabbMin);
+		closest.setMin(proxy->m_aabbMax);
+		if ((closest - centre).length2() <= radius2) {
+			out.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject));
+		}
+		return true;
+	}
+};
+}
+
+RaycastService::RaycastService(btDbvtBroadphase* broadphase, WorkerPool* workers)
+	: broadphase(broadphase)
+	, workers(workers)
+{
+}
+
+unsigned int RaycastService::getThreadCount() const
+{
+	return workers ? workers->getThreadCount() : 1;
+}
+
+RaycastService::Hit RaycastService::cast(const Ray& ray) const
+{
+	btVector3 from(ray.from.x, ray.from.y, ray.from.z);
+	btVector3 to(ray.to.x, ray.to.y, ray.to.z);
+
+	ClosestNotMeRayResultCallback callback(const_cast<btCollisionObject*>(ray.ignore), from, to);
+	callback.m_collisionFilterGroup = ray.filterGroup;
+	callback.m_collisionFilterMask = ray.filterMask;
+
+	RayLeafCollector collector(from, to, callback);
+	btDbvt::rayTest(broadphase->m_sets[0].m_root, from, to, collector);
+	btDbvt::rayTest(broadphase->m_sets[1].m_root, from, to, collector);
+
+	Hit hit;
+	if (callback.hasHit()) {
+		hit.hit = true;
+		auto& p = callback.m_hitPointWorld;
+		auto& n = callback.m_hitNormalWorld;
+		hit.point = glm::vec3(p.x(), p.y(), p.z());
+		hit.normal = glm::vec3(n.x(), n.y(), n.z());
+		hit.fraction = callback.m_closestHitFraction;
+		hit.object = callback.m_collisionObject;
+	}
+	return hit;
+}
+
+void RaycastService::castBatch(const Ray* rays, Hit* hits, std::size_t count)
+{
+	auto castRange = [&](std::size_t first, std::size_t last) {
+		for (std::size_t i = first; i < last; ++i) {
+			hits[i] = cast(rays[i]);
+		}
+	};
+
+	if (workers == nullptr || count < kMinParallelRays) {
+		castRange(0, count);
+		return;
+	}
+
+	workers->parallelFor(0, count, kRayChunk, castRange);
+}
+
+void RaycastService::queryRadius(const glm::vec3& centre, float radius, std::vector<const btCollisionObject*>& out) const
+{
+	btVector3 c(centre.x, centre.y, centre.z);
+	btVector3 extent(radius, radius, radius);
+	RadiusCollector collector(c, radius, out);
+	broadphase->aabbTest(c - extent, c + extent, collector);
+}
@@ -36,7 +36,7 @@ void Animator::tick(float dt)
 				auto bit = state.animation->bones.find( model->frames[f]->getName() );
 				if( bit != state.animation->bones.end() )
 				{
-					state.boneInstances.insert( { bit->second, { f } } );
+					state.boneInstances.insert( { bit->second, { f, KeyframeCursor() } } );
 				}
 			}
 		}
@@ -56,7 +56,7 @@ void Animator::tick(float dt)
 		for( auto& b : state.boneInstances )
 		{
 			if (b.first->frames.size() == 0) continue;
-			auto kf = b.first->getInterpolatedKeyframe(animTime);
+			auto kf = b.first->getInterpolatedKeyframe(animTime, &b.second.cursor);
 
 			BoneTransform xform;
 			if(b.first->type == AnimationBone::R00 ) {
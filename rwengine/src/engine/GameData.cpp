@@ -9,6 +9,7 @@
 #include <data/WeaponData.hpp>
 #include <script/SCMFile.hpp>
 #include <data/Model.hpp>
+#include <dynamics/BuoyancySystem.hpp>
 
 #include <loaders/GenericDATLoader.hpp>
 #include <loaders/LoaderGXT.hpp>
@@ -87,6 +88,8 @@ std::string fixPath(std::string path) {
 
 GameData::GameData(Logger* log, WorkContext* work, const std::string& path)
 : datpath(path), logger(log), workContext(work), engine(nullptr)
+, geometryArenas(Model::CompactGeometryVertex::vertex_attributes(),
+				 sizeof(Model::CompactGeometryVertex))
 {
 }
 
@@ -435,17 +438,21 @@ void GameData::loadTXD(const std::string& name, bool async)
 void GameData::loadDFF(const std::string& name, bool async)
 {
 	auto realname = name.substr(0, name.size() - 4);
-	if( models.find(realname) != models.end() ) {
+	auto id = internAssetName(realname);
+	if( models.find(id) != models.end() ) {
 		return;
 	}
 
 	// Before starting the job make sure the file isn't loaded again.
 	loadedFiles.insert({name, true});
 
-	models[realname] = ModelRef( new ResourceHandle<Model>(realname) );
+	models[id] = ModelRef( new ResourceHandle<Model>(realname) );
 	
+	LoaderDFF loader;
+	loader.setGeometryArenas(&geometryArenas);
+
 	auto job = new BackgroundLoaderJob<Model, LoaderDFF> 
-	{ workContext, &this->index, name, models[realname] };
+	{ workContext, &this->index, name, models[id], loader };
 
 	if( async ) {
 		workContext->queueJob( job  );
@@ -558,7 +565,7 @@ int GameData::getWaterIndexAt(const glm::vec3 &ws) const
 
 float GameData::getWaveHeightAt(const glm::vec3 &ws) const
 {
-	return (1+sin(engine->getGameTime() + (ws.x + ws.y) * WATER_SCALE)) * WATER_HEIGHT;
+	return BuoyancySystem::getWaveHeight(engine->getGameTime(), ws);
 }
 
 bool GameData::isValidGameDirectory(const std::string& path)
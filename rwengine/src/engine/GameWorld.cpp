@@ -8,6 +8,11 @@
 #include <loaders/LoaderIDE.hpp>
 #include <ai/DefaultAIController.hpp>
 #include <ai/TrafficDirector.hpp>
+#include <ai/RoutePlanner.hpp>
+#include <dynamics/RaycastService.hpp>
+#include <dynamics/PhysicsWorld.hpp>
+#include <dynamics/BuoyancySystem.hpp>
+#include <core/WorkerPool.hpp>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <data/Model.hpp>
 #include <data/WeaponData.hpp>
@@ -20,6 +25,7 @@
 #include <objects/VehicleObject.hpp>
 #include <objects/CutsceneObject.hpp>
 #include <objects/ItemPickup.hpp>
+#include <objects/ProjectileObject.hpp>
 
 #include <data/CutsceneData.hpp>
 #include <loaders/LoaderCutsceneDAT.hpp>
@@ -86,23 +92,33 @@ public:
 	}
 };
 
-GameWorld::GameWorld(Logger* log, WorkContext* work, GameData* dat)
-	: logger(log), data(dat), randomEngine(rand()),
+GameWorld::GameWorld(Logger* log, WorkContext* work, GameData* dat, unsigned int workerThreads)
+	: logger(log), data(dat),
 	  _work( work ),
 	  paused(false)
 {
 	data->engine = this;
 	
+	workers = new WorkerPool(workerThreads);
+
 	collisionConfig = new btDefaultCollisionConfiguration;
+	// Collision dispatch stays serial: needsResponse and the contact callback
+	// touch game objects. Only island solving is spread across workers.
 	collisionDispatcher = new WorldCollisionDispatcher(collisionConfig);
-	broadphase = new btDbvtBroadphase();
-	solver = new btSequentialImpulseConstraintSolver;
-	dynamicsWorld = new btDiscreteDynamicsWorld(collisionDispatcher, broadphase, solver, collisionConfig);
+	auto dbvtBroadphase = new btDbvtBroadphase();
+	broadphase = dbvtBroadphase;
+	physics = new PhysicsWorld(collisionDispatcher, broadphase, collisionConfig, workers);
+	dynamicsWorld = physics->getDynamicsWorld();
+	raycasts = new RaycastService(dbvtBroadphase, workers);
+	buoyancy = new BuoyancySystem(this);
 	dynamicsWorld->setGravity(btVector3(0.f, 0.f, -9.81f));
 	broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(new btGhostPairCallback());
 	gContactProcessedCallback = ContactProcessedCallback;
 	dynamicsWorld->setInternalTickCallback(PhysicsTickCallback, this);
 
+	routePlanner = new RoutePlanner(aigraph);
+	trafficDirector = new TrafficDirector(&aigraph, this);
+
 	// Populate inventory items
 	for( auto& w : data->weaponData ) {
 		inventoryItems.push_back(
@@ -118,11 +134,15 @@ GameWorld::~GameWorld()
 		delete p;
 	}
 
-	delete dynamicsWorld;
-	delete solver;
+	delete trafficDirector;
+	delete routePlanner;
+	delete buoyancy;
+	delete raycasts;
+	delete physics;
 	delete broadphase;
 	delete collisionDispatcher;
 	delete collisionConfig;
+	delete workers;
 
 	/// @todo delete other things.
 }
@@ -144,8 +164,7 @@ bool GameWorld::placeItems(const std::string& name)
 		}
 		
 		// Attempt to Associate LODs.
-		for(auto& p: instancePool.objects) {
-			auto object = p.second;
+		for(auto& object : instancePool.objects) {
 			InstanceObject* instance = static_cast<InstanceObject*>(object);
 			if( !instance->object->LOD ) {
 				auto lodInstit = modelInstances.find("LOD" + instance->object->modelName.substr(3));
@@ -187,7 +206,7 @@ InstanceObject *GameWorld::createInstance(const uint16_t id, const glm::vec3& po
 			data->loadTXD(texturename + ".txd", true);
 		}
 
-		ModelRef m = data->models[modelname];
+		ModelRef m = data->findModel(modelname);
 
 		// Check for dynamic data.
 		auto dyit = data->dynamicObjectData.find(oi->modelName);
@@ -211,6 +230,7 @@ InstanceObject *GameWorld::createInstance(const uint16_t id, const glm::vec3& po
 
 		instancePool.insert(instance);
         allObjects.push_back(instance);
+		instanceIndex.insert(instance);
 
 		if( shouldBeOnGrid(instance) )
 		{
@@ -230,33 +250,22 @@ InstanceObject *GameWorld::createInstance(const uint16_t id, const glm::vec3& po
 
 void GameWorld::createTraffic(const ViewCamera& viewCamera)
 {
-	TrafficDirector director(&aigraph, this);
-	
-	director.populateNearby( viewCamera, kMaxTrafficSpawnRadius, 5 );
+	trafficDirector->populateNearby( viewCamera, kMaxTrafficSpawnRadius, 5 );
 }
 
 void GameWorld::cleanupTraffic(const ViewCamera& focus)
 {
-	for (auto& p : pedestrianPool.objects) {
-		if (p.second->getLifetime() != GameObject::TrafficLifetime) {
-			continue;
-		}
-		
-		if (glm::distance( focus.position, p.second->getPosition() ) >= kMaxTrafficCleanupRadius) {
-			if (! focus.frustum.intersects(p.second->getPosition(), 1.f)) {
-				destroyObjectQueued( p.second );
-			}
-		}
-	}
-	for ( auto& p : vehiclePool.objects ) {
-		if (p.second->getLifetime() != GameObject::TrafficLifetime) {
+	distantTraffic.clear();
+	pedestrianHash.queryOutside(focus.position, kMaxTrafficCleanupRadius, distantTraffic);
+	vehicleHash.queryOutside(focus.position, kMaxTrafficCleanupRadius, distantTraffic);
+
+	for (auto& p : distantTraffic) {
+		if (p->getLifetime() != GameObject::TrafficLifetime) {
 			continue;
 		}
 
-		if (glm::distance( focus.position, p.second->getPosition() ) >= kMaxTrafficCleanupRadius) {
-			if (! focus.frustum.intersects(p.second->getPosition(), 1.f)) {
-				destroyObjectQueued( p.second );
-			}
+		if (! focus.frustum.intersects(p->getPosition(), 1.f)) {
+			destroyObjectQueued( p );
 		}
 	}
 
@@ -327,7 +336,7 @@ CutsceneObject *GameWorld::createCutsceneObject(const uint16_t id, const glm::ve
 	}
 
 
-	ModelRef m = data->models[modelname];
+	ModelRef m = data->findModel(modelname);
 
 	auto instance = new CutsceneObject(
 		this,
@@ -359,7 +368,7 @@ VehicleObject *GameWorld::createVehicle(const uint16_t id, const glm::vec3& pos,
 		auto palit = data->vehiclePalettes.find(vti->modelName); // modelname is conveniently lowercase (usually)
 		if(palit != data->vehiclePalettes.end() && palit->second.size() > 0 ) {
 			 std::uniform_int_distribution<int> uniform(0, palit->second.size()-1);
-			 int set = uniform(randomEngine);
+			 int set = uniform(random.stream(RandomService::General));
 			 prim = data->vehicleColours[palit->second[set].first];
 			 sec = data->vehicleColours[palit->second[set].second];
 		}
@@ -375,7 +384,7 @@ VehicleObject *GameWorld::createVehicle(const uint16_t id, const glm::vec3& pos,
 			}
 		}
 		
-		ModelRef& m = data->models[vti->modelName];
+		ModelRef m = data->findModel(vti->modelName);
 		auto model = m->resource;
 		auto info = data->vehicleInfo.find(vti->handlingID);
 		if(model && info != data->vehicleInfo.end()) {
@@ -402,6 +411,7 @@ VehicleObject *GameWorld::createVehicle(const uint16_t id, const glm::vec3& pos,
 		vehicle->setGameObjectID(gid);
 
 		vehiclePool.insert( vehicle );
+		vehicleHash.insert( vehicle, vehicle->getPosition() );
         allObjects.push_back( vehicle );
 
 		return vehicle;
@@ -437,13 +447,14 @@ CharacterObject* GameWorld::createPedestrian(const uint16_t id, const glm::vec3&
 			data->loadTXD(texturename + ".txd");
 		}
 
-		ModelRef m = data->models[modelname];
+		ModelRef m = data->findModel(modelname);
 
 		if(m && m->resource) {
 			auto ped = new CharacterObject( this, pos, rot, m, pt );
 			ped->setGameObjectID(gid);
 			new DefaultAIController(ped);
 			pedestrianPool.insert( ped );
+			pedestrianHash.insert( ped, ped->getPosition() );
             allObjects.push_back( ped );
 			return ped;
 		}
@@ -464,7 +475,7 @@ CharacterObject* GameWorld::createPlayer(const glm::vec3& pos, const glm::quat&
 		data->loadDFF(modelname + ".dff");
 		data->loadTXD(texturename + ".txd");
 
-		ModelRef m = data->models[modelname];
+		ModelRef m = data->findModel(modelname);
 
 		if(m && m->resource) {
 			auto ped = new CharacterObject( this, pos, rot, m, nullptr );
@@ -472,6 +483,7 @@ CharacterObject* GameWorld::createPlayer(const glm::vec3& pos, const glm::quat&
 			ped->setLifetime(GameObject::PlayerLifetime);
 			players.push_back(new PlayerController(ped));
 			pedestrianPool.insert(ped);
+			pedestrianHash.insert(ped, ped->getPosition());
             allObjects.push_back( ped );
 			return ped;
 		}
@@ -511,37 +523,133 @@ PickupObject* GameWorld::createPickup(const glm::vec3& pos, int id, int type)
 
 void GameWorld::ObjectPool::insert(GameObject* object)
 {
-	if( object->getGameObjectID() == 0 )
+	uint32_t slotIndex;
+	auto id = object->getGameObjectID();
+
+	if( id == 0 )
 	{
-		// Find the lowest free GameObjectID.
-		GameObjectID availID = 1;
-		for( auto& p : objects )
-		{
-			if( p.first == availID ) availID++;
+		// Reuse a free slot, keeping its bumped generation
+		if( ! freeSlots.empty() ) {
+			slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else {
+			slotIndex = slots.size();
+			slots.emplace_back();
+		}
+		RW_CHECK(slotIndex <= kGameObjectIndexMask, "Object pool is full");
+
+		object->setGameObjectID( makeGameObjectID(slotIndex, slots[slotIndex].generation) );
+	}
+	else
+	{
+		// The caller picked the ID, so claim that exact slot.
+		slotIndex = gameObjectIndex(id);
+		while( slots.size() <= slotIndex ) {
+			freeSlots.push_back(slots.size());
+			slots.emplace_back();
+		}
+
+		auto& slot = slots[slotIndex];
+		if( slot.used ) {
+			RW_ERROR("Replacing existing object with ID " << id);
+			remove(objects[slot.index]);
+		}
+
+		auto it = std::find(freeSlots.begin(), freeSlots.end(), slotIndex);
+		if( it != freeSlots.end() ) {
+			freeSlots.erase(it);
 		}
+		slot.generation = gameObjectGeneration(id);
+	}
+
+	auto& slot = slots[slotIndex];
+	slot.used = true;
+	slot.index = objects.size();
+	objects.push_back(object);
 
-		object->setGameObjectID( availID );
+	if( object->isActive() ) {
+		addActive(slot, object);
 	}
-	objects[object->getGameObjectID()] = object;
 }
 
 GameObject* GameWorld::ObjectPool::find(GameObjectID id) const
 {
-	auto it = objects.find( id );
-	return (it == objects.end())? nullptr : it->second;
+	auto slotIndex = gameObjectIndex(id);
+	if( slotIndex >= slots.size() ) {
+		return nullptr;
+	}
+
+	const auto& slot = slots[slotIndex];
+	if( ! slot.used || slot.generation != gameObjectGeneration(id) ) {
+		return nullptr;
+	}
+	return objects[slot.index];
 }
 
 void GameWorld::ObjectPool::remove(GameObject* object)
 {
 	if( object )
 	{
-		auto it = objects.find(object->getGameObjectID());
-		if( it != objects.end() ) {
-			it = objects.erase(it);
+		if( find(object->getGameObjectID()) != object ) {
+			return;
 		}
+
+		auto& slot = slots[gameObjectIndex(object->getGameObjectID())];
+
+		if( slot.activeIndex != kInactive ) {
+			removeActive(slot);
+		}
+
+		// Fill the hole with the last object to keep the array dense.
+		GameObject* moved = objects.back();
+		objects[slot.index] = moved;
+		slots[gameObjectIndex(moved->getGameObjectID())].index = slot.index;
+		objects.pop_back();
+
+		// Invalidate any outstanding IDs for this slot, skipping 0
+		slot.used = false;
+		slot.generation = (slot.generation + 1) & kGameObjectGenerationMask;
+		if( slot.generation == 0 ) {
+			slot.generation = 1;
+		}
+		freeSlots.push_back(gameObjectIndex(object->getGameObjectID()));
+	}
+}
+
+void GameWorld::ObjectPool::updateActive(GameObject* object)
+{
+	// Objects that haven't been inserted yet are handled by insert()
+	if( find(object->getGameObjectID()) != object ) {
+		return;
+	}
+
+	auto& slot = slots[gameObjectIndex(object->getGameObjectID())];
+	bool listed = slot.activeIndex != kInactive;
+	if( object->isActive() && ! listed ) {
+		addActive(slot, object);
+	}
+	else if( ! object->isActive() && listed ) {
+		removeActive(slot);
 	}
 }
 
+void GameWorld::ObjectPool::addActive(Slot& slot, GameObject* object)
+{
+	slot.activeIndex = activeObjects.size();
+	activeObjects.push_back(object);
+}
+
+void GameWorld::ObjectPool::removeActive(Slot& slot)
+{
+	auto index = slot.activeIndex;
+	GameObject* moved = activeObjects.back();
+	activeObjects[index] = moved;
+	slots[gameObjectIndex(moved->getGameObjectID())].activeIndex = index;
+	activeObjects.pop_back();
+	slot.activeIndex = kInactive;
+}
+
 
 GameWorld::ObjectPool& GameWorld::getTypeObjectPool(GameObject* object)
 {
@@ -564,6 +672,18 @@ GameWorld::ObjectPool& GameWorld::getTypeObjectPool(GameObject* object)
 	}
 }
 
+SpatialHash* GameWorld::getTypeSpatialHash(GameObject* object)
+{
+	switch( object->type() ) {
+		case GameObject::Character:
+			return &pedestrianHash;
+		case GameObject::Vehicle:
+			return &vehicleHash;
+		default:
+			return nullptr;
+	}
+}
+
 GameObject*GameWorld::getBlipTarget(const BlipData& blip) const
 {
 	switch( blip.type )
@@ -581,6 +701,11 @@ GameObject*GameWorld::getBlipTarget(const BlipData& blip) const
 
 void GameWorld::destroyObject(GameObject* object)
 {
+	buoyancy->removeObject(object);
+	if (object->type() == GameObject::Instance) {
+		instanceIndex.remove(static_cast<InstanceObject*>(object));
+	}
+
 	auto coord = worldToGrid(glm::vec2(object->getPosition()));
 	if( coord.x < 0 || coord.y < 0 || coord.x >= WORLD_GRID_WIDTH || coord.y >= WORLD_GRID_WIDTH )
 	{
@@ -592,6 +717,10 @@ void GameWorld::destroyObject(GameObject* object)
 	auto& pool = getTypeObjectPool(object);
 	pool.remove(object);
 
+	if (auto hash = getTypeSpatialHash(object)) {
+		hash->remove(object);
+	}
+
 	auto it = std::find(allObjects.begin(), allObjects.end(), object);
 	RW_CHECK(it != allObjects.end(), "destroying object not in allObjects");
 	if (it != allObjects.end()) {
@@ -652,57 +781,243 @@ glm::ivec2 GameWorld::worldToGrid(const glm::vec2& world)
 	return glm::ivec2((world - glm::vec2(lowerCoord)) / glm::vec2(WORLD_CELL_SIZE));
 }
 
-VisualFX* GameWorld::createEffect(VisualFX::EffectType type)
+namespace
 {
-	auto effect = new VisualFX( type );
-	effects.push_back(effect);
-	return effect;
+/**
+ * Ticks every object in pool as a T. The qualified calls are resolved at
+ * compile time, keeping the loop free of virtual dispatch.
+ */
+template <class T>
+void tickObjectPool(GameWorld::ObjectPool& pool, std::vector<GameObject*>& tickList,
+					TransformStore& transforms, float dt)
+{
+	// Objects may (de)activate or spawn others while ticking, so iterate a copy.
+	tickList.assign(pool.activeObjects.begin(), pool.activeObjects.end());
+	for (GameObject* o : tickList) {
+		T* object = static_cast<T*>(o);
+		transforms.setLastTransform(object->getTransformSlot(),
+									object->T::getPosition(),
+									object->T::getRotation());
+		object->T::tick(dt);
+	}
+}
 }
 
-void GameWorld::destroyEffect(VisualFX* effect)
+void GameWorld::tickObjects(float dt)
 {
-	for( auto it = effects.begin(); it != effects.end(); )
-	{
-		if( *it == effect )
-		{
-			it = effects.erase( it );
+	simulationTick++;
+	updateSimulationTiers();
+	buoyancy->updateCandidates();
+
+	tickObjectPool<InstanceObject>(instancePool, tickList, transforms, dt);
+	buoyancy->tickInstances();
+
+	// Characters are split into two passes: every controller, batched by
+	// goal, then the characters themselves.
+	for (GameObject* o : pedestrianPool.activeObjects) {
+		auto character = static_cast<CharacterObject*>(o);
+		transforms.setLastTransform(character->getTransformSlot(),
+									character->CharacterObject::getPosition(),
+									character->CharacterObject::getRotation());
+	}
+	updateControllers(dt);
+	tickList.assign(pedestrianPool.activeObjects.begin(), pedestrianPool.activeObjects.end());
+	for (GameObject* o : tickList) {
+		static_cast<CharacterObject*>(o)->tickSimulation(dt);
+	}
+
+	tickObjectPool<VehicleObject>(vehiclePool, tickList, transforms, dt);
+	tickObjectPool<PickupObject>(pickupPool, tickList, transforms, dt);
+	tickObjectPool<ProjectileObject>(projectilePool, tickList, transforms, dt);
+	tickObjectPool<CutsceneObject>(cutscenePool, tickList, transforms, dt);
+
+	doQueuedWeaponScans();
+
+	particles.update(getGameTime(), dt, random.stream(RandomService::Effects));
+
+	for (GameObject* object : pedestrianPool.objects) {
+		pedestrianHash.update(object, object->getPosition());
+	}
+	for (GameObject* object : vehiclePool.objects) {
+		vehicleHash.update(object, object->getPosition());
+	}
+}
+
+void GameWorld::setSimulationFocus(const glm::vec3& focus)
+{
+	simulationFocus = focus;
+	hasSimulationFocus = true;
+}
+
+void GameWorld::updateSimulationTiers()
+{
+	glm::vec3 focus = simulationFocus;
+	if (! hasSimulationFocus) {
+		auto player = pedestrianPool.find(state ? state->playerObject : 0);
+		if (player == nullptr) {
+			return;
 		}
-		else
-		{
-			it++;
+		focus = player->getPosition();
+	}
+
+	for (GameObject* object : pedestrianPool.objects) {
+		auto character = static_cast<CharacterObject*>(object);
+
+		// Only wandering characters can be moved along their path without
+		// physics, and the player is always fully simulated
+		auto coarsest = SimulationReduced;
+		if (character->getLifetime() == GameObject::PlayerLifetime) {
+			coarsest = SimulationFull;
 		}
+		else if (character->controller &&
+		         character->controller->getGoal() == CharacterController::TrafficWander &&
+		         character->getCurrentVehicle() == nullptr) {
+			coarsest = SimulationKinematic;
+		}
+
+		float distance = glm::distance(focus, character->getPosition());
+		character->setSimulationTier(simulationLOD.selectTier(character->getSimulationTier(), distance, coarsest));
+	}
+
+	for (GameObject* object : vehiclePool.objects) {
+		auto vehicle = static_cast<VehicleObject*>(object);
+
+		// Vehicles floating in water or being driven keep their physics
+		auto coarsest = SimulationKinematic;
+		if (vehicle->isInWater() || vehicle->isOccupied()) {
+			coarsest = SimulationReduced;
+		}
+
+		float distance = glm::distance(focus, vehicle->getPosition());
+		vehicle->setSimulationTier(simulationLOD.selectTier(vehicle->getSimulationTier(), distance, coarsest));
 	}
 }
 
-void GameWorld::doWeaponScan(const WeaponScan &scan)
+bool GameWorld::isSimulationUpdateTick(const GameObject* object) const
 {
-	RW_CHECK(scan.type != WeaponScan::RADIUS, "Radius scans not implemented yet");
+	return simulationLOD.isUpdateTick(simulationTick, object->getGameObjectID());
+}
 
-	if( scan.type == WeaponScan::RADIUS ) {
-		// TODO
-		// Requires custom ConvexResultCallback
+void GameWorld::updateControllers(float dt)
+{
+	for (auto& bucket : controllerBuckets) {
+		bucket.clear();
 	}
-	else if( scan.type == WeaponScan::HITSCAN ) {
-		btVector3 from(scan.center.x, scan.center.y, scan.center.z),
-				to(scan.end.x, scan.end.y, scan.end.z);
-		glm::vec3 hitEnd = scan.end;
-		btCollisionWorld::ClosestRayResultCallback cb(from, to);
-		cb.m_collisionFilterGroup = btBroadphaseProxy::AllFilter;
-		dynamicsWorld->rayTest(from, to, cb);
-		// TODO: did any weapons penetrate?
-
-		if( cb.hasHit() ) {
-			GameObject* go = static_cast<GameObject*>(cb.m_collisionObject->getUserPointer());
+	for (GameObject* o : pedestrianPool.activeObjects) {
+		auto controller = static_cast<CharacterObject*>(o)->controller;
+		if (controller) {
+			controllerBuckets[controller->getGoal()].push_back(controller);
+		}
+	}
+	for (auto& bucket : controllerBuckets) {
+		for (CharacterController* controller : bucket) {
+			controller->update(dt);
+		}
+	}
+}
+
+size_t GameWorld::getActiveObjectCount() const
+{
+	return instancePool.activeObjects.size()
+			+ pedestrianPool.activeObjects.size()
+			+ vehiclePool.activeObjects.size()
+			+ pickupPool.activeObjects.size()
+			+ projectilePool.activeObjects.size()
+			+ cutscenePool.activeObjects.size();
+}
+
+namespace
+{
+RaycastService::Ray hitscanRay(const WeaponScan& scan)
+{
+	RaycastService::Ray ray(scan.center, scan.end);
+	ray.filterGroup = btBroadphaseProxy::AllFilter;
+	return ray;
+}
+
+void applyHitscanDamage(const WeaponScan& scan, const RaycastService::Hit& hit)
+{
+	// TODO: did any weapons penetrate?
+	if (! hit.hit) {
+		return;
+	}
+
+	GameObject* go = static_cast<GameObject*>(hit.object->getUserPointer());
+	if (go == nullptr) {
+		return;
+	}
+
+	GameObject::DamageInfo di;
+	di.damageLocation = hit.point;
+	di.damageSource = scan.center;
+	di.type = GameObject::DamageInfo::Bullet;
+	di.hitpoints = scan.damage;
+	go->takeDamage(di);
+}
+}
+
+void GameWorld::doWeaponScan(const WeaponScan &scan)
+{
+	if( scan.type == WeaponScan::RADIUS ) {
+		std::vector<const btCollisionObject*> bodies;
+		raycasts->queryRadius(scan.center, scan.radius, bodies);
+
+		// Objects can be made of more than one body, only damage them once
+		std::set<GameObject*> damaged;
+		for (auto body : bodies) {
+			GameObject* go = static_cast<GameObject*>(body->getUserPointer());
+			if (go == nullptr || ! damaged.insert(go).second) {
+				continue;
+			}
+
 			GameObject::DamageInfo di;
-			hitEnd = di.damageLocation = glm::vec3(cb.m_hitPointWorld.x(),
-								  cb.m_hitPointWorld.y(),
-								  cb.m_hitPointWorld.z() );
+			di.damageLocation = go->getPosition();
 			di.damageSource = scan.center;
-			di.type = GameObject::DamageInfo::Bullet;
+			di.type = GameObject::DamageInfo::Explosion;
 			di.hitpoints = scan.damage;
 			go->takeDamage(di);
 		}
 	}
+	else if( scan.type == WeaponScan::HITSCAN ) {
+		applyHitscanDamage(scan, raycasts->cast(hitscanRay(scan)));
+	}
+}
+
+void GameWorld::queueWeaponScan(const WeaponScan& scan)
+{
+	weaponScanQueue.push_back(scan);
+}
+
+void GameWorld::doQueuedWeaponScans()
+{
+	if (weaponScanQueue.empty()) {
+		return;
+	}
+
+	// Cast every hitscan ray together, then apply damage in the order the
+	// scans were queued
+	std::vector<RaycastService::Ray> rays;
+	for (auto& scan : weaponScanQueue) {
+		if (scan.type == WeaponScan::HITSCAN) {
+			rays.push_back(hitscanRay(scan));
+		}
+	}
+	std::vector<RaycastService::Hit> hits(rays.size());
+	raycasts->castBatch(rays.data(), hits.data(), rays.size());
+
+	// Damage may kill things that queue more scans
+	std::vector<WeaponScan> scans;
+	scans.swap(weaponScanQueue);
+
+	std::size_t hit = 0;
+	for (auto& scan : scans) {
+		if (scan.type == WeaponScan::HITSCAN) {
+			applyHitscanDamage(scan, hits[hit++]);
+		}
+		else {
+			doWeaponScan(scan);
+		}
+	}
 }
 
 int GameWorld::getHour()
@@ -717,19 +1032,33 @@ int GameWorld::getMinute()
 
 glm::vec3 GameWorld::getGroundAtPosition(const glm::vec3 &pos) const
 {
-	btVector3 rayFrom(pos.x, pos.y, 100.f);
-	btVector3 rayTo(pos.x, pos.y, -100.f);
+	auto hit = raycasts->cast({ glm::vec3(pos.x, pos.y, 100.f),
+								glm::vec3(pos.x, pos.y, -100.f) });
 
-	btDynamicsWorld::ClosestRayResultCallback rr(rayFrom, rayTo);
+	if (hit.hit) {
+		return hit.point;
+	}
 
-	dynamicsWorld->rayTest( rayFrom, rayTo, rr );
+	return pos;
+}
 
-	if(rr.hasHit()) {
-		auto& ws = rr.m_hitPointWorld;
-		return { ws.x(), ws.y(), ws.z() };
+void GameWorld::getGroundAtPositions(std::vector<glm::vec3>& positions) const
+{
+	std::vector<RaycastService::Ray> rays;
+	rays.reserve(positions.size());
+	for (auto& pos : positions) {
+		rays.push_back({ glm::vec3(pos.x, pos.y, 100.f),
+						 glm::vec3(pos.x, pos.y, -100.f) });
 	}
 
-	return pos;
+	std::vector<RaycastService::Hit> hits(rays.size());
+	raycasts->castBatch(rays.data(), hits.data(), rays.size());
+
+	for (std::size_t i = 0; i < positions.size(); ++i) {
+		if (hits[i].hit) {
+			positions[i] = hits[i].point;
+		}
+	}
 }
 
 float GameWorld::getGameTime() const
@@ -837,9 +1166,23 @@ void GameWorld::PhysicsTickCallback(btDynamicsWorld *physWorld, btScalar timeSte
 {
 	GameWorld* world = static_cast<GameWorld*>(physWorld->getWorldUserInfo());
 
-	for( auto& p : world->vehiclePool.objects ) {
-		GameObject* object = p.second;
-		static_cast<VehicleObject*>(object)->tickPhysics(timeStep);
+	world->buoyancy->tickVehicles();
+
+	for( auto& object : world->vehiclePool.objects ) {
+		auto vehicle = static_cast<VehicleObject*>(object);
+		switch (vehicle->getSimulationTier()) {
+		case SimulationKinematic:
+			continue;
+		case SimulationReduced:
+			// Floating vehicles need their damping and rudder every step
+			if (! vehicle->isInWater() && ! world->isSimulationUpdateTick(vehicle)) {
+				continue;
+			}
+			break;
+		default:
+			break;
+		}
+		vehicle->tickPhysics(timeStep);
 	}
 }
 
@@ -893,7 +1236,7 @@ void GameWorld::startCutscene()
 void GameWorld::clearCutscene()
 {
 	for(auto& p : cutscenePool.objects) {
-		destroyObjectQueued(p.second);
+		destroyObjectQueued(p);
 	}
 
 	if (cutsceneAudio.length() > 0) {
@@ -938,40 +1281,26 @@ void GameWorld::loadSpecialModel(const unsigned short index, const std::string &
 
 void GameWorld::disableAIPaths(AIGraphNode::NodeType type, const glm::vec3& min, const glm::vec3& max)
 {
-	for(AIGraphNode* n : aigraph.nodes)
+	std::vector<AIGraph::NodeIndex> inside;
+	aigraph.gatherNodesInBox(min, max, inside);
+	for(auto n : inside)
 	{
-		if( n->type == type )
+		if( aigraph.nodes[n].type == type )
 		{
-			if( n->position.x >= min.x &&
-				n->position.y >= min.y &&
-				n->position.z >= min.z &&
-				n->position.x <= max.x &&
-				n->position.y <= max.y &&
-				n->position.z <= max.z
-			)
-			{
-				n->disabled = true;
-			}
+			aigraph.setNodeDisabled(n, true);
 		}
 	}
 }
 
 void GameWorld::enableAIPaths(AIGraphNode::NodeType type, const glm::vec3& min, const glm::vec3& max)
 {
-	for(AIGraphNode* n : aigraph.nodes)
+	std::vector<AIGraph::NodeIndex> inside;
+	aigraph.gatherNodesInBox(min, max, inside);
+	for(auto n : inside)
 	{
-		if( n->type == type )
+		if( aigraph.nodes[n].type == type )
 		{
-			if( n->position.x >= min.x &&
-				n->position.y >= min.y &&
-				n->position.z >= min.z &&
-				n->position.x <= max.x &&
-				n->position.y <= max.y &&
-				n->position.z <= max.z
-			)
-			{
-				n->disabled = false;
-			}
+			aigraph.setNodeDisabled(n, false);
 		}
 	}
 }
@@ -1017,12 +1346,8 @@ VehicleObject* GameWorld::tryToSpawnVehicle(VehicleGenerator& gen)
 	}
 
 	// Ensure there's no existing vehicles near our spawn point
-	for (auto& v : vehiclePool.objects)
-	{
-		if (glm::distance2(position, v.second->getPosition())
-				< kMinClearRadius * kMinClearRadius) {
-			return nullptr;
-		}
+	if (vehicleHash.anyWithin(position, kMinClearRadius)) {
+		return nullptr;
 	}
 
 	int id = gen.vehicleID;
@@ -0,0 +1,354 @@
+#include <engine/InstanceIndex.hpp>
+#include <objects/InstanceObject.hpp>
+#include <engine/GameData.hpp>
+#include <data/CollisionModel.hpp>
+#include <data/Model.hpp>
+#include <rw/defines.hpp>
+
+#include <algorithm>
+
+namespace
+{
+const uint32_t kLeafSize = 4;
+/// Loose instances tolerated before the tree is rebuilt
+const std::size_t kMaxLoose = 64;
+const int kMaxDepth = 64;
+
+bool overlaps(const glm::vec3& amin, const glm::vec3& amax,
+			  const glm::vec3& bmin, const glm::vec3& bmax)
+{
+	return amin.x <= bmax.x && amax.x >= bmin.x &&
+		   amin.y <= bmax.y && amax.y >= bmin.y &&
+		   amin.z <= bmax.z && amax.z >= bmin.z;
+}
+
+bool inside(const glm::vec3& p, const glm::vec3& min, const glm::vec3& max)
+{
+	return p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+		   p.x <= max.x && p.y <= max.y && p.z <= max.z;
+}
+}
+
+InstanceIndex::InstanceIndex()
+	: dynamicRadius(0.f)
+	, removedItems(0)
+{
+}
+
+bool InstanceIndex::isStatic(InstanceObject* instance)
+{
+	return ! instance->dynamics;
+}
+
+std::string InstanceIndex::modelName(InstanceObject* instance)
+{
+	return instance->model ? instance->model->name : std::string();
+}
+
+InstanceIndex::Item InstanceIndex::makeItem(InstanceObject* instance)
+{
+	auto position = instance->getPosition();
+	float radius = 0.f;
+	if (instance->model && instance->model->resource) {
+		radius = instance->model->resource->getBoundingRadius();
+	}
+
+	// Models are usually still loading when instances are placed, but their
+	// collision models were read along with the map
+	if (instance->object) {
+		auto& collisions = instance->engine->data->collisions;
+		auto it = collisions.find(instance->object->modelName);
+		if (it != collisions.end()) {
+			auto& collision = *it->second;
+			radius = std::max(radius, glm::length(collision.center) + collision.radius);
+		}
+	}
+	return { instance, position, position - glm::vec3(radius), position + glm::vec3(radius) };
+}
+
+void InstanceIndex::addDynamic(InstanceObject* instance)
+{
+	auto item = makeItem(instance);
+	dynamicRadius = std::max(dynamicRadius, item.max.x - item.position.x);
+	if (dynamicHash.contains(instance)) {
+		dynamicHash.update(instance, item.position);
+	}
+	else {
+		dynamicHash.insert(instance, item.position);
+	}
+}
+
+void InstanceIndex::addLoose(InstanceObject* instance, Entry& entry)
+{
+	entry.inTree = false;
+	entry.index = loose.size();
+	loose.push_back(instance);
+}
+
+void InstanceIndex::removeLoose(Entry& entry)
+{
+	auto instance = loose[entry.index];
+	auto last = loose.back();
+	if (last != instance) {
+		loose[entry.index] = last;
+		entries[last].index = entry.index;
+	}
+	loose.pop_back();
+}
+
+void InstanceIndex::removeModel(const std::string& model, InstanceObject* instance)
+{
+	auto range = models.equal_range(model);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == instance) {
+			models.erase(it);
+			return;
+		}
+	}
+}
+
+void InstanceIndex::insert(InstanceObject* instance)
+{
+	RW_CHECK(! contains(instance), "Instance inserted twice");
+	if (contains(instance)) {
+		update(instance);
+		return;
+	}
+
+	auto& entry = entries[instance];
+	entry.model = modelName(instance);
+	models.insert({entry.model, instance});
+	entry.dynamic = ! isStatic(instance);
+	if (entry.dynamic) {
+		entry.inTree = false;
+		addDynamic(instance);
+	}
+	else {
+		addLoose(instance, entry);
+	}
+}
+
+void InstanceIndex::remove(InstanceObject* instance)
+{
+	auto it = entries.find(instance);
+	if (it == entries.end()) {
+		return;
+	}
+
+	auto& entry = it->second;
+	removeModel(entry.model, instance);
+	if (entry.dynamic) {
+		dynamicHash.remove(instance);
+	}
+	else if (entry.inTree) {
+		items[entry.index].instance = nullptr;
+		removedItems++;
+	}
+	else {
+		removeLoose(entry);
+	}
+	entries.erase(it);
+}
+
+void InstanceIndex::update(InstanceObject* instance)
+{
+	auto it = entries.find(instance);
+	if (it == entries.end()) {
+		return;
+	}
+
+	auto& entry = it->second;
+	auto model = modelName(instance);
+	if (model != entry.model) {
+		removeModel(entry.model, instance);
+		entry.model = model;
+		models.insert({entry.model, instance});
+	}
+
+	if (entry.dynamic) {
+		addDynamic(instance);
+	}
+	// Model bounds may have changed too, so the item is always replaced
+	else if (entry.inTree) {
+		items[entry.index].instance = nullptr;
+		removedItems++;
+		addLoose(instance, entry);
+	}
+}
+
+bool InstanceIndex::contains(InstanceObject* instance) const
+{
+	return entries.find(instance) != entries.end();
+}
+
+void InstanceIndex::clear()
+{
+	items.clear();
+	nodes.clear();
+	loose.clear();
+	dynamicHash.clear();
+	dynamicRadius = 0.f;
+	entries.clear();
+	models.clear();
+	removedItems = 0;
+}
+
+void InstanceIndex::refresh()
+{
+	if (loose.size() > kMaxLoose || removedItems > kMaxLoose + items.size() / 4) {
+		rebuild();
+	}
+}
+
+void InstanceIndex::rebuild()
+{
+	items.erase(std::remove_if(items.begin(), items.end(),
+							   [](const Item& item) { return item.instance == nullptr; }),
+				items.end());
+
+	for (auto instance : loose) {
+		items.push_back(makeItem(instance));
+	}
+
+	nodes.clear();
+	if (! items.empty()) {
+		nodes.reserve(2 * (items.size() / kLeafSize + 1));
+		build(0, items.size());
+	}
+
+	loose.clear();
+	removedItems = 0;
+	for (uint32_t i = 0; i < items.size(); ++i) {
+		auto& entry = entries[items[i].instance];
+		entry.inTree = true;
+		entry.index = i;
+	}
+}
+
+uint32_t InstanceIndex::build(uint32_t first, uint32_t last)
+{
+	uint32_t node = nodes.size();
+	nodes.push_back({items[first].min, items[first].max, first, last - first});
+
+	glm::vec3 centreMin = items[first].position, centreMax = centreMin;
+	for (uint32_t i = first; i < last; ++i) {
+		nodes[node].min = glm::min(nodes[node].min, items[i].min);
+		nodes[node].max = glm::max(nodes[node].max, items[i].max);
+		centreMin = glm::min(centreMin, items[i].position);
+		centreMax = glm::max(centreMax, items[i].position);
+	}
+
+	if (last - first <= kLeafSize) {
+		return node;
+	}
+
+	// Split at the median along the axis the positions spread furthest on
+	auto extent = centreMax - centreMin;
+	int axis = 0;
+	if (extent.y > extent[axis]) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+
+	uint32_t middle = first + (last - first) / 2;
+	std::nth_element(items.begin() + first, items.begin() + middle, items.begin() + last,
+					 [axis](const Item& a, const Item& b) {
+		return a.position[axis] < b.position[axis];
+	});
+
+	build(first, middle);
+	uint32_t right = build(middle, last);
+	nodes[node].index = right;
+	nodes[node].count = 0;
+	return node;
+}
+
+template <class ItemTest>
+bool InstanceIndex::query(const glm::vec3& min, const glm::vec3& max, float padding, ItemTest itemTest)
+{
+	if (! nodes.empty()) {
+		uint32_t stack[kMaxDepth];
+		int top = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			uint32_t n = stack[--top];
+			auto& node = nodes[n];
+			if (! overlaps(node.min, node.max, min, max)) {
+				continue;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = node.index; i < node.index + node.count; ++i) {
+					if (items[i].instance && itemTest(items[i])) {
+						return true;
+					}
+				}
+			}
+			else {
+				stack[top++] = node.index;
+				stack[top++] = n + 1;
+			}
+		}
+	}
+
+	for (auto instance : loose) {
+		if (itemTest(makeItem(instance))) {
+			return true;
+		}
+	}
+
+	dynamicResults.clear();
+	dynamicHash.queryBox(min - glm::vec3(padding), max + glm::vec3(padding), dynamicResults);
+	for (auto object : dynamicResults) {
+		if (itemTest(makeItem(static_cast<InstanceObject*>(object)))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void InstanceIndex::queryBox(const glm::vec3& min, const glm::vec3& max, std::vector<InstanceObject*>& out)
+{
+	refresh();
+	query(min, max, 0.f, [&](const Item& item) {
+		if (inside(item.position, min, max)) {
+			out.push_back(item.instance);
+		}
+		return false;
+	});
+}
+
+bool InstanceIndex::anyInBox(const glm::vec3& min, const glm::vec3& max)
+{
+	refresh();
+	return query(min, max, 0.f, [&](const Item& item) {
+		return inside(item.position, min, max);
+	});
+}
+
+void InstanceIndex::queryBounds(const glm::vec3& min, const glm::vec3& max, std::vector<InstanceObject*>& out)
+{
+	refresh();
+	query(min, max, dynamicRadius, [&](const Item& item) {
+		if (overlaps(item.min, item.max, min, max)) {
+			out.push_back(item.instance);
+		}
+		return false;
+	});
+}
+
+void InstanceIndex::findByModel(const std::string& model, std::vector<InstanceObject*>& out) const
+{
+	auto range = models.equal_range(model);
+	for (auto it = range.first; it != range.second; ++it) {
+		out.push_back(it->second);
+	}
+}
+
+void InstanceIndex::findByModel(const std::string& model, const glm::vec3& centre, float radius,
+								std::vector<InstanceObject*>& out) const
+{
+	auto range = models.equal_range(model);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (glm::distance(centre, it->second->getPosition()) < radius) {
+			out.push_back(it->second);
+		}
+	}
+}
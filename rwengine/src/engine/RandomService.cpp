@@ -0,0 +1,22 @@
+#include <engine/RandomService.hpp>
+
+constexpr uint64_t RandomService::DefaultSeed;
+
+RandomService::RandomService(uint64_t seed)
+{
+	this->seed(seed);
+}
+
+void RandomService::seed(uint64_t seed)
+{
+	seedValue = seed;
+	for (std::size_t s = 0; s < streams.size(); ++s) {
+		streams[s].seed(seed, s);
+	}
+}
+
+RandomStream RandomService::makeStream(uint64_t id) const
+{
+	// Thread streams are numbered after the subsystem streams
+	return RandomStream(seedValue, StreamCount + id);
+}
@@ -0,0 +1,231 @@
+#include <engine/SpatialHash.hpp>
+#include <rw/defines.hpp>
+
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Cell coordinates are packed into 21 bits per axis
+constexpr int kCoordBits = 21;
+constexpr int kCoordBias = 1 << (kCoordBits - 1);
+constexpr uint64_t kCoordMask = (uint64_t(1) << kCoordBits) - 1;
+}
+
+SpatialHash::SpatialHash(float cellSize)
+	: cellSize(cellSize)
+	, inverseCellSize(1.f / cellSize)
+{
+}
+
+glm::ivec3 SpatialHash::cellCoord(const glm::vec3& position) const
+{
+	return glm::ivec3(glm::floor(position * inverseCellSize));
+}
+
+SpatialHash::CellKey SpatialHash::cellKey(const glm::ivec3& coord)
+{
+	return (uint64_t(coord.x + kCoordBias) & kCoordMask)
+			| ((uint64_t(coord.y + kCoordBias) & kCoordMask) << kCoordBits)
+			| ((uint64_t(coord.z + kCoordBias) & kCoordMask) << (kCoordBits * 2));
+}
+
+glm::ivec3 SpatialHash::keyCoord(CellKey key)
+{
+	return glm::ivec3(
+				int(key & kCoordMask) - kCoordBias,
+				int((key >> kCoordBits) & kCoordMask) - kCoordBias,
+				int((key >> (kCoordBits * 2)) & kCoordMask) - kCoordBias);
+}
+
+void SpatialHash::insert(GameObject* object, const glm::vec3& position)
+{
+	RW_CHECK(locations.find(object) == locations.end(), "Object inserted twice");
+	if (locations.find(object) != locations.end()) {
+		update(object, position);
+		return;
+	}
+
+	auto key = cellKey(cellCoord(position));
+	auto& cell = cells[key];
+	locations[object] = { key, uint32_t(cell.size()) };
+	cell.push_back({ object, position });
+}
+
+void SpatialHash::update(GameObject* object, const glm::vec3& position)
+{
+	auto it = locations.find(object);
+	if (it == locations.end()) {
+		return;
+	}
+
+	auto key = cellKey(cellCoord(position));
+	if (key == it->second.cell) {
+		cells[key][it->second.index].position = position;
+		return;
+	}
+
+	removeFromCell(it->second);
+
+	auto& cell = cells[key];
+	it->second = { key, uint32_t(cell.size()) };
+	cell.push_back({ object, position });
+}
+
+void SpatialHash::remove(GameObject* object)
+{
+	auto it = locations.find(object);
+	if (it == locations.end()) {
+		return;
+	}
+
+	removeFromCell(it->second);
+	locations.erase(it);
+}
+
+bool SpatialHash::contains(GameObject* object) const
+{
+	return locations.find(object) != locations.end();
+}
+
+void SpatialHash::clear()
+{
+	cells.clear();
+	locations.clear();
+}
+
+void SpatialHash::removeFromCell(const Location& location)
+{
+	auto& cell = cells[location.cell];
+	if (location.index + 1 != cell.size()) {
+		cell[location.index] = cell.back();
+		locations[cell[location.index].object].index = location.index;
+	}
+	cell.pop_back();
+}
+
+template <class F>
+void SpatialHash::forEachCell(const glm::ivec3& lo, const glm::ivec3& hi, F function) const
+{
+	int64_t cellCount = int64_t(hi.x - lo.x + 1)
+			* int64_t(hi.y - lo.y + 1)
+			* int64_t(hi.z - lo.z + 1);
+
+	// Large queries are cheaper to answer by walking the occupied cells
+	if (cellCount > int64_t(cells.size())) {
+		for (auto& cell : cells) {
+			auto coord = keyCoord(cell.first);
+			if (coord.x >= lo.x && coord.y >= lo.y && coord.z >= lo.z &&
+			    coord.x <= hi.x && coord.y <= hi.y && coord.z <= hi.z) {
+				function(cell.second);
+			}
+		}
+		return;
+	}
+
+	for (int x = lo.x; x <= hi.x; ++x) {
+		for (int y = lo.y; y <= hi.y; ++y) {
+			for (int z = lo.z; z <= hi.z; ++z) {
+				auto it = cells.find(cellKey(glm::ivec3(x, y, z)));
+				if (it != cells.end()) {
+					function(it->second);
+				}
+			}
+		}
+	}
+}
+
+void SpatialHash::queryRadius(const glm::vec3& centre, float radius, std::vector<GameObject*>& out) const
+{
+	float radius2 = radius * radius;
+	forEachCell(cellCoord(centre - glm::vec3(radius)), cellCoord(centre + glm::vec3(radius)),
+		[&](const std::vector<Entry>& cell) {
+			for (auto& entry : cell) {
+				if (glm::distance2(centre, entry.position) <= radius2) {
+					out.push_back(entry.object);
+				}
+			}
+		});
+}
+
+bool SpatialHash::anyWithin(const glm::vec3& centre, float radius) const
+{
+	float radius2 = radius * radius;
+	bool found = false;
+	forEachCell(cellCoord(centre - glm::vec3(radius)), cellCoord(centre + glm::vec3(radius)),
+		[&](const std::vector<Entry>& cell) {
+			for (auto it = cell.begin(); !found && it != cell.end(); ++it) {
+				found = glm::distance2(centre, it->position) <= radius2;
+			}
+		});
+	return found;
+}
+
+void SpatialHash::queryBox(const glm::vec3& min, const glm::vec3& max, std::vector<GameObject*>& out) const
+{
+	forEachCell(cellCoord(min), cellCoord(max),
+		[&](const std::vector<Entry>& cell) {
+			for (auto& entry : cell) {
+				auto& p = entry.position;
+				if (p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+				    p.x <= max.x && p.y <= max.y && p.z <= max.z) {
+					out.push_back(entry.object);
+				}
+			}
+		});
+}
+
+void SpatialHash::queryNearest(const glm::vec3& centre, std::size_t k, float maxRadius, std::vector<GameObject*>& out) const
+{
+	if (k == 0) {
+		return;
+	}
+
+	std::vector<std::pair<float, GameObject*>> candidates;
+	float radius2 = maxRadius * maxRadius;
+	forEachCell(cellCoord(centre - glm::vec3(maxRadius)), cellCoord(centre + glm::vec3(maxRadius)),
+		[&](const std::vector<Entry>& cell) {
+			for (auto& entry : cell) {
+				float d2 = glm::distance2(centre, entry.position);
+				if (d2 <= radius2) {
+					candidates.push_back({ d2, entry.object });
+				}
+			}
+		});
+
+	auto count = std::min(k, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+		[](const std::pair<float, GameObject*>& a, const std::pair<float, GameObject*>& b) {
+			return a.first < b.first;
+		});
+
+	for (std::size_t i = 0; i < count; ++i) {
+		out.push_back(candidates[i].second);
+	}
+}
+
+void SpatialHash::queryOutside(const glm::vec3& centre, float radius, std::vector<GameObject*>& out) const
+{
+	float radius2 = radius * radius;
+	for (auto& cell : cells) {
+		if (cell.second.empty()) {
+			continue;
+		}
+
+		// Skip the cell if even its farthest corner is inside the radius
+		glm::vec3 cellMin = glm::vec3(keyCoord(cell.first)) * cellSize;
+		glm::vec3 farthest = glm::max(glm::abs(cellMin - centre),
+		                              glm::abs(cellMin + glm::vec3(cellSize) - centre));
+		if (glm::length2(farthest) < radius2) {
+			continue;
+		}
+
+		for (auto& entry : cell.second) {
+			if (glm::distance2(centre, entry.position) >= radius2) {
+				out.push_back(entry.object);
+			}
+		}
+	}
+}
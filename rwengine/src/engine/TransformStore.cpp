@@ -0,0 +1,32 @@
+#include <engine/TransformStore.hpp>
+#include <objects/GameObject.hpp>
+#include <rw/defines.hpp>
+
+TransformStore::Slot TransformStore::add(GameObject* object, const glm::vec3& position, const glm::quat& rotation)
+{
+	Slot slot = owners.size();
+	lastPositions.push_back(position);
+	lastRotations.push_back(rotation);
+	owners.push_back(object);
+	return slot;
+}
+
+void TransformStore::remove(Slot slot)
+{
+	RW_CHECK(slot < owners.size(), "Removing transform slot out of range");
+	if (slot >= owners.size()) {
+		return;
+	}
+
+	Slot last = owners.size() - 1;
+	if (slot != last) {
+		lastPositions[slot] = lastPositions[last];
+		lastRotations[slot] = lastRotations[last];
+		owners[slot] = owners[last];
+		owners[slot]->transformSlot = slot;
+	}
+
+	lastPositions.pop_back();
+	lastRotations.pop_back();
+	owners.pop_back();
+}
@@ -25,14 +25,14 @@ void WeaponItem::fireHitscan(CharacterObject* owner)
 	auto fireOrigin = owner->getPosition() +
 			owner->getRotation() * handPos;
 
-	owner->engine->doWeaponScan(WeaponScan(_wepData->damage, fireOrigin, farTarget, _wepData.get()));
+	owner->engine->queueWeaponScan(WeaponScan(_wepData->damage, fireOrigin, farTarget, _wepData.get()));
 
 	// Particle FX involved:
 	// - smokeII emited around barrel
 	// - Some circle particle used for the tracer
 	// - smoke emited at hit point
 	// - gunflash
-#if 0 // Should be merged into the VisualFX system
+#if 0 // Should be moved to the ParticleSystem
 	auto flashDir = owner->getRotation() * glm::vec3{0.f, 0.f, 1.f};
 	auto flashUp = owner->getRotation() * glm::vec3{0.f, -1.f, 0.f};
 
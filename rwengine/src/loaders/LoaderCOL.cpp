@@ -1,6 +1,7 @@
 #include "loaders/LoaderCOL.hpp"
 #include <string>
 #include <fstream>
+#include <cstring>
 
 typedef glm::vec3 CollTVec3;
 
@@ -146,9 +147,23 @@ bool LoaderCOL::load(char* data, const size_t size)
 		
 		CollisionModel *model = new CollisionModel;
 		model->version = version;
-		model->center = head.bounds.center;
-		model->min = head.bounds.min;
-		model->max = head.bounds.max;
+		if(version == 1)
+		{
+			// Version 1 files store the same bounds in a different order
+			CollTBoundsV1 bounds;
+			std::memcpy(&bounds, &head.bounds, sizeof(bounds));
+			model->radius = bounds.radius;
+			model->center = bounds.center;
+			model->min = bounds.min;
+			model->max = bounds.max;
+		}
+		else
+		{
+			model->radius = head.bounds.radius;
+			model->center = head.bounds.center;
+			model->min = head.bounds.min;
+			model->max = head.bounds.max;
+		}
 		model->name = head.name;
 		model->modelid = head.modelid;
 		
@@ -17,7 +17,7 @@ void LoaderCutsceneDAT::load(CutsceneTracks &tracks, FileHandle file)
 		ss.ignore(1, ',');
 		ss >> z;
 		ss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		tracks.zoom[t] = z;
+		tracks.zoom.insert(t, z);
 		tracks.duration = std::max(t, tracks.duration);
 	}
 
@@ -34,7 +34,7 @@ void LoaderCutsceneDAT::load(CutsceneTracks &tracks, FileHandle file)
 		ss.ignore(1, ',');
 		ss >> r;
 		ss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		tracks.rotation[t] = r;
+		tracks.rotation.insert(t, r);
 		tracks.duration = std::max(t, tracks.duration);
 	}
 
@@ -55,7 +55,7 @@ void LoaderCutsceneDAT::load(CutsceneTracks &tracks, FileHandle file)
 		ss.ignore(1, ',');
 		ss >> p.z;
 		ss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		tracks.position[t] = p;
+		tracks.position.insert(t, p);
 		tracks.duration = std::max(t, tracks.duration);
 	}
 
@@ -76,7 +76,7 @@ void LoaderCutsceneDAT::load(CutsceneTracks &tracks, FileHandle file)
 		ss.ignore(1, ',');
 		ss >> p.z;
 		ss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		tracks.target[t] = p;
+		tracks.target.insert(t, p);
 		tracks.duration = std::max(t, tracks.duration);
 	}
 }
@@ -1,9 +1,46 @@
 #include <loaders/LoaderGXT.hpp>
-#include <iconv.h>
+
+#include <cstring>
+
+namespace
+{
+/**
+ * Appends a null terminated UTF-16LE string to out as UTF-8. Returns the
+ * number of bytes read.
+ */
+size_t appendUTF8(const char* in, size_t available, std::string& out)
+{
+	size_t read = 0;
+	while (read + 1 < available) {
+		auto lo = static_cast<unsigned char>(in[read]);
+		auto hi = static_cast<unsigned char>(in[read + 1]);
+		uint32_t c = lo | (hi << 8);
+		read += 2;
+		if (c == 0) {
+			break;
+		}
+
+		if (c < 0x80) {
+			out.push_back(static_cast<char>(c));
+		}
+		else if (c < 0x800) {
+			out.push_back(static_cast<char>(0xC0 | (c >> 6)));
+			out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+		}
+		else {
+			out.push_back(static_cast<char>(0xE0 | (c >> 12)));
+			out.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+			out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+		}
+	}
+	return read;
+}
+}
 
 void LoaderGXT::load(GameTexts &texts, FileHandle &file)
 {
 	auto data = file->data;
+	auto end = file->data + file->length;
 
 	data += 4; // TKEY
 
@@ -12,37 +49,28 @@ void LoaderGXT::load(GameTexts &texts, FileHandle &file)
 	data += 4;
 
 	auto tdata = data+blocksize+8;
+	std::uint32_t tdataSize = *(std::uint32_t*)(data+blocksize+4);
+	if (tdata + tdataSize > end) {
+		tdataSize = end - tdata;
+	}
 
-	// This is not supported in GCC 4.8.1
-	//std::wstring_convert<std::codecvt<char16_t,char,std::mbstate_t>,char16_t> convert;
-
-	auto icv = iconv_open("UTF-8", "UTF-16");
+	// Most text is ASCII, which halves in size as UTF-8
+	size_t count = blocksize/12;
+	texts.reserve(texts.size() + count, tdataSize / 2);
 
-	for( size_t t = 0; t < blocksize/12; ++t ) {
+	std::string message;
+	for( size_t t = 0; t < count; ++t ) {
 		size_t offset = *(std::uint32_t*)(data+(t * 12 + 0));
-		std::string id(data+(t * 12 + 4));
+		const char* id = data+(t * 12 + 4);
+		size_t idLength = strnlen(id, 8);
 
-		// Find the terminating bytes
-		size_t bytes = 0;
-		for(;; bytes++ ) {
-			if(tdata[offset+bytes-1] == 0 && tdata[offset+bytes] == 0) break;
+		if (offset >= tdataSize) {
+			continue;
 		}
-		size_t len = bytes/2;
-
-		size_t outSize = 1024;
-		char u8buff[1024];
-		char *uwot = u8buff;
 
-		char* strbase = tdata+offset;
+		message.clear();
+		appendUTF8(tdata+offset, tdataSize-offset, message);
 
-		iconv(icv, &strbase, &bytes, &uwot, &outSize);
-
-		u8buff[len] = '\0';
-
-		std::string message(u8buff);
-
-		texts.addText(id, message);
+		texts.addText(id, idLength, message.data(), message.size());
 	}
-
-	iconv_close(icv);
 }
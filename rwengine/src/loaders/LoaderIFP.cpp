@@ -2,44 +2,51 @@
 #include <algorithm>
 #include <iostream>
 
-bool findKeyframes(float t, AnimationBone* bone, AnimationKeyframe& f1, AnimationKeyframe& f2, float& alpha)
+bool findKeyframes(float t, AnimationBone* bone, AnimationKeyframe& f1, AnimationKeyframe& f2, float& alpha,
+				   KeyframeCursor* cursor)
 {
-	for(size_t f = 0; f < bone->frames.size(); ++f ) {
-		if( t <= bone->frames[f].starttime ) {
-			f2 = bone->frames[f];
-
-			if( f == 0 ) {
-				if( bone->frames.size() != 1 ) {
-					f1 = bone->frames.back();
-				}
-				else {
-					f1 = f2;
-				}
-			}
-			else {
-				f1 = bone->frames[f-1];
-			}
+	auto& frames = bone->frames;
+	if( frames.empty() || t > frames.back().starttime ) {
+		return false;
+	}
 
-			float tdiff = (f2.starttime - f1.starttime);
-			if( tdiff == 0.f ) {
-				alpha = 1.f;
-			}
-			else {
-				alpha = glm::clamp((t - f1.starttime) / tdiff, 0.f, 1.f);
-			}
+	// The first frame at or after t ends the interpolated span
+	auto f = findKeyframe(frames.data(), frames.size(), t,
+						  [](const AnimationKeyframe& k) { return k.starttime; }, cursor);
+	if( frames[f].starttime < t ) {
+		f++;
+	}
+	f2 = frames[f];
 
-			return true;
+	if( f == 0 ) {
+		if( frames.size() != 1 ) {
+			f1 = frames.back();
+		}
+		else {
+			f1 = f2;
 		}
 	}
-	return false;
+	else {
+		f1 = frames[f-1];
+	}
+
+	float tdiff = (f2.starttime - f1.starttime);
+	if( tdiff == 0.f ) {
+		alpha = 1.f;
+	}
+	else {
+		alpha = glm::clamp((t - f1.starttime) / tdiff, 0.f, 1.f);
+	}
+
+	return true;
 }
 
-AnimationKeyframe AnimationBone::getInterpolatedKeyframe(float time)
+AnimationKeyframe AnimationBone::getInterpolatedKeyframe(float time, KeyframeCursor* cursor)
 {
 	AnimationKeyframe f1, f2;
 	float alpha;
 
-	if( findKeyframes(time, this, f1, f2, alpha) ) {
+	if( findKeyframes(time, this, f1, f2, alpha, cursor) ) {
 		return {
 			glm::normalize(glm::slerp(f1.rotation, f2.rotation, alpha)),
 					glm::mix(f1.position, f2.position, alpha),
@@ -7,6 +7,7 @@
 #include <items/InventoryItem.hpp>
 #include <data/Skeleton.hpp>
 #include <rw/defines.hpp>
+#include <core/PoolAllocator.hpp>
 
 // TODO: make this not hardcoded
 static glm::vec3 enter_offset(0.81756252f, 0.34800607f, -0.486281008f);
@@ -22,6 +23,7 @@ CharacterObject::CharacterObject(GameWorld* engine, const glm::vec3& pos, const
 	, jumped(false)
 	, jumpSpeed(DefaultJumpSpeed)
 	, motionBlockedByActivity(false)
+	, pendingAnimationTime(0.f)
 	, ped(data)
 	, physCharacter(nullptr)
 	, physObject(nullptr)
@@ -81,6 +83,22 @@ CharacterObject::~CharacterObject()
 	}
 }
 
+void* CharacterObject::operator new(std::size_t size)
+{
+	return PoolAllocator<CharacterObject>::allocateObject(size);
+}
+
+void CharacterObject::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<CharacterObject>::deallocateObject(p, size);
+}
+
+/// Movement speeds of characters simulated kinematically
+constexpr float kKinematicWalkSpeed = 1.5f;
+constexpr float kKinematicRunSpeed = 5.f;
+/// Height of a standing character's origin above the path it walks on
+constexpr float kKinematicStandingHeight = 1.f;
+
 void CharacterObject::createActor(const glm::vec2& size)
 {
 	if(physCharacter) {
@@ -108,7 +126,9 @@ void CharacterObject::createActor(const glm::vec2& size)
 
 		engine->dynamicsWorld->addCollisionObject(physObject, btBroadphaseProxy::KinematicFilter,
 												  btBroadphaseProxy::StaticFilter|btBroadphaseProxy::SensorTrigger);
-		engine->dynamicsWorld->addAction(physCharacter);
+		if (getSimulationTier() != SimulationKinematic) {
+			engine->dynamicsWorld->addAction(physCharacter);
+		}
 	}
 }
 
@@ -260,7 +280,23 @@ void CharacterObject::tick(float dt)
 		controller->update(dt);
 	}
 
-	animator->tick(dt);
+	tickSimulation(dt);
+}
+
+void CharacterObject::tickSimulation(float dt)
+{
+	if (getSimulationTier() == SimulationKinematic) {
+		tickKinematic(dt);
+		return;
+	}
+
+	// At reduced detail the animation is only caught up every few ticks
+	pendingAnimationTime += dt;
+	if (getSimulationTier() == SimulationFull || engine->isSimulationUpdateTick(this)) {
+		animator->tick(pendingAnimationTime);
+		pendingAnimationTime = 0.f;
+	}
+
 	updateCharacter(dt);
 
 	// Ensure the character doesn't need to be reset
@@ -269,6 +305,56 @@ void CharacterObject::tick(float dt)
 	}
 }
 
+void CharacterObject::tickKinematic(float dt)
+{
+	if (! isAlive() || glm::length(movement) < 0.001f) {
+		return;
+	}
+
+	// Controllers turn characters to face where they are walking
+	float speed = running ? kKinematicRunSpeed : kKinematicWalkSpeed;
+	auto position = getPosition();
+	auto step = rotation * glm::vec3(0.f, speed * dt, 0.f);
+
+	// Nothing holds them to the ground, so climb or descend evenly towards
+	// the height of the path node they're walking to
+	auto node = controller ? controller->getTargetNode() : AIGraph::NoNode;
+	if (node != AIGraph::NoNode) {
+		auto& target = engine->aigraph.nodes[node].position;
+		float rise = target.z + kKinematicStandingHeight - position.z;
+		float remaining = glm::length(glm::vec2(target - position));
+		float along = glm::length(glm::vec2(step));
+		step.z = (remaining > along) ? rise * (along / remaining) : rise;
+	}
+
+	setPosition(position + step);
+}
+
+void CharacterObject::setSimulationTier(SimulationTier tier)
+{
+	auto current = getSimulationTier();
+	if (tier == current) {
+		return;
+	}
+
+	if (physCharacter) {
+		if (tier == SimulationKinematic) {
+			// Stays in the collision world to be hit by weapons
+			engine->dynamicsWorld->removeAction(physCharacter);
+		}
+		else if (current == SimulationKinematic) {
+			auto pos = getPosition();
+			physCharacter->reset(engine->dynamicsWorld);
+			physCharacter->warp(btVector3(pos.x, pos.y, pos.z));
+			engine->dynamicsWorld->addAction(physCharacter);
+		}
+	}
+
+	pendingAnimationTime = 0.f;
+
+	GameObject::setSimulationTier(tier);
+}
+
 #include <algorithm>
 void CharacterObject::changeCharacterModel(const std::string &name)
 {
@@ -278,10 +364,9 @@ void CharacterObject::changeCharacterModel(const std::string &name)
 	engine->data->loadDFF(modelName + ".dff");
 	engine->data->loadTXD(modelName + ".txd");
 
-	auto& models = engine->data->models;
-	auto mfind = models.find(modelName);
-	if( mfind != models.end() ) {
-		model = mfind->second;
+	auto mfind = engine->data->findModel(modelName);
+	if( mfind ) {
+		model = mfind;
 	}
 
 	if( skeleton )
@@ -397,6 +482,7 @@ void CharacterObject::setPosition(const glm::vec3& pos)
 		physCharacter->warp(bpos);
 	}
 	position = pos;
+	engine->pedestrianHash.update(this, getPosition());
 }
 
 glm::vec3 CharacterObject::getPosition() const
@@ -544,30 +630,18 @@ void CharacterObject::setJumpSpeed(float speed)
 
 void CharacterObject::resetToAINode()
 {
-	auto nodes = engine->aigraph.nodes;
+	auto& graph = engine->aigraph;
 	bool vehicleNode = !! getCurrentVehicle();
-	AIGraphNode* nearest = nullptr; float d = std::numeric_limits<float>::max();
-	for(auto it = nodes.begin(); it != nodes.end(); ++it) {
-		if(vehicleNode) {
-			if((*it)->type == AIGraphNode::Pedestrian) continue;
-		}
-		else {
-			if((*it)->type == AIGraphNode::Vehicle) continue;
-		}
-		
-		float dist = glm::length((*it)->position - getPosition());
-		if(dist < d) {
-			nearest = *it;
-			d = dist;
-		}
-	}
-	
-	if(nearest) {
+	auto nearest = graph.findNearestNode(getPosition(),
+			vehicleNode ? AIGraphNode::Vehicle : AIGraphNode::Pedestrian);
+
+	if(nearest != AIGraph::NoNode) {
+		auto& position = graph.nodes[nearest].position;
 		if(vehicleNode) {
-			getCurrentVehicle()->setPosition(nearest->position + glm::vec3(0.f, 0.f, 2.5f));
+			getCurrentVehicle()->setPosition(position + glm::vec3(0.f, 0.f, 2.5f));
 		}
 		else {
-			setPosition(nearest->position + glm::vec3(0.f, 0.f, 2.5f));
+			setPosition(position + glm::vec3(0.f, 0.f, 2.5f));
 		}
 	}
 }
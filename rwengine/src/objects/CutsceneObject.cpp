@@ -1,6 +1,7 @@
 #include <objects/CutsceneObject.hpp>
 #include <engine/Animator.hpp>
 #include <data/Skeleton.hpp>
+#include <core/PoolAllocator.hpp>
 
 CutsceneObject::CutsceneObject(GameWorld *engine, const glm::vec3 &pos, const glm::quat& rot, const ModelRef& model)
 	: GameObject(engine, pos, rot, model)
@@ -15,6 +16,16 @@ CutsceneObject::~CutsceneObject()
 {
 }
 
+void* CutsceneObject::operator new(std::size_t size)
+{
+	return PoolAllocator<CutsceneObject>::allocateObject(size);
+}
+
+void CutsceneObject::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<CutsceneObject>::deallocateObject(p, size);
+}
+
 void CutsceneObject::tick(float dt)
 {
 	animator->tick(dt);
@@ -1,12 +1,32 @@
 #include <objects/GameObject.hpp>
+#include <engine/GameWorld.hpp>
 #include <loaders/LoaderIFP.hpp>
 #include <loaders/LoaderDFF.hpp>
 #include <engine/Animator.hpp>
 #include <data/Skeleton.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+GameObject::GameObject(GameWorld* engine, const glm::vec3& pos, const glm::quat& rot, ModelRef model)
+	: objectID(0)
+	, transformSlot(engine->transforms.add(this, pos, rot))
+	, position(pos)
+	, rotation(rot)
+	, model(model)
+	, engine(engine)
+	, animator(nullptr)
+	, skeleton(nullptr)
+	, inWater(false)
+	, _lastHeight(std::numeric_limits<float>::max())
+	, visible(true)
+	, lifetime(GameObject::UnknownLifetime)
+	, active(true)
+	, simulationTier(SimulationFull)
+{}
+
 GameObject::~GameObject()
 {
+	engine->transforms.remove(transformSlot);
+
 	if(animator)
 	{
 		delete animator;
@@ -20,7 +40,36 @@ GameObject::~GameObject()
 
 void GameObject::setPosition(const glm::vec3& pos)
 {
-	_lastPosition = position = pos;
+	position = pos;
+	engine->transforms.setLastPosition(transformSlot, pos);
+}
+
+const glm::vec3& GameObject::getLastPosition() const
+{
+	return engine->transforms.getLastPosition(transformSlot);
+}
+
+void GameObject::_updateLastTransform()
+{
+	engine->transforms.setLastTransform(transformSlot, getPosition(), getRotation());
+}
+
+void GameObject::setActive(bool enable)
+{
+	if (active == enable) {
+		return;
+	}
+	active = enable;
+	engine->getTypeObjectPool(this).updateActive(this);
+}
+
+glm::mat4 GameObject::getTimeAdjustedTransform(float alpha) const
+{
+	auto& transforms = engine->transforms;
+	glm::mat4 t;
+	t = glm::translate(t, glm::mix(transforms.getLastPosition(transformSlot), getPosition(), alpha));
+	t = t * glm::mat4_cast(glm::slerp(transforms.getLastRotation(transformSlot), getRotation(), alpha));
+	return t;
 }
 
 glm::quat GameObject::getRotation() const
@@ -4,6 +4,7 @@
 #include <dynamics/CollisionInstance.hpp>
 #include <engine/Animator.hpp>
 #include <engine/GameData.hpp>
+#include <core/PoolAllocator.hpp>
 
 InstanceObject::InstanceObject(GameWorld* engine,
 		const glm::vec3& pos,
@@ -31,6 +32,7 @@ InstanceObject::InstanceObject(GameWorld* engine,
 		}
 	}
 
+	updateActive();
 }
 
 InstanceObject::~InstanceObject()
@@ -40,6 +42,16 @@ InstanceObject::~InstanceObject()
 	}
 }
 
+void* InstanceObject::operator new(std::size_t size)
+{
+	return PoolAllocator<InstanceObject>::allocateObject(size);
+}
+
+void InstanceObject::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<InstanceObject>::deallocateObject(p, size);
+}
+
 void InstanceObject::tick(float dt)
 {
 	if( dynamics && body ) {
@@ -56,64 +68,7 @@ void InstanceObject::tick(float dt)
 		
 		_updateLastTransform();
 
-		auto _bws = body->body->getWorldTransform().getOrigin();
-		glm::vec3 ws(_bws.x(), _bws.y(), _bws.z());
-		auto wX = (int) ((ws.x + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
-		auto wY = (int) ((ws.y + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
-		float vH = ws.z;// - _collisionHeight/2.f;
-		float wH = 0.f;
-
-		if( wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 && wY < WATER_HQ_DATA_SIZE ) {
-			int i = (wX*WATER_HQ_DATA_SIZE) + wY;
-			int hI = engine->data->realWater[i];
-			if( hI < NO_WATER_INDEX ) {
-				wH = engine->data->waterHeights[hI];
-				wH += engine->data->getWaveHeightAt(ws);
-				if( vH <= wH ) {
-					inWater = true;
-				}
-				else {
-					inWater = false;
-				}
-			}
-			else {
-				inWater = false;
-			}
-		}
-		_lastHeight = ws.z;
-
-		if( inWater ) {
-			float oZ = -(body->collisionHeight * (dynamics->bouancy/100.f));
-			body->body->activate(true);
-			// Damper motion
-			body->body->setDamping(0.95f, 0.9f);
-
-			auto wi = engine->data->getWaterIndexAt(ws);
-			if(wi != NO_WATER_INDEX) {
-				float h = engine->data->waterHeights[wi] + oZ;
-
-				// Calculate wave height
-				h += engine->data->getWaveHeightAt(ws);
-
-				if ( ws.z <= h ) {
-					/*if( dynamics->uprootForce > 0.f && (body->body->getCollisionFlags() & btRigidBody::CF_STATIC_OBJECT) != 0 ) {
-						// Apparently bodies must be removed and re-added if their mass changes.
-						engine->dynamicsWorld->removeRigidBody(body->body);
-						btVector3 inert;
-						body->getCollisionShape()->calculateLocalInertia(dynamics->mass, inert);
-						body->setMassProps(dynamics->mass, inert);
-						engine->dynamicsWorld->addRigidBody(body);
-					}*/
-
-					float x = (h - ws.z);
-					float F = WATER_BUOYANCY_K * x + -WATER_BUOYANCY_C * body->body->getLinearVelocity().z();
-					btVector3 forcePos = btVector3(0.f, 0.f, 2.f).rotate(
-								body->body->getOrientation().getAxis(), body->body->getOrientation().getAngle());
-					body->body->applyForce(btVector3(0.f, 0.f, F),
-										 forcePos);
-				}
-			}
-		}
+		// Buoyancy is applied by GameWorld::buoyancy
 	}
 
 	if( animator ) animator->tick(dt);
@@ -137,6 +92,14 @@ void InstanceObject::changeModel(std::shared_ptr<ObjectData> incoming)
 			body = bod;
 		}
 	}
+
+	updateActive();
+}
+
+void InstanceObject::updateActive()
+{
+	// Static world geometry has nothing to do in tick()
+	setActive((dynamics && body) || animator);
 }
 
 glm::vec3 InstanceObject::getPosition() const
@@ -149,6 +112,12 @@ glm::quat InstanceObject::getRotation() const
 	return rotation;
 }
 
+void InstanceObject::setPosition(const glm::vec3& pos)
+{
+	GameObject::setPosition(pos);
+	engine->instanceIndex.update(this);
+}
+
 void InstanceObject::setRotation(const glm::quat &r)
 {
 	if( body ) {
@@ -156,6 +125,11 @@ void InstanceObject::setRotation(const glm::quat &r)
 		wtr.setRotation(btQuaternion(r.x, r.y, r.z, r.w));
 	}
 	GameObject::setRotation(r);
+
+	// Inactive instances don't refresh their last transform each tick
+	if( ! isActive() ) {
+		_updateLastTransform();
+	}
 }
 
 bool InstanceObject::takeDamage(const GameObject::DamageInfo& dmg)
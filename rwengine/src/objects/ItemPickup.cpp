@@ -3,6 +3,7 @@
 #include <engine/GameWorld.hpp>
 #include <items/WeaponItem.hpp>
 #include <rw/defines.hpp>
+#include <core/PoolAllocator.hpp>
 
 ItemPickup::ItemPickup(GameWorld *world, const glm::vec3 &position, PickupType type, InventoryItem* item)
 	: PickupObject(world, position, item->getModelID(), type)
@@ -11,6 +12,16 @@ ItemPickup::ItemPickup(GameWorld *world, const glm::vec3 &position, PickupType t
 	RW_CHECK(item != nullptr, "Pickup created with null item");
 }
 
+void* ItemPickup::operator new(std::size_t size)
+{
+	return PoolAllocator<ItemPickup>::allocateObject(size);
+}
+
+void ItemPickup::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<ItemPickup>::deallocateObject(p, size);
+}
+
 bool ItemPickup::onCharacterTouch(CharacterObject *character)
 {
 	character->addToInventory(item);
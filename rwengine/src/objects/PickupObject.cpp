@@ -2,6 +2,7 @@
 #include <objects/CharacterObject.hpp>
 #include <engine/GameWorld.hpp>
 #include <engine/GameData.hpp>
+#include <core/PoolAllocator.hpp>
 
 bool PickupObject::doesRespawn(PickupType type)
 {
@@ -68,6 +69,7 @@ PickupObject::PickupObject(GameWorld *world, const glm::vec3 &position, int mode
 	, m_enabled(false)
 	, m_collected(false)
 	, m_model(modelID)
+	, m_corona(0)
 	, m_type(type)
 {
 	btTransform tf;
@@ -81,12 +83,16 @@ PickupObject::PickupObject(GameWorld *world, const glm::vec3 &position, int mode
 	m_ghost->setCollisionShape(m_shape);
 	m_ghost->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT|btCollisionObject::CF_NO_CONTACT_RESPONSE);
 
-	m_corona = world->createEffect(VisualFX::Particle);
-	m_corona->particle.position = getPosition();
-	m_corona->particle.direction = glm::vec3(0.f, 0.f, 1.f);
-	m_corona->particle.orientation = VisualFX::ParticleData::Camera;
-	m_corona->particle.colour = glm::vec4(1.0f, 0.3f, 0.3f, 0.3f);
-	m_corona->particle.texture = engine->data->findTexture("coronacircle");
+	auto tex = engine->data->findTexture("coronacircle");
+
+	ParticleInfo corona;
+	corona.position = getPosition();
+	corona.direction = glm::vec3(0.f, 0.f, 1.f);
+	corona.orientation = ParticleInfo::Camera;
+	corona.colour = glm::vec4(1.0f, 0.3f, 0.3f, 0.3f);
+	corona.texture = tex ? tex->getName() : 0;
+	corona.size = glm::vec2(0.f, 0.f);
+	m_corona = world->particles.spawn(corona, world->getGameTime());
 
 	auto flags = behaviourFlags(m_type);
 	RW_UNUSED(flags);
@@ -100,12 +106,22 @@ PickupObject::~PickupObject()
 {
 	if(m_ghost) {
 		setEnabled(false);
-		engine->destroyEffect(m_corona);
+		engine->particles.destroy(m_corona);
 		delete m_ghost;
 		delete m_shape;
 	}
 }
 
+void* PickupObject::operator new(std::size_t size)
+{
+	return PoolAllocator<PickupObject>::allocateObject(size);
+}
+
+void PickupObject::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<PickupObject>::deallocateObject(p, size);
+}
+
 void PickupObject::tick(float dt)
 {
 	if(! m_enabled) {
@@ -155,12 +171,15 @@ void PickupObject::setEnabled(bool enabled)
 {
 	if( ! m_enabled && enabled ) {
 		engine->dynamicsWorld->addCollisionObject(m_ghost, btBroadphaseProxy::SensorTrigger);
-		m_corona->particle.size = glm::vec2(1.5f, 1.5f);
+		engine->particles.setSize(m_corona, glm::vec2(1.5f, 1.5f));
 	}
 	else if( m_enabled && ! enabled ) {
 		engine->dynamicsWorld->removeCollisionObject(m_ghost);
-		m_corona->particle.size = glm::vec2(0.f, 0.f);
+		engine->particles.setSize(m_corona, glm::vec2(0.f, 0.f));
 	}
 
 	m_enabled = enabled;
+
+	// Disabled pickups only need ticking to count down to their respawn
+	setActive(m_enabled || doesRespawn(m_type));
 }
@@ -2,6 +2,7 @@
 #include <engine/GameWorld.hpp>
 #include <engine/GameData.hpp>
 #include <data/WeaponData.hpp>
+#include <core/PoolAllocator.hpp>
 
 void ProjectileObject::checkPhysicsContact()
 {
@@ -73,15 +74,15 @@ void ProjectileObject::explode()
 
 		auto tex = engine->data->findTexture("explo02");
 		
-		auto explosion = engine->createEffect(VisualFX::Particle);
-		explosion->particle.size = glm::vec2(exp_size);
-		explosion->particle.texture = tex;
-		explosion->particle.starttime = engine->getGameTime();
-		explosion->particle.lifetime = 0.5f;
-		explosion->particle.orientation = VisualFX::ParticleData::Camera;
-		explosion->particle.colour = glm::vec4(1.0f);
-		explosion->particle.position = getPosition();
-		explosion->particle.direction = glm::vec3(0.f, 0.f, 1.f);
+		ParticleInfo explosion;
+		explosion.size = glm::vec2(exp_size);
+		explosion.texture = tex ? tex->getName() : 0;
+		explosion.lifetime = 0.5f;
+		explosion.orientation = ParticleInfo::Camera;
+		explosion.colour = glm::vec4(1.0f);
+		explosion.position = getPosition();
+		explosion.direction = glm::vec3(0.f, 0.f, 1.f);
+		engine->particles.spawn(explosion, engine->getGameTime());
 
 		_exploded = true;
 		engine->destroyObjectQueued(this);
@@ -149,6 +150,16 @@ ProjectileObject::~ProjectileObject()
 	cleanup();
 }
 
+void* ProjectileObject::operator new(std::size_t size)
+{
+	return PoolAllocator<ProjectileObject>::allocateObject(size);
+}
+
+void ProjectileObject::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<ProjectileObject>::deallocateObject(p, size);
+}
+
 void ProjectileObject::tick(float dt)
 {
 	if( _body == nullptr ) return;
@@ -2,12 +2,13 @@
 #include <objects/CharacterObject.hpp>
 #include <engine/GameWorld.hpp>
 #include <BulletDynamics/Vehicle/btRaycastVehicle.h>
-#include <dynamics/RaycastCallbacks.hpp>
+#include <dynamics/RaycastService.hpp>
 #include <data/CollisionModel.hpp>
 #include <data/Skeleton.hpp>
 #include <data/Model.hpp>
 #include <engine/Animator.hpp>
 #include <engine/GameData.hpp>
+#include <core/PoolAllocator.hpp>
 
 #define PART_CLOSE_VELOCITY 0.25f
 constexpr float kVehicleMaxExitVelocity = 0.15f;
@@ -22,7 +23,7 @@ VehicleObject::VehicleObject(GameWorld* engine, const glm::vec3& pos, const glm:
 	if( collision->createPhysicsBody(this, data->modelName, nullptr, &info->handling) ) {
 		physBody = collision->body;
 
-		physRaycaster = new VehicleRaycaster(this, engine->dynamicsWorld);
+		physRaycaster = new VehicleRaycaster(this, engine->raycasts);
 		btRaycastVehicle::btVehicleTuning tuning;
 
 		float travel = fabs(info->handling.suspensionUpperLimit - info->handling.suspensionLowerLimit);
@@ -100,6 +101,16 @@ VehicleObject::~VehicleObject()
 	delete physRaycaster;
 }
 
+void* VehicleObject::operator new(std::size_t size)
+{
+	return PoolAllocator<VehicleObject>::allocateObject(size);
+}
+
+void VehicleObject::operator delete(void* p, std::size_t size)
+{
+	PoolAllocator<VehicleObject>::deallocateObject(p, size);
+}
+
 void VehicleObject::setPosition(const glm::vec3& pos)
 {
 	GameObject::setPosition(pos);
@@ -119,6 +130,7 @@ void VehicleObject::setPosition(const glm::vec3& pos)
 		t.setOrigin(btVector3(pos.x, pos.y, pos.z));
 		physBody->setWorldTransform(t);
 	}
+	engine->vehicleHash.update(this, pos);
 }
 
 glm::vec3 VehicleObject::getPosition() const
@@ -157,6 +169,30 @@ void VehicleObject::tick(float dt)
 	// Moved to tickPhysics
 }
 
+void VehicleObject::setSimulationTier(SimulationTier tier)
+{
+	auto current = getSimulationTier();
+	if (tier == current) {
+		return;
+	}
+
+	if (physVehicle) {
+		if (tier == SimulationKinematic) {
+			// Parked where it is: no wheel raycasts and no integration, but the
+			// body is still there to collide with and shoot at
+			engine->dynamicsWorld->removeAction(physVehicle);
+			physBody->forceActivationState(DISABLE_SIMULATION);
+		}
+		else if (current == SimulationKinematic) {
+			engine->dynamicsWorld->addAction(physVehicle);
+			physBody->forceActivationState(ACTIVE_TAG);
+			physBody->activate(true);
+		}
+	}
+
+	GameObject::setSimulationTier(tier);
+}
+
 void VehicleObject::tickPhysics(float dt)
 {
 	RW_UNUSED(dt);
@@ -226,82 +262,12 @@ void VehicleObject::tickPhysics(float dt)
 			}
 		}
 
-		auto ws = getPosition();
-		auto wX = (int) ((ws.x + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
-		auto wY = (int) ((ws.y + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
-		btVector3 bbmin, bbmax;
-		// This is in world space.
-		physBody->getAabb(bbmin, bbmax);
-		float vH = bbmin.z();
-		float wH = 0.f;
-
-
-		if( wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 && wY < WATER_HQ_DATA_SIZE ) {
-			int i = (wX*WATER_HQ_DATA_SIZE) + wY;
-			int hI = engine->data->realWater[i];
-			if( hI < NO_WATER_INDEX ) {
-				wH = engine->data->waterHeights[hI];
-				wH += engine->data->getWaveHeightAt(ws);
-				// If the vehicle is currently underwater
-				if( vH <= wH ) {
-					// and was not underwater here in the last tick
-					if( _lastHeight >= wH ) {
-						// we are for real, underwater
-						inWater = true;
-					}
-					else if( inWater == false ) {
-						// It's just a tunnel or something, we good.
-						inWater = false;
-					}
-				}
-				else {
-					// The water is beneath us
-					inWater = false;
-				}
-			}
-			else {
-				inWater = false;
-			}
-		}
-
+		// inWater and the buoyancy impulses come from GameWorld::buoyancy
 		if( inWater ) {
-			// Ensure that vehicles don't fall asleep at the top of a wave.
-			if(! physBody->isActive() )
-			{
-				physBody->activate(true);
-			}
-			
-			float bbZ = info->handling.dimensions.z/2.f;
-
-			float oZ = 0.f;
-			oZ = -bbZ/2.f + (bbZ * (info->handling.percentSubmerged/120.f));
-
 			if( vehicle->type != VehicleData::BOAT ) {
 				// Damper motion
 				physBody->setDamping(0.95f, 0.9f);
 			}
-
-			if( vehicle->type == VehicleData::BOAT ) {
-				oZ = 0.f;
-			}
-
-			// Boats, Buoyancy offset is affected by the orientation of the chassis.
-			// Vehicles, it isn't.
-			glm::vec3 vFwd = glm::vec3(0.f, info->handling.dimensions.y/2.f, oZ),
-					vBack = glm::vec3(0.f, -info->handling.dimensions.y/2.f, oZ);
-			glm::vec3 vRt = glm::vec3( info->handling.dimensions.x/2.f, 0.f, oZ),
-					vLeft = glm::vec3(-info->handling.dimensions.x/2.f, 0.f, oZ);
-
-			vFwd = getRotation() * vFwd;
-			vBack = getRotation() * vBack;
-			vRt = getRotation() * vRt;
-			vLeft = getRotation() * vLeft;
-
-			// This function will try to keep v* at the water level.
-			applyWaterFloat( vFwd);
-			applyWaterFloat( vBack);
-			applyWaterFloat( vRt);
-			applyWaterFloat( vLeft);
 		}
 		else {
 			if( vehicle->type == VehicleData::BOAT ) {
@@ -312,8 +278,6 @@ void VehicleObject::tickPhysics(float dt)
 			}
 		}
 
-		_lastHeight = vH;
-
 		// Update hinge object rotations
 		for(auto& it : dynamicParts) {
 			if(it.second.body == nullptr) continue;
@@ -447,6 +411,10 @@ void VehicleObject::setOccupant(size_t seat, GameObject* occupant)
 	}
 	else {
 		seatOccupants[seat] = occupant;
+		// Parked vehicles need their physics back as soon as they're used
+		if (getSimulationTier() == SimulationKinematic) {
+			setSimulationTier(SimulationReduced);
+		}
 	}
 }
 
@@ -527,25 +495,6 @@ void VehicleObject::setPartState(VehicleObject::Part* part, VehicleObject::Frame
 	}
 }
 
-void VehicleObject::applyWaterFloat(const glm::vec3 &relPt)
-{
-	auto ws = getPosition() + relPt;
-	auto wi = engine->data->getWaterIndexAt(ws);
-	if(wi != NO_WATER_INDEX) {
-		float h = engine->data->waterHeights[wi];
-
-		// Calculate wave height
-		h += engine->data->getWaveHeightAt(ws);
-
-		if ( ws.z <= h ) {
-			float x = (h - ws.z);
-			float F = WATER_BUOYANCY_K * x + -WATER_BUOYANCY_C * physBody->getLinearVelocity().z();
-			physBody->applyImpulse(btVector3(0.f, 0.f, F),
-								 btVector3(relPt.x, relPt.y, relPt.z));
-		}
-	}
-}
-
 void VehicleObject::setPartLocked(VehicleObject::Part* part, bool locked)
 {
 	if( part->body == nullptr && locked == false )
@@ -759,20 +708,20 @@ bool VehicleObject::isStopped() const
 
 void *VehicleRaycaster::castRay(const btVector3 &from, const btVector3 &to, btVehicleRaycaster::btVehicleRaycasterResult &result)
 {
-	ClosestNotMeRayResultCallback rayCallback( _vehicle->physBody, from, to );
+	auto hit = _raycasts->cast({ glm::vec3(from.x(), from.y(), from.z()),
+								 glm::vec3(to.x(), to.y(), to.z()),
+								 _vehicle->physBody });
 
 	const void *res = 0;
 
-	_world->rayTest(from, to, rayCallback);
-
-	if( rayCallback.hasHit() ) {
-		const btRigidBody* body = btRigidBody::upcast( rayCallback.m_collisionObject );
+	if( hit.hit ) {
+		const btRigidBody* body = btRigidBody::upcast( hit.object );
 
 		if( body && body->hasContactResponse() ) {
-			result.m_hitPointInWorld = rayCallback.m_hitPointWorld;
-			result.m_hitNormalInWorld = rayCallback.m_hitNormalWorld;
+			result.m_hitPointInWorld = btVector3(hit.point.x, hit.point.y, hit.point.z);
+			result.m_hitNormalInWorld = btVector3(hit.normal.x, hit.normal.y, hit.normal.z);
 			result.m_hitNormalInWorld.normalize();
-			result.m_distFraction = rayCallback.m_closestHitFraction;
+			result.m_distFraction = hit.fraction;
 			res = body;
 		}
 	}
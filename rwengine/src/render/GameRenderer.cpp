@@ -22,14 +22,19 @@
 #include <render/GameShaders.hpp>
 #include <core/Logger.hpp>
 
+#include <cstddef>
 #include <deque>
 #include <cmath>
+#include <limits>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/string_cast.hpp>
 
 #include <core/Profiler.hpp>
 
 const size_t skydomeSegments = 8, skydomeRows = 10;
+const AssetID kArrowModel = internAssetName("arrow");
+const AssetID kArrowTexture = internAssetName("copblue");
+const AssetID kAreaIndicatorTexture = internAssetName("cloud1");
 constexpr uint32_t kMissingTextureBytes[] = {
 	0xFF0000FF, 0xFFFF00FF, 0xFF0000FF, 0xFFFF00FF,
 	0xFFFF00FF, 0xFF0000FF, 0xFFFF00FF, 0xFF0000FF,
@@ -47,6 +52,36 @@ struct WaterVertex {
 	float x, y;
 };
 
+namespace
+{
+/**
+ * @return A radius about the object's position that contains everything
+ * ObjectRenderer might draw for it, or infinity if that isn't known.
+ */
+float getCullingRadius(GameObject* object)
+{
+	if (object->type() != GameObject::Instance) {
+		return std::numeric_limits<float>::infinity();
+	}
+	auto instance = static_cast<InstanceObject*>(object);
+	// Animated and simulated parts can move anywhere, and the frames of
+	// multi-clump objects are placed relative to a child.
+	if (instance->skeleton || instance->animator || instance->dynamics
+		|| !instance->model->resource || instance->object->numClumps != 1) {
+		return std::numeric_limits<float>::infinity();
+	}
+
+	float radius = instance->model->resource->getCullingRadius();
+	auto lod = instance->LODinstance;
+	if (lod && lod->model->resource) {
+		radius = std::max(radius,
+						  glm::distance(lod->getPosition(), instance->getPosition())
+						  + lod->model->resource->getCullingRadius());
+	}
+	return radius;
+}
+}
+
 /// @todo collapse all of these into "VertPNC" etc.
 struct ParticleVert {
 	static const AttributeList vertex_attributes() {
@@ -65,6 +100,10 @@ struct ParticleVert {
 GeometryBuffer particleGeom;
 DrawBuffer particleDraw;
 
+/// Per-instance data for the particle batches, replaced every frame
+GeometryBuffer particleInstanceGeom;
+DrawBuffer particleBatchDraw;
+
 std::vector<VertexP2> sspaceRect = {
 	{-1.f, -1.f},
 	{ 1.f, -1.f},
@@ -82,6 +121,8 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
 	, _renderAlpha(0.f)
 	, _renderWorld(nullptr)
 	, cullOverride(false)
+	, occlusionCulling(true)
+	, splashID(0)
 	, map(renderer, _data)
 	, water(this)
 	, text(this)
@@ -95,6 +136,15 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
 	renderer->setUniformTexture(worldProg, "texture", 0);
 	renderer->setProgramBlockBinding(worldProg, "SceneData", 1);
 	renderer->setProgramBlockBinding(worldProg, "ObjectData", 2);
+
+	worldInstancedProg = renderer->createShader(
+				GameShaders::WorldObjectInstanced::VertexShader,
+				GameShaders::WorldObject::FragmentShader);
+
+	renderer->setUniformTexture(worldInstancedProg, "texture", 0);
+	renderer->setProgramBlockBinding(worldInstancedProg, "SceneData", 1);
+	renderer->setProgramBlockBinding(worldInstancedProg, "ObjectData", 2);
+	renderer->setInstancedProgram(worldInstancedProg);
 	
 	particleProg = renderer->createShader(
 		GameShaders::WorldObject::VertexShader,
@@ -104,6 +154,13 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
 	renderer->setProgramBlockBinding(particleProg, "SceneData", 1);
 	renderer->setProgramBlockBinding(particleProg, "ObjectData", 2);
 
+	particleBatchProg = renderer->createShader(
+		GameShaders::ParticleBatch::VertexShader,
+		GameShaders::ParticleBatch::FragmentShader);
+
+	renderer->setUniformTexture(particleBatchProg, "tex", 0);
+	renderer->setProgramBlockBinding(particleBatchProg, "SceneData", 1);
+
 	skyProg = renderer->createShader(
 		GameShaders::Sky::VertexShader,
 		GameShaders::Sky::FragmentShader);
@@ -202,6 +259,17 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
 	particleDraw.addGeometry(&particleGeom);
 	particleDraw.setFaceType(GL_TRIANGLE_STRIP);
 
+	particleInstanceGeom.uploadVertices(0, 0, nullptr, GL_STREAM_DRAW);
+	particleInstanceGeom.getDataAttributes() = {
+		{ATRS_Instance0, 3, sizeof(ParticleInstance), offsetof(ParticleInstance, origin), GL_FLOAT, 1},
+		{ATRS_Instance1, 3, sizeof(ParticleInstance), offsetof(ParticleInstance, axisX), GL_FLOAT, 1},
+		{ATRS_Instance2, 3, sizeof(ParticleInstance), offsetof(ParticleInstance, axisY), GL_FLOAT, 1},
+		{ATRS_Instance3, 4, sizeof(ParticleInstance), offsetof(ParticleInstance, colour), GL_UNSIGNED_BYTE, 1}
+	};
+	particleBatchDraw.addGeometry(&particleGeom);
+	particleBatchDraw.addGeometry(&particleInstanceGeom);
+	particleBatchDraw.setFaceType(GL_TRIANGLE_STRIP);
+
 	ssRectGeom.uploadVertices(sspaceRect);
 	ssRectDraw.addGeometry(&ssRectGeom);
 	ssRectDraw.setFaceType(GL_TRIANGLE_STRIP);
@@ -319,6 +387,24 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera &camera, float
 	
 	culled = 0;
 
+	const OcclusionBuffer* occlusion = nullptr;
+	if (occlusionCulling)
+	{
+		RW_PROFILE_BEGIN("Occluders");
+		if (cullOverride)
+		{
+			occlusionCuller.build(world, cullingCamera,
+								  cullingCamera.frustum.projection() * cullingCamera.getView(),
+								  _renderAlpha);
+		}
+		else
+		{
+			occlusionCuller.build(world, _camera, proj * view, _renderAlpha);
+		}
+		occlusion = &occlusionCuller.getBuffer();
+		RW_PROFILE_END();
+	}
+
 	renderer->useProgram(worldProg);
 
 	//===============================================================
@@ -338,12 +424,26 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera &camera, float
 	ObjectRenderer objectRenderer(_renderWorld,
 					  (cullOverride ? cullingCamera : _camera),
 					  _renderAlpha,
-					  getMissingTexture());
+					  getMissingTexture(),
+					  occlusion);
+
+	// Whole objects are culled in batches before their frames are
+	cullSpheres.clear();
+	for (auto object : world->allObjects) {
+		cullSpheres.add(object->getPosition(), getCullingRadius(object));
+	}
+	(cullOverride ? cullingCamera : _camera).frustum.intersects(cullSpheres, cullMask);
 
 	// World Objects
+	std::size_t index = 0;
 	for (auto object : world->allObjects) {
+		if (!ViewFrustum::isVisible(cullMask, index++)) {
+			culled++;
+			continue;
+		}
 		objectRenderer.buildRenderList(object, renderList);
 	}
+	culled += objectRenderer.getOccludedCount();
 	RW_PROFILE_END();
 
 	renderer->pushDebugGroup("Objects");
@@ -368,10 +468,14 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera &camera, float
 	RW_PROFILE_END();
 
 	// Render arrows above anything that isn't radar only (or hidden)
-	ModelRef& arrowModel = world->data->models["arrow"];
-	if( arrowModel && arrowModel->resource )
+	if( ! arrowModel ) {
+		arrowModel = world->data->findModel(kArrowModel);
+	}
+	if( ! arrowTexture ) {
+		arrowTexture = world->data->findTexture(kArrowTexture);
+	}
+	if( arrowModel && arrowModel->resource && arrowTexture )
 	{
-		auto arrowTex = world->data->textures[{"copblue",""}];
 		auto arrowFrame = arrowModel->resource->findFrame( "arrow" );
 		for( auto& blip : world->state->radarBlips )
 		{
@@ -398,7 +502,7 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera &camera, float
 				model = glm::scale( model, glm::vec3(1.5f, 1.5f, 1.5f) );
 
 				Renderer::DrawParameters dp;
-				dp.textures = {arrowTex->getName()};
+				dp.textures = {arrowTexture->getName()};
 				dp.ambient = 1.f;
 				dp.colour = glm::u8vec4(255, 255, 255, 255);
 
@@ -407,9 +511,10 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera &camera, float
 
 				dp.start = sg.start;
 				dp.count = sg.numIndices;
+				dp.baseVertex = geom->baseVertex;
 				dp.diffuse = 1.f;
 
-				renderer->draw( model, &geom->dbuff, dp );
+				renderer->draw( model, geom->getDrawBuffer(), dp );
 			}
 		}
 	}
@@ -454,10 +559,19 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera &camera, float
 	GLuint splashTexName = 0;
 	auto fc = world->state->fadeColour;
 	if((fc.r + fc.g + fc.b) == 0 && world->state->currentSplash.size() > 0) {
-		auto splash = world->data->findTexture(world->state->currentSplash);
-		if ( splash )
+		if ( world->state->currentSplash != splashName )
 		{
-			splashTexName = splash->getName();
+			splashName = world->state->currentSplash;
+			splashID = internAssetName(splashName);
+			splashTexture = nullptr;
+		}
+		if ( ! splashTexture )
+		{
+			splashTexture = world->data->findTexture(splashID);
+		}
+		if ( splashTexture )
+		{
+			splashTexName = splashTexture->getName();
 		}
 	}
 
@@ -536,6 +650,7 @@ void GameRenderer::renderGeometry(Model* model, size_t g, const glm::mat4& model
 		dp.colour = {255, 255, 255, 255};
 		dp.count = subgeom.numIndices;
 		dp.start = subgeom.start;
+		dp.baseVertex = model->geometries[g]->baseVertex;
 		dp.textures = {0};
 
 		if (model->geometries[g]->materials.size() > subgeom.material) {
@@ -550,7 +665,7 @@ void GameRenderer::renderGeometry(Model* model, size_t g, const glm::mat4& model
 					tex = data->findTexture(tC, tA);
 					if( ! tex )
 					{
-						//logger->warning("Renderer", "Missing texture: " + tC + " " + tA);
+						//logger->warning("Renderer", "Missing texture: " + getAssetName(tC) + " " + getAssetName(tA));
 					}
 					mat.textures[0].texture = tex;
 				}
@@ -580,7 +695,7 @@ void GameRenderer::renderGeometry(Model* model, size_t g, const glm::mat4& model
 			dp.ambient = mat.ambientIntensity;
 		}
 
-		renderer->draw(modelMatrix, &model->geometries[g]->dbuff, dp);
+		renderer->draw(modelMatrix, model->geometries[g]->getDrawBuffer(), dp);
 	}
 }
 
@@ -591,8 +706,15 @@ void GameRenderer::renderAreaIndicator(const AreaIndicatorInfo* info)
 	m = glm::translate(m, info->position);
 	glm::vec3 scale = info->radius + 0.15f * glm::sin(_renderWorld->getGameTime() * 5.f);
 	
+	if( ! areaIndicatorTexture ) {
+		areaIndicatorTexture = data->findTexture(kAreaIndicatorTexture);
+		if( ! areaIndicatorTexture ) {
+			return;
+		}
+	}
+
 	Renderer::DrawParameters dp;
-	dp.textures = {data->findTexture("cloud1")->getName()};
+	dp.textures = {areaIndicatorTexture->getName()};
 	dp.ambient = 1.f;
 	dp.colour = glm::u8vec4(50, 100, 255, 128);
 	dp.start = 0;
@@ -613,67 +735,33 @@ void GameRenderer::renderAreaIndicator(const AreaIndicatorInfo* info)
 
 void GameRenderer::renderEffects(GameWorld* world)
 {
-	renderer->useProgram( particleProg );
-
 	auto cpos = _camera.position;
 	auto cfwd = glm::normalize(glm::inverse(_camera.rotation) * glm::vec3(0.f, 1.f, 0.f));
-	
-	auto& effects = world->effects;
-
-	std::sort( effects.begin(), effects.end(),
-			   [&](const VisualFX* a, const VisualFX* b) {
-		return glm::distance( a->getPosition(), cpos ) > glm::distance( b->getPosition(), cpos );
-	});
-
-	for(VisualFX* fx : effects) {
-		// Other effects not implemented yet
-		if( fx->getType() != VisualFX::Particle ) continue;
-		
-		auto& particle = fx->particle;
-
-		auto& p = particle.position;
 
-		glm::mat4 m(1.f);
+	auto& particles = world->particles;
+	particles.buildBatches(cpos, cfwd);
 
-		// Figure the direction to the camera center.
-		auto amp = cpos - p;
-		glm::vec3 ptc = particle.up;
+	auto& instances = particles.getInstances();
+	if (instances.empty()) {
+		return;
+	}
 
-		if( particle.orientation == VisualFX::ParticleData::UpCamera ) {
-			ptc = glm::normalize(amp - (glm::dot(amp, cfwd))*cfwd);
-		}
-		else if( particle.orientation == VisualFX::ParticleData::Camera ) {
-			ptc = amp;
-		}
+	renderer->useProgram( particleBatchProg );
 
-		glm::vec3 f = glm::normalize(particle.direction);
-		glm::vec3 s = glm::cross(f, glm::normalize(ptc));
-		glm::vec3 u	= glm::cross(s, f);
-		m[0][0] = s.x;
-		m[1][0] = s.y;
-		m[2][0] = s.z;
-		m[0][1] =-f.x;
-		m[1][1] =-f.y;
-		m[2][1] =-f.z;
-		m[0][2] = u.x;
-		m[1][2] = u.y;
-		m[2][2] = u.z;
-		m[3][0] =-glm::dot(s, p);
-		m[3][1] = glm::dot(f, p);
-		m[3][2] =-glm::dot(u, p);
-		m = glm::scale(glm::inverse(m), glm::vec3(particle.size, 1.f));
-
-		//m = glm::translate(m, p);
+	for (auto& batch : particles.getBatches()) {
+		// GL 3.3 has no base instance, so each texture's instances are
+		// streamed in before its draw.
+		particleInstanceGeom.uploadVertices(batch.count,
+											batch.count * sizeof(ParticleInstance),
+											instances.data() + batch.first,
+											GL_STREAM_DRAW);
 
 		Renderer::DrawParameters dp;
-		dp.textures = {particle.texture->getName()};
-		dp.ambient = 1.f;
-		dp.colour = glm::u8vec4(particle.colour * 255.f);
+		dp.textures = {batch.texture};
 		dp.start = 0;
 		dp.count = 4;
-		dp.diffuse = 1.f;
-		
-		renderer->drawArrays(m, &particleDraw, dp);
+
+		renderer->drawArraysInstanced(&particleBatchDraw, dp, batch.count);
 	}
 }
 
@@ -804,8 +892,9 @@ void GameRenderer::renderPaths()
 
     glBindVertexArray( vao );
 
-    for( size_t n = 0; n < engine->aigraph.nodes.size(); ++n ) {
-        auto start = engine->aigraph.nodes[n];
+    auto& graph = engine->aigraph;
+    for( size_t n = 0; n < graph.nodes.size(); ++n ) {
+        auto start = &graph.nodes[n];
 		
 		if( start->type == AIGraphNode::Pedestrian ) {
 			pedlines.push_back(start->position);
@@ -821,8 +910,8 @@ void GameRenderer::renderPaths()
 			carlines.push_back(start->position+glm::vec3(start->size / 2.f, 0.f, 0.f));
 		}
 
-		for( size_t c = 0; c < start->connections.size(); ++c ) {
-			auto end = start->connections[c];
+		graph.forEachConnection(n, [&](AIGraph::NodeIndex c) {
+			auto end = &graph.nodes[c];
 			
 			if( start->type == AIGraphNode::Pedestrian ) {	
 				pedlines.push_back(start->position + glm::vec3(0.f, 0.f, 1.f));
@@ -832,7 +921,7 @@ void GameRenderer::renderPaths()
 				carlines.push_back(start->position + glm::vec3(0.f, 0.f, 1.f));
 				carlines.push_back(end->position + glm::vec3(0.f, 0.f, 1.f));
 			}
-		}
+		});
     }
 
     glm::mat4 model;
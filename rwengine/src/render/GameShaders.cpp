@@ -192,6 +192,52 @@ void main()
 	WorldSpace = vec4(worldspace.xyz, length(worldspace.xyz - campos.xyz));
 })";
 
+const char* WorldObjectInstanced::VertexShader = R"(
+#version 330
+#extension GL_ARB_explicit_attrib_location : enable
+#extension GL_ARB_uniform_buffer_object : enable
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec4 _colour;
+layout(location = 3) in vec2 texCoords;
+layout(location = 4) in mat4 instanceModel;
+out vec3 Normal;
+out vec2 TexCoords;
+out vec4 Colour;
+out vec4 WorldSpace;
+
+layout(std140) uniform SceneData {
+	mat4 projection;
+	mat4 view;
+	vec4 ambient;
+	vec4 dynamic;
+	vec4 fogColor;
+	vec4 campos;
+	float fogStart;
+	float fogEnd;
+};
+
+layout(std140) uniform ObjectData {
+	mat4 model;
+	vec4 colour;
+	float diffusefac;
+	float ambientfac;
+	float visibility;
+};
+
+void main()
+{
+	Normal = normal;
+	TexCoords = texCoords;
+	Colour = _colour;
+	vec4 worldspace = model * instanceModel * vec4(position, 1.0);
+	vec4 viewspace = view * worldspace;
+	gl_Position = projection * viewspace;
+
+	WorldSpace = vec4(worldspace.xyz, length(worldspace.xyz - campos.xyz));
+})";
+
 const char* WorldObject::FragmentShader = R"(
 #version 330
 #extension GL_ARB_uniform_buffer_object : enable
@@ -289,6 +335,57 @@ void main()
 })";
 
 
+const char* ParticleBatch::VertexShader = R"(
+#version 330
+#extension GL_ARB_explicit_attrib_location : enable
+#extension GL_ARB_uniform_buffer_object : enable
+
+layout(location = 0) in vec2 position;
+layout(location = 3) in vec2 texCoords;
+layout(location = 4) in vec3 origin;
+layout(location = 5) in vec3 axisX;
+layout(location = 6) in vec3 axisY;
+layout(location = 7) in vec4 _colour;
+out vec2 TexCoords;
+out vec4 Colour;
+
+layout(std140) uniform SceneData {
+	mat4 projection;
+	mat4 view;
+	vec4 ambient;
+	vec4 dynamic;
+	vec4 fogColor;
+	vec4 campos;
+	float fogStart;
+	float fogEnd;
+};
+
+void main()
+{
+	TexCoords = texCoords;
+	Colour = _colour;
+	vec3 worldspace = origin + axisX * position.x + axisY * position.y;
+	gl_Position = projection * view * vec4(worldspace, 1.0);
+})";
+
+const char* ParticleBatch::FragmentShader = R"(
+#version 330
+
+in vec2 TexCoords;
+in vec4 Colour;
+uniform sampler2D tex;
+out vec4 outColour;
+
+#define ALPHA_DISCARD_THRESHOLD 0.01
+
+void main()
+{
+	vec4 c = texture(tex, TexCoords);
+	c.a = clamp(0, length(c.rgb/length(vec3(1,1,1))), 1);
+	if(c.a <= ALPHA_DISCARD_THRESHOLD) discard;
+	outColour = c * vec4(Colour.rgb, 1.0);
+})";
+
 const char* ScreenSpaceRect::VertexShader = R"(
 #version 330
 #extension GL_ARB_explicit_attrib_location : enable
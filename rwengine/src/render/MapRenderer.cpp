@@ -6,6 +6,13 @@
 #include <ai/PlayerController.hpp>
 #include <objects/CharacterObject.hpp>
 
+namespace
+{
+const AssetID kRadarDiscTexture = internAssetName("radardisc");
+const AssetID kRadarCentreTexture = internAssetName("radar_centre");
+const AssetID kRadarNorthTexture = internAssetName("radar_north");
+}
+
 const char* MapVertexShader = R"(
 #version 330
 #extension GL_ARB_explicit_attrib_location : enable
@@ -52,6 +59,12 @@ MapRenderer::MapRenderer(Renderer* renderer, GameData* _data)
 	rect.addGeometry(&rectGeom);
 	rect.setFaceType(GL_TRIANGLE_STRIP);
 
+	for( int m = 0; m < MAP_BLOCK_SIZE; ++m )
+	{
+		std::string num = (m < 10 ? "0" : "");
+		radarTiles[m] = internAssetName("radar" + num + std::to_string(m));
+	}
+
 	std::vector<VertexP2> circleVerts;
 	circleVerts.push_back({0.f, 0.f});
 	for (int v = 0; v < 181; ++v) {
@@ -127,11 +140,9 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi)
 
 	for( int m = 0; m < MAP_BLOCK_SIZE; ++m )
 	{
-		std::string num = (m < 10 ? "0" : "");
-		std::string name = "radar" + num +  std::to_string(m);
-		auto texture = world->data->textures[{name,""}];
+		auto texture = world->data->findTexture(radarTiles[m]);
 		
-		glBindTexture(GL_TEXTURE_2D, texture->getName());
+		glBindTexture(GL_TEXTURE_2D, texture ? texture->getName() : 0);
 		
 		int mX = initX + (m % mapBlockLine);
 		int mY = initY + (m / mapBlockLine);
@@ -154,7 +165,7 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi)
 		glDisable(GL_STENCIL_TEST);
 		// We only need the outer ring if we're clipping.
 		glBlendFuncSeparate(GL_DST_COLOR, GL_ZERO, GL_ONE, GL_ZERO);
-		TextureData::Handle radarDisc = data->findTexture("radardisc");
+		TextureData::Handle radarDisc = data->findTexture(kRadarDiscTexture);
 
 		glm::mat4 model;
 		model = glm::translate(model, glm::vec3(mi.screenPosition, 0.0f));
@@ -186,10 +197,10 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi)
 	{
 		glm::vec2 plyblip(player->getPosition());
 		float hdg = glm::roll(player->getRotation());
-		drawBlip(plyblip, view, mi, "radar_centre", mi.rotation - hdg);
+		drawBlip(plyblip, view, mi, kRadarCentreTexture, mi.rotation - hdg);
 	}
 
-	drawBlip(mi.worldCenter + glm::vec2(0.f, mi.worldSize), view, mi, "radar_north", 0.f, 24.f);
+	drawBlip(mi.worldCenter + glm::vec2(0.f, mi.worldSize), view, mi, kRadarNorthTexture, 0.f, 24.f);
 
 	glBindVertexArray( 0 );
 	glBindTexture(GL_TEXTURE_2D, 0);
@@ -200,7 +211,7 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi)
 	renderer->popDebugGroup();
 }
 
-void MapRenderer::drawBlip(const glm::vec2& coord, const glm::mat4& view, const MapInfo& mi, const std::string& texture, float heading, float size)
+void MapRenderer::drawBlip(const glm::vec2& coord, const glm::mat4& view, const MapInfo& mi, AssetID texture, float heading, float size)
 {
 	glm::vec2 adjustedCoord = coord;
 	if (mi.clipToSize)
@@ -220,10 +231,10 @@ void MapRenderer::drawBlip(const glm::vec2& coord, const glm::mat4& view, const
 	renderer->setUniform(rectProg, "model", model);
 
 	GLuint tex = 0;
-	if ( !texture.empty() )
+	if ( texture != 0 )
 	{
 		auto sprite= data->findTexture(texture);
-		tex = sprite->getName();
+		tex = sprite ? sprite->getName() : 0;
 		renderer->setUniform(rectProg, "colour", glm::vec4(0.f, 0.f, 0.f, 1.f));
 	}
 	else
@@ -0,0 +1,125 @@
+#include <render/NullRenderer.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+NullRenderer::NullRenderer()
+	: currentDbuff(nullptr)
+	, profileInfo()
+{
+	std::fill(std::begin(currentTextures), std::end(currentTextures), 0);
+	swap();
+}
+
+std::string NullRenderer::getIDString() const
+{
+	return "Null Renderer";
+}
+
+Renderer::ShaderProgram* NullRenderer::createShader(const std::string&, const std::string&)
+{
+	return new ShaderProgram;
+}
+
+void NullRenderer::useProgram(Renderer::ShaderProgram*)
+{
+}
+
+void NullRenderer::setProgramBlockBinding(Renderer::ShaderProgram*, const std::string&, GLint)
+{
+}
+
+void NullRenderer::setUniformTexture(Renderer::ShaderProgram*, const std::string&, GLint)
+{
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram*, const std::string&, const glm::mat4&)
+{
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram*, const std::string&, const glm::vec4&)
+{
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram*, const std::string&, const glm::vec3&)
+{
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram*, const std::string&, const glm::vec2&)
+{
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram*, const std::string&, float)
+{
+}
+
+void NullRenderer::clear(const glm::vec4&, bool, bool)
+{
+}
+
+void NullRenderer::setSceneParameters(const Renderer::SceneUniformData& data)
+{
+	lastSceneData = data;
+}
+
+void NullRenderer::setDrawState(DrawBuffer* draw, const Renderer::DrawParameters& p)
+{
+	if( draw != currentDbuff ) {
+		currentDbuff = draw;
+		bufferCounter++;
+	}
+
+	for( GLuint u = 0; u < p.textures.size(); ++u )
+	{
+		if( u >= MAX_TEXTURE_UNITS || currentTextures[u] != p.textures[u] ) {
+			if( u < MAX_TEXTURE_UNITS ) {
+				currentTextures[u] = p.textures[u];
+			}
+			textureCounter++;
+		}
+	}
+
+	drawCounter++;
+}
+
+void NullRenderer::draw(const glm::mat4&, DrawBuffer* draw, const Renderer::DrawParameters& p)
+{
+	setDrawState(draw, p);
+}
+
+void NullRenderer::drawArrays(const glm::mat4&, DrawBuffer* draw, const Renderer::DrawParameters& p)
+{
+	setDrawState(draw, p);
+}
+
+void NullRenderer::drawArraysInstanced(DrawBuffer* draw, const Renderer::DrawParameters& p, unsigned int)
+{
+	setDrawState(draw, p);
+}
+
+void NullRenderer::drawBatched(const RenderList& list)
+{
+	// As though the instance buffer could hold any number of transforms
+	batchRenderList(list, batches, instancedProgram ? std::numeric_limits<size_t>::max() : 0);
+	for(auto& batch : batches)
+	{
+		auto& first = list[batch.first];
+		setDrawState(first.dbuff, first.drawInfo);
+	}
+}
+
+void NullRenderer::invalidate()
+{
+	currentDbuff = nullptr;
+	std::fill(std::begin(currentTextures), std::end(currentTextures), 0);
+}
+
+void NullRenderer::pushDebugGroup(const std::string&)
+{
+}
+
+const Renderer::ProfileInfo& NullRenderer::popDebugGroup()
+{
+	return profileInfo;
+}
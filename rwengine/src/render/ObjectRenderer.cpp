@@ -18,6 +18,12 @@
 #include <rw_mingw.hpp>
 #endif
 
+namespace
+{
+const AssetID kWeaponsModel = internAssetName("weapons");
+const AssetID kWheelsModel = internAssetName("wheels");
+}
+
 constexpr float kDrawDistanceFactor = 1.0f;
 constexpr float kWorldDrawDistanceFactor = kDrawDistanceFactor;
 #if 0 // There's no distance based culling for these types of objects yet
@@ -25,11 +31,27 @@ constexpr float kVehicleDrawDistanceFactor = kDrawDistanceFactor;
 constexpr float kPedestrianDrawDistanceFactor = kDrawDistanceFactor;
 #endif
 
-RenderKey createKey(bool transparent, float normalizedDepth, Renderer::Textures& textures)
+RenderKey ObjectRenderer::createKey(bool transparent,
+									float normalizedDepth,
+									const DrawBuffer* dbuff,
+									const Renderer::DrawParameters& dp)
 {
-	return ((transparent?0x1:0x0) << 31)
-			| uint32_t(0x7FFFFF * (transparent? 1.f - normalizedDepth : normalizedDepth)) << 8
-			| uint8_t(0xFF & (textures.size() > 0 ? textures[0] : 0)) << 0;
+	normalizedDepth = glm::clamp(normalizedDepth, 0.f, 1.f);
+	RenderKey texture = dp.textures.size() > 0 ? dp.textures[0] : 0;
+
+	if( transparent ) {
+		return RenderKey(1) << 63
+				| RenderKey(0x7FFFFF * (1.f - normalizedDepth)) << 8
+				| (texture & 0xFF);
+	}
+
+	// Identifies the range drawn; a collision only costs a batch
+	auto geometry = uint32_t(reinterpret_cast<uintptr_t>(dbuff) >> 4) * 2654435761u
+			^ (dp.start * 40503u + uint32_t(dp.baseVertex)) * 2246822519u;
+
+	return (texture & 0xFFFF) << 47
+			| RenderKey(geometry >> 9) << 24
+			| RenderKey(0xFFFFFF * normalizedDepth);
 }
 
 void ObjectRenderer::renderGeometry(Model* model,
@@ -50,6 +72,7 @@ void ObjectRenderer::renderGeometry(Model* model,
 		dp.colour = {255, 255, 255, 255};
 		dp.count = subgeom.numIndices;
 		dp.start = subgeom.start;
+		dp.baseVertex = model->geometries[g]->baseVertex;
 		dp.textures = {0};
 		dp.visibility = 1.f;
 
@@ -70,7 +93,7 @@ void ObjectRenderer::renderGeometry(Model* model,
 					tex = m_world->data->findTexture(tC, tA);
 					if( ! tex )
 					{
-						//logger->warning("Renderer", "Missing texture: " + tC + " " + tA);
+						//logger->warning("Renderer", "Missing texture: " + getAssetName(tC) + " " + getAssetName(tA));
 						dp.textures = { m_errorTexture };
 					}
 					mat.textures[0].texture = tex;
@@ -114,9 +137,9 @@ void ObjectRenderer::renderGeometry(Model* model,
 		float distance = glm::length(m_camera.position - position);
 		float depth = (distance - m_camera.frustum.near) / (m_camera.frustum.far - m_camera.frustum.near);
 		outList.emplace_back(
-							  createKey(isTransparent, depth * depth, dp.textures),
+							  createKey(isTransparent, depth * depth, model->geometries[g]->getDrawBuffer(), dp),
 							  modelMatrix,
-							  &model->geometries[g]->dbuff,
+							  model->geometries[g]->getDrawBuffer(),
 							  dp
 						  );
 	}
@@ -173,7 +196,7 @@ void ObjectRenderer::renderItem(InventoryItem *item,
 	}
 
 	std::shared_ptr<ObjectData> odata = m_world->data->findObjectType<ObjectData>(item->getModelID());
-	auto weapons = m_world->data->models["weapons"];
+	auto weapons = m_world->data->findModel(kWeaponsModel);
 	if( weapons && weapons->resource ) {
 		auto itemModel = weapons->resource->findFrame(odata->modelName + "_l0");
 		auto matrix = glm::inverse(itemModel->getTransform());
@@ -196,6 +219,13 @@ void ObjectRenderer::renderInstance(InstanceObject *instance,
 		return;
 	}
 
+	if(m_occlusion && !m_occlusion->isVisible(instance->getPosition(),
+											  instance->model->resource->getBoundingRadius()))
+	{
+		m_occluded++;
+		return;
+	}
+
 	auto matrixModel = instance->getTimeAdjustedTransform(m_renderAlpha);
 
 	float mindist = glm::length(instance->getPosition()-m_camera.position)
@@ -379,7 +409,7 @@ void ObjectRenderer::renderVehicle(VehicleObject *vehicle,
 	for( size_t w = 0; w < vehicle->info->wheels.size(); ++w) {
 		auto woi = m_world->data->findObjectType<ObjectData>(vehicle->vehicle->wheelModelID);
 		if( woi ) {
-			Model* wheelModel = m_world->data->models["wheels"]->resource;
+			Model* wheelModel = m_world->data->findModel(kWheelsModel)->resource;
 			auto& wi = vehicle->physVehicle->getWheelInfo(w);
 			if( wheelModel ) {
 				// Construct our own matrix so we can use the local transform
@@ -439,7 +469,7 @@ void ObjectRenderer::renderPickup(PickupObject *pickup,
 	/// @todo Better determination of is this object a weapon.
 	if( odata->ID >= 170 && odata->ID <= 184 )
 	{
-		auto weapons = m_world->data->models["weapons"];
+		auto weapons = m_world->data->findModel(kWeaponsModel);
 		if( weapons && weapons->resource && odata ) {
 			model = weapons->resource;
 			itemModel = weapons->resource->findFrame(odata->modelName + "_l0");
@@ -452,7 +482,7 @@ void ObjectRenderer::renderPickup(PickupObject *pickup,
 	}
 	else
 	{
-		auto handle = m_world->data->models[odata->modelName];
+		auto handle = m_world->data->findModel(odata->modelName);
 		RW_CHECK( handle && handle->resource, "Pickup has no model");
 		if ( handle && handle->resource )
 		{
@@ -529,7 +559,7 @@ void ObjectRenderer::renderProjectile(ProjectileObject *projectile,
 	glm::mat4 modelMatrix = projectile->getTimeAdjustedTransform(m_renderAlpha);
 
 	auto odata = m_world->data->findObjectType<ObjectData>(projectile->getProjectileInfo().weapon->modelID);
-	auto weapons = m_world->data->models["weapons"];
+	auto weapons = m_world->data->findModel(kWeaponsModel);
 
 	RW_CHECK(weapons, "Weapons model not loaded");
 
@@ -0,0 +1,284 @@
+#include <render/OcclusionBuffer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RW_OCCLUSION_SSE 1
+#else
+#define RW_OCCLUSION_SSE 0
+#endif
+
+namespace
+{
+const uint32_t kBoxIndices[] = {
+	0, 1, 3,  0, 3, 2,
+	4, 6, 7,  4, 7, 5,
+	0, 4, 5,  0, 5, 1,
+	2, 3, 7,  2, 7, 6,
+	0, 2, 6,  0, 6, 4,
+	1, 5, 7,  1, 7, 3,
+};
+
+/**
+ * Linear function of pixel position, A * x + B * y + C
+ */
+struct PixelFunction
+{
+	float a;
+	float b;
+	float c;
+};
+
+/**
+ * The edge from p to q, positive to its left
+ */
+PixelFunction edge(const glm::vec3& p, const glm::vec3& q)
+{
+	float a = p.y - q.y;
+	float b = q.x - p.x;
+	return {a, b, -(a * p.x + b * p.y)};
+}
+}
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+	: width((width + 3) & ~3)
+	, height(height)
+	, depth(this->width * height, 1.f)
+	, triangles(0)
+{
+}
+
+void OcclusionBuffer::begin(const glm::mat4& viewProjection)
+{
+	this->viewProjection = viewProjection;
+	std::fill(depth.begin(), depth.end(), 1.f);
+	triangles = 0;
+}
+
+void OcclusionBuffer::drawTriangles(const glm::mat4& model,
+									const glm::vec3* vertices,
+									std::size_t vertexCount,
+									const uint32_t* indices,
+									std::size_t indexCount)
+{
+	auto mvp = viewProjection * model;
+	clipVertices.resize(vertexCount);
+	for(std::size_t v = 0; v < vertexCount; ++v)
+	{
+		clipVertices[v] = mvp * glm::vec4(vertices[v], 1.f);
+	}
+
+	for(std::size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		drawClipTriangle(clipVertices[indices[i]],
+						 clipVertices[indices[i+1]],
+						 clipVertices[indices[i+2]]);
+	}
+}
+
+void OcclusionBuffer::drawBox(const glm::mat4& model, const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 corners[8];
+	for(int c = 0; c < 8; ++c)
+	{
+		corners[c] = glm::vec3(c & 4 ? max.x : min.x,
+							   c & 2 ? max.y : min.y,
+							   c & 1 ? max.z : min.z);
+	}
+	drawTriangles(model, corners, 8, kBoxIndices, 36);
+}
+
+void OcclusionBuffer::drawClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+	// Clip against the near plane, z = -w, leaving at most a quad
+	const glm::vec4 in[3] = {a, b, c};
+	glm::vec4 out[4];
+	int count = 0;
+	for(int i = 0; i < 3; ++i)
+	{
+		auto& p = in[i];
+		auto& q = in[(i + 1) % 3];
+		float dp = p.z + p.w;
+		float dq = q.z + q.w;
+		if( dp >= 0.f ) {
+			out[count++] = p;
+		}
+		if( (dp >= 0.f) != (dq >= 0.f) ) {
+			out[count++] = p + (q - p) * (dp / (dp - dq));
+		}
+	}
+	if( count < 3 ) {
+		return;
+	}
+
+	glm::vec3 screen[4];
+	for(int i = 0; i < count; ++i)
+	{
+		if( out[i].w <= 0.f ) {
+			return;
+		}
+		float inv = 1.f / out[i].w;
+		screen[i] = glm::vec3((out[i].x * inv * 0.5f + 0.5f) * width,
+							  (out[i].y * inv * 0.5f + 0.5f) * height,
+							  out[i].z * inv);
+	}
+
+	for(int i = 1; i + 1 < count; ++i)
+	{
+		rasterize(screen[0], screen[i], screen[i + 1]);
+	}
+	triangles++;
+}
+
+void OcclusionBuffer::rasterize(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2)
+{
+	float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+	if( std::abs(area) < 1e-6f ) {
+		return;
+	}
+	// Occluders may be seen from either side
+	if( area < 0.f ) {
+		std::swap(v1, v2);
+		area = -area;
+	}
+
+	int minX = std::max(0, int(std::floor(std::min({v0.x, v1.x, v2.x}))));
+	int minY = std::max(0, int(std::floor(std::min({v0.y, v1.y, v2.y}))));
+	int maxX = std::min(width - 1, int(std::floor(std::max({v0.x, v1.x, v2.x}))));
+	int maxY = std::min(height - 1, int(std::floor(std::max({v0.y, v1.y, v2.y}))));
+	if( minX > maxX || minY > maxY ) {
+		return;
+	}
+
+	// Pixels on a shared edge are drawn by both triangles, so there are no
+	// cracks between them
+	auto e0 = edge(v1, v2);
+	auto e1 = edge(v2, v0);
+	auto e2 = edge(v0, v1);
+
+	// The depth plane, moved back to the farthest point of each pixel
+	float dzdx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+	float dzdy = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+	PixelFunction z {dzdx, dzdy,
+		v0.z - dzdx * v0.x - dzdy * v0.y + 0.5f * (std::abs(dzdx) + std::abs(dzdy))};
+
+	// Rows are a multiple of 4 wide, so aligned groups never run off the end
+	int startX = minX & ~3;
+
+#if RW_OCCLUSION_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 steps = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 e0a = _mm_set1_ps(e0.a), e1a = _mm_set1_ps(e1.a), e2a = _mm_set1_ps(e2.a);
+	const __m128 za = _mm_set1_ps(z.a);
+#endif
+
+	for(int y = minY; y <= maxY; ++y)
+	{
+		float cy = y + 0.5f;
+		float* row = &depth[y * width];
+
+#if RW_OCCLUSION_SSE
+		const __m128 e0y = _mm_set1_ps(e0.b * cy + e0.c);
+		const __m128 e1y = _mm_set1_ps(e1.b * cy + e1.c);
+		const __m128 e2y = _mm_set1_ps(e2.b * cy + e2.c);
+		const __m128 zy = _mm_set1_ps(z.b * cy + z.c);
+
+		for(int x = startX; x <= maxX; x += 4)
+		{
+			__m128 cx = _mm_add_ps(_mm_set1_ps(float(x)), steps);
+			__m128 inside = _mm_and_ps(
+						_mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e0a, cx), e0y), zero),
+								   _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e1a, cx), e1y), zero)),
+						_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e2a, cx), e2y), zero));
+			if( _mm_movemask_ps(inside) == 0 ) {
+				continue;
+			}
+
+			__m128 current = _mm_loadu_ps(row + x);
+			__m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(za, cx), zy));
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest),
+											 _mm_andnot_ps(inside, current)));
+		}
+#else
+		for(int x = startX; x <= maxX; ++x)
+		{
+			float cx = x + 0.5f;
+			if( e0.a * cx + e0.b * cy + e0.c >= 0.f &&
+				e1.a * cx + e1.b * cy + e1.c >= 0.f &&
+				e2.a * cx + e2.b * cy + e2.c >= 0.f ) {
+				row[x] = std::min(row[x], z.a * cx + z.b * cy + z.c);
+			}
+		}
+#endif
+	}
+}
+
+bool OcclusionBuffer::isVisible(const glm::vec3& min, const glm::vec3& max) const
+{
+	float minX = std::numeric_limits<float>::max();
+	float minY = std::numeric_limits<float>::max();
+	float maxX = std::numeric_limits<float>::lowest();
+	float maxY = std::numeric_limits<float>::lowest();
+	float nearest = std::numeric_limits<float>::max();
+
+	for(int c = 0; c < 8; ++c)
+	{
+		auto clip = viewProjection * glm::vec4(c & 4 ? max.x : min.x,
+												c & 2 ? max.y : min.y,
+												c & 1 ? max.z : min.z,
+												1.f);
+		// Bounds that reach the near plane can't be hidden
+		if( clip.w <= 0.f || clip.z < -clip.w ) {
+			return true;
+		}
+		float inv = 1.f / clip.w;
+		float x = (clip.x * inv * 0.5f + 0.5f) * width;
+		float y = (clip.y * inv * 0.5f + 0.5f) * height;
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+		nearest = std::min(nearest, clip.z * inv);
+	}
+
+	// Anything off screen is left to frustum culling
+	if( maxX < 0.f || maxY < 0.f || minX >= width || minY >= height ) {
+		return true;
+	}
+
+	// Coverage is sampled at pixel centres, so a pixel is also checked either
+	// side of the bounds in case the occluder only covers part of it
+	int x0 = std::max(0, int(std::floor(minX)) - 1);
+	int y0 = std::max(0, int(std::floor(minY)) - 1);
+	int x1 = std::min(width - 1, int(std::floor(maxX)) + 1);
+	int y1 = std::min(height - 1, int(std::floor(maxY)) + 1);
+
+#if RW_OCCLUSION_SSE
+	const __m128 nearestv = _mm_set1_ps(nearest);
+#endif
+
+	for(int y = y0; y <= y1; ++y)
+	{
+		const float* row = &depth[y * width];
+		int x = x0;
+#if RW_OCCLUSION_SSE
+		for(; x + 3 <= x1; x += 4)
+		{
+			if( _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), nearestv)) != 0 ) {
+				return true;
+			}
+		}
+#endif
+		for(; x <= x1; ++x)
+		{
+			if( row[x] >= nearest ) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,93 @@
+#include <render/OcclusionCuller.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <objects/InstanceObject.hpp>
+#include <data/CollisionModel.hpp>
+
+#include <algorithm>
+
+const float OcclusionCuller::kMinOccluderRadius = 15.f;
+const float OcclusionCuller::kOccluderRange = 300.f;
+const std::size_t OcclusionCuller::kTriangleBudget = 6000;
+
+OcclusionCuller::OcclusionCuller()
+	: occluderCount(0)
+{
+}
+
+const CollisionModel* OcclusionCuller::findOccluderModel(GameWorld* world, const ObjectData* object)
+{
+	auto it = occluderModels.find(object);
+	if( it != occluderModels.end() ) {
+		return it->second;
+	}
+
+	const CollisionModel* model = nullptr;
+	auto col = world->data->collisions.find(object->modelName);
+	if( col != world->data->collisions.end() && col->second->radius >= kMinOccluderRadius ) {
+		model = col->second.get();
+	}
+	occluderModels[object] = model;
+	return model;
+}
+
+void OcclusionCuller::build(GameWorld* world,
+							const ViewCamera& camera,
+							const glm::mat4& viewProjection,
+							float alpha)
+{
+	buffer.begin(viewProjection);
+	occluderCount = 0;
+
+	nearby.clear();
+	world->instanceIndex.queryBounds(camera.position - glm::vec3(kOccluderRange),
+									 camera.position + glm::vec3(kOccluderRange),
+									 nearby);
+
+	candidates.clear();
+	for(auto instance : nearby)
+	{
+		// Anything that can move or disappear would leave a hole
+		if( ! instance->object || instance->dynamics || ! instance->visible ) {
+			continue;
+		}
+		auto model = findOccluderModel(world, instance->object.get());
+		if( ! model ) {
+			continue;
+		}
+
+		auto position = instance->getPosition();
+		if( ! camera.frustum.intersects(position, model->radius) ) {
+			continue;
+		}
+		float distance = glm::length(position - camera.position) - model->radius;
+		candidates.push_back({distance, instance, model});
+	}
+
+	// The nearest occluders hide the most
+	std::sort(candidates.begin(), candidates.end(),
+			  [](const Candidate& a, const Candidate& b) {
+				  return a.distance < b.distance;
+			  });
+
+	for(auto& candidate : candidates)
+	{
+		if( buffer.getTriangleCount() >= kTriangleBudget ) {
+			break;
+		}
+
+		auto& model = *candidate.model;
+		auto matrix = candidate.instance->getTimeAdjustedTransform(alpha);
+
+		for(auto& box : model.boxes)
+		{
+			buffer.drawBox(matrix, box.min, box.max);
+		}
+		if( ! model.indices.empty() ) {
+			buffer.drawTriangles(matrix,
+								 model.vertices.data(), model.vertices.size(),
+								 model.indices.data(), model.indices.size());
+		}
+		occluderCount++;
+	}
+}
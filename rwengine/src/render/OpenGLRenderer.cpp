@@ -2,6 +2,9 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <sstream>
 #include <iostream>
 
@@ -113,6 +116,64 @@ const Renderer::SceneUniformData& Renderer::getSceneData() const
 	return lastSceneData;
 }
 
+namespace
+{
+bool sameState(const Renderer::RenderInstruction& a, const Renderer::RenderInstruction& b)
+{
+	const auto& pa = a.drawInfo;
+	const auto& pb = b.drawInfo;
+	return a.dbuff == b.dbuff
+			&& pa.textures == pb.textures
+			&& pa.blend == pb.blend
+			&& pa.depthWrite == pb.depthWrite
+			&& pa.colour == pb.colour
+			&& pa.ambient == pb.ambient
+			&& pa.diffuse == pb.diffuse
+			&& pa.visibility == pb.visibility;
+}
+
+bool canBatch(const Renderer::RenderInstruction& a, const Renderer::RenderInstruction& b)
+{
+	return sameState(a, b) && a.model == b.model;
+}
+
+bool canInstance(const Renderer::RenderInstruction& a, const Renderer::RenderInstruction& b)
+{
+	const auto& pa = a.drawInfo;
+	const auto& pb = b.drawInfo;
+	return sameState(a, b)
+			&& pa.start == pb.start
+			&& pa.count == pb.count
+			&& pa.baseVertex == pb.baseVertex;
+}
+}
+
+void Renderer::batchRenderList(const RenderList& list, DrawBatches& batches, size_t maxInstances)
+{
+	batches.clear();
+	for(size_t i = 0; i < list.size(); ++i)
+	{
+		if( ! batches.empty() )
+		{
+			auto& batch = batches.back();
+			auto& first = list[batch.first];
+			if( ! batch.instanced && canBatch(first, list[i]) ) {
+				batch.count++;
+				continue;
+			}
+			// A single instruction can start either kind of batch
+			if( (batch.instanced || batch.count == 1)
+					&& batch.count < maxInstances
+					&& canInstance(first, list[i]) ) {
+				batch.instanced = true;
+				batch.count++;
+				continue;
+			}
+		}
+		batches.push_back({i, 1, false});
+	}
+}
+
 void OpenGLRenderer::useDrawBuffer(DrawBuffer* dbuff)
 {
 	if( dbuff != currentDbuff )
@@ -131,11 +192,13 @@ void OpenGLRenderer::useDrawBuffer(DrawBuffer* dbuff)
 
 void OpenGLRenderer::useTexture(GLuint unit, GLuint tex)
 {
-	if( currentTextures[unit] != tex )
+	if( unit >= MAX_TEXTURE_UNITS || currentTextures[unit] != tex )
 	{
 		glActiveTexture(GL_TEXTURE0 + unit);
 		glBindTexture(GL_TEXTURE_2D, tex);
-		currentTextures[unit] = tex;
+		if( unit < MAX_TEXTURE_UNITS ) {
+			currentTextures[unit] = tex;
+		}
 		textureCounter++;
 #if RW_PROFILER
 		if( currentDebugDepth > 0 )
@@ -156,39 +219,43 @@ void OpenGLRenderer::useProgram(Renderer::ShaderProgram* p)
 	}
 }
 
-#if 0
-template<>
-void OpenGLRenderer::uploadUBO<OpenGLRenderer::ObjectUniformData>(GLuint buffer, const ObjectUniformData& data)
+namespace
 {
-	if( currentUBO != buffer ) {
-		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
-		currentUBO = buffer;
-	}
-	/*glBindBufferRange(GL_UNIFORM_BUFFER,
-					  2,
-					  UBOObject,
-					  entryAlignment * currentObjectEntry,
-					  sizeof(ObjectUniformData));*/
-	glBufferSubData(GL_UNIFORM_BUFFER,
-					0,
-					sizeof(ObjectUniformData), &data);
-#if RW_PROFILER
-	if( currentDebugDepth > 0 )
-	{
-		profileInfo[currentDebugDepth-1].uploads++;
-	}
-#endif
-	currentObjectEntry = (currentObjectEntry+1) % maxObjectEntries;
+/// Size of the uniform ring, split between three frames
+const std::size_t kUniformRingSize = 6 * 1024 * 1024;
+/// Size of the instance transform ring, split between three frames
+const std::size_t kInstanceRingSize = 6 * 1024 * 1024;
+/// Longest to wait for the GPU to release a region of a ring
+const GLuint64 kRingFenceTimeout = 1000000000;
+/// The instanced program's transform takes this and the next three locations
+const GLuint kInstanceTransformLocation = ATRS_Instance0;
+
+std::size_t getUniformAlignment()
+{
+	GLint alignment;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return alignment;
+}
+
+Renderer::ObjectUniformData makeObjectData(const glm::mat4& model, const Renderer::DrawParameters& p)
+{
+	return {
+		model,
+		glm::vec4(p.colour.r/255.f, p.colour.g/255.f, p.colour.b/255.f, p.colour.a/255.f),
+		1.f,
+		1.f,
+		p.visibility
+	};
+}
 }
-#endif
 
 OpenGLRenderer::OpenGLRenderer()
 	: currentDbuff(nullptr)
 	, currentProgram(nullptr)
-	, currentUBO(0)
-	, maxObjectEntries(0)
-	, currentObjectEntry(0)
-	, entryAlignment(0)
+	, uniformBuffer(0)
+	, uniformRing(kUniformRingSize, getUniformAlignment())
+	, instanceBuffer(0)
+	, instanceRing(kInstanceRingSize, sizeof(glm::mat4))
 	, blendEnabled(false)
 	, depthWriteEnabled(true)
 	, currentDebugDepth(0)
@@ -196,32 +263,98 @@ OpenGLRenderer::OpenGLRenderer()
 	// We need to query for some profiling exts.
 	ogl_CheckExtensions();
 
-	glGenBuffers(1, &UBOScene);
-	glGenBuffers(1, &UBOObject);
-
-	glBindBufferBase(GL_UNIFORM_BUFFER, 1, UBOScene);
-	glBindBufferBase(GL_UNIFORM_BUFFER, 2, UBOObject);
-	
-	swap();
-
-	GLint maxUBOSize, UBOAlignment;
-	glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxUBOSize);
-	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UBOAlignment);
-	entryAlignment = 128;
-	maxObjectEntries = maxUBOSize / entryAlignment;
-	std::cout << "Max UBO Size: " << maxUBOSize << std::endl;
-	std::cout << "UBO Alignment: " << UBOAlignment << std::endl;
-	std::cout << "Max batch size: " << maxObjectEntries << std::endl;
-
-	glBindBuffer(GL_UNIFORM_BUFFER, UBOObject);
-	glBufferData(GL_UNIFORM_BUFFER,
-				 entryAlignment * maxObjectEntries,
-				 NULL,
-				 GL_STREAM_DRAW);
+	std::fill(std::begin(currentTextures), std::end(currentTextures), 0);
+
+	// Allocated once, regions are reused when their fence has passed
+	glGenBuffers(1, &uniformBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, kUniformRingSize, NULL, GL_DYNAMIC_DRAW);
+
+	glGenBuffers(1, &instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, kInstanceRingSize, NULL, GL_DYNAMIC_DRAW);
+
+	std::cout << "UBO Alignment: " << uniformRing.getAlignment() << std::endl;
+
+	Renderer::swap();
 
 	glGenQueries(1, &debugQuery);
 }
 
+OpenGLRenderer::~OpenGLRenderer()
+{
+	for( auto ring : {&uniformRing, &instanceRing} )
+	{
+		for( std::size_t r = 0; r < ring->getRegionCount(); ++r )
+		{
+			auto fence = static_cast<GLsync>(ring->advance(nullptr));
+			if( fence ) {
+				glDeleteSync(fence);
+			}
+		}
+	}
+	glDeleteBuffers(1, &uniformBuffer);
+	glDeleteBuffers(1, &instanceBuffer);
+}
+
+std::size_t OpenGLRenderer::allocateRing(RingAllocator& ring, std::size_t size)
+{
+	std::size_t offset = 0;
+	if( ! ring.allocate(size, offset) ) {
+		retireRegion(ring);
+		ring.allocate(size, offset);
+	}
+	return offset;
+}
+
+void OpenGLRenderer::retireRegion(RingAllocator& ring)
+{
+	auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	auto previous = static_cast<GLsync>(ring.advance(fence));
+	if( previous ) {
+		// The region is written unsynchronized, so it must not be reused
+		// until the fence has really passed
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		GLenum result;
+		while( (result = glClientWaitSync(previous, flags, kRingFenceTimeout)) == GL_TIMEOUT_EXPIRED )
+		{
+			flags = 0;
+		}
+		if( result == GL_WAIT_FAILED ) {
+			RW_ERROR("Waiting for a ring fence failed");
+			glFinish();
+		}
+		glDeleteSync(previous);
+	}
+}
+
+void OpenGLRenderer::writeUniforms(GLuint point, const void* data, std::size_t size)
+{
+	// std140 blocks are padded to a multiple of a vec4
+	auto blockSize = (size + 15) / 16 * 16;
+	auto offset = allocateRing(uniformRing, blockSize);
+
+	// The ring's fences guarantee the GPU isn't reading this range
+	auto mapped = glMapBufferRange(GL_UNIFORM_BUFFER, offset, size,
+								   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	RW_CHECK(mapped != nullptr, "Failed to map uniform buffer");
+	if( mapped ) {
+		std::memcpy(mapped, data, size);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+	}
+	else {
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	}
+	glBindBufferRange(GL_UNIFORM_BUFFER, point, uniformBuffer, offset, blockSize);
+}
+
+void OpenGLRenderer::swap()
+{
+	Renderer::swap();
+	retireRegion(uniformRing);
+	retireRegion(instanceRing);
+}
+
 std::string OpenGLRenderer::getIDString() const
 {
 	std::stringstream ss;
@@ -310,11 +443,11 @@ void OpenGLRenderer::clear(const glm::vec4& colour, bool clearColour, bool clear
 
 void OpenGLRenderer::setSceneParameters(const Renderer::SceneUniformData& data)
 {
-	uploadUBO(UBOScene, data);
+	bindUniforms(1, data);
 	lastSceneData = data;
 }
 
-void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw, const Renderer::DrawParameters& p)
+void OpenGLRenderer::applyDrawState(DrawBuffer* draw, const Renderer::DrawParameters& p)
 {
 	useDrawBuffer(draw);
 
@@ -326,15 +459,6 @@ void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw, cons
 	setBlend(p.blend);
 	setDepthWrite(p.depthWrite);
 
-	ObjectUniformData oudata {
-		model,
-		glm::vec4(p.colour.r/255.f, p.colour.g/255.f, p.colour.b/255.f, p.colour.a/255.f),
-		1.f,
-		1.f,
-		p.visibility
-	};
-	uploadUBO(UBOObject, oudata);
-
 	drawCounter++;
 #if RW_PROFILER
 	if( currentDebugDepth > 0 )
@@ -345,12 +469,18 @@ void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw, cons
 #endif
 }
 
+void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw, const Renderer::DrawParameters& p)
+{
+	applyDrawState(draw, p);
+	bindUniforms(2, makeObjectData(model, p));
+}
+
 void OpenGLRenderer::draw(const glm::mat4& model, DrawBuffer* draw, const Renderer::DrawParameters& p)
 {
 	setDrawState(model, draw, p);
 
-	glDrawElements(draw->getFaceType(), p.count, GL_UNSIGNED_INT,
-				   (void*) (sizeof(RenderIndex) * p.start));
+	glDrawElementsBaseVertex(draw->getFaceType(), p.count, draw->getIndexType(),
+							 (void*) (draw->getIndexSize() * p.start), p.baseVertex);
 }
 
 void OpenGLRenderer::drawArrays(const glm::mat4& model, DrawBuffer* draw, const Renderer::DrawParameters& p)
@@ -360,64 +490,197 @@ void OpenGLRenderer::drawArrays(const glm::mat4& model, DrawBuffer* draw, const
 	glDrawArrays(draw->getFaceType(), p.start, p.count);
 }
 
+void OpenGLRenderer::drawArraysInstanced(DrawBuffer* draw, const Renderer::DrawParameters& p, unsigned int instances)
+{
+	setDrawState(glm::mat4(1.f), draw, p);
+
+	glDrawArraysInstanced(draw->getFaceType(), p.start, p.count, instances);
+}
+
+void OpenGLRenderer::drawInstanced(const RenderList& list, const DrawBatch& batch, std::size_t instanceOffset)
+{
+	auto& first = list[batch.first];
+	auto dbuff = first.dbuff;
+	auto& p = first.drawInfo;
+
+	// The transform is bound to the geometry's vertex array for this draw
+	// only; there's no base instance in GL 3.3, so the offset is the pointer
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	for( GLuint c = 0; c < 4; ++c )
+	{
+		auto location = kInstanceTransformLocation + c;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+							  (void*) (instanceOffset + c * sizeof(glm::vec4)));
+		glVertexAttribDivisor(location, 1);
+	}
+
+	glDrawElementsInstancedBaseVertex(dbuff->getFaceType(), p.count, dbuff->getIndexType(),
+									  (void*) (dbuff->getIndexSize() * p.start),
+									  batch.count, p.baseVertex);
+
+	for( GLuint c = 0; c < 4; ++c )
+	{
+		glDisableVertexAttribArray(kInstanceTransformLocation + c);
+	}
+
+#if RW_PROFILER
+	if( currentDebugDepth > 0 )
+	{
+		profileInfo[currentDebugDepth-1].primitives += p.count * (batch.count - 1);
+	}
+#endif
+}
+
 void OpenGLRenderer::drawBatched(const RenderList& list)
 {
-#if 0 // Needs shader changes
-	// Determine how many batches we need to process the entire list
-	auto entries = list.size();
-	glBindBuffer(GL_UNIFORM_BUFFER, UBOObject);
-	for (int b = 0; b < entries; b += maxObjectEntries)
+	auto program = currentProgram;
+	auto maxInstances = instancedProgram ? instanceRing.getRegionSize() / sizeof(glm::mat4) : 0;
+	batchRenderList(list, batches, maxInstances);
+
+	// The object uniforms for as many batches as fit in one region of the
+	// ring are written with a single mapping, then each draw binds its entry.
+	// The transforms of their instanced batches are written the same way.
+	auto objectSize = (sizeof(ObjectUniformData) + 15) / 16 * 16;
+	auto entrySize = uniformRing.align(objectSize);
+	auto maxEntries = uniformRing.getRegionSize() / entrySize;
+
+	for(size_t b = 0; b < batches.size(); )
 	{
-		auto toConsume = std::min((GLuint)entries, b + maxObjectEntries) - b;
-		std::vector<ObjectUniformData> uploadBuffer;
-		uploadBuffer.resize(toConsume);
-		for (int d = 0; d < toConsume; ++d)
+		size_t entries = 0;
+		size_t instances = 0;
+		for(; entries < maxEntries && b + entries < batches.size(); ++entries)
 		{
-			auto& draw = list[b+d];
-			uploadBuffer[d] = {
-				draw.model,
-				glm::vec4(draw.drawInfo.colour.r/255.f,
-				draw.drawInfo.colour.g/255.f,
-				draw.drawInfo.colour.b/255.f, 1.f),
-				1.f,
-				1.f,
-				draw.drawInfo.colour.a/255.f
-			};
+			auto& batch = batches[b + entries];
+			if( batch.instanced ) {
+				if( instances + batch.count > maxInstances ) {
+					break;
+				}
+				instances += batch.count;
+			}
 		}
-		glBufferData(GL_UNIFORM_BUFFER,
-					 toConsume * sizeof(ObjectUniformData),
-					 uploadBuffer.data(),
-					 GL_STREAM_DRAW);
 
-		// Dispatch individual draws
-		for (int d = 0; d < toConsume; ++d)
+		auto offset = allocateRing(uniformRing, entries * entrySize);
+
+		// The ring's fences guarantee the GPU isn't reading this range
+		auto mapped = static_cast<char*>(glMapBufferRange(GL_UNIFORM_BUFFER, offset, entries * entrySize,
+														   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+		RW_CHECK(mapped != nullptr, "Failed to map uniform buffer");
+		if( mapped == nullptr ) {
+			return;
+		}
+		for(size_t e = 0; e < entries; ++e)
 		{
-			auto& draw = list[b+d];
-			useDrawBuffer(draw.dbuff);
+			auto& batch = batches[b + e];
+			auto& first = list[batch.first];
+			// Instanced batches take their transforms from the instance buffer
+			auto data = makeObjectData(batch.instanced ? glm::mat4(1.f) : first.model, first.drawInfo);
+			std::memcpy(mapped + e * entrySize, &data, sizeof(data));
+		}
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+#if RW_PROFILER
+		if( currentDebugDepth > 0 )
+		{
+			profileInfo[currentDebugDepth-1].uploads++;
+		}
+#endif
 
-			for( GLuint u = 0; u < draw.drawInfo.textures.size(); ++u )
+		std::size_t instanceOffset = 0;
+		if( instances > 0 )
+		{
+			instanceOffset = allocateRing(instanceRing, instances * sizeof(glm::mat4));
+			glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+			auto transforms = static_cast<glm::mat4*>(glMapBufferRange(GL_ARRAY_BUFFER, instanceOffset, instances * sizeof(glm::mat4),
+																	   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+			RW_CHECK(transforms != nullptr, "Failed to map instance buffer");
+			if( transforms == nullptr ) {
+				return;
+			}
+			for(size_t e = 0; e < entries; ++e)
+			{
+				auto& batch = batches[b + e];
+				if( ! batch.instanced ) {
+					continue;
+				}
+				for(size_t i = batch.first; i < batch.first + batch.count; ++i)
+				{
+					*transforms++ = list[i].model;
+				}
+			}
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+#if RW_PROFILER
+			if( currentDebugDepth > 0 )
 			{
-				useTexture(u, draw.drawInfo.textures[u]);
+				profileInfo[currentDebugDepth-1].uploads++;
 			}
+#endif
+		}
+
+		for(size_t e = 0; e < entries; ++e)
+		{
+			auto& batch = batches[b + e];
+			auto& first = list[batch.first];
+			auto dbuff = first.dbuff;
 
-			glDrawElements(draw.dbuff->getFaceType(), draw.drawInfo.count, GL_UNSIGNED_INT,
-						   (void*) (sizeof(RenderIndex) * draw.drawInfo.start));
+			auto batchProgram = batch.instanced ? instancedProgram : program;
+			if( batchProgram ) {
+				useProgram(batchProgram);
+			}
+			applyDrawState(dbuff, first.drawInfo);
+			glBindBufferRange(GL_UNIFORM_BUFFER, 2, uniformBuffer, offset + e * entrySize, objectSize);
+
+			if( batch.instanced ) {
+				drawInstanced(list, batch, instanceOffset);
+				instanceOffset += batch.count * sizeof(glm::mat4);
+				continue;
+			}
+
+			if( batch.count == 1 ) {
+				glDrawElementsBaseVertex(dbuff->getFaceType(), first.drawInfo.count, dbuff->getIndexType(),
+										 (void*) (dbuff->getIndexSize() * first.drawInfo.start),
+										 first.drawInfo.baseVertex);
+				continue;
+			}
+
+			batchCounts.clear();
+			batchOffsets.clear();
+			batchBaseVertices.clear();
+			auto indexSize = dbuff->getIndexSize();
+			for(size_t i = batch.first; i < batch.first + batch.count; ++i)
+			{
+				auto& p = list[i].drawInfo;
+				batchCounts.push_back(p.count);
+				batchOffsets.push_back((const GLvoid*) (indexSize * p.start));
+				batchBaseVertices.push_back(p.baseVertex);
+#if RW_PROFILER
+				if( i != batch.first && currentDebugDepth > 0 )
+				{
+					profileInfo[currentDebugDepth-1].primitives += p.count;
+				}
+#endif
+			}
+
+			glMultiDrawElementsBaseVertex(dbuff->getFaceType(),
+										  batchCounts.data(),
+										  dbuff->getIndexType(),
+										  batchOffsets.data(),
+										  batch.count,
+										  batchBaseVertices.data());
 		}
+
+		b += entries;
 	}
-#else
-	for(auto& ri : list)
-	{
-		draw(ri.model, ri.dbuff, ri.drawInfo);
+
+	if( program ) {
+		useProgram(program);
 	}
-#endif
 }
 
 void OpenGLRenderer::invalidate()
 {
 	currentDbuff = nullptr;
 	currentProgram = nullptr;
-	currentTextures.clear();
-	currentUBO = 0;
+	std::fill(std::begin(currentTextures), std::end(currentTextures), 0);
 }
 
 void OpenGLRenderer::pushDebugGroup(const std::string& title)
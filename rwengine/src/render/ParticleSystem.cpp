@@ -0,0 +1,302 @@
+#include <render/ParticleSystem.hpp>
+#include <engine/RandomService.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+/// The low half of an id is its entry plus one, the high half the generation
+const std::uint32_t kIndexBits = 32;
+const std::uint32_t kIndexMask = 0xFFFFFFFF;
+
+ParticleID makeID(std::uint32_t entry, std::uint32_t generation)
+{
+	return (ParticleID(generation) << kIndexBits) | (entry + 1);
+}
+
+/**
+ * The bit pattern of a non-negative float orders the same way as its value
+ */
+std::uint32_t orderedBits(float f)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+}
+
+ParticleSystem::ParticleSystem()
+	: nextEmitterID(1)
+{
+}
+
+ParticleID ParticleSystem::spawn(const ParticleInfo& info, float time)
+{
+	std::uint32_t entry;
+	if (freeParticleIDs.empty()) {
+		entry = particleIDs.size();
+		if (entry >= kIndexMask) {
+			return 0;
+		}
+		particleIDs.push_back({0, 0});
+	}
+	else {
+		entry = freeParticleIDs.back();
+		freeParticleIDs.pop_back();
+	}
+
+	particleIDs[entry].index = position.size();
+	owner.push_back(entry);
+
+	position.push_back(info.position);
+	velocity.push_back(info.velocity);
+	direction.push_back(info.direction);
+	up.push_back(info.up);
+	size.push_back(info.size);
+	growth.push_back(info.growth);
+	colour.push_back(info.colour);
+	expiry.push_back(info.lifetime < 0.f ? std::numeric_limits<float>::infinity()
+	                                     : time + info.lifetime);
+	texture.push_back(info.texture);
+	orientation.push_back(info.orientation);
+
+	return makeID(entry, particleIDs[entry].generation);
+}
+
+std::ptrdiff_t ParticleSystem::find(ParticleID id) const
+{
+	std::uint32_t entry = (id & kIndexMask) - 1;
+	if (id == 0 || entry >= particleIDs.size()) {
+		return -1;
+	}
+	auto& slot = particleIDs[entry];
+	if (slot.generation != (id >> kIndexBits)) {
+		return -1;
+	}
+	return slot.index;
+}
+
+bool ParticleSystem::isAlive(ParticleID id) const
+{
+	return find(id) >= 0;
+}
+
+void ParticleSystem::destroy(ParticleID id)
+{
+	auto slot = find(id);
+	if (slot >= 0) {
+		removeSlot(slot);
+	}
+}
+
+void ParticleSystem::setPosition(ParticleID id, const glm::vec3& p)
+{
+	auto slot = find(id);
+	if (slot >= 0) {
+		position[slot] = p;
+	}
+}
+
+void ParticleSystem::setSize(ParticleID id, const glm::vec2& s)
+{
+	auto slot = find(id);
+	if (slot >= 0) {
+		size[slot] = s;
+	}
+}
+
+void ParticleSystem::setColour(ParticleID id, const glm::vec4& c)
+{
+	auto slot = find(id);
+	if (slot >= 0) {
+		colour[slot] = c;
+	}
+}
+
+void ParticleSystem::moveSlot(std::size_t from, std::size_t to)
+{
+	position[to] = position[from];
+	velocity[to] = velocity[from];
+	direction[to] = direction[from];
+	up[to] = up[from];
+	size[to] = size[from];
+	growth[to] = growth[from];
+	colour[to] = colour[from];
+	expiry[to] = expiry[from];
+	texture[to] = texture[from];
+	orientation[to] = orientation[from];
+	owner[to] = owner[from];
+	particleIDs[owner[to]].index = to;
+}
+
+void ParticleSystem::removeSlot(std::size_t slot)
+{
+	// Retire the id first, so a stale copy no longer finds the slot
+	auto entry = owner[slot];
+	particleIDs[entry].generation++;
+	freeParticleIDs.push_back(entry);
+
+	auto last = position.size() - 1;
+	if (slot != last) {
+		moveSlot(last, slot);
+	}
+
+	position.pop_back();
+	velocity.pop_back();
+	direction.pop_back();
+	up.pop_back();
+	size.pop_back();
+	growth.pop_back();
+	colour.pop_back();
+	expiry.pop_back();
+	texture.pop_back();
+	orientation.pop_back();
+	owner.pop_back();
+}
+
+EmitterID ParticleSystem::createEmitter(const EmitterInfo& info, float time)
+{
+	auto id = nextEmitterID++;
+	emitters.push_back({info, time, 0.f, id});
+	return id;
+}
+
+void ParticleSystem::destroyEmitter(EmitterID id)
+{
+	emitters.erase(std::remove_if(emitters.begin(), emitters.end(),
+	                              [&](const Emitter& e) { return e.id == id; }),
+	               emitters.end());
+}
+
+void ParticleSystem::setEmitterPosition(EmitterID id, const glm::vec3& p)
+{
+	for (auto& e : emitters) {
+		if (e.id == id) {
+			e.info.position = p;
+		}
+	}
+}
+
+void ParticleSystem::update(float time, float dt, RandomStream& random)
+{
+	// Emit before moving, so new particles take their first step this tick
+	for (std::size_t e = 0; e < emitters.size(); ) {
+		auto& emitter = emitters[e];
+		auto& info = emitter.info;
+
+		emitter.accumulator += info.rate * dt;
+		ParticleInfo particle = info.particle;
+		while (emitter.accumulator >= 1.f) {
+			emitter.accumulator -= 1.f;
+			particle.position = info.position + info.particle.position;
+			particle.velocity = info.particle.velocity;
+			if (info.spread > 0.f) {
+				particle.velocity += glm::vec3(random.unit() - 0.5f,
+				                               random.unit() - 0.5f,
+				                               random.unit() - 0.5f) * (info.spread * 2.f);
+			}
+			spawn(particle, time);
+		}
+
+		if (info.duration >= 0.f && time >= emitter.start + info.duration) {
+			emitters[e] = emitters.back();
+			emitters.pop_back();
+		}
+		else {
+			++e;
+		}
+	}
+
+	std::size_t count = position.size();
+	for (std::size_t i = 0; i < count; ++i) {
+		position[i] += velocity[i] * dt;
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		size[i] = glm::max(size[i] + growth[i] * dt, glm::vec2(0.f));
+	}
+
+	// Fill the holes left by expired particles from the end, then shrink
+	// every array once.
+	for (std::size_t i = 0; i < count; ) {
+		if (expiry[i] > time) {
+			++i;
+			continue;
+		}
+		auto entry = owner[i];
+		particleIDs[entry].generation++;
+		freeParticleIDs.push_back(entry);
+		if (i != --count) {
+			moveSlot(count, i);
+		}
+	}
+
+	position.resize(count);
+	velocity.resize(count);
+	direction.resize(count);
+	up.resize(count);
+	size.resize(count);
+	growth.resize(count);
+	colour.resize(count);
+	expiry.resize(count);
+	texture.resize(count);
+	orientation.resize(count);
+	owner.resize(count);
+}
+
+void ParticleSystem::buildBatches(const glm::vec3& cameraPosition, const glm::vec3& cameraForward)
+{
+	std::size_t count = position.size();
+
+	// Texture in the high bits ascending, distance in the low bits inverted
+	// so the furthest particle comes first.
+	sortKeys.resize(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		auto d = position[i] - cameraPosition;
+		std::uint32_t distance = ~orderedBits(glm::dot(d, d));
+		sortKeys[i] = {(std::uint64_t(texture[i]) << 32) | distance, std::uint32_t(i)};
+	}
+	std::sort(sortKeys.begin(), sortKeys.end());
+
+	instances.resize(count);
+	batches.clear();
+	for (std::size_t k = 0; k < count; ++k) {
+		auto i = sortKeys[k].second;
+		auto& p = position[i];
+
+		// Figure the direction to the camera center.
+		glm::vec3 ptc = up[i];
+		auto amp = cameraPosition - p;
+		if (orientation[i] == ParticleInfo::UpCamera) {
+			ptc = amp - glm::dot(amp, cameraForward) * cameraForward;
+		}
+		else if (orientation[i] == ParticleInfo::Camera) {
+			ptc = amp;
+		}
+
+		glm::vec3 f = glm::normalize(direction[i]);
+		glm::vec3 s = glm::cross(f, glm::normalize(ptc));
+
+		auto& instance = instances[k];
+		instance.origin = p;
+		instance.axisX = s * size[i].x;
+		instance.axisY = -f * size[i].y;
+		instance.colour = glm::u8vec4(glm::clamp(colour[i], 0.f, 1.f) * 255.f);
+
+		if (batches.empty() || batches.back().texture != texture[i]) {
+			batches.push_back({texture[i], k, 0});
+		}
+		batches.back().count++;
+	}
+}
+
+void ParticleSystem::clear()
+{
+	while (! position.empty()) {
+		removeSlot(position.size() - 1);
+	}
+	emitters.clear();
+	instances.clear();
+	batches.clear();
+}
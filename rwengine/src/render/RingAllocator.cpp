@@ -0,0 +1,34 @@
+#include <render/RingAllocator.hpp>
+
+RingAllocator::RingAllocator(std::size_t capacity, std::size_t alignment, std::size_t regions)
+	: alignment(alignment > 0 ? alignment : 1)
+	, fences(regions, nullptr)
+	, region(0)
+	, used(0)
+{
+	// Regions start on aligned offsets
+	regionSize = capacity / regions / this->alignment * this->alignment;
+}
+
+bool RingAllocator::allocate(std::size_t size, std::size_t& offset)
+{
+	auto start = align(used);
+	if( start + size > regionSize ) {
+		return false;
+	}
+
+	offset = region * regionSize + start;
+	used = start + size;
+	return true;
+}
+
+RingAllocator::Fence RingAllocator::advance(Fence fence)
+{
+	fences[region] = fence;
+	region = (region + 1) % fences.size();
+	used = 0;
+
+	auto previous = fences[region];
+	fences[region] = nullptr;
+	return previous;
+}
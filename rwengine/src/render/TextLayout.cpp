@@ -0,0 +1,303 @@
+#include <render/TextLayout.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+/// Frames a layout is kept for after it was last drawn
+const uint64_t kMaxIdleFrames = 120;
+
+bool isSpace(char c)
+{
+	return std::isspace(static_cast<unsigned char>(c));
+}
+
+glm::vec4 indexToCoord(int font, int index)
+{
+	float x = int(index % 16);
+	float y = int(index / 16) + 0.01f;
+	float fontHeight = ((font == 0) ? 16.f : 13.f);
+	glm::vec2 gsize( 1.f / 16.f, 1.f / fontHeight );
+	return glm::vec4( x, y, x + 1, y + 0.98f ) *
+		glm::vec4( gsize, gsize );
+}
+
+/**
+ * Returns true and sets colour if c is a colour markup character
+ */
+bool markupColour(char c, glm::vec3& colour)
+{
+	switch( c )
+	{
+	case 'g': // Green
+		colour = glm::vec3(glm::u8vec3(90, 157, 102)) * (1/255.f);
+		return true;
+	case 'h': // White
+		colour = glm::vec3(1.f); /// @todo FIXME! Use proper colour!
+		return true;
+	case 'l': // Black
+		colour = glm::vec3(0.f); /// @todo FIXME! Use proper colour!
+		return true;
+	case 'r': // Red
+		colour = glm::vec3(1.f, 0.0f, 0.0f); /// @todo FIXME! Use proper colour!
+		return true;
+	case 'w': // Gray
+		colour = glm::vec3(0.5f); /// @todo FIXME! Use proper colour!
+		return true;
+	case 'y': // Yellow
+		colour = glm::vec3(1.0f, 1.0f, 0.0f); /// @todo FIXME! Use proper colour!
+		return true;
+	default:
+		return false;
+	}
+}
+}
+
+/// @todo This is very rough
+int TextLayoutCache::charToIndex(char g)
+{
+	if( g >= '0' && g <= '9' )
+	{
+		return 16 + (g - '0');
+	}
+	else if( g >= 'A' && g <= 'Z' )
+	{
+		return 33 + (g - 'A');
+	}
+	else if( g >= 'a' && g <= 'z' )
+	{
+		return 65 + (g - 'a');
+	}
+	switch(g)
+	{
+		default: return 0;
+		case '!': return 1;
+		case '"': return 2;
+		case '#': return 3;
+		case '$': return 4;
+		case '%': return 5;
+		case '&': return 6;
+		case '\'': return 7;
+		case '(': return 8;
+		case ')': return 9;
+		case '*': return 10;
+		case '+': return 11;
+		case ',': return 12;
+		case '-': return 13;
+		case '.': return 14;
+		case '/': return 15;
+		case ':': return 26;
+		case '[': return 59;
+		case ']': return 61;
+		// This is a guess.
+		case '@': return 91;
+	}
+}
+
+TextLayoutCache::TextLayoutCache()
+	: count(0)
+	, created(0)
+	, frame(0)
+{
+	for( int g = 0; g < GAME_GLYPHS; g++ )
+	{
+		glyphData[g] = { .9f };
+	}
+
+	glyphData[charToIndex(' ')].widthFrac = 0.4f;
+	glyphData[charToIndex('-')].widthFrac = 0.5f;
+	glyphData[charToIndex('\'')].widthFrac = 0.5f;
+	glyphData[charToIndex('(')].widthFrac = 0.45f;
+	glyphData[charToIndex(')')].widthFrac = 0.45f;
+	glyphData[charToIndex(':')].widthFrac = 0.65f;
+	glyphData[charToIndex('$')].widthFrac = 0.65f;
+
+	for(char g = '0'; g <= '9'; ++g) {
+		glyphData[charToIndex(g)].widthFrac = 0.65f;
+	}
+
+	// Assumes contigious a-z character encoding
+	for(char g = 0; g <= ('z'-'a'); g++)
+	{
+		switch( ('a' + g) )
+		{
+		case 'i':
+			glyphData[charToIndex('a' + g)].widthFrac = 0.4f;
+			glyphData[charToIndex('A' + g)].widthFrac = 0.4f;
+			break;
+		case 'l':
+			glyphData[charToIndex('a' + g)].widthFrac = 0.5f;
+			glyphData[charToIndex('A' + g)].widthFrac = 0.5f;
+			break;
+		case 'm':
+			glyphData[charToIndex('a' + g)].widthFrac = 1.0f;
+			glyphData[charToIndex('A' + g)].widthFrac = 1.0f;
+			break;
+		case 'w':
+			glyphData[charToIndex('a' + g)].widthFrac = 1.0f;
+			glyphData[charToIndex('A' + g)].widthFrac = 1.0f;
+			break;
+		default:
+			glyphData[charToIndex('a' + g)].widthFrac = 0.7f;
+			glyphData[charToIndex('A' + g)].widthFrac = 0.7f;
+			break;
+		}
+	}
+}
+
+const TextLayout& TextLayoutCache::layout(const std::string& text, int font, float size, int wrapX)
+{
+	auto& entries = layouts[text];
+	for (auto& entry : entries) {
+		if (entry.font == font && entry.size == size && entry.wrapX == wrapX) {
+			entry.lastUsed = frame;
+			return entry.layout;
+		}
+	}
+
+	entries.push_back({font, size, wrapX, frame, TextLayout()});
+	layoutText(text, font, size, wrapX, entries.back().layout);
+	count++;
+	created++;
+	return entries.back().layout;
+}
+
+void TextLayoutCache::layoutText(const std::string& text, int font, float size, int wrapX,
+								 TextLayout& out) const
+{
+	out.glyphs.clear();
+	out.runs.clear();
+	out.runs.push_back({0, false, glm::vec3(1.f)});
+
+	glm::vec2 coord( 0.f, 0.f );
+	glm::vec2 ss( size );
+	// We should track real size not just chars.
+	int lineLength = 0;
+	float maxWidth = 0.f;
+	float maxHeight = 0.f;
+	bool wordStart = true;
+
+	auto newLine = [&]() {
+		coord.x = 0.f;
+		coord.y += ss.y;
+		maxHeight = coord.y + ss.y;
+		lineLength = 0;
+	};
+
+	// from is the position of c in text, for measuring the word it begins
+	auto addGlyph = [&](char c, std::size_t from) {
+		int glyph = charToIndex(c);
+
+		// If we're not at the start of the column, check if the word will
+		// need to be wrapped
+		if (wrapX > 0 && wordStart && coord.x > 0.f && !isSpace(c))
+		{
+			int word = 0;
+			while (from + word < text.size() && !isSpace(text[from + word])) {
+				word++;
+			}
+			if (lineLength + word >= wrapX)
+			{
+				newLine();
+			}
+		}
+		wordStart = isSpace(c);
+
+		auto& data = glyphData[glyph];
+		auto tex = indexToCoord(font, glyph);
+
+		ss.x = size * data.widthFrac;
+		tex.z = tex.x + (tex.z - tex.x) * data.widthFrac;
+
+		// Handle special chars.
+		if( c == '\n' )
+		{
+			newLine();
+			return;
+		}
+		lineLength ++;
+
+		out.glyphs.push_back({coord, ss, tex});
+		coord.x += ss.x;
+		maxWidth = std::max(coord.x, maxWidth);
+	};
+
+	std::size_t i = 0;
+	while (i < text.size())
+	{
+		char c = text[i];
+
+		// Handle any markup changes.
+		if( c == '~' && i + 1 < text.size() )
+		{
+			glm::vec3 colour;
+			if (markupColour(text[i + 1], colour))
+			{
+				if (out.runs.back().first != out.glyphs.size()) {
+					out.runs.push_back({out.glyphs.size(), true, colour});
+				}
+				else {
+					out.runs.back() = {out.glyphs.size(), true, colour};
+				}
+				i += 3;
+				continue;
+			}
+			else if (text[i + 1] == 'k')
+			{
+				// Since we don't have a key map yet, just print out the name
+				// that follows as ~NAME~
+				std::size_t key = i + 3;
+				if (key < text.size() && text[key] == '~') {
+					key++;
+				}
+				auto keyend = std::min(text.find('~', key), text.size());
+				for (auto k = key; k < keyend; ++k) {
+					addGlyph(text[k], k);
+				}
+				i = keyend + 1;
+				continue;
+			}
+		}
+
+		addGlyph(c, i);
+		++i;
+	}
+
+	out.extents = glm::vec2(maxWidth, maxHeight);
+	out.lastGlyphSize = ss;
+}
+
+void TextLayoutCache::nextFrame()
+{
+	frame++;
+	for (auto it = layouts.begin(); it != layouts.end(); )
+	{
+		auto& entries = it->second;
+		for (std::size_t e = 0; e < entries.size(); )
+		{
+			if (frame - entries[e].lastUsed > kMaxIdleFrames) {
+				if (e + 1 != entries.size()) {
+					entries[e] = std::move(entries.back());
+				}
+				entries.pop_back();
+				count--;
+			}
+			else {
+				++e;
+			}
+		}
+		if (entries.empty()) {
+			it = layouts.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void TextLayoutCache::clear()
+{
+	layouts.clear();
+	count = 0;
+}
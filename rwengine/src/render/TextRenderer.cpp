@@ -2,77 +2,22 @@
 #include <render/GameRenderer.hpp>
 #include <engine/GameWorld.hpp>
 
-#include <algorithm>
-
-/// @todo This is very rough
-int charToIndex(char g)
-{
-	if( g >= '0' && g <= '9' )
-	{
-		return 16 + (g - '0');
-	}
-	else if( g >= 'A' && g <= 'Z' )
-	{
-		return 33 + (g - 'A');
-	}
-	else if( g >= 'a' && g <= 'z' )
-	{
-		return 65 + (g - 'a');
-	}
-	switch(g)
-	{
-		default: return 0;
-		case '!': return 1;
-		case '"': return 2;
-		case '#': return 3;
-		case '$': return 4;
-		case '%': return 5;
-		case '&': return 6;
-		case '\'': return 7;
-		case '(': return 8;
-		case ')': return 9;
-		case '*': return 10;
-		case '+': return 11;
-		case ',': return 12;
-		case '-': return 13;
-		case '.': return 14;
-		case '/': return 15;
-		case ':': return 26;
-		case '[': return 59;
-		case ']': return 61;
-		// This is a guess.
-		case '@': return 91;
-	}
-}
-
-glm::vec4 indexToCoord(int font, int index)
-{
-	float x = int(index % 16);
-	float y = int(index / 16) + 0.01f;
-	float fontHeight = ((font == 0) ? 16.f : 13.f);
-	glm::vec2 gsize( 1.f / 16.f, 1.f / fontHeight );
-	return glm::vec4( x, y, x + 1, y + 0.98f ) *
-		glm::vec4( gsize, gsize );
-}
-
-
 const char* TextVertexShader = R"(
 #version 330
 #extension GL_ARB_explicit_attrib_location : enable
 #extension GL_ARB_uniform_buffer_object : enable
 
 layout(location = 0) in vec2 position;
-layout(location = 3) in vec2 texcoord;
-layout(location = 2) in vec3 colour;
-out vec2 TexCoord;
-out vec3 Colour;
+layout(location = 3) in vec3 texcoord;
+layout(location = 2) in vec4 colour;
+out vec3 TexCoord;
+out vec4 Colour;
 
 uniform mat4 proj;
-uniform vec2 alignment;
 
 void main()
 {
-	gl_Position = proj * vec4(alignment + position, 0.0, 1.0);
+	gl_Position = proj * vec4(position, 0.0, 1.0);
 	TexCoord = texcoord;
 	Colour = colour;
 })";
@@ -80,32 +25,27 @@ void main()
 const char* TextFragmentShader = R"(
 #version 330
 
-in vec2 TexCoord;
-in vec3 Colour;
-uniform vec4 colour;
-uniform sampler2D fontTexture;
+in vec3 TexCoord;
+in vec4 Colour;
+uniform sampler2D font0;
+uniform sampler2D font1;
+uniform sampler2D font2;
 out vec4 outColour;
 
 void main()
 {
-	float a = texture(fontTexture, TexCoord).a;
-	outColour = vec4(Colour, a);
-})";
-
-struct TextVertex
-{
-	glm::vec2 position;
-	glm::vec2 texcoord;
-	glm::vec3 colour;
-	
-	static const AttributeList vertex_attributes() {
-		return {
-			{ATRS_Position, 2, sizeof(TextVertex),  0ul},
-			{ATRS_TexCoord, 2, sizeof(TextVertex),  0ul + sizeof(glm::vec2)},
-			{ATRS_Colour, 3, sizeof(TextVertex),  0ul + sizeof(glm::vec2) * 2},
-		};
+	float a = 1.0;
+	if (TexCoord.z > 1.5) {
+		a = texture(font2, TexCoord.xy).a;
+	}
+	else if (TexCoord.z > 0.5) {
+		a = texture(font1, TexCoord.xy).a;
 	}
-};
+	else if (TexCoord.z > -0.5) {
+		a = texture(font0, TexCoord.xy).a;
+	}
+	outColour = vec4(Colour.rgb, Colour.a * a);
+})";
 
 TextRenderer::TextInfo::TextInfo()
 : font(0), size(1.f), baseColour({1.f, 1.f, 1.f}), align(Left), wrapX(0)
@@ -114,55 +54,15 @@ TextRenderer::TextInfo::TextInfo()
 }
 
 TextRenderer::TextRenderer(GameRenderer* renderer)
-: fonts({}), renderer(renderer)
+: fonts{}, renderer(renderer)
 {
 	textShader = renderer->getRenderer()->createShader(
 		TextVertexShader, TextFragmentShader );
-	
-	for( int g = 0; g < GAME_GLYPHS; g++ )
-	{
-		glyphData[g] = { .9f };
-	}
-	
-	glyphData[charToIndex(' ')].widthFrac = 0.4f;
-	glyphData[charToIndex('-')].widthFrac = 0.5f;
-	glyphData[charToIndex('\'')].widthFrac = 0.5f;
-	glyphData[charToIndex('(')].widthFrac = 0.45f;
-	glyphData[charToIndex(')')].widthFrac = 0.45f;
-	glyphData[charToIndex(':')].widthFrac = 0.65f;
-	glyphData[charToIndex('$')].widthFrac = 0.65f;
-
-	for(char g = '0'; g <= '9'; ++g) {
-		glyphData[charToIndex(g)].widthFrac = 0.65f;
-	}
 
-	// Assumes contigious a-z character encoding
-	for(char g = 0; g <= ('z'-'a'); g++)
-	{
-		switch( ('a' + g) )
-		{
-		case 'i':
-			glyphData[charToIndex('a' + g)].widthFrac = 0.4f;
-			glyphData[charToIndex('A' + g)].widthFrac = 0.4f;
-			break;
-		case 'l':
-			glyphData[charToIndex('a' + g)].widthFrac = 0.5f;
-			glyphData[charToIndex('A' + g)].widthFrac = 0.5f;
-			break;
-		case 'm':
-			glyphData[charToIndex('a' + g)].widthFrac = 1.0f;
-			glyphData[charToIndex('A' + g)].widthFrac = 1.0f;
-			break;
-		case 'w':
-			glyphData[charToIndex('a' + g)].widthFrac = 1.0f;
-			glyphData[charToIndex('A' + g)].widthFrac = 1.0f;
-			break;
-		default:
-			glyphData[charToIndex('a' + g)].widthFrac = 0.7f;
-			glyphData[charToIndex('A' + g)].widthFrac = 0.7f;
-			break;
-		}
-	}
+	gb.uploadVertices(0, 0, nullptr, GL_STREAM_DRAW);
+	gb.getDataAttributes() = TextVertex::vertex_attributes();
+	db.addGeometry(&gb);
+	db.setFaceType(GL_TRIANGLES);
 }
 
 TextRenderer::~TextRenderer()
@@ -174,182 +74,116 @@ void TextRenderer::setFontTexture(int index, const std::string& texture)
 {
 	if( index < GAME_FONTS )
 	{
-		fonts[index] = texture;
+		fonts[index] = internAssetName(texture);
 	}
 }
 
 void TextRenderer::renderText(const TextRenderer::TextInfo& ti, bool forceColour)
 {
-	renderer->getRenderer()->pushDebugGroup("Text");
-	renderer->getRenderer()->useProgram(textShader);
-	
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glActiveTexture(GL_TEXTURE0);
-	
-	glm::vec2 coord( 0.f, 0.f );
-	glm::vec2 alignment = ti.screenPosition;
-	// We should track real size not just chars.
-	auto lineLength = 0;
-	
-	glm::vec2 ss( ti.size );
-
-	glm::vec3 colour = glm::vec3(ti.baseColour) * (1/255.f);
-	glm::vec4 colourBG  = glm::vec4(ti.backgroundColour) * (1/255.f);
-	std::vector<TextVertex> geo;
-	
-	float maxWidth = 0.f;
-	float maxHeight = 0.f;
-
-	auto text = ti.text;
-	
-	for (size_t i = 0; i < text.length(); ++i)
+	if( ti.font < 0 || ti.font >= GAME_FONTS )
 	{
-		char c = text[i];
-
-		// Handle any markup changes.
-		if( c == '~' && text.length() > i + 1 )
-		{
-			switch( text[i+1] )
-			{
-			case 'g': // Green
-				text.erase(text.begin()+i, text.begin()+i+3);
-				colour = glm::vec3(glm::u8vec3(90, 157, 102)) * (1/255.f);
-				break;
-			case 'h': // White
-				text.erase(text.begin()+i, text.begin()+i+3);
-				colour = glm::vec3(1.f); /// @todo FIXME! Use proper colour!
-				break;
-			case 'k': { // Key
-				text.erase(text.begin()+i, text.begin()+i+3);
-				// Extract the key name from the /next/ markup
-				auto keyend = text.find('~', i+1);
-				auto keyname = text.substr(i+1, keyend-i-1);
-				// Since we don't have a key map yet, just print out the name
-				text.erase(text.begin()+i, text.begin()+keyend);
-				text.insert(i, keyname);
-				break;
-			}
-			case 'l': // Black
-				text.erase(text.begin()+i, text.begin()+i+3);
-				colour = glm::vec3(0.f); /// @todo FIXME! Use proper colour!
-				break;
-			case 'r': // Red
-				text.erase(text.begin()+i, text.begin()+i+3);
-				colour = glm::vec3(1.f, 0.0f, 0.0f); /// @todo FIXME! Use proper colour!
-				break;
-			case 'w': // Gray
-				text.erase(text.begin()+i, text.begin()+i+3);
-				colour = glm::vec3(0.5f); /// @todo FIXME! Use proper colour!
-				break;
-			case 'y': // Yellow
-				text.erase(text.begin()+i, text.begin()+i+3);
-				colour = glm::vec3(1.0f, 1.0f, 0.0f); /// @todo FIXME! Use proper colour!
-				break;
-			}
-			
-			c = text[i];
-		}
-
-		if (forceColour) {
-			colour = glm::vec3(ti.baseColour) * (1/255.f);
-		}
-		
-		int glyph = charToIndex(c);
-		if( glyph >= GAME_GLYPHS )
-		{
-			continue;
-		}
-
-		// If we're not at the start of the column, check if the current word
-		// will need to be wrapped
-		if (ti.wrapX > 0 && coord.x > 0.f && !std::isspace(c))
-		{
-			auto wend = std::find_if(std::begin(text)+i,
-									 std::end(text),
-									 [](char x) { return std::isspace(x); });
-			if (wend != std::end(text))
-			{
-				auto word = std::distance(std::begin(text)+i, wend);
-				if (lineLength + word >= ti.wrapX)
-				{
-					coord.x = 0;
-					coord.y += ss.y;
-					maxHeight = coord.y + ss.y;
-					lineLength = 0;
-				}
-			}
-		}
-		
-		auto& data = glyphData[glyph];
-		auto tex = indexToCoord(ti.font, glyph);
-		
-		ss.x = ti.size * data.widthFrac;
-		tex.z = tex.x + (tex.z - tex.x) * data.widthFrac;
-		
-		// Handle special chars.
-		if( c == '\n' )
-		{
-			coord.x = 0.f;
-			coord.y += ss.y;
-			maxHeight = coord.y + ss.y;
-			lineLength = 0;
-			continue;
-		}
-		lineLength ++;
-
-		glm::vec2 p = coord;
-		coord.x += ss.x;
-		maxWidth = std::max(coord.x, maxWidth);
-		
-		geo.push_back({ { p.x,        p.y + ss.y }, {tex.x, tex.w}, colour });
-		geo.push_back({ { p.x + ss.x, p.y + ss.y }, {tex.z, tex.w}, colour });
-		geo.push_back({ { p.x,        p.y },        {tex.x, tex.y}, colour });
-		
-		
-		geo.push_back({ { p.x + ss.x, p.y },        {tex.z, tex.y}, colour });
-		geo.push_back({ { p.x,        p.y },        {tex.x, tex.y}, colour });
-		geo.push_back({ { p.x + ss.x, p.y + ss.y }, {tex.z, tex.w}, colour });
+		return;
 	}
-	
+	auto& layout = layouts.layout(ti.text, ti.font, ti.size, ti.wrapX);
+	buildVertices(ti, layout, forceColour, vertices);
+}
+
+void TextRenderer::buildVertices(const TextInfo& ti, const TextLayout& layout, bool forceColour,
+								 std::vector<TextVertex>& out)
+{
+	glm::vec2 alignment = ti.screenPosition;
 	if ( ti.align == TextInfo::Right )
 	{
-		alignment.x -= maxWidth;
+		alignment.x -= layout.extents.x;
 	}
 	else if ( ti.align == TextInfo::Center )
 	{
-		alignment.x -= (maxWidth / 2.f);
+		alignment.x -= (layout.extents.x / 2.f);
 	}
 
 	alignment.y -= ti.size * 0.2f;
 
 	// If we need to, draw the background.
+	glm::vec4 colourBG  = glm::vec4(ti.backgroundColour) * (1/255.f);
 	if (colourBG.a > 0.f)
 	{
-		renderer->drawColour(
-					colourBG,
-					glm::vec4(
-						ti.screenPosition - (ss/3.f),
-						glm::vec2(maxWidth, maxHeight)+(ss/2.f)));
+		auto& ss = layout.lastGlyphSize;
+		glm::vec2 p = ti.screenPosition - (ss/3.f);
+		glm::vec2 s = layout.extents + (ss/2.f);
+		glm::vec3 solid(0.f, 0.f, -1.f);
+
+		out.push_back({ { p.x,       p.y + s.y }, solid, colourBG });
+		out.push_back({ { p.x + s.x, p.y + s.y }, solid, colourBG });
+		out.push_back({ { p.x,       p.y },       solid, colourBG });
+		out.push_back({ { p.x + s.x, p.y },       solid, colourBG });
+		out.push_back({ { p.x,       p.y },       solid, colourBG });
+		out.push_back({ { p.x + s.x, p.y + s.y }, solid, colourBG });
+	}
+
+	glm::vec4 baseColour(glm::vec3(ti.baseColour) * (1/255.f), 1.f);
+	float font = ti.font;
+
+	for (std::size_t r = 0; r < layout.runs.size(); ++r)
+	{
+		auto& run = layout.runs[r];
+		auto colour = baseColour;
+		if (run.markup && !forceColour) {
+			colour = glm::vec4(run.colour, 1.f);
+		}
 
+		auto last = (r + 1 < layout.runs.size()) ? layout.runs[r + 1].first : layout.glyphs.size();
+		for (std::size_t g = run.first; g < last; ++g)
+		{
+			auto& glyph = layout.glyphs[g];
+			glm::vec2 p = alignment + glyph.position;
+			auto& ss = glyph.size;
+			auto& tex = glyph.texcoords;
+
+			out.push_back({ { p.x,        p.y + ss.y }, {tex.x, tex.w, font}, colour });
+			out.push_back({ { p.x + ss.x, p.y + ss.y }, {tex.z, tex.w, font}, colour });
+			out.push_back({ { p.x,        p.y },        {tex.x, tex.y, font}, colour });
+
+			out.push_back({ { p.x + ss.x, p.y },        {tex.z, tex.y, font}, colour });
+			out.push_back({ { p.x,        p.y },        {tex.x, tex.y, font}, colour });
+			out.push_back({ { p.x + ss.x, p.y + ss.y }, {tex.z, tex.w, font}, colour });
+		}
 	}
+}
+
+void TextRenderer::flush()
+{
+	if( vertices.empty() )
+	{
+		return;
+	}
+
+	auto r = renderer->getRenderer();
+	r->pushDebugGroup("Text");
+	r->useProgram(textShader);
 	
-	renderer->getRenderer()->setUniform(textShader, "proj", renderer->getRenderer()->get2DProjection());
-	renderer->getRenderer()->setUniformTexture(textShader, "fontTexture", 0);
-	renderer->getRenderer()->setUniform(textShader, "alignment", alignment);
-	
-	gb.uploadVertices(geo);
-	db.addGeometry(&gb);
-	db.setFaceType(GL_TRIANGLES);
-	
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	r->setUniform(textShader, "proj", r->get2DProjection());
+	r->setUniformTexture(textShader, "font0", 0);
+	r->setUniformTexture(textShader, "font1", 1);
+	r->setUniformTexture(textShader, "font2", 2);
+
+	gb.uploadVertices(vertices.size(), vertices.size() * sizeof(TextVertex),
+					  vertices.data(), GL_STREAM_DRAW);
+
 	Renderer::DrawParameters dp;
 	dp.start = 0;
-	dp.count = gb.getCount();
-	auto ftexture = renderer->getData()->findTexture(fonts[ti.font]);
-	dp.textures = {ftexture->getName()};
+	dp.count = vertices.size();
+	for( int f = 0; f < GAME_FONTS; ++f )
+	{
+		auto ftexture = renderer->getData()->findTexture(fonts[f]);
+		dp.textures.push_back(ftexture ? ftexture->getName() : 0);
+	}
 	dp.depthWrite = false;
 	
-	renderer->getRenderer()->drawArrays(glm::mat4(), &db, dp);
+	r->drawArrays(glm::mat4(), &db, dp);
 
-	renderer->getRenderer()->popDebugGroup();
+	r->popDebugGroup();
+	vertices.clear();
 }
@@ -0,0 +1,103 @@
+#include <render/ViewFrustum.hpp>
+
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RW_FRUSTUM_AVX 1
+#else
+#define RW_FRUSTUM_AVX 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RW_FRUSTUM_SSE 1
+#else
+#define RW_FRUSTUM_SSE 0
+#endif
+
+void ViewFrustum::intersects(const float* x,
+							 const float* y,
+							 const float* z,
+							 const float* radius,
+							 std::size_t count,
+							 uint32_t* visible) const
+{
+	std::fill(visible, visible + (count + 31) / 32, 0u);
+	std::size_t i = 0;
+
+	// Groups start on multiples of their width, so their bits never span
+	// two words. Spheres are tested against every plane without branching.
+#if RW_FRUSTUM_AVX
+	{
+		__m256 nx[6], ny[6], nz[6], nd[6];
+		for(size_t p = 0; p < 6; ++p)
+		{
+			nx[p] = _mm256_set1_ps(planes[p].normal.x);
+			ny[p] = _mm256_set1_ps(planes[p].normal.y);
+			nz[p] = _mm256_set1_ps(planes[p].normal.z);
+			nd[p] = _mm256_set1_ps(planes[p].distance);
+		}
+		const __m256 zero = _mm256_setzero_ps();
+
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256 cx = _mm256_loadu_ps(x + i);
+			__m256 cy = _mm256_loadu_ps(y + i);
+			__m256 cz = _mm256_loadu_ps(z + i);
+			__m256 limit = _mm256_sub_ps(zero, _mm256_loadu_ps(radius + i));
+
+			__m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+			for(size_t p = 0; p < 6; ++p)
+			{
+				__m256 d = _mm256_add_ps(
+							_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)),
+							_mm256_add_ps(_mm256_mul_ps(nz[p], cz), nd[p]));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, limit, _CMP_GE_OQ));
+			}
+
+			visible[i / 32] |= uint32_t(_mm256_movemask_ps(inside)) << (i % 32);
+		}
+	}
+#endif
+
+#if RW_FRUSTUM_SSE
+	{
+		__m128 nx[6], ny[6], nz[6], nd[6];
+		for(size_t p = 0; p < 6; ++p)
+		{
+			nx[p] = _mm_set1_ps(planes[p].normal.x);
+			ny[p] = _mm_set1_ps(planes[p].normal.y);
+			nz[p] = _mm_set1_ps(planes[p].normal.z);
+			nd[p] = _mm_set1_ps(planes[p].distance);
+		}
+		const __m128 zero = _mm_setzero_ps();
+
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128 cx = _mm_loadu_ps(x + i);
+			__m128 cy = _mm_loadu_ps(y + i);
+			__m128 cz = _mm_loadu_ps(z + i);
+			__m128 limit = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for(size_t p = 0; p < 6; ++p)
+			{
+				__m128 d = _mm_add_ps(
+							_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+							_mm_add_ps(_mm_mul_ps(nz[p], cz), nd[p]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(d, limit));
+			}
+
+			visible[i / 32] |= uint32_t(_mm_movemask_ps(inside)) << (i % 32);
+		}
+	}
+#endif
+
+	for(; i < count; ++i)
+	{
+		if( intersects(glm::vec3(x[i], y[i], z[i]), radius[i]) ) {
+			visible[i / 32] |= 1u << (i % 32);
+		}
+	}
+}
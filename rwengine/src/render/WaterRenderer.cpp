@@ -5,6 +5,11 @@
 
 #include <glm/glm.hpp>
 
+namespace
+{
+const AssetID kWaterTexture = internAssetName("water_old");
+}
+
 WaterRenderer::WaterRenderer(GameRenderer* renderer)
 : waterProg(nullptr)
 {
@@ -110,9 +115,11 @@ void WaterRenderer::render(GameRenderer* renderer, GameWorld* world)
 {
 	auto r = renderer->getRenderer();
 
-	auto waterTex = world->data->findTexture("water_old");
-	RW_CHECK(waterTex != nullptr, "Water texture is null");
-	if (waterTex == nullptr) {
+	if (waterTexture == nullptr) {
+		waterTexture = world->data->findTexture(kWaterTexture);
+	}
+	RW_CHECK(waterTexture != nullptr, "Water texture is null");
+	if (waterTexture == nullptr) {
 		// Can't render water if we don't have a texture.
 		return;
 	}
@@ -154,7 +161,7 @@ void WaterRenderer::render(GameRenderer* renderer, GameWorld* world)
 	r->setUniform(waterProg, "inverseVP", ivp);
 
 	wdp.count = gridGeom.getCount();
-	wdp.textures = {waterTex->getName(), dataTexture};
+	wdp.textures = {waterTexture->getName(), dataTexture};
 	
 	r->drawArrays(m, &gridDraw, wdp);
 
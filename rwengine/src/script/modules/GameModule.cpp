@@ -74,7 +74,7 @@ void game_print_soon(const ScriptArguments& args)
 	int time = args[1].integerValue();
 	unsigned short style = args[2].integerValue();
 
-	auto str = world->data->texts.text(id);
+	std::string str = world->data->texts.text(id);
 
 	auto textEntry = ScreenTextEntry::makeBig(id, str, style, time);
 	world->state->text.addText<ScreenTextType::BigLowPriority>(textEntry);
@@ -334,7 +334,7 @@ void game_add_object_blip(const ScriptArguments& args)
 		break;
 	}
 
-	data.texture = "";
+	data.texture = 0;
 	*args[1].globalInteger = args.getWorld()->state->addRadarBlip(data);
 }
 
@@ -344,7 +344,7 @@ void game_add_location_blip(const ScriptArguments& args)
 	data.target = 0;
 	/// @todo this might use ground coords if z is -100.0
 	data.coord = glm::vec3(args[0].realValue(), args[1].realValue(), args[2].realValue());
-	data.texture = "";
+	data.texture = 0;
 	*args[3].globalInteger = args.getWorld()->state->addRadarBlip(data);
 }
 
@@ -451,16 +451,11 @@ bool game_is_car_inside_garage(const ScriptArguments& args)
 	RW_CHECK(garageIndex < static_cast<int>(garages.size()), "Garage index too high");
 	const auto& garage = garages[garageIndex];
 
-	for(auto& v : gw->vehiclePool.objects) {
-		// @todo if this car only accepts mission cars we probably have to filter here / only check for one specific car
-		auto vp = v.second->getPosition();
-		if (vp.x >= garage.min.x && vp.y >= garage.min.y && vp.z >= garage.min.z &&
-		    vp.x <= garage.max.x && vp.y <= garage.max.y && vp.z <= garage.max.z) {
-			return true;
-		}
-	}
+	// @todo if this car only accepts mission cars we probably have to filter here / only check for one specific car
+	std::vector<GameObject*> inside;
+	gw->vehicleHash.queryBox(garage.min, garage.max, inside);
 
-	return false;
+	return ! inside.empty();
 }
 
 bool game_garage_contains_car(const ScriptArguments& args)
@@ -511,8 +506,8 @@ bool game_special_char_loaded(const ScriptArguments& args)
 {
 	auto chartype = args.getWorld()->data->findObjectType<CharacterData>(args[0].integer);
 	if( chartype ) {
-		auto modelfind = args.getWorld()->data->models.find(chartype->modelName);
-		if( modelfind != args.getWorld()->data->models.end() && modelfind->second->resource != nullptr ) {
+		auto modelfind = args.getWorld()->data->findModel(chartype->modelName);
+		if( modelfind && modelfind->resource != nullptr ) {
 			return true;
 		}
 	}
@@ -621,7 +616,7 @@ void game_add_contact_blip(const ScriptArguments& args)
 	BlipData bd;
 	bd.coord = c;
 	bd.target = 0;
-	bd.texture = spriteName;
+	bd.texture = internAssetName(spriteName);
 	
 	*args[4].globalInteger = args.getWorld()->state->addRadarBlip(bd);
 }
@@ -641,7 +636,7 @@ void game_add_sprite_blip(const ScriptArguments& args)
 	BlipData bd;
 	bd.coord = c;
 	bd.target = 0;
-	bd.texture = spriteName;
+	bd.texture = internAssetName(spriteName);
 	
 	*args[4].globalInteger = args.getWorld()->state->addRadarBlip(bd);
 }
@@ -677,7 +672,7 @@ void game_add_object_sprite_blip(const ScriptArguments& args)
 		break;
 	}
 
-	data.texture = spriteName;
+	data.texture = internAssetName(spriteName);
 	*args[2].globalInteger = args.getWorld()->state->addRadarBlip(data);
 }
 
@@ -1058,23 +1053,20 @@ void game_clear_area(const ScriptArguments& args)
 
 	GameWorld* gw = args.getWorld();
 
-	for(auto& v : gw->vehiclePool.objects)
-	{
-		if( glm::distance(position, v.second->getPosition()) < radius )
-		{
-			gw->destroyObjectQueued(v.second);
-		}
-	}
+	std::vector<GameObject*> objects;
+	gw->vehicleHash.queryRadius(position, radius, objects);
+	gw->pedestrianHash.queryRadius(position, radius, objects);
 
-	for(auto& p : gw->pedestrianPool.objects)
+	for(auto& o : objects)
 	{
 		// Hack: Not sure what other objects are exempt from this opcode
-		if (p.second->getLifetime() == GameObject::PlayerLifetime) {
+		if (o->getLifetime() == GameObject::PlayerLifetime) {
 			continue;
 		}
-		if( glm::distance(position, p.second->getPosition()) < radius )
+		// The hash query is inclusive, but objects on the edge are kept
+		if( glm::distance(position, o->getPosition()) < radius )
 		{
-			gw->destroyObjectQueued(p.second);
+			gw->destroyObjectQueued(o);
 		}
 	}
 
@@ -827,33 +827,24 @@ bool game_objects_in_volume(const ScriptArguments& args)
 	RW_UNUSED(objects);
 	RW_UNUSED(particles);
 	
-	for(auto& object : args.getWorld()->allObjects)
+	auto world = args.getWorld();
+
+	// Maybe consider object bounds?
+	if( solids && world->instanceIndex.anyInBox(min, max) )
 	{
-		switch( object->type() )
-		{
-			case GameObject::Instance:
-				if( !solids ) continue;
-				break;
-			case GameObject::Character:
-				if( !actors ) continue;
-				break;
-			case GameObject::Vehicle:
-				if( !cars ) continue;
-				break;
-			default:
-				continue;
-		}
-		
-		// Maybe consider object bounds?
-		auto pp = object->getPosition();
-		
-		if( pp.x >= min.x && pp.y >= min.y && pp.z >= min.z &&
-			pp.x <= max.x && pp.y <= max.y && pp.z <= max.z )
-		{
-			return true;
-		}
+		return true;
 	}
-	return false;
+
+	std::vector<GameObject*> found;
+	if( actors )
+	{
+		world->pedestrianHash.queryBox(min, max, found);
+	}
+	if( cars )
+	{
+		world->vehicleHash.queryBox(min, max, found);
+	}
+	return !found.empty();
 }
 
 bool game_is_vehicle_in_water(const ScriptArguments& args)
@@ -882,10 +873,13 @@ void game_get_random_character_in_zone(const ScriptArguments& args)
 	auto zfind = zones.find(zname);
 	if(zfind != zones.end()) {
 
-		// Create a list of candidate characters by iterating and checking if the char is in this zone
-		std::vector<std::pair<GameObjectID, GameObject*>> candidates;
-		for(auto& p : args.getWorld()->pedestrianPool.objects) {
-			auto character = static_cast<CharacterObject*>(p.second);
+		// Create a list of candidate characters from those inside this zone
+		std::vector<GameObject*> inZone;
+		args.getWorld()->pedestrianHash.queryBox(zfind->second.min, zfind->second.max, inZone);
+
+		std::vector<CharacterObject*> candidates;
+		for(auto& p : inZone) {
+			auto character = static_cast<CharacterObject*>(p);
 
 			// We only consider characters walking around normally
 			/// @todo not sure if we are able to grab script objects or players too
@@ -893,13 +887,13 @@ void game_get_random_character_in_zone(const ScriptArguments& args)
 				continue;
 			}
 
-			// Check if character is in this zone
+			// The hash query is inclusive, but the zone check is strict
 			auto cp = character->getPosition();
 			auto& min = zfind->second.min;
 			auto& max = zfind->second.max;
 			if (cp.x > min.x && cp.y > min.y && cp.z > min.z &&
 			    cp.x < max.x && cp.y < max.y && cp.z < max.z) {
-				candidates.push_back(p);
+				candidates.push_back(character);
 			}
 		}
 
@@ -908,11 +902,10 @@ void game_get_random_character_in_zone(const ScriptArguments& args)
 		if (candidateCount > 0) {
 			// Return the handle for any random character in this zone and use lifetime for use by script
 			// @todo verify if the lifetime is actually changed in the original game
-			unsigned int randomIndex = std::rand() % candidateCount;
-			const auto p = candidates[randomIndex];
-			auto character = static_cast<CharacterObject*>(p.second);
+			unsigned int randomIndex = args.getWorld()->random.stream(RandomService::Script).below(candidateCount);
+			auto character = candidates[randomIndex];
 			character->setLifetime(GameObject::UnknownLifetime);
-			*args[1].globalInteger = p.first;
+			*args[1].globalInteger = character->getGameObjectID();
 			return;
 		}
 
@@ -1229,14 +1222,10 @@ void game_set_close_object_visible(const ScriptArguments& args)
 	
 	std::transform(model.begin(), model.end(), model.begin(), ::tolower);
 	
-	for(auto& p : args.getWorld()->instancePool.objects) {
-		auto o = p.second;
-		if( !o->model ) continue;
-		if( o->model->name != model ) continue;
-		float d = glm::distance(position, o->getPosition());
-		if( d < radius ) {
-			o->visible = !!args[5].integer;
-		}
+	std::vector<InstanceObject*> instances;
+	args.getWorld()->instanceIndex.findByModel(model, position, radius, instances);
+	for(auto o : instances) {
+		o->visible = !!args[5].integer;
 	}
 }
 
@@ -1298,17 +1287,13 @@ void game_change_nearest_model(const ScriptArguments& args)
 	auto nobj = args.getWorld()->data->findObjectType<ObjectData>(newobjectid);
 	
 	/// @todo Objects need to adopt the new object ID, not just the model.
-	for(auto p : args.getWorld()->instancePool.objects) {
-		auto o = p.second;
-		if( !o->model ) continue;
-		if( o->model->name != oldmodel ) continue;
-		float d = glm::distance(position, o->getPosition());
-		if( d < radius ) {
-			args.getWorld()->data->loadDFF(newmodel + ".dff", false);
-			InstanceObject* inst = static_cast<InstanceObject*>(o);
-			inst->changeModel(nobj);
-			inst->model = args.getWorld()->data->models[newmodel];
-		}
+	std::vector<InstanceObject*> instances;
+	args.getWorld()->instanceIndex.findByModel(oldmodel, position, radius, instances);
+	for(auto inst : instances) {
+		args.getWorld()->data->loadDFF(newmodel + ".dff", false);
+		inst->changeModel(nobj);
+		inst->model = args.getWorld()->data->findModel(newmodel);
+		args.getWorld()->instanceIndex.update(inst);
 	}
 }
 
@@ -224,9 +224,15 @@ void vm_sqrt(const ScriptArguments& args)
 
 void vm_random_int_in_range(const ScriptArguments& args)
 {
-  auto min = args[0].integerValue();
-  auto max = args[1].integerValue();
-	*args[2].globalInteger = std::rand() % (max - min) + min;
+	auto min = args[0].integerValue();
+	auto max = args[1].integerValue();
+	// Scripts do ask for empty and reversed ranges
+	if (max <= min) {
+		*args[2].globalInteger = min;
+		return;
+	}
+	auto span = uint32_t(max) - uint32_t(min);
+	*args[2].globalInteger = args.getWorld()->random.stream(RandomService::Script).below(span) + min;
 }
 
 void vm_name_thread(const ScriptArguments& args)
@@ -2,6 +2,7 @@
 #include <rw/defines.hpp>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
 
 #include <ini.h>
 
@@ -12,6 +13,7 @@ GameConfig::GameConfig(const std::string& configName, const std::string& configP
 	, m_configPath(configPath)
 	, m_valid(false)
 	, m_inputInvertY(false)
+	, m_workerThreads(0)
 {
 	if (m_configPath.empty())
 	{
@@ -83,6 +85,10 @@ int GameConfig::handler(void* user,
 	{
 		self->m_inputInvertY = atoi(value) > 0;
 	}
+	else if (MATCH("engine", "worker_threads"))
+	{
+		self->m_workerThreads = std::max(0, atoi(value));
+	}
 	else
 	{
 		RW_MESSAGE("Unhandled config entry [" << section << "] " << name << " = " << value);
@@ -25,6 +25,7 @@ public:
 
 	const std::string& getGameDataPath() const { return m_gamePath; }
 	bool getInputInvertY() const { return m_inputInvertY; }
+	unsigned int getWorkerThreads() const { return m_workerThreads; }
 
 private:
 	static std::string getDefaultConfigPath();
@@ -42,6 +43,9 @@ private:
 
 	/// Invert the y axis for camera control.
 	bool m_inputInvertY;
+
+	/// Threads for physics and batched queries, 0 for one per core.
+	unsigned int m_workerThreads;
 };
 
 #endif
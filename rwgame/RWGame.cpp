@@ -183,7 +183,7 @@ void RWGame::newGame()
 	}
 
 	state = new GameState();
-	world = new GameWorld(&log, &work, data);
+	world = new GameWorld(&log, &work, data, config.getWorkerThreads());
 	world->dynamicsWorld->setDebugDrawer(debug);
 
 	// Associate the new world with the new state and vice versa
@@ -380,10 +380,13 @@ int RWGame::run()
 		if (StateManager::get().states.size() > 0) {
 			StateManager::get().draw(renderer);
 		}
+		renderer->text.flush();
 		RW_PROFILE_END();
 		RW_PROFILE_END();
 
 		renderProfile();
+		renderer->text.flush();
+		renderer->text.nextFrame();
 
 		window.swap();
 	}
@@ -425,26 +428,8 @@ void RWGame::tick(float dt)
 			clockAccumulator -= 1.f;
 		}
 		
-		// Clean up old VisualFX
-		for( int i = 0; i < world->effects.size(); ++i )
-		{
-			VisualFX* effect = world->effects[i];
-			if( effect->getType() == VisualFX::Particle )
-			{
-				auto& part = effect->particle;
-				if( part.lifetime < 0.f ) continue;
-				if( world->getGameTime() >= part.starttime + part.lifetime )
-				{
-					world->destroyEffect( effect );
-					--i;
-				}
-			}
-		}
-
-		for( auto& object : world->allObjects ) {
-			object->_updateLastTransform();
-			object->tick(dt);
-		}
+		world->setSimulationFocus(nextCam.position);
+		world->tickObjects(dt);
 		
 		world->destroyQueuedObjects();
 
@@ -494,11 +479,11 @@ void RWGame::render(float alpha, float time)
 		float cutsceneTime = std::min(world->getGameTime() - state->cutsceneStartTime,
 									  cutscene->tracks.duration);
 		cutsceneTime += GAME_TIMESTEP * alpha;
-		glm::vec3 cameraPos = cutscene->tracks.getPositionAt(cutsceneTime),
-				targetPos = cutscene->tracks.getTargetAt(cutsceneTime);
-		float zoom = cutscene->tracks.getZoomAt(cutsceneTime);
-		viewCam.frustum.fov = glm::radians(zoom);
-		float tilt = cutscene->tracks.getRotationAt(cutsceneTime);
+		auto camera = cutscene->tracks.getCameraAt(cutsceneTime);
+		glm::vec3 cameraPos = camera.position,
+				targetPos = camera.target;
+		viewCam.frustum.fov = glm::radians(camera.zoom);
+		float tilt = camera.rotation;
 
 		auto direction = glm::normalize(targetPos - cameraPos);
 		auto right = glm::normalize(glm::cross(glm::vec3(0.f, 0.f, 1.f), direction));
@@ -578,6 +563,9 @@ void RWGame::render(float alpha, float time)
 	RW_PROFILE_END();
 	
 	drawOnScreenText(world, renderer);
+
+	// Draw the world's text before the state draws over it
+	renderer->text.flush();
 }
 
 void RWGame::renderDebugStats(float time, Renderer::ProfileInfo& worldRenderTime)
@@ -633,6 +621,8 @@ void RWGame::renderDebugStats(float time, Renderer::ProfileInfo& worldRenderTime
 	}
 	
 	ss << "P " << peds << " V " << cars << "\n";
+	ss << "Active objects: " << world->getActiveObjectCount()
+	   << " / " << world->allObjects.size() << "\n";
 	
 	if( state->playerObject ) {
 		ss << "Player (" << state->playerObject << ")\n";
@@ -690,19 +680,22 @@ void RWGame::renderDebugPaths(float time)
 	btVector3 roadColour(1.f, 0.f, 0.f);
 	btVector3 pedColour(0.f, 0.f, 1.f);
 	
-	for( AIGraphNode* n : world->aigraph.nodes )
+	auto& graph = world->aigraph;
+	for( size_t i = 0; i < graph.nodes.size(); ++i )
 	{
+		auto n = &graph.nodes[i];
 		btVector3 p( n->position.x, n->position.y, n->position.z );
 		auto& col = n->type == AIGraphNode::Pedestrian ? pedColour : roadColour;
 		debug->drawLine( p - btVector3(0.f, 0.f, 1.f), p + btVector3(0.f, 0.f, 1.f), col);
 		debug->drawLine( p - btVector3(1.f, 0.f, 0.f), p + btVector3(1.f, 0.f, 0.f), col);
 		debug->drawLine( p - btVector3(0.f, 1.f, 0.f), p + btVector3(0.f, 1.f, 0.f), col);
 
-		for( AIGraphNode* c : n->connections )
+		graph.forEachConnection(i, [&](AIGraph::NodeIndex c)
 		{
-			btVector3 f( c->position.x, c->position.y, c->position.z );
+			auto& cp = graph.nodes[c].position;
+			btVector3 f( cp.x, cp.y, cp.z );
 			debug->drawLine( p, f, col);
-		}
+		});
 	}
 
 	// Draw Garage bounds
@@ -46,7 +46,7 @@ Menu* DebugState::createDebugMenu()
 	m->addEntry(Menu::lambda("Random Vehicle", [this] {
 		auto it = getWorld()->vehicleTypes.begin();
 		std::uniform_int_distribution<int> uniform(0, 3);
-		for(size_t i = 0, n = uniform(getWorld()->randomEngine); i != n; i++) {
+		for(size_t i = 0, n = uniform(getWorld()->random.stream(RandomService::General)); i != n; i++) {
 			it++;
 		}
 		spawnVehicle(it->first);
@@ -201,7 +201,7 @@ Menu* DebugState::createMapMenu()
 
 		auto gw = game->getWorld();
 		for(auto& i : gw->instancePool.objects) {
-			auto obj = static_cast<InstanceObject*>(i.second);
+			auto obj = static_cast<InstanceObject*>(i);
 			if (std::find(garageDoorModels.begin(), garageDoorModels.end(), obj->model->name) != garageDoorModels.end()) {
 				obj->setSolid(false);
 			}
@@ -271,11 +271,11 @@ Menu* DebugState::createAIMenu()
 
 	m->addEntry(Menu::lambda("Kill All Peds", [=] {
 		for (auto& p : game->getWorld()->pedestrianPool.objects) {
-			if (p.second->getLifetime() == GameObject::PlayerLifetime) {
+			if (p->getLifetime() == GameObject::PlayerLifetime) {
 				continue;
 			}
-			p.second->takeDamage({p.second->getPosition(),
-			                      p.second->getPosition(), 100.f,
+			p->takeDamage({p->getPosition(),
+			               p->getPosition(), 100.f,
 			                      GameObject::DamageInfo::Explosion, 0.f});
 		}
 	}, kDebugEntryHeight));
@@ -342,7 +342,7 @@ void DebugState::tick(float dt)
 					for(auto tit = itt->textures.begin(); tit != itt->textures.end();
 						++tit)
 					{
-						ss << " " << tit->name << std::endl;
+						ss << " " << getAssetName(tit->name) << std::endl;
 					}
 				}
 			}
@@ -0,0 +1,69 @@
+#include <data/AssetName.hpp>
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+/**
+ * Names are stored in a deque so that references to them survive new names
+ * being added.
+ */
+struct AssetNameTable
+{
+	std::mutex mutex;
+	std::deque<std::string> names;
+	std::unordered_map<std::string, AssetID> ids;
+
+	AssetNameTable()
+	{
+		names.push_back(std::string());
+		ids.insert({std::string(), 0});
+	}
+};
+
+AssetNameTable& table()
+{
+	static AssetNameTable names;
+	return names;
+}
+}
+
+AssetID internAssetName(const std::string& name)
+{
+	if (name.empty()) {
+		return 0;
+	}
+
+	auto& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	auto it = t.ids.find(name);
+	if (it != t.ids.end()) {
+		return it->second;
+	}
+
+	AssetID id = t.names.size();
+	t.names.push_back(name);
+	t.ids.insert({name, id});
+	return id;
+}
+
+AssetID findAssetName(const std::string& name)
+{
+	if (name.empty()) {
+		return 0;
+	}
+
+	auto& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	auto it = t.ids.find(name);
+	return it != t.ids.end() ? it->second : kUnknownAssetName;
+}
+
+const std::string& getAssetName(AssetID id)
+{
+	auto& t = table();
+	std::lock_guard<std::mutex> lock(t.mutex);
+	return id < t.names.size() ? t.names[id] : t.names[0];
+}
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef _RWLIB_DATA_ASSETNAME_HPP_
+#define _RWLIB_DATA_ASSETNAME_HPP_
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Identifies an interned model or texture name. Names are compared exactly,
+ * so they should be lower case before being interned.
+ *
+ * The empty name is always 0.
+ */
+typedef uint32_t AssetID;
+
+/**
+ * Identifies a texture by its name and alpha mask name.
+ */
+typedef uint64_t TextureID;
+
+/**
+ * Returns the ID for name, adding it to the table if it's new. IDs stay
+ * valid for the life of the program. Safe to call from loader threads.
+ */
+AssetID internAssetName(const std::string& name);
+
+/**
+ * Returned by findAssetName for names that have never been interned. No
+ * asset can have this ID.
+ */
+constexpr AssetID kUnknownAssetName = 0xFFFFFFFF;
+
+/**
+ * Returns the ID for name without adding it to the table, or
+ * kUnknownAssetName if it has never been interned.
+ */
+AssetID findAssetName(const std::string& name);
+
+/**
+ * Returns the name an ID was interned from.
+ */
+const std::string& getAssetName(AssetID id);
+
+inline TextureID makeTextureID(AssetID name, AssetID alpha = 0)
+{
+	return (TextureID(name) << 32) | alpha;
+}
+
+#endif
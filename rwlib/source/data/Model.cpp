@@ -2,10 +2,15 @@
 #include <iostream>
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstring>
 
 
 Model::Geometry::Geometry()
-	: flags(0)
+	: EBO(0)
+	, arena(nullptr)
+	, baseVertex(0)
+	, flags(0)
 {
 	
 }
@@ -15,6 +20,64 @@ Model::Geometry::~Geometry()
 
 }
 
+Model::CompactGeometryVertex Model::CompactGeometryVertex::pack(const GeometryVertex& v)
+{
+	CompactGeometryVertex c;
+	c.position = v.position;
+	c.normal = packNormal(v.normal);
+	c.texcoord[0] = packHalf(v.texcoord.x);
+	c.texcoord[1] = packHalf(v.texcoord.y);
+	c.colour = v.colour;
+	return c;
+}
+
+uint32_t Model::CompactGeometryVertex::packNormal(const glm::vec3& n)
+{
+	auto pack10 = [](float v) {
+		auto i = static_cast<int32_t>(std::round(glm::clamp(v, -1.f, 1.f) * 511.f));
+		return static_cast<uint32_t>(i) & 0x3FF;
+	};
+	return pack10(n.x) | (pack10(n.y) << 10) | (pack10(n.z) << 20);
+}
+
+uint16_t Model::CompactGeometryVertex::packHalf(float f)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x7FFFFF;
+
+	if ((bits & 0x7F800000) == 0x7F800000) {
+		// Infinity or NaN
+		return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+	}
+	if (exponent >= 31) {
+		return sign | 0x7BFF;
+	}
+	if (exponent <= 0) {
+		// Too small for a normal half, store as denormal or zero
+		if (exponent < -10) {
+			return sign;
+		}
+		mantissa |= 0x800000;
+		uint32_t shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1) {
+			half++;
+		}
+		return sign | half;
+	}
+
+	uint32_t half = (exponent << 10) | (mantissa >> 13);
+	// Round to nearest, a carry into the exponent is still correct
+	if (mantissa & 0x1000) {
+		half++;
+	}
+	return sign | std::min(half, 0x7BFFu);
+}
+
 ModelFrame::ModelFrame(unsigned int index, ModelFrame* parent, glm::mat3 dR, glm::vec3 dT)
  : index(index), defaultRotation(dR), defaultTranslation(dT), parentFrame(parent)
 {
@@ -50,4 +113,21 @@ void Model::recalculateMetrics()
 		RW::BSGeometryBounds& bounds = geometries[g]->geometryBounds;
 		boundingRadius = std::max(boundingRadius, glm::length(bounds.center) + bounds.radius);
 	}
+
+	// Frames only rotate and translate, so the sum of the translations up the
+	// hierarchy bounds a geometry's offset whichever of them are applied
+	cullingRadius = boundingRadius;
+	for (ModelFrame* frame : frames)
+	{
+		float offset = 0.f;
+		for (ModelFrame* f = frame; f != nullptr; f = f->getParent())
+		{
+			offset += glm::length(glm::vec3(f->getTransform()[3]));
+		}
+		for (size_t g : frame->getGeometries())
+		{
+			RW::BSGeometryBounds& bounds = geometries[g]->geometryBounds;
+			cullingRadius = std::max(cullingRadius, offset + glm::length(bounds.center) + bounds.radius);
+		}
+	}
 }
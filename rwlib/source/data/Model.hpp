@@ -7,9 +7,11 @@
 #include <memory>
 #include <algorithm>
 
+#include <data/AssetName.hpp>
 #include <data/ResourceHandle.hpp>
 #include <loaders/RWBinaryStream.hpp>
 #include <gl/DrawBuffer.hpp>
+#include <gl/GeometryArena.hpp>
 #include <gl/GeometryBuffer.hpp>
 #include <gl/TextureData.hpp>
 
@@ -79,8 +81,9 @@ public:
 	std::uint32_t numAtomics;
 
 	struct Texture {
-		std::string name;
-		std::string alphaName;
+		AssetID name;
+		AssetID alphaName;
+		/// Resolved the first time the material is drawn
 		TextureData::Handle texture;
 	};
 	
@@ -102,6 +105,7 @@ public:
 	struct SubGeometry {
 		GLuint start = 0;
 		size_t material;
+		/// Emptied once uploaded, unless the loader is told to keep them
 		std::vector<uint32_t> indices;
 		size_t numIndices;
 	};
@@ -122,12 +126,51 @@ public:
 			};
 		}
 	};
+
+	/**
+	 * Quantized GeometryVertex, 24 bytes instead of 36. The normal is
+	 * packed into signed 10 bit components and the texture coordinates are
+	 * half floats, both of which GL expands so shaders are unchanged.
+	 */
+	struct CompactGeometryVertex {
+		glm::vec3 position;   /* 0 */
+		uint32_t normal;      /* 12 */
+		uint16_t texcoord[2]; /* 16 */
+		glm::u8vec4 colour;   /* 20 */
+
+		static CompactGeometryVertex pack(const GeometryVertex& v);
+
+		/**
+		 * Packs a unit vector as GL_INT_2_10_10_10_REV
+		 */
+		static uint32_t packNormal(const glm::vec3& n);
+
+		/**
+		 * Converts to a half float, clamping to the largest finite value
+		 */
+		static uint16_t packHalf(float f);
+
+		/** @see GeometryBuffer */
+		static const AttributeList vertex_attributes() {
+			return {
+				{ATRS_Position, 3, sizeof(CompactGeometryVertex),  0ul},
+				{ATRS_Normal,   4, sizeof(CompactGeometryVertex), 12ul, GL_INT_2_10_10_10_REV},
+				{ATRS_TexCoord, 2, sizeof(CompactGeometryVertex), 16ul, GL_HALF_FLOAT},
+				{ATRS_Colour,   4, sizeof(CompactGeometryVertex), 20ul, GL_UNSIGNED_BYTE}
+			};
+		}
+	};
 	
 	struct Geometry {
 		DrawBuffer dbuff;
 		GeometryBuffer gbuff;
 		
 		GLuint EBO;
+
+		/// Holds the vertices and indices instead of dbuff when set
+		GeometryArena* arena;
+		/// Added to the indices when drawing from the arena
+		GLint baseVertex;
 		
 		RW::BSGeometryBounds geometryBounds;
 		
@@ -142,6 +185,9 @@ public:
 		
 		Geometry();
 		~Geometry();
+
+		DrawBuffer* getDrawBuffer()
+			{ return arena ? arena->getDrawBuffer() : &dbuff; }
 	};
 	
 	struct Atomic {
@@ -169,8 +215,15 @@ public:
 
 	float getBoundingRadius() const { return boundingRadius; }
 
+	/**
+	 * @return A radius about the model's origin that contains all of its
+	 * geometry however the frames are placed, for culling whole objects
+	 */
+	float getCullingRadius() const { return cullingRadius; }
+
 private:
 	float boundingRadius;
+	float cullingRadius;
 };
 
 typedef ResourceHandle<Model>::Ref ModelRef;
@@ -7,11 +7,15 @@ std::map<AttributeSemantic, GLuint> semantic_to_attrib_array = {
 	{ATRS_Position, 0},
 	{ATRS_Normal,   1},
 	{ATRS_Colour,   2},
-	{ATRS_TexCoord, 3}
+	{ATRS_TexCoord, 3},
+	{ATRS_Instance0, 4},
+	{ATRS_Instance1, 5},
+	{ATRS_Instance2, 6},
+	{ATRS_Instance3, 7}
 };
 
 DrawBuffer::DrawBuffer()
-: vao(0)
+: vao(0), facetype(GL_TRIANGLES), indextype(GL_UNSIGNED_INT)
 {
 
 }
@@ -36,5 +40,6 @@ void DrawBuffer::addGeometry(GeometryBuffer* gbuff)
 		GLuint vaoindex = semantic_to_attrib_array[at.sem];
 		glEnableVertexAttribArray(vaoindex);
 		glVertexAttribPointer(vaoindex, at.size, at.type, GL_TRUE, at.stride, reinterpret_cast<GLvoid*>(at.offset));
+		glVertexAttribDivisor(vaoindex, at.divisor);
 	}
 }
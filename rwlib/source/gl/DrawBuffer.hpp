@@ -12,6 +12,7 @@ class DrawBuffer {
 	GLuint vao;
 	
 	GLenum facetype;
+	GLenum indextype;
 public:
 	
 	DrawBuffer();
@@ -25,6 +26,22 @@ public:
 	
 	GLenum getFaceType() const
 		{ return facetype; }
+
+	/**
+	 * Sets the type of the element buffer's indices, GL_UNSIGNED_INT by
+	 * default or GL_UNSIGNED_SHORT.
+	 */
+	void setIndexType(GLenum it)
+		{ indextype = it; }
+
+	GLenum getIndexType() const
+		{ return indextype; }
+
+	/**
+	 * @return The size of one index in bytes
+	 */
+	GLsizei getIndexSize() const
+		{ return indextype == GL_UNSIGNED_SHORT ? 2 : 4; }
 	
 	/**
 	 * Adds a Geometry Buffer to the Draw Buffer.
@@ -0,0 +1,111 @@
+#include <gl/GeometryArena.hpp>
+
+GeometryArena::GeometryArena(const AttributeList& attributes,
+							 GLsizei vertexSize,
+							 GLenum faceType,
+							 std::size_t vertexCapacity,
+							 std::size_t indexCapacity)
+	: ebo(0)
+	, attributes(attributes)
+	, vertexSize(vertexSize)
+	, vertexCapacity(vertexCapacity)
+	, indexCapacity(indexCapacity)
+	, vertexCount(0)
+	, indexCount(0)
+{
+	dbuff.setFaceType(faceType);
+	dbuff.setIndexType(GL_UNSIGNED_SHORT);
+}
+
+GeometryArena::~GeometryArena()
+{
+	if( ebo != 0 ) {
+		glDeleteBuffers(1, &ebo);
+	}
+}
+
+bool GeometryArena::allocate(std::size_t vertices, std::size_t indices, Allocation& out)
+{
+	// The indices are 16 bit, relative to the base vertex
+	if( vertices > 0x10000 ) {
+		return false;
+	}
+	if( vertexCount + vertices > vertexCapacity || indexCount + indices > indexCapacity ) {
+		return false;
+	}
+
+	out.baseVertex = vertexCount;
+	out.firstIndex = indexCount;
+	vertexCount += vertices;
+	indexCount += indices;
+	return true;
+}
+
+void GeometryArena::createBuffers()
+{
+	gbuff.uploadVertices(vertexCapacity, vertexCapacity * vertexSize, nullptr);
+	gbuff.getDataAttributes() = attributes;
+	dbuff.addGeometry(&gbuff);
+
+	// Bound while the vertex array is, so it becomes part of it
+	glGenBuffers(1, &ebo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * sizeof(uint16_t), nullptr, GL_STATIC_DRAW);
+}
+
+void GeometryArena::upload(const Allocation& allocation,
+						   const void* vertices, std::size_t vertexCount,
+						   const uint16_t* indices, std::size_t indexCount)
+{
+	if( ebo == 0 ) {
+		createBuffers();
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, gbuff.getVBOName());
+	glBufferSubData(GL_ARRAY_BUFFER,
+					allocation.baseVertex * vertexSize,
+					vertexCount * vertexSize,
+					vertices);
+
+	// Not through the element array binding, which would need the vertex
+	// array bound and leave the renderer's state cache stale
+	glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+	glBufferSubData(GL_COPY_WRITE_BUFFER,
+					allocation.firstIndex * sizeof(uint16_t),
+					indexCount * sizeof(uint16_t),
+					indices);
+}
+
+GeometryArenas::GeometryArenas(const AttributeList& attributes,
+							   GLsizei vertexSize,
+							   std::size_t vertexCapacity,
+							   std::size_t indexCapacity)
+	: attributes(attributes)
+	, vertexSize(vertexSize)
+	, vertexCapacity(vertexCapacity)
+	, indexCapacity(indexCapacity)
+{
+}
+
+GeometryArena* GeometryArenas::allocate(GLenum faceType,
+										std::size_t vertices,
+										std::size_t indices,
+										GeometryArena::Allocation& out)
+{
+	if( vertices > vertexCapacity || indices > indexCapacity ) {
+		return nullptr;
+	}
+
+	for( auto& arena : arenas ) {
+		if( arena->getFaceType() == faceType && arena->allocate(vertices, indices, out) ) {
+			return arena.get();
+		}
+	}
+
+	arenas.emplace_back(new GeometryArena(attributes, vertexSize, faceType,
+										  vertexCapacity, indexCapacity));
+	if( arenas.back()->allocate(vertices, indices, out) ) {
+		return arenas.back().get();
+	}
+	return nullptr;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#ifndef _GEOMETRYARENA_HPP_
+#define _GEOMETRYARENA_HPP_
+#include <gl/DrawBuffer.hpp>
+#include <gl/GeometryBuffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Vertex and index storage shared by many geometries, so that they
+ * can be drawn one after another without rebinding vertex arrays.
+ *
+ * Space is handed out from the front and never returned. Indices are 16 bit
+ * and relative to each geometry's first vertex, which is passed to the draw
+ * as its base vertex.
+ */
+class GeometryArena
+{
+public:
+	/**
+	 * Where in the arena a geometry was placed
+	 */
+	struct Allocation
+	{
+		/// Added to every index when drawing
+		GLint baseVertex;
+		/// Offset of the geometry's first index, in indices
+		GLuint firstIndex;
+	};
+
+	GeometryArena(const AttributeList& attributes,
+				  GLsizei vertexSize,
+				  GLenum faceType,
+				  std::size_t vertexCapacity,
+				  std::size_t indexCapacity);
+	~GeometryArena();
+
+	/**
+	 * Reserves space for a geometry. Returns false if it doesn't fit.
+	 * Doesn't touch GL.
+	 */
+	bool allocate(std::size_t vertices, std::size_t indices, Allocation& out);
+
+	/**
+	 * Copies a geometry into its allocation, creating the buffers the
+	 * first time.
+	 */
+	void upload(const Allocation& allocation,
+				const void* vertices, std::size_t vertexCount,
+				const uint16_t* indices, std::size_t indexCount);
+
+	DrawBuffer* getDrawBuffer()
+		{ return &dbuff; }
+
+	GLenum getFaceType() const
+		{ return dbuff.getFaceType(); }
+
+	std::size_t getVertexCount() const
+		{ return vertexCount; }
+
+	std::size_t getIndexCount() const
+		{ return indexCount; }
+
+	/**
+	 * @return The size of the arena's buffers in bytes
+	 */
+	std::size_t getCapacityBytes() const
+		{ return vertexCapacity * vertexSize + indexCapacity * sizeof(uint16_t); }
+
+private:
+	DrawBuffer dbuff;
+	GeometryBuffer gbuff;
+	GLuint ebo;
+
+	AttributeList attributes;
+	GLsizei vertexSize;
+	std::size_t vertexCapacity;
+	std::size_t indexCapacity;
+	std::size_t vertexCount;
+	std::size_t indexCount;
+
+	void createBuffers();
+};
+
+/**
+ * @brief The arenas for one vertex format, adding more as they fill up.
+ */
+class GeometryArenas
+{
+public:
+	GeometryArenas(const AttributeList& attributes,
+				   GLsizei vertexSize,
+				   std::size_t vertexCapacity = 512 * 1024,
+				   std::size_t indexCapacity = 1536 * 1024);
+
+	/**
+	 * Reserves space in an arena with the given face type.
+	 * @return The arena, or nullptr if the geometry is too large for one
+	 */
+	GeometryArena* allocate(GLenum faceType,
+							std::size_t vertices,
+							std::size_t indices,
+							GeometryArena::Allocation& out);
+
+	std::size_t size() const
+		{ return arenas.size(); }
+
+	GeometryArena* getArena(std::size_t i)
+		{ return arenas[i].get(); }
+
+private:
+	AttributeList attributes;
+	GLsizei vertexSize;
+	std::size_t vertexCapacity;
+	std::size_t indexCapacity;
+
+	std::vector<std::unique_ptr<GeometryArena>> arenas;
+};
+
+#endif
@@ -13,12 +13,12 @@ GeometryBuffer::~GeometryBuffer()
 	}
 }
 
-void GeometryBuffer::uploadVertices(GLsizei num, GLsizeiptr size, const GLvoid* mem)
+void GeometryBuffer::uploadVertices(GLsizei num, GLsizeiptr size, const GLvoid* mem, GLenum usage)
 {
 	if(vbo == 0) {
 		glGenBuffers(1, &vbo);
 	}
 	this->num = num;
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, size, mem, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, size, mem, usage);
 }
@@ -11,7 +11,12 @@ enum AttributeSemantic {
 	ATRS_Position,
 	ATRS_Normal,
 	ATRS_Colour,
-	ATRS_TexCoord
+	ATRS_TexCoord,
+	/// Generic attributes for per-instance data
+	ATRS_Instance0,
+	ATRS_Instance1,
+	ATRS_Instance2,
+	ATRS_Instance3
 };
 
 /**
@@ -23,13 +28,16 @@ struct AttributeIndex {
 	GLsizei stride;
 	GLsizei offset;
 	GLenum type;
+	/// Number of instances drawn before advancing, 0 advances per vertex
+	GLuint divisor;
 
 	AttributeIndex(AttributeSemantic s,
 				   GLsizei sz,
 				   GLsizei strd,
 				   GLsizei offs,
-				   GLenum type = GL_FLOAT)
-			: sem(s), size(sz), stride(strd), offset(offs), type(type)
+				   GLenum type = GL_FLOAT,
+				   GLuint divisor = 0)
+			: sem(s), size(sz), stride(strd), offset(offs), type(type), divisor(divisor)
 	{}
 };
 
@@ -74,8 +82,9 @@ public:
 	
 	/**
 	 * Uploads raw memory into the buffer.
+	 * @param usage GL_STREAM_DRAW for data replaced every frame
 	 */
-	void uploadVertices(GLsizei num, GLsizeiptr size, const GLvoid* mem);
+	void uploadVertices(GLsizei num, GLsizeiptr size, const GLvoid* mem, GLenum usage = GL_STATIC_DRAW);
 	
 	const AttributeList& getDataAttributes() const 
 		{ return attributes; }
@@ -0,0 +1,16 @@
+#include <gl/Headless.hpp>
+
+namespace
+{
+bool gHeadless = false;
+}
+
+void setHeadlessGL(bool headless)
+{
+	gHeadless = headless;
+}
+
+bool isHeadlessGL()
+{
+	return gHeadless;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#ifndef _RWLIB_GL_HEADLESS_HPP_
+#define _RWLIB_GL_HEADLESS_HPP_
+
+/**
+ * When set, loaders still parse models and textures but don't create any
+ * GL objects for them. For tools that run the engine without a GL context.
+ */
+void setHeadlessGL(bool headless);
+bool isHeadlessGL();
+
+#endif
@@ -1,5 +1,7 @@
 #include <loaders/LoaderDFF.hpp>
 #include <data/Model.hpp>
+#include <gl/Headless.hpp>
+#include <data/AssetName.hpp>
 
 #include <iostream>
 #include <algorithm>
@@ -241,25 +243,80 @@ void LoaderDFF::readGeometry(Model *model, const RWBStream &stream)
 		}
 	}
 
-	geom->dbuff.setFaceType(geom->facetype == Model::Triangles ?
-									GL_TRIANGLES : GL_TRIANGLE_STRIP);
-	geom->gbuff.uploadVertices(verts);
-	geom->dbuff.addGeometry(&geom->gbuff);
+	if( isHeadlessGL() ) {
+		return;
+	}
 
-	glGenBuffers(1, &geom->EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom->EBO);
+	GLenum faceType = geom->facetype == Model::Triangles ?
+				GL_TRIANGLES : GL_TRIANGLE_STRIP;
 
 	size_t icount = std::accumulate(geom->subgeom.begin(), geom->subgeom.end(),
 									0u,
 									[](size_t a, const Model::SubGeometry& b) {return a + b.numIndices;});
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * icount, 0, GL_STATIC_DRAW);
-	for(auto& sg : geom->subgeom) {
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
-						sg.start * sizeof(uint32_t),
-						sizeof(uint32_t) * sg.numIndices,
-						sg.indices.data());
+
+	std::vector<Model::CompactGeometryVertex> compact;
+	if( compactVertices ) {
+		compact.reserve(verts.size());
+		for(auto& v : verts) {
+			compact.push_back(Model::CompactGeometryVertex::pack(v));
+		}
+	}
+
+	// 16 bit indices are enough for almost every model
+	bool shortIndices = numVerts <= 0x10000;
+
+	GeometryArena::Allocation allocation;
+	if( compactVertices && arenas ) {
+		geom->arena = arenas->allocate(faceType, numVerts, icount, allocation);
 	}
 
+	if( geom->arena ) {
+		std::vector<uint16_t> indices;
+		indices.reserve(icount);
+		for(auto& sg : geom->subgeom) {
+			indices.insert(indices.end(), sg.indices.begin(), sg.indices.end());
+			sg.start += allocation.firstIndex;
+		}
+		geom->arena->upload(allocation, compact.data(), compact.size(),
+							indices.data(), indices.size());
+		geom->baseVertex = allocation.baseVertex;
+	}
+	else {
+		geom->dbuff.setFaceType(faceType);
+		if( compactVertices ) {
+			geom->gbuff.uploadVertices(compact);
+		}
+		else {
+			geom->gbuff.uploadVertices(verts);
+		}
+		geom->dbuff.addGeometry(&geom->gbuff);
+
+		geom->dbuff.setIndexType(shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+		size_t indexSize = geom->dbuff.getIndexSize();
+
+		glGenBuffers(1, &geom->EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom->EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * icount, 0, GL_STATIC_DRAW);
+
+		std::vector<uint16_t> shorts;
+		for(auto& sg : geom->subgeom) {
+			const void* indices = sg.indices.data();
+			if( shortIndices ) {
+				shorts.assign(sg.indices.begin(), sg.indices.end());
+				indices = shorts.data();
+			}
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+							sg.start * indexSize,
+							indexSize * sg.numIndices,
+							indices);
+		}
+	}
+
+	if( ! keepIndices ) {
+		for(auto& sg : geom->subgeom) {
+			std::vector<uint32_t>().swap(sg.indices);
+		}
+	}
 }
 
 void LoaderDFF::readMaterialList(Model *model, const RWBStream &stream)
@@ -353,7 +410,7 @@ void LoaderDFF::readTexture(Model *model, const RWBStream &stream)
 	std::transform(name.begin(), name.end(), name.begin(), ::tolower );
 	std::transform(alpha.begin(), alpha.end(), alpha.begin(), ::tolower );
 
-	model->geometries.back()->materials.back().textures.push_back({name, alpha, nullptr});
+	model->geometries.back()->materials.back().textures.push_back({internAssetName(name), internAssetName(alpha), nullptr});
 }
 
 void LoaderDFF::readGeometryExtension(Model *model, const RWBStream &stream)
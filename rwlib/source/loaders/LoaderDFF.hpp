@@ -11,6 +11,7 @@
 
 class Model;
 class GameData;
+class GeometryArenas;
 
 class DFFLoaderException
 {
@@ -26,6 +27,9 @@ public:
 
 class LoaderDFF
 {
+	bool compactVertices;
+	bool keepIndices;
+	GeometryArenas* arenas;
 
 	/**
 	 * @brief loads a Frame List chunk from stream into model.
@@ -51,6 +55,30 @@ class LoaderDFF
 	void readAtomic(Model* model, const RWBStream& stream);
 
 public:
+	LoaderDFF()
+		: compactVertices(true), keepIndices(false), arenas(nullptr) { }
+
+	/**
+	 * Upload Model::CompactGeometryVertex instead of the full float vertex.
+	 * Enabled by default.
+	 */
+	void setCompactVertices(bool compact)
+		{ compactVertices = compact; }
+
+	/**
+	 * Keep SubGeometry::indices after they've been uploaded, for anything
+	 * that needs the triangles on the CPU such as building collision.
+	 */
+	void setKeepIndices(bool keep)
+		{ keepIndices = keep; }
+
+	/**
+	 * Place compact geometry in shared arenas of
+	 * Model::CompactGeometryVertex, rather than buffers of its own.
+	 */
+	void setGeometryArenas(GeometryArenas* shared)
+		{ arenas = shared; }
+
 	Model* loadFromMemory(FileHandle file);
 };
 
@@ -1,5 +1,6 @@
 #include <loaders/LoaderTXD.hpp>
 #include <gl/TextureData.hpp>
+#include <gl/Headless.hpp>
 
 #include <fstream>
 #include <iostream>
@@ -15,6 +16,13 @@ TextureData::Handle getErrorTexture()
 {
 	static GLuint errTexName = 0;
 	static TextureData::Handle tex;
+	if( isHeadlessGL() )
+	{
+		if( ! tex ) {
+			tex = TextureData::create(0, {2, 2}, false);
+		}
+		return tex;
+	}
 	if(errTexName == 0)
 	{
 		glGenTextures(1, &errTexName);
@@ -67,6 +75,10 @@ TextureData::Handle createTexture(RW::BSTextureNative& texNative, RW::BinaryStre
 		return getErrorTexture();
 	}
 
+	if( isHeadlessGL() ) {
+		return TextureData::create( 0, { texNative.width, texNative.height }, transparent );
+	}
+
 	GLuint textureName = 0;
 
 	if(isPal8)
@@ -190,10 +202,11 @@ bool TextureLoader::loadFromMemory(FileHandle file, TextureArchive &inTextures)
 
 		auto texture = createTexture(texNative, rootSection);
 
-		inTextures[{name, alpha}] = texture;
+		auto nameID = internAssetName(name);
+		inTextures[makeTextureID(nameID, internAssetName(alpha))] = texture;
 
 		if( !alpha.empty() ) {
-			inTextures[{name, ""}] = texture;
+			inTextures[makeTextureID(nameID)] = texture;
 		}
 	}
 
@@ -8,11 +8,12 @@
 #include <platform/FileHandle.hpp>
 #include <functional>
 #include <string>
-#include <map>
+#include <unordered_map>
 
 // This might suffice
 #include <gl/TextureData.hpp>
-typedef std::map<std::pair<std::string, std::string>, TextureData::Handle> TextureArchive;
+#include <data/AssetName.hpp>
+typedef std::unordered_map<TextureID, TextureData::Handle> TextureArchive;
 
 class FileIndex;
 
@@ -18,8 +18,8 @@ void ModelFramesWidget::updateInfoBox(Model* model, ModelFrame *f)
 			for(Model::Material& m : g->materials) {
 				for(Model::Texture& t : m.textures) {
 					geomString += QString("\n %1 (%2)")
-							.arg(t.name.c_str())
-							.arg(t.alphaName.c_str());
+							.arg(getAssetName(t.name).c_str())
+							.arg(getAssetName(t.alphaName).c_str());
 				}
 			}
 		}
@@ -0,0 +1,303 @@
+#include "SoakRunner.hpp"
+
+#include <engine/GameData.hpp>
+#include <engine/GameState.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/SaveGame.hpp>
+#include <gl/Headless.hpp>
+#include <objects/GameObject.hpp>
+
+#include <script/ScriptMachine.hpp>
+#include <script/modules/VMModule.hpp>
+#include <script/modules/GameModule.hpp>
+#include <script/modules/ObjectModule.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#ifndef RW_WINDOWS
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+typedef std::chrono::steady_clock SoakClock;
+
+long getResidentKB()
+{
+#if defined(RW_LINUX)
+	std::ifstream statm("/proc/self/statm");
+	long pages = 0, resident = 0;
+	if (statm >> pages >> resident) {
+		return resident * (sysconf(_SC_PAGESIZE) / 1024);
+	}
+#endif
+	return 0;
+}
+
+long getPeakResidentKB()
+{
+#ifndef RW_WINDOWS
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(RW_OSX)
+		// Reported in bytes rather than kilobytes
+		return usage.ru_maxrss / 1024;
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return 0;
+}
+
+/**
+ * Adds the time spent in its scope to a subsystem's total
+ */
+struct ScopedTimer
+{
+	SoakClock::duration& total;
+	SoakClock::time_point start;
+
+	ScopedTimer(SoakClock::duration& total)
+		: total(total), start(SoakClock::now()) { }
+
+	~ScopedTimer()
+	{
+		total += SoakClock::now() - start;
+	}
+};
+}
+
+SoakRunner::SoakRunner(const SoakOptions& options)
+	: options(options)
+	, data(nullptr)
+	, state(nullptr)
+	, world(nullptr)
+	, script(nullptr)
+	, clockAccumulator(0.f)
+{
+	for (auto& t : subsystemTime) {
+		t = SoakClock::duration::zero();
+	}
+}
+
+SoakRunner::~SoakRunner()
+{
+	delete script;
+	delete world;
+	delete state;
+	delete data;
+}
+
+bool SoakRunner::start()
+{
+	// Nothing is drawn or heard, so avoid needing a GL context or a sound
+	// card on the machine running the test
+	setHeadlessGL(true);
+#ifndef RW_WINDOWS
+	setenv("ALSOFT_DRIVERS", "null", 0);
+#endif
+
+	report.startResidentKB = getResidentKB();
+
+	if (! GameData::isValidGameDirectory(options.gamePath)) {
+		log.error("Soak", "Invalid game directory path: " + options.gamePath);
+		return false;
+	}
+
+	data = new GameData(&log, &work, options.gamePath);
+	data->loadIMG("/models/gta3");
+	data->loadIMG("/anim/cuts");
+	data->load();
+	data->loadDynamicObjects(options.gamePath + "/data/object.dat");
+	data->loadGXT("english.gxt");
+
+	state = new GameState();
+	world = new GameWorld(&log, &work, data, options.workerThreads);
+	state->world = world;
+	world->state = state;
+	if (options.hasSeed) {
+		world->random.seed(options.seed);
+	}
+
+	for (auto& ipl : data->iplLocations) {
+		data->loadZone(ipl.second);
+		world->placeItems(ipl.second);
+	}
+
+	while (! work.isEmpty()) {
+		work.update();
+		std::this_thread::yield();
+	}
+
+	if (! startScript()) {
+		return false;
+	}
+
+	if (options.saveFile.empty()) {
+		script->startThread(0);
+	}
+	else if (! SaveGame::loadGame(*state, options.saveFile)) {
+		log.error("Soak", "Failed to load save " + options.saveFile);
+		return false;
+	}
+
+	return true;
+}
+
+bool SoakRunner::startScript()
+{
+	SCMFile* file = data->loadSCM(options.scriptFile);
+	if (! file) {
+		log.error("Soak", "Failed to load SCM: " + options.scriptFile);
+		return false;
+	}
+
+	SCMOpcodes* opcodes = new SCMOpcodes;
+	opcodes->modules.push_back(new VMModule);
+	opcodes->modules.push_back(new GameModule);
+	opcodes->modules.push_back(new ObjectModule);
+
+	script = new ScriptMachine(state, file, opcodes);
+	state->script = script;
+	return true;
+}
+
+void SoakRunner::run()
+{
+	// One game minute passes per simulated second
+	auto simulated = options.hours * 60.f;
+	auto ticks = uint64_t(simulated / options.timestep);
+
+	auto begin = SoakClock::now();
+	for (uint64_t t = 0; t < ticks; ++t) {
+		tick(options.timestep);
+		recordPeaks();
+	}
+	auto end = SoakClock::now();
+
+	report.ticks = ticks;
+	report.simulatedSeconds = ticks * double(options.timestep);
+	report.wallSeconds = std::chrono::duration<double>(end - begin).count();
+	report.endResidentKB = getResidentKB();
+	report.peakResidentKB = getPeakResidentKB();
+
+	static const char* names[SubsystemCount] = {
+		"work", "objects", "physics", "script", "traffic"
+	};
+	report.subsystems.clear();
+	for (int s = 0; s < SubsystemCount; ++s) {
+		report.subsystems.push_back({
+			names[s], std::chrono::duration<double>(subsystemTime[s]).count()
+		});
+	}
+}
+
+void SoakRunner::tick(float dt)
+{
+	// Follows RWGame::tick, without input, camera control or rendering.
+	{
+		ScopedTimer timer(subsystemTime[Work]);
+		work.update();
+	}
+
+	world->clearTickData();
+	world->chase.update(dt);
+
+	state->gameTime += dt;
+
+	clockAccumulator += dt;
+	while (clockAccumulator >= 1.f) {
+		state->basic.gameMinute++;
+		while (state->basic.gameMinute >= 60) {
+			state->basic.gameMinute = 0;
+			state->basic.gameHour++;
+			while (state->basic.gameHour >= 24) {
+				state->basic.gameHour = 0;
+			}
+		}
+		clockAccumulator -= 1.f;
+	}
+
+	updateCamera();
+
+	{
+		ScopedTimer timer(subsystemTime[Objects]);
+		world->setSimulationFocus(camera.position);
+		world->tickObjects(dt);
+		world->destroyQueuedObjects();
+		state->text.tick(dt);
+	}
+
+	{
+		ScopedTimer timer(subsystemTime[Physics]);
+		world->dynamicsWorld->stepSimulation(dt, 2, dt);
+	}
+
+	{
+		ScopedTimer timer(subsystemTime[Script]);
+		script->execute(dt);
+	}
+
+	if (state->playerObject) {
+		ScopedTimer timer(subsystemTime[Traffic]);
+		camera.frustum.update(camera.frustum.projection() * camera.getView());
+		world->cleanupTraffic(camera);
+		world->createTraffic(camera);
+	}
+}
+
+void SoakRunner::updateCamera()
+{
+	// Stand in for the game camera: sit on the player, looking where they are
+	auto player = world->pedestrianPool.find(state->playerObject);
+	if (player) {
+		camera.position = player->getPosition();
+		camera.rotation = player->getRotation();
+	}
+}
+
+void SoakRunner::recordPeaks()
+{
+	report.peakPedestrians = std::max(report.peakPedestrians, world->pedestrianPool.objects.size());
+	report.peakVehicles = std::max(report.peakVehicles, world->vehiclePool.objects.size());
+	report.peakInstances = std::max(report.peakInstances, world->instancePool.objects.size());
+	report.peakPickups = std::max(report.peakPickups, world->pickupPool.objects.size());
+	report.peakProjectiles = std::max(report.peakProjectiles, world->projectilePool.objects.size());
+	report.peakParticles = std::max(report.peakParticles, world->particles.getParticleCount());
+	report.peakObjects = std::max(report.peakObjects, world->allObjects.size());
+}
+
+void SoakRunner::printReport(std::ostream& out) const
+{
+	out << std::fixed << std::setprecision(2);
+	out << "ticks: " << report.ticks << "\n";
+	out << "simulated seconds: " << report.simulatedSeconds << "\n";
+	out << "wall seconds: " << report.wallSeconds << "\n";
+	out << "ticks per second: "
+		<< (report.wallSeconds > 0.0 ? report.ticks / report.wallSeconds : 0.0) << "\n";
+
+	out << "peak objects: " << report.peakObjects << "\n";
+	out << "peak pedestrians: " << report.peakPedestrians << "\n";
+	out << "peak vehicles: " << report.peakVehicles << "\n";
+	out << "peak instances: " << report.peakInstances << "\n";
+	out << "peak pickups: " << report.peakPickups << "\n";
+	out << "peak projectiles: " << report.peakProjectiles << "\n";
+	out << "peak particles: " << report.peakParticles << "\n";
+
+	out << "resident KB at start: " << report.startResidentKB << "\n";
+	out << "resident KB at end: " << report.endResidentKB << "\n";
+	out << "peak resident KB: " << report.peakResidentKB << "\n";
+
+	for (auto& s : report.subsystems) {
+		double perTick = report.ticks ? s.seconds * 1e6 / report.ticks : 0.0;
+		out << "time " << s.name << ": " << s.seconds << " s ("
+			<< perTick << " us/tick)\n";
+	}
+	out.flush();
+}
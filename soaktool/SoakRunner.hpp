@@ -0,0 +1,124 @@
+#pragma once
+#ifndef _SOAKTOOL_SOAKRUNNER_HPP_
+#define _SOAKTOOL_SOAKRUNNER_HPP_
+
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+#include <render/ViewCamera.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class GameData;
+class GameWorld;
+struct GameState;
+class ScriptMachine;
+
+struct SoakOptions
+{
+	std::string gamePath;
+	/// Save to load, or empty to start a new game
+	std::string saveFile;
+	std::string scriptFile = "main.scm";
+	/// Game hours to simulate; one game minute passes per simulated second
+	float hours = 1.f;
+	float timestep = 1.f / 30.f;
+	unsigned int workerThreads = 0;
+	uint64_t seed = 0;
+	bool hasSeed = false;
+};
+
+struct SoakReport
+{
+	uint64_t ticks = 0;
+	double simulatedSeconds = 0.0;
+	double wallSeconds = 0.0;
+
+	std::size_t peakPedestrians = 0;
+	std::size_t peakVehicles = 0;
+	std::size_t peakInstances = 0;
+	std::size_t peakPickups = 0;
+	std::size_t peakProjectiles = 0;
+	std::size_t peakParticles = 0;
+	std::size_t peakObjects = 0;
+
+	/// Resident set sizes in kilobytes, 0 where the platform can't tell
+	long startResidentKB = 0;
+	long endResidentKB = 0;
+	long peakResidentKB = 0;
+
+	struct Subsystem
+	{
+		const char* name;
+		double seconds;
+	};
+	std::vector<Subsystem> subsystems;
+};
+
+/**
+ * @brief Runs the game simulation with no window, audio or rendering.
+ *
+ * Steps the world at a fixed timestep as fast as it can and records
+ * throughput, object counts, memory use and time spent in each part of the
+ * tick. Used for long running leak and performance tests.
+ */
+class SoakRunner
+{
+public:
+	SoakRunner(const SoakOptions& options);
+	~SoakRunner();
+
+	/**
+	 * Loads game data and starts the game, either from the save or by
+	 * running the script from the start.
+	 * @return false if the game couldn't be started
+	 */
+	bool start();
+
+	/**
+	 * Simulates options.hours of game time.
+	 */
+	void run();
+
+	const SoakReport& getReport() const { return report; }
+
+	void printReport(std::ostream& out) const;
+
+	Logger& getLogger() { return log; }
+
+private:
+	enum Subsystem
+	{
+		Work,
+		Objects,
+		Physics,
+		Script,
+		Traffic,
+		SubsystemCount
+	};
+
+	SoakOptions options;
+	SoakReport report;
+
+	Logger log;
+	WorkContext work;
+	GameData* data;
+	GameState* state;
+	GameWorld* world;
+	ScriptMachine* script;
+	ViewCamera camera;
+
+	float clockAccumulator;
+	std::chrono::steady_clock::duration subsystemTime[SubsystemCount];
+
+	bool startScript();
+	void tick(float dt);
+	void updateCamera();
+	void recordPeaks();
+};
+
+#endif
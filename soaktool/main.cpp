@@ -0,0 +1,90 @@
+#include "SoakRunner.hpp"
+#include "GameConfig.hpp"
+
+#include <script/ScriptMachine.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+void printUsage()
+{
+	std::cout << "Usage: soaktool [options]\n"
+		"  --hours <n>     game hours to simulate (default 1)\n"
+		"  --load <save>   start from a save instead of a new game\n"
+		"  --script <scm>  script to run (default main.scm)\n"
+		"  --threads <n>   worker threads, 0 for one per core\n"
+		"  --seed <n>      seed for the world's random streams\n"
+		"  --data <path>   game data path (default from openrw.ini)\n"
+		"  --quiet         only print the report\n";
+}
+
+int main(int argc, char* argv[])
+{
+	SoakOptions options;
+	bool quiet = false;
+
+	for (int i = 1; i < argc; ++i) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp("--hours", argv[i]) == 0 && hasValue) {
+			options.hours = std::atof(argv[++i]);
+		}
+		else if (strcmp("--load", argv[i]) == 0 && hasValue) {
+			options.saveFile = argv[++i];
+		}
+		else if (strcmp("--script", argv[i]) == 0 && hasValue) {
+			options.scriptFile = argv[++i];
+		}
+		else if (strcmp("--threads", argv[i]) == 0 && hasValue) {
+			options.workerThreads = std::atoi(argv[++i]);
+		}
+		else if (strcmp("--seed", argv[i]) == 0 && hasValue) {
+			options.seed = std::strtoull(argv[++i], nullptr, 0);
+			options.hasSeed = true;
+		}
+		else if (strcmp("--data", argv[i]) == 0 && hasValue) {
+			options.gamePath = argv[++i];
+		}
+		else if (strcmp("--quiet", argv[i]) == 0) {
+			quiet = true;
+		}
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (options.gamePath.empty()) {
+		GameConfig config("openrw.ini");
+		if (! config.isValid()) {
+			std::cerr << "Invalid configuration file at: " << config.getConfigFile() << std::endl;
+			return 1;
+		}
+		options.gamePath = config.getGameDataPath();
+		if (options.workerThreads == 0) {
+			options.workerThreads = config.getWorkerThreads();
+		}
+	}
+
+	StdOutReciever logPrinter;
+	SoakRunner runner(options);
+	if (! quiet) {
+		runner.getLogger().addReciever(&logPrinter);
+	}
+
+	if (! runner.start()) {
+		return 1;
+	}
+
+	try {
+		runner.run();
+	}
+	catch (SCMException& ex) {
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	runner.printReport(std::cout);
+
+	return 0;
+}
@@ -4,6 +4,47 @@
 
 BOOST_AUTO_TEST_SUITE(GameDataTests)
 
+BOOST_AUTO_TEST_CASE(test_asset_names)
+{
+	BOOST_CHECK_EQUAL( internAssetName(""), 0 );
+
+	auto a = internAssetName("test_asset_a");
+	auto b = internAssetName("test_asset_b");
+	BOOST_CHECK_NE( a, 0 );
+	BOOST_CHECK_NE( a, b );
+	BOOST_CHECK_EQUAL( internAssetName(std::string("test_asset_") + "a"), a );
+	BOOST_CHECK_EQUAL( getAssetName(a), "test_asset_a" );
+	BOOST_CHECK_EQUAL( getAssetName(0), "" );
+
+	// Probing for a name doesn't intern it
+	BOOST_CHECK_EQUAL( findAssetName("test_asset_a"), a );
+	BOOST_CHECK_EQUAL( findAssetName(""), 0 );
+	BOOST_CHECK_EQUAL( findAssetName("test_asset_probe"), kUnknownAssetName );
+	BOOST_CHECK_EQUAL( findAssetName("test_asset_probe"), kUnknownAssetName );
+
+	BOOST_CHECK_NE( makeTextureID(a, b), makeTextureID(b, a) );
+	BOOST_CHECK_NE( makeTextureID(a, b), makeTextureID(a) );
+}
+
+BOOST_AUTO_TEST_CASE(test_find_assets)
+{
+	GameData gd(&Global::get().log, &Global::get().work, "");
+
+	auto texture = TextureData::create(1, {16, 16}, false);
+	auto name = internAssetName("test_texture");
+	gd.textures[makeTextureID(name)] = texture;
+
+	BOOST_CHECK_EQUAL( gd.findTexture(name), texture );
+	BOOST_CHECK_EQUAL( gd.findTexture("test_texture"), texture );
+	BOOST_CHECK( ! gd.findTexture("test_texture", "test_alpha") );
+	BOOST_CHECK( ! gd.findTexture("test_missing") );
+	// Failed lookups don't add entries
+	BOOST_CHECK_EQUAL( gd.textures.size(), 1 );
+
+	BOOST_CHECK( ! gd.findModel("test_model") );
+	BOOST_CHECK( gd.models.empty() );
+}
+
 #if RW_TEST_WITH_DATA
 BOOST_AUTO_TEST_CASE(test_object_data)
 {
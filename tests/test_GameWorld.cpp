@@ -16,6 +16,23 @@ BOOST_AUTO_TEST_CASE(test_gameobject_id)
 
 	BOOST_CHECK_NE( object1->getGameObjectID(), object2->getGameObjectID() );
 }
+
+BOOST_AUTO_TEST_CASE(test_transform_slots)
+{
+	GameWorld gw(&Global::get().log, &Global::get().work, Global::get().d);
+
+	auto object1 = gw.createInstance(1337, glm::vec3(100.f, 0.f, 0.f));
+	auto object2 = gw.createInstance(1337, glm::vec3(100.f, 0.f, 100.f));
+
+	BOOST_CHECK_EQUAL( gw.transforms.size(), 2 );
+
+	// Removing the first object moves the second into its slot
+	gw.destroyObject(object1);
+
+	BOOST_CHECK_EQUAL( gw.transforms.size(), 1 );
+	BOOST_CHECK_EQUAL( object2->getTransformSlot(), 0 );
+	BOOST_CHECK_EQUAL( object2->getLastPosition(), glm::vec3(100.f, 0.f, 100.f) );
+}
 #endif
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+#include <ai/AIGraph.hpp>
+#include <ai/AIGraphNode.hpp>
+
+#include <algorithm>
+
+BOOST_AUTO_TEST_SUITE(AIGraphTests)
+
+BOOST_AUTO_TEST_CASE(test_path_loading)
+{
+	AIGraph graph;
+
+	PathData first {
+		PathData::PATH_PED,
+		0, "",
+		{
+			{ PathNode::EXTERNAL, 1, { 0.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, 2, { 10.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::EXTERNAL, -1, { 20.f, 0.f, 0.f }, 1.f, 0, 0 },
+		}
+	};
+
+	// Starts where the first path ends, on the other side of a grid cell border
+	PathData second {
+		PathData::PATH_PED,
+		0, "",
+		{
+			{ PathNode::EXTERNAL, 1, { -0.5f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::EXTERNAL, -1, { -0.5f, 10.f, 0.f }, 1.f, 0, 0 },
+		}
+	};
+
+	graph.createPathNodes(glm::vec3(), glm::quat(), first);
+	graph.createPathNodes(glm::vec3(), glm::quat(), second);
+
+	// The overlapping external nodes are merged
+	BOOST_REQUIRE_EQUAL( graph.nodes.size(), 4 );
+	BOOST_CHECK_EQUAL( graph.externalNodes.size(), 3 );
+
+	BOOST_CHECK_EQUAL( graph.nodes[0].connectionCount, 2 );
+	BOOST_CHECK_EQUAL( graph.nodes[1].connectionCount, 2 );
+	BOOST_CHECK_EQUAL( graph.nodes[2].connectionCount, 1 );
+	BOOST_CHECK_EQUAL( graph.nodes[3].connectionCount, 1 );
+
+	std::vector<AIGraph::NodeIndex> connected;
+	graph.forEachConnection(0, [&](AIGraph::NodeIndex n) { connected.push_back(n); });
+	std::sort(connected.begin(), connected.end());
+	BOOST_REQUIRE_EQUAL( connected.size(), 2 );
+	BOOST_CHECK_EQUAL( connected[0], 1 );
+	BOOST_CHECK_EQUAL( connected[1], 3 );
+	BOOST_CHECK_EQUAL( graph.getConnection(0, 2), AIGraph::NoNode );
+}
+
+BOOST_AUTO_TEST_CASE(test_spatial_queries)
+{
+	AIGraph graph;
+
+	BOOST_CHECK_EQUAL( graph.findNearestNode(glm::vec3()), AIGraph::NoNode );
+
+	PathData peds {
+		PathData::PATH_PED,
+		0, "",
+		{
+			{ PathNode::INTERNAL, -1, { 0.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, -1, { 250.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, -1, { 1500.f, 1500.f, 0.f }, 1.f, 0, 0 },
+		}
+	};
+	PathData cars {
+		PathData::PATH_CAR,
+		0, "",
+		{
+			{ PathNode::INTERNAL, -1, { 240.f, 0.f, 0.f }, 1.f, 0, 0 },
+		}
+	};
+	graph.createPathNodes(glm::vec3(), glm::quat(), peds);
+	graph.createPathNodes(glm::vec3(), glm::quat(), cars);
+
+	BOOST_CHECK_EQUAL( graph.findNearestNode(glm::vec3(200.f, 0.f, 0.f)), 3 );
+	BOOST_CHECK_EQUAL( graph.findNearestNode(glm::vec3(200.f, 0.f, 0.f), AIGraphNode::Pedestrian), 1 );
+	BOOST_CHECK_EQUAL( graph.findNearestNode(glm::vec3(1000.f, 1000.f, 0.f)), 2 );
+	// Positions outside of the grid still find their closest node
+	BOOST_CHECK_EQUAL( graph.findNearestNode(glm::vec3(-9000.f, 0.f, 0.f)), 0 );
+
+	std::vector<AIGraph::NodeIndex> found;
+	graph.gatherNodesNear(glm::vec3(245.f, 0.f, 0.f), 10.f, found);
+	BOOST_CHECK_EQUAL( found.size(), 2 );
+
+	found.clear();
+	graph.gatherNodesInBox(glm::vec3(-10.f, -10.f, -10.f), glm::vec3(245.f, 10.f, 10.f), found);
+	std::sort(found.begin(), found.end());
+	BOOST_REQUIRE_EQUAL( found.size(), 2 );
+	BOOST_CHECK_EQUAL( found[0], 0 );
+	BOOST_CHECK_EQUAL( found[1], 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,293 @@
+#include <boost/test/unit_test.hpp>
+#include "test_globals.hpp"
+#include <ai/DefaultAIController.hpp>
+#include <ai/RoutePlanner.hpp>
+#include <ai/TrafficDirector.hpp>
+#include <objects/CharacterObject.hpp>
+#include <render/ViewCamera.hpp>
+#include <job/WorkContext.hpp>
+#include <LinearMath/btAlignedAllocator.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+
+/*
+ * These tests replace the global allocation functions, so they are built
+ * into run_allocation_tests rather than run_tests.
+ */
+
+namespace
+{
+/// Allocations made on this thread while an AllocationCounter is alive
+thread_local std::size_t* allocationCount = nullptr;
+
+void* countedAllocate(std::size_t size)
+{
+	if (allocationCount) {
+		(*allocationCount)++;
+	}
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+/**
+ * Counts the heap allocations made by the current thread during its lifetime
+ */
+class AllocationCounter
+{
+	std::size_t count;
+	std::size_t* previous;
+public:
+	AllocationCounter()
+		: count(0)
+		, previous(allocationCount)
+	{
+		allocationCount = &count;
+	}
+
+	~AllocationCounter()
+	{
+		allocationCount = previous;
+	}
+
+	std::size_t getCount() const { return count; }
+};
+
+/// Bullet allocates through its own hooks rather than operator new
+struct CountBulletAllocations
+{
+	CountBulletAllocations()
+	{
+		btAlignedAllocSetCustom(countedAllocate, std::free);
+	}
+} countBulletAllocations;
+
+/// Long enough for every pedestrian to walk several legs of the ring
+const int kWarmupTicks = 60 * 60;
+const int kMeasuredTicks = 60 * 60;
+
+/**
+ * Adds a loop of external pedestrian path nodes around the origin
+ */
+void createPathRing(GameWorld& world, int nodeCount, float radius)
+{
+	PathData ring { PathData::PATH_PED, 0, "", { } };
+	for (int i = 0; i < nodeCount; ++i) {
+		float a = i * glm::two_pi<float>() / nodeCount;
+		ring.nodes.push_back({ PathNode::EXTERNAL, (i + 1) % nodeCount,
+							   { std::cos(a) * radius, std::sin(a) * radius, 0.f }, 1.f, 0, 0 });
+	}
+	world.aigraph.createPathNodes(glm::vec3(), glm::quat(), ring);
+}
+
+/**
+ * Plans every route around the ring up front, so wandering is answered from
+ * the route cache
+ */
+void planRingRoutes(GameWorld& world, int nodeCount)
+{
+	for (int a = 0; a < nodeCount; ++a) {
+		for (int b = 0; b < nodeCount; ++b) {
+			if (a == b) {
+				continue;
+			}
+			auto request = world.routePlanner->requestRoute(a, b, AIGraphNode::Pedestrian);
+			auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+			while (! request->isReady() && std::chrono::steady_clock::now() < timeout) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			BOOST_REQUIRE( request->isReady() );
+		}
+	}
+}
+
+/**
+ * One tick of the world as RWGame runs it, with traffic cleaned up and
+ * spawned around camera
+ */
+void tickTraffic(GameWorld& world, const ViewCamera& camera)
+{
+	const float dt = 1.f / 60.f;
+	world.clearTickData();
+	world.tickObjects(dt);
+	world.destroyQueuedObjects();
+	world.dynamicsWorld->stepSimulation(dt, 2, dt);
+	world.cleanupTraffic(camera);
+	world.createTraffic(camera);
+}
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* p = countedAllocate(size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	if (void* p = countedAllocate(size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+BOOST_AUTO_TEST_SUITE(AllocationTests)
+
+BOOST_AUTO_TEST_CASE(test_allocation_counter)
+{
+	AllocationCounter counter;
+	std::unique_ptr<int> single(new int(1));
+	std::unique_ptr<int[]> array(new int[4]);
+	std::unique_ptr<int> nothrow(new (std::nothrow) int(2));
+	BOOST_CHECK_EQUAL( counter.getCount(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE(test_traffic_steady_state_allocations)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameState state;
+	GameWorld world(&log, &work, &data);
+	world.state = &state;
+
+	const int nodeCount = 8;
+	createPathRing(world, nodeCount, 15.f);
+	planRingRoutes(world, nodeCount);
+
+	// Characters without models can't be spawned as traffic, so the world is
+	// populated by hand and the traffic limit set to what's there
+	const int pedCount = nodeCount * 2;
+	std::vector<CharacterObject*> peds;
+	for (int i = 0; i < pedCount; ++i) {
+		auto position = world.aigraph.nodes[i % nodeCount].position;
+		auto ped = new CharacterObject(&world, position, glm::quat(), nullptr, nullptr);
+		new DefaultAIController(ped);
+		ped->setLifetime(GameObject::TrafficLifetime);
+		ped->controller->setGoal(CharacterController::TrafficWander);
+		world.pedestrianPool.insert(ped);
+		world.pedestrianHash.insert(ped, position);
+		world.allObjects.push_back(ped);
+		peds.push_back(ped);
+	}
+	world.trafficDirector->setPopulationLimits(pedCount, 0);
+
+	// Far from the focus, so they are all moved kinematically
+	ViewCamera camera;
+	camera.frustum.update(camera.frustum.projection() * camera.getView());
+	world.setSimulationFocus(glm::vec3(10000.f, 0.f, 0.f));
+
+	for (int i = 0; i < kWarmupTicks; ++i) {
+		tickTraffic(world, camera);
+	}
+
+	std::size_t allocations;
+	{
+		AllocationCounter counter;
+		for (int i = 0; i < kMeasuredTicks; ++i) {
+			tickTraffic(world, camera);
+		}
+		allocations = counter.getCount();
+	}
+	BOOST_CHECK_EQUAL( allocations, 0 );
+	BOOST_CHECK_EQUAL( world.pedestrianPool.objects.size(), pedCount );
+	for (auto ped : peds) {
+		BOOST_CHECK_EQUAL( ped->getSimulationTier(), SimulationKinematic );
+	}
+
+	for (auto ped : peds) {
+		world.destroyObject(ped);
+	}
+}
+
+#if RW_TEST_WITH_DATA
+BOOST_AUTO_TEST_CASE(test_traffic_steady_state_allocations_with_data)
+{
+	auto& global = Global::get();
+
+	// A world of its own, so the paths don't end up in the shared one
+	GameState state;
+	GameWorld world(&global.log, &global.work, global.d);
+	world.state = &state;
+	// There is no ground to walk on
+	world.dynamicsWorld->setGravity(btVector3(0.f, 0.f, 0.f));
+
+	// Far enough apart that a pedestrian on one node doesn't block the next
+	const int nodeCount = 12;
+	createPathRing(world, nodeCount, 30.f);
+	planRingRoutes(world, nodeCount);
+
+	// The camera looks along the ring's x axis, leaving the nodes behind it
+	// free to spawn on, and the traffic is fully simulated around it
+	const int pedCount = 4;
+	world.trafficDirector->setPopulationLimits(pedCount, 0);
+	ViewCamera camera;
+	camera.frustum.update(camera.frustum.projection() * camera.getView());
+	world.setSimulationFocus(camera.position);
+
+	for (int i = 0; i < kWarmupTicks; ++i) {
+		tickTraffic(world, camera);
+	}
+	BOOST_REQUIRE_EQUAL( world.pedestrianPool.objects.size(), pedCount );
+
+	std::size_t allocations;
+	{
+		AllocationCounter counter;
+		for (int i = 0; i < kMeasuredTicks; ++i) {
+			tickTraffic(world, camera);
+		}
+		allocations = counter.getCount();
+	}
+	BOOST_CHECK_EQUAL( allocations, 0 );
+	BOOST_CHECK_EQUAL( world.pedestrianPool.objects.size(), pedCount );
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,7 +16,7 @@ BOOST_AUTO_TEST_CASE(test_matrix)
 		
 		/** Models are currently needed to relate animation bones <=> model frame #s. */
 		Global::get().e->data->loadDFF("player.dff");
-		ModelRef& test_model = Global::get().e->data->models["player"];
+		ModelRef test_model = Global::get().e->data->findModel("player");
 		
 		Animator animator(test_model->resource, &skeleton);
 
@@ -1,10 +1,379 @@
 #include <boost/test/unit_test.hpp>
 #include "test_globals.hpp"
+#include <objects/InstanceObject.hpp>
 #include <objects/VehicleObject.hpp>
+#include <dynamics/BuoyancySystem.hpp>
+#include <dynamics/CollisionInstance.hpp>
+#include <data/CollisionModel.hpp>
+#include <data/Model.hpp>
+#include <data/ObjectData.hpp>
+#include <engine/GameData.hpp>
+#include <job/WorkContext.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(BuoyancyTests)
 
+BOOST_AUTO_TEST_CASE(test_wave_heights_batch)
+{
+	std::vector<glm::vec3> points;
+	for (int i = 0; i < 1000; ++i) {
+		points.emplace_back(i * 3.7f - 1800.f, i * -2.1f + 900.f, 0.f);
+	}
+	std::vector<float> heights(points.size());
+
+	const float time = 123.4f;
+	BuoyancySystem::getWaveHeights(time, points.data(), heights.data(), points.size());
+
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		// The formula previously used by GameData::getWaveHeightAt
+		float expected = (1 + std::sin(time + (points[i].x + points[i].y) * WATER_SCALE)) * WATER_HEIGHT;
+		BOOST_CHECK_SMALL(heights[i] - expected, 1e-5f);
+		BOOST_CHECK_EQUAL(heights[i], BuoyancySystem::getWaveHeight(time, points[i]));
+	}
+}
+
+namespace
+{
+/**
+ * The wave formula previously used by GameData::getWaveHeightAt
+ */
+float legacyWaveHeight(GameWorld* world, const glm::vec3& ws)
+{
+	return (1 + std::sin(world->getGameTime() + (ws.x + ws.y) * WATER_SCALE)) * WATER_HEIGHT;
+}
+
+/**
+ * The per-vehicle water code BuoyancySystem replaced, to check the batched
+ * version against.
+ */
+void legacyVehicleBuoyancy(VehicleObject* vehicle)
+{
+	auto data = vehicle->engine->data;
+	auto physBody = vehicle->physBody;
+	auto ws = vehicle->getPosition();
+	auto wX = (int) ((ws.x + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
+	auto wY = (int) ((ws.y + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
+	btVector3 bbmin, bbmax;
+	physBody->getAabb(bbmin, bbmax);
+	float vH = bbmin.z();
+
+	if( wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 && wY < WATER_HQ_DATA_SIZE ) {
+		int i = (wX*WATER_HQ_DATA_SIZE) + wY;
+		int hI = data->realWater[i];
+		if( hI < NO_WATER_INDEX ) {
+			float wH = data->waterHeights[hI] + legacyWaveHeight(vehicle->engine, ws);
+			if( vH <= wH ) {
+				if( vehicle->_lastHeight >= wH ) {
+					vehicle->inWater = true;
+				}
+			}
+			else {
+				vehicle->inWater = false;
+			}
+		}
+		else {
+			vehicle->inWater = false;
+		}
+	}
+
+	if( vehicle->inWater ) {
+		auto& handling = vehicle->info->handling;
+		float bbZ = handling.dimensions.z/2.f;
+		float oZ = -bbZ/2.f + (bbZ * (handling.percentSubmerged/120.f));
+		if( vehicle->vehicle->type == VehicleData::BOAT ) {
+			oZ = 0.f;
+		}
+
+		glm::vec3 floats[] = {
+			glm::vec3(0.f, handling.dimensions.y/2.f, oZ),
+			glm::vec3(0.f, -handling.dimensions.y/2.f, oZ),
+			glm::vec3( handling.dimensions.x/2.f, 0.f, oZ),
+			glm::vec3(-handling.dimensions.x/2.f, 0.f, oZ),
+		};
+		for( auto& f : floats ) {
+			auto relPt = vehicle->getRotation() * f;
+			auto fws = vehicle->getPosition() + relPt;
+			auto wi = data->getWaterIndexAt(fws);
+			if( wi != NO_WATER_INDEX ) {
+				float h = data->waterHeights[wi] + legacyWaveHeight(vehicle->engine, fws);
+				if ( fws.z <= h ) {
+					float x = (h - fws.z);
+					float F = WATER_BUOYANCY_K * x + -WATER_BUOYANCY_C * physBody->getLinearVelocity().z();
+					physBody->applyImpulse(btVector3(0.f, 0.f, F),
+										 btVector3(relPt.x, relPt.y, relPt.z));
+				}
+			}
+		}
+	}
+
+	vehicle->_lastHeight = vH;
+}
+}
+
+/**
+ * The water code InstanceObject::tick ran before BuoyancySystem replaced it
+ */
+void legacyInstanceBuoyancy(InstanceObject* instance)
+{
+	auto data = instance->engine->data;
+	auto body = instance->body;
+	auto _bws = body->body->getWorldTransform().getOrigin();
+	glm::vec3 ws(_bws.x(), _bws.y(), _bws.z());
+	auto wX = (int) ((ws.x + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
+	auto wY = (int) ((ws.y + WATER_WORLD_SIZE/2.f) / (WATER_WORLD_SIZE/WATER_HQ_DATA_SIZE));
+	float vH = ws.z;
+	float wH = 0.f;
+
+	if( wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 && wY < WATER_HQ_DATA_SIZE ) {
+		int i = (wX*WATER_HQ_DATA_SIZE) + wY;
+		int hI = data->realWater[i];
+		if( hI < NO_WATER_INDEX ) {
+			wH = data->waterHeights[hI];
+			wH += legacyWaveHeight(instance->engine, ws);
+			if( vH <= wH ) {
+				instance->inWater = true;
+			}
+			else {
+				instance->inWater = false;
+			}
+		}
+		else {
+			instance->inWater = false;
+		}
+	}
+	instance->_lastHeight = ws.z;
+
+	if( instance->inWater ) {
+		float oZ = -(body->collisionHeight * (instance->dynamics->bouancy/100.f));
+		body->body->activate(true);
+		body->body->setDamping(0.95f, 0.9f);
+
+		auto wi = data->getWaterIndexAt(ws);
+		if(wi != NO_WATER_INDEX) {
+			float h = data->waterHeights[wi] + oZ;
+			h += legacyWaveHeight(instance->engine, ws);
+
+			if ( ws.z <= h ) {
+				float x = (h - ws.z);
+				float F = WATER_BUOYANCY_K * x + -WATER_BUOYANCY_C * body->body->getLinearVelocity().z();
+				btVector3 forcePos = btVector3(0.f, 0.f, 2.f).rotate(
+							body->body->getOrientation().getAxis(), body->body->getOrientation().getAngle());
+				body->body->applyForce(btVector3(0.f, 0.f, F),
+									 forcePos);
+			}
+		}
+	}
+}
+
+/**
+ * Moves vehicle through the water at tpos, checking that BuoyancySystem
+ * leaves it in the same state as the legacy code each time
+ */
+void checkVehicleMatchesLegacy(GameWorld* world, VehicleObject* vehicle, const glm::vec2& tpos)
+{
+	auto body = vehicle->physBody;
+	body->setLinearVelocity(btVector3(1.f, 0.f, -2.f));
+	body->setAngularVelocity(btVector3(0.1f, 0.2f, 0.f));
+
+	// Above the water, falling in, bobbing and sinking again
+	const float heights[] = { 5.f, -0.5f, -1.f, -0.2f, 0.3f, -2.f };
+	for (float z : heights) {
+		vehicle->setPosition(glm::vec3(tpos, z));
+		vehicle->setRotation(glm::angleAxis(0.3f, glm::normalize(glm::vec3(0.2f, 1.f, 0.1f))));
+
+		auto linear = body->getLinearVelocity();
+		auto angular = body->getAngularVelocity();
+		bool wasInWater = vehicle->inWater;
+		float lastHeight = vehicle->_lastHeight;
+
+		legacyVehicleBuoyancy(vehicle);
+		auto expectedLinear = body->getLinearVelocity();
+		auto expectedAngular = body->getAngularVelocity();
+		bool expectedInWater = vehicle->inWater;
+		float expectedLastHeight = vehicle->_lastHeight;
+
+		body->setLinearVelocity(linear);
+		body->setAngularVelocity(angular);
+		vehicle->inWater = wasInWater;
+		vehicle->_lastHeight = lastHeight;
+
+		world->buoyancy->tickVehicles(&vehicle, 1);
+
+		BOOST_CHECK_EQUAL(vehicle->inWater, expectedInWater);
+		BOOST_CHECK_EQUAL(vehicle->_lastHeight, expectedLastHeight);
+		BOOST_CHECK_SMALL((body->getLinearVelocity() - expectedLinear).length(), 1e-3f);
+		BOOST_CHECK_SMALL((body->getAngularVelocity() - expectedAngular).length(), 1e-3f);
+	}
+}
+
+/**
+ * A world without game data whose only water is the realWater cell at the
+ * corner of the map, and a box collision model to float in it
+ */
+struct WaterWorld
+{
+	Logger log;
+	WorkContext work;
+	GameData data;
+	GameState state;
+	GameWorld world;
+	/// Centre of the watered cell
+	glm::vec2 tpos;
+
+	WaterWorld()
+		: data(&log, &work, "")
+		, world(&log, &work, &data)
+		, tpos(-WATER_WORLD_SIZE/2.f + 10.f)
+	{
+		world.state = &state;
+		state.gameTime = 12.3f;
+
+		std::fill(std::begin(data.realWater), std::end(data.realWater), NO_WATER_INDEX);
+		data.realWater[0] = 0;
+		data.waterHeights[0] = 0.f;
+
+		std::unique_ptr<CollisionModel> box(new CollisionModel);
+		box->boxes.push_back({ glm::vec3(-1.f, -2.f, -0.75f), glm::vec3(1.f, 2.f, 0.75f) });
+		data.collisions["buoyancy_box"] = std::move(box);
+	}
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_instance_buoyancy_matches_legacy)
+{
+	WaterWorld water;
+
+	auto object = std::make_shared<ObjectData>();
+	object->modelName = "buoyancy_box";
+	auto dynamics = std::make_shared<DynamicObjectData>();
+	dynamics->mass = 50.f;
+	dynamics->bouancy = 80.f;
+
+	std::unique_ptr<InstanceObject> instance(new InstanceObject(
+			&water.world, glm::vec3(water.tpos, 5.f), glm::quat(), nullptr,
+			glm::vec3(1.f), object, nullptr, dynamics));
+	BOOST_REQUIRE(instance->body != nullptr);
+	auto body = instance->body->body;
+	BOOST_REQUIRE(! body->isStaticObject());
+	body->setLinearVelocity(btVector3(0.f, 0.f, -2.f));
+
+	auto rotation = btQuaternion(btVector3(0.2f, 1.f, 0.1f).normalized(), 0.3f);
+	auto instancePtr = instance.get();
+	const float heights[] = { 5.f, -0.5f, -1.f, -3.f, 0.2f, -2.f };
+	for (float z : heights) {
+		body->setWorldTransform(btTransform(rotation, btVector3(water.tpos.x, water.tpos.y, z)));
+		body->setDamping(0.f, 0.f);
+		body->clearForces();
+		bool wasInWater = instance->inWater;
+
+		legacyInstanceBuoyancy(instancePtr);
+		auto expectedForce = body->getTotalForce();
+		auto expectedTorque = body->getTotalTorque();
+		auto expectedLinearDamping = body->getLinearDamping();
+		auto expectedAngularDamping = body->getAngularDamping();
+		bool expectedInWater = instance->inWater;
+		float expectedLastHeight = instance->_lastHeight;
+
+		body->setDamping(0.f, 0.f);
+		body->clearForces();
+		instance->inWater = wasInWater;
+
+		water.world.buoyancy->tickInstances(&instancePtr, 1);
+
+		BOOST_CHECK_EQUAL(instance->inWater, expectedInWater);
+		BOOST_CHECK_EQUAL(instance->_lastHeight, expectedLastHeight);
+		BOOST_CHECK_SMALL((body->getTotalForce() - expectedForce).length(), 1e-3f);
+		BOOST_CHECK_SMALL((body->getTotalTorque() - expectedTorque).length(), 1e-3f);
+		BOOST_CHECK_EQUAL(body->getLinearDamping(), expectedLinearDamping);
+		BOOST_CHECK_EQUAL(body->getAngularDamping(), expectedAngularDamping);
+	}
+
+	// The sequence must have pushed on it at least once
+	BOOST_CHECK(instance->inWater);
+}
+
+BOOST_AUTO_TEST_CASE(test_vehicle_buoyancy_matches_legacy)
+{
+	WaterWorld water;
+
+	auto vehicleData = std::make_shared<VehicleData>();
+	vehicleData->modelName = "buoyancy_box";
+	vehicleData->type = VehicleData::CAR;
+	auto info = std::make_shared<VehicleInfo>();
+	info->handling.mass = 1000.f;
+	info->handling.dimensions = glm::vec3(2.f, 4.f, 1.5f);
+	info->handling.percentSubmerged = 75.f;
+
+	// The vehicle only needs a model to look for frames in
+	Model model;
+	auto modelRef = std::make_shared<ResourceHandle<Model>>("buoyancy_box");
+	modelRef->resource = &model;
+
+	std::unique_ptr<VehicleObject> vehicle(new VehicleObject(
+			&water.world, glm::vec3(water.tpos, 100.f), glm::quat(), modelRef,
+			vehicleData, info, glm::u8vec3(255), glm::u8vec3(128)));
+	BOOST_REQUIRE(vehicle->physBody != nullptr);
+
+	checkVehicleMatchesLegacy(&water.world, vehicle.get(), water.tpos);
+	BOOST_CHECK(vehicle->inWater);
+}
+
 #if RW_TEST_WITH_DATA
+namespace
+{
+/**
+ * Updates the vehicle the way a physics step would
+ */
+void tickVehicleInWater(VehicleObject* vehicle)
+{
+	Global::get().e->buoyancy->tickVehicles(&vehicle, 1);
+	vehicle->tickPhysics(0.0016f);
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_vehicle_buoyancy_matches_legacy_with_data)
+{
+	glm::vec2 tpos(-WATER_WORLD_SIZE/2.f + 10.f);
+	auto world = Global::get().e;
+	VehicleObject* vehicle = world->createVehicle(90u, glm::vec3(tpos, 100.f), glm::quat());
+	BOOST_REQUIRE(vehicle != nullptr);
+	BOOST_REQUIRE(vehicle->physBody != nullptr);
+
+	checkVehicleMatchesLegacy(world, vehicle, tpos);
+
+	world->destroyObject(vehicle);
+}
+
+BOOST_AUTO_TEST_CASE(test_sleeping_vehicle_skipped)
+{
+	glm::vec2 tpos(-WATER_WORLD_SIZE/2.f + 10.f);
+	auto world = Global::get().e;
+	VehicleObject* vehicle = world->createVehicle(90u, glm::vec3(tpos, 100.f), glm::quat());
+	BOOST_REQUIRE(vehicle != nullptr);
+
+	auto isCandidate = [&]() {
+		auto& candidates = world->buoyancy->getVehicleCandidates();
+		return std::find(candidates.begin(), candidates.end(), vehicle) != candidates.end();
+	};
+
+	vehicle->physBody->activate(true);
+	world->buoyancy->updateCandidates();
+	BOOST_CHECK(isCandidate());
+
+	vehicle->physBody->setActivationState(ISLAND_SLEEPING);
+	world->buoyancy->updateCandidates();
+	BOOST_CHECK(! isCandidate());
+
+	world->destroyObject(vehicle);
+	BOOST_CHECK(! isCandidate());
+}
+
 BOOST_AUTO_TEST_CASE(test_vehicle_buoyancy)
 {
 	glm::vec2 tpos(-WATER_WORLD_SIZE/2.f + 10.f);
@@ -24,34 +393,34 @@ BOOST_AUTO_TEST_CASE(test_vehicle_buoyancy)
 		vehicle->setPosition(glm::vec3(tpos, -5.f));
 
 		// Allow the object to update
-		vehicle->tickPhysics(0.0016f);
+		tickVehicleInWater(vehicle);
 
 		BOOST_CHECK( vehicle->isInWater() );
 
 		// Ensure that the in water state sticks
-		vehicle->tickPhysics(0.0016f);
+		tickVehicleInWater(vehicle);
 
 		BOOST_CHECK( vehicle->isInWater() );
 
 		vehicle->setPosition(glm::vec3(tpos, 5.f));
-		vehicle->tickPhysics(0.0016f);
+		tickVehicleInWater(vehicle);
 		BOOST_CHECK( ! vehicle->isInWater() );
 
 		// TODO: fix magic numbers
 		auto orgval	= Global::get().e->data->realWater[0];
 		Global::get().e->data->realWater[0] = NO_WATER_INDEX;
 
-		vehicle->tickPhysics(0.0016f);
+		tickVehicleInWater(vehicle);
 		BOOST_CHECK( ! vehicle->isInWater() );
 
 		vehicle->setPosition(glm::vec3(tpos, -5.f));
 
-		vehicle->tickPhysics(0.0016f);
+		tickVehicleInWater(vehicle);
 		BOOST_CHECK( ! vehicle->isInWater() );
 
 		Global::get().e->data->realWater[0] = orgval;
 
-		vehicle->tickPhysics(0.0016f);
+		tickVehicleInWater(vehicle);
 		BOOST_CHECK( ! vehicle->isInWater() );
 
 		Global::get().e->destroyObject(vehicle);
@@ -0,0 +1,26 @@
+#include <boost/test/unit_test.hpp>
+#include "test_globals.hpp"
+#include <ai/CharacterController.hpp>
+
+BOOST_AUTO_TEST_SUITE(ControllerTests)
+
+BOOST_AUTO_TEST_CASE(test_pooled_activities)
+{
+	auto& pool = PoolAllocator<Activities::GoTo, 64>::get();
+
+	auto first = new Activities::GoTo(glm::vec3(1.f, 2.f, 3.f));
+	auto live = pool.getLiveCount();
+	auto capacity = pool.getCapacity();
+	delete first;
+	BOOST_CHECK_EQUAL( pool.getLiveCount(), live - 1 );
+
+	// The freed block is handed straight back out, without growing the pool
+	auto second = new Activities::GoTo(glm::vec3(4.f, 5.f, 6.f));
+	BOOST_CHECK_EQUAL( second, first );
+	BOOST_CHECK_EQUAL( pool.getLiveCount(), live );
+	BOOST_CHECK_EQUAL( pool.getCapacity(), capacity );
+	BOOST_CHECK_EQUAL( second->target, glm::vec3(4.f, 5.f, 6.f) );
+	delete second;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,61 @@
 
 BOOST_AUTO_TEST_SUITE(CutsceneTests)
 
+BOOST_AUTO_TEST_CASE(test_keyframe_track)
+{
+	KeyframeTrack<float> track;
+	// Out of order, with one key replaced
+	track.insert(2.f, 20.f);
+	track.insert(0.f, 0.f);
+	track.insert(1.f, 5.f);
+	track.insert(1.f, 10.f);
+
+	BOOST_REQUIRE_EQUAL(track.size(), 3);
+	BOOST_CHECK(track.hasKey(1.f));
+	BOOST_CHECK(! track.hasKey(1.5f));
+
+	BOOST_CHECK_EQUAL(track.sample(-1.f), 0.f);
+	BOOST_CHECK_CLOSE(track.sample(0.5f), 5.f, 1e-3f);
+	BOOST_CHECK_EQUAL(track.sample(1.f), 10.f);
+	BOOST_CHECK_CLOSE(track.sample(1.5f), 15.f, 1e-3f);
+	BOOST_CHECK_EQUAL(track.sample(3.f), 20.f);
+}
+
+BOOST_AUTO_TEST_CASE(test_keyframe_cursor)
+{
+	KeyframeTrack<float> track;
+	for (int k = 0; k <= 100; ++k) {
+		track.insert(float(k), float(k * 2));
+	}
+
+	// Playing forwards, jumping ahead and rewinding all agree with a search
+	KeyframeCursor cursor;
+	const float times[] = { 0.f, 0.25f, 0.5f, 3.5f, 50.25f, 50.5f, 10.75f, 99.5f, 150.f, -1.f };
+	for (float t : times) {
+		BOOST_CHECK_EQUAL(track.sample(t, &cursor), track.sample(t));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_cutscene_camera)
+{
+	CutsceneTracks tracks;
+	tracks.position.insert(0.f, glm::vec3(0.f));
+	tracks.position.insert(2.f, glm::vec3(10.f, 0.f, 0.f));
+	tracks.target.insert(0.f, glm::vec3(0.f, 1.f, 0.f));
+	tracks.zoom.insert(0.f, 60.f);
+	tracks.zoom.insert(2.f, 80.f);
+	tracks.rotation.insert(0.f, 5.f);
+
+	auto camera = tracks.getCameraAt(1.f);
+	BOOST_CHECK_CLOSE(camera.position.x, 5.f, 1e-3f);
+	BOOST_CHECK_CLOSE(camera.target.y, 1.f, 1e-3f);
+	BOOST_CHECK_CLOSE(camera.zoom, 70.f, 1e-3f);
+	BOOST_CHECK_CLOSE(camera.rotation, 5.f, 1e-3f);
+
+	BOOST_CHECK_CLOSE(tracks.getPositionAt(1.5f).x, 7.5f, 1e-3f);
+	BOOST_CHECK_CLOSE(tracks.getZoomAt(0.5f), 65.f, 1e-3f);
+}
+
 #if RW_TEST_WITH_DATA
 BOOST_AUTO_TEST_CASE(test_load)
 {
@@ -17,14 +72,14 @@ BOOST_AUTO_TEST_CASE(test_load)
 
 		loader.load( tracks, d );
 
-		BOOST_CHECK( tracks.position.find(0.f) != tracks.position.end() );
-		BOOST_CHECK( tracks.position.find(64.8f) != tracks.position.end() );
+		BOOST_CHECK( tracks.position.hasKey(0.f) );
+		BOOST_CHECK( tracks.position.hasKey(64.8f) );
 
-		BOOST_CHECK( tracks.zoom.find(64.8f) != tracks.zoom.end() );
+		BOOST_CHECK( tracks.zoom.hasKey(64.8f) );
 
-		BOOST_CHECK( tracks.zoom.find(64.8f) != tracks.zoom.end() );
+		BOOST_CHECK( tracks.zoom.hasKey(64.8f) );
 
-		BOOST_CHECK( tracks.target.find(64.8f) != tracks.target.end() );
+		BOOST_CHECK( tracks.target.hasKey(64.8f) );
 
 		BOOST_CHECK( tracks.duration == 64.8f );
 	}
@@ -0,0 +1,190 @@
+#include <boost/test/unit_test.hpp>
+#include <engine/InstanceIndex.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <objects/InstanceObject.hpp>
+#include <data/Model.hpp>
+#include <data/ObjectData.hpp>
+#include <data/CollisionModel.hpp>
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+namespace
+{
+InstanceObject* makeInstance(GameWorld* world, const glm::vec3& position, const std::string& model,
+							 std::shared_ptr<DynamicObjectData> dynamics = nullptr)
+{
+	return new InstanceObject(world, position, glm::quat(),
+							  std::make_shared<ResourceHandle<Model>>(model),
+							  glm::vec3(1.f), nullptr, nullptr, dynamics);
+}
+
+bool contains(const std::vector<InstanceObject*>& instances, InstanceObject* instance)
+{
+	return std::find(instances.begin(), instances.end(), instance) != instances.end();
+}
+}
+
+BOOST_AUTO_TEST_SUITE(InstanceIndexTests)
+
+BOOST_AUTO_TEST_CASE(test_instanceindex_matches_scan)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> coord(-500.f, 500.f);
+
+	// Enough instances that the tree is built and searched
+	InstanceIndex index;
+	std::vector<std::unique_ptr<InstanceObject>> instances;
+	for (int i = 0; i < 2000; ++i) {
+		instances.emplace_back(makeInstance(&world, glm::vec3(coord(rng), coord(rng), coord(rng) * 0.1f),
+											i % 3 ? "wall" : "lamppost"));
+		index.insert(instances.back().get());
+	}
+	BOOST_CHECK_EQUAL(index.size(), 2000);
+
+	for (int q = 0; q < 50; ++q) {
+		glm::vec3 a(coord(rng), coord(rng), -20.f), b(coord(rng), coord(rng), 20.f);
+		glm::vec3 min = glm::min(a, b), max = glm::max(a, b);
+
+		std::vector<InstanceObject*> found;
+		index.queryBox(min, max, found);
+
+		std::size_t expected = 0;
+		for (auto& instance : instances) {
+			auto p = instance->getPosition();
+			if (glm::all(glm::greaterThanEqual(p, min)) && glm::all(glm::lessThanEqual(p, max))) {
+				expected++;
+				BOOST_CHECK(contains(found, instance.get()));
+			}
+		}
+		BOOST_CHECK_EQUAL(found.size(), expected);
+		BOOST_CHECK_EQUAL(index.anyInBox(min, max), expected > 0);
+	}
+	BOOST_CHECK_EQUAL(index.getLooseCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_instanceindex_changes)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	InstanceIndex index;
+	std::vector<std::unique_ptr<InstanceObject>> instances;
+	for (int i = 0; i < 200; ++i) {
+		instances.emplace_back(makeInstance(&world, glm::vec3(i * 10.f, 0.f, 0.f), "wall"));
+		index.insert(instances.back().get());
+	}
+	auto moved = instances[5].get();
+	auto removed = instances[6].get();
+
+	std::vector<InstanceObject*> found;
+	index.queryBox(glm::vec3(45.f, -1.f, -1.f), glm::vec3(65.f, 1.f, 1.f), found);
+	BOOST_CHECK_EQUAL(found.size(), 2);
+
+	// Moved after the tree was built
+	moved->GameObject::setPosition(glm::vec3(5000.f, 0.f, 0.f));
+	index.update(moved);
+	index.remove(removed);
+
+	found.clear();
+	index.queryBox(glm::vec3(45.f, -1.f, -1.f), glm::vec3(65.f, 1.f, 1.f), found);
+	BOOST_CHECK(found.empty());
+	BOOST_CHECK(index.anyInBox(glm::vec3(4999.f, -1.f, -1.f), glm::vec3(5001.f, 1.f, 1.f)));
+
+	// Renamed models move between names
+	moved->model = std::make_shared<ResourceHandle<Model>>("door");
+	index.update(moved);
+	found.clear();
+	index.findByModel("door", found);
+	BOOST_CHECK_EQUAL(found.size(), 1);
+	found.clear();
+	index.findByModel("wall", found);
+	BOOST_CHECK_EQUAL(found.size(), 198);
+	found.clear();
+	index.findByModel("wall", glm::vec3(0.f), 25.f, found);
+	BOOST_CHECK_EQUAL(found.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_instanceindex_dynamic)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	auto dynamics = std::make_shared<DynamicObjectData>();
+	InstanceIndex index;
+	std::vector<std::unique_ptr<InstanceObject>> instances;
+	for (int i = 0; i < 200; ++i) {
+		instances.emplace_back(makeInstance(&world, glm::vec3(i * 10.f, 0.f, 0.f), "barrel", dynamics));
+		index.insert(instances.back().get());
+	}
+
+	// Dynamic instances never wait in the loose list
+	BOOST_CHECK_EQUAL(index.getLooseCount(), 0);
+
+	std::vector<InstanceObject*> found;
+	index.queryBox(glm::vec3(45.f, -1.f, -1.f), glm::vec3(65.f, 1.f, 1.f), found);
+	BOOST_CHECK_EQUAL(found.size(), 2);
+
+	auto moved = instances[5].get();
+	moved->GameObject::setPosition(glm::vec3(5000.f, 0.f, 0.f));
+	index.update(moved);
+	index.remove(instances[6].get());
+
+	found.clear();
+	index.queryBox(glm::vec3(45.f, -1.f, -1.f), glm::vec3(65.f, 1.f, 1.f), found);
+	BOOST_CHECK(found.empty());
+	BOOST_CHECK(index.anyInBox(glm::vec3(4999.f, -1.f, -1.f), glm::vec3(5001.f, 1.f, 1.f)));
+	BOOST_CHECK_EQUAL(index.size(), 199);
+	BOOST_CHECK_EQUAL(index.getLooseCount(), 0);
+
+	found.clear();
+	index.queryBounds(glm::vec3(4999.f, -1.f, -1.f), glm::vec3(5001.f, 1.f, 1.f), found);
+	BOOST_CHECK_EQUAL(found.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_instanceindex_collision_bounds)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	std::unique_ptr<CollisionModel> collision(new CollisionModel);
+	collision->center = glm::vec3(0.f, 0.f, 5.f);
+	collision->radius = 20.f;
+	collision->boxes.push_back({ glm::vec3(-10.f), glm::vec3(10.f) });
+	data.collisions["warehouse"] = std::move(collision);
+
+	// The model hasn't loaded, so only the collision model gives it an extent
+	auto object = std::make_shared<ObjectData>();
+	object->modelName = "warehouse";
+	std::unique_ptr<InstanceObject> instance(new InstanceObject(
+			&world, glm::vec3(0.f), glm::quat(),
+			std::make_shared<ResourceHandle<Model>>("warehouse"),
+			glm::vec3(1.f), object, nullptr, nullptr));
+	InstanceIndex index;
+	index.insert(instance.get());
+
+	std::vector<InstanceObject*> found;
+	index.queryBounds(glm::vec3(20.f, -1.f, -1.f), glm::vec3(30.f, 1.f, 1.f), found);
+	BOOST_CHECK_EQUAL(found.size(), 1);
+
+	found.clear();
+	index.queryBounds(glm::vec3(30.f, -1.f, -1.f), glm::vec3(40.f, 1.f, 1.f), found);
+	BOOST_CHECK(found.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
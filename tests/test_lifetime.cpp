@@ -11,23 +11,17 @@ BOOST_AUTO_TEST_CASE(test_cleanup)
 {
 	GameObject* f = Global::get().e->createInstance(1337, glm::vec3(0.f, 0.f, 1000.f));
 	auto id = f->getGameObjectID();
-	auto& objects = Global::get().e->instancePool.objects;
+	auto& pool = Global::get().e->instancePool;
 
 	f->setLifetime(GameObject::TrafficLifetime);
 	
-	{
-		auto search = objects.find(id);
-		BOOST_CHECK( search != objects.end() );
-	}
+	BOOST_CHECK( pool.find(id) == f );
 	
 	ViewCamera testCamera;
 	testCamera.position = glm::vec3(0.f, 0.f, 0.f);
 	Global::get().e->cleanupTraffic(testCamera);
 	
-	{
-		auto search = objects.find(id);
-		BOOST_CHECK( search != objects.end() );
-	}
+	BOOST_CHECK( pool.find(id) == f );
 }
 #endif
 
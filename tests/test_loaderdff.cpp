@@ -3,6 +3,7 @@
 #include <data/Model.hpp>
 #include <job/WorkContext.hpp>
 #include <loaders/BackgroundLoader.hpp>
+#include <cmath>
 
 BOOST_AUTO_TEST_SUITE(LoaderDFFTests)
 
@@ -67,4 +68,25 @@ BOOST_AUTO_TEST_CASE(test_loader_job)
 }
 #endif
 
+BOOST_AUTO_TEST_CASE(test_compact_vertex)
+{
+	BOOST_CHECK_EQUAL( sizeof(Model::CompactGeometryVertex), 24 );
+
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(0.f), 0x0000 );
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(1.f), 0x3C00 );
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(0.5f), 0x3800 );
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(-2.f), 0xC000 );
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(65504.f), 0x7BFF );
+	// Out of range values clamp instead of becoming infinite
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(1e6f), 0x7BFF );
+	// Smallest denormal
+	BOOST_CHECK_EQUAL( Model::CompactGeometryVertex::packHalf(std::ldexp(1.f, -24)), 0x0001 );
+
+	// x = 1, y = -1, z = 0
+	auto n = Model::CompactGeometryVertex::packNormal(glm::vec3(1.f, -1.f, 0.f));
+	BOOST_CHECK_EQUAL( n & 0x3FF, 511 );
+	BOOST_CHECK_EQUAL( (n >> 10) & 0x3FF, 0x3FF - 510 );
+	BOOST_CHECK_EQUAL( (n >> 20) & 0x3FF, 0 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,157 @@
+#include <boost/test/unit_test.hpp>
+#include <render/ParticleSystem.hpp>
+#include <engine/RandomService.hpp>
+
+BOOST_AUTO_TEST_SUITE(ParticleSystemTests)
+
+BOOST_AUTO_TEST_CASE(test_particle_expiry)
+{
+	ParticleSystem particles;
+	RandomStream random;
+
+	ParticleInfo info;
+	info.lifetime = 1.f;
+	auto a = particles.spawn(info, 0.f);
+	info.lifetime = 2.f;
+	auto b = particles.spawn(info, 0.f);
+	info.lifetime = -1.f;
+	auto c = particles.spawn(info, 0.f);
+
+	BOOST_CHECK_EQUAL(particles.getParticleCount(), 3);
+
+	particles.update(1.5f, 1.5f, random);
+	BOOST_CHECK_EQUAL(particles.getParticleCount(), 2);
+	BOOST_CHECK(! particles.isAlive(a));
+	BOOST_CHECK(particles.isAlive(b));
+	BOOST_CHECK(particles.isAlive(c));
+
+	particles.update(100.f, 98.5f, random);
+	BOOST_CHECK_EQUAL(particles.getParticleCount(), 1);
+	BOOST_CHECK(particles.isAlive(c));
+
+	particles.destroy(c);
+	BOOST_CHECK_EQUAL(particles.getParticleCount(), 0);
+	BOOST_CHECK(! particles.isAlive(c));
+}
+
+BOOST_AUTO_TEST_CASE(test_particle_ids_survive_removal)
+{
+	ParticleSystem particles;
+	RandomStream random;
+
+	ParticleInfo info;
+	info.orientation = ParticleInfo::Camera;
+	info.lifetime = 1.f;
+	auto expired = particles.spawn(info, 0.f);
+	info.lifetime = -1.f;
+	info.position = glm::vec3(5.f, 0.f, 0.f);
+	auto kept = particles.spawn(info, 0.f);
+
+	// The expired particle's slot is filled by the kept one
+	particles.update(2.f, 0.f, random);
+	particles.setSize(kept, glm::vec2(3.f, 3.f));
+	particles.buildBatches(glm::vec3(0.f, -10.f, 0.f), glm::vec3(0.f, 1.f, 0.f));
+
+	BOOST_REQUIRE_EQUAL(particles.getInstances().size(), 1);
+	auto& instance = particles.getInstances()[0];
+	BOOST_CHECK_CLOSE(instance.origin.x, 5.f, 1e-3f);
+	BOOST_CHECK_CLOSE(glm::length(instance.axisX), 3.f, 1e-3f);
+
+	// A new particle reusing the expired id's entry doesn't answer to it
+	auto fresh = particles.spawn(info, 2.f);
+	BOOST_CHECK(fresh != expired);
+	BOOST_CHECK(particles.isAlive(fresh));
+	BOOST_CHECK(! particles.isAlive(expired));
+}
+
+BOOST_AUTO_TEST_CASE(test_particle_ids_outlive_slot_reuse)
+{
+	ParticleSystem particles;
+
+	ParticleInfo info;
+	auto stale = particles.spawn(info, 0.f);
+	particles.destroy(stale);
+
+	// Far more reuses of the one slot than a narrow generation could tell
+	// apart
+	for (int i = 0; i < 1000; ++i) {
+		auto id = particles.spawn(info, 0.f);
+		BOOST_REQUIRE(id != stale);
+		BOOST_CHECK(! particles.isAlive(stale));
+		particles.destroy(id);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_particle_batches)
+{
+	ParticleSystem particles;
+
+	ParticleInfo info;
+	info.orientation = ParticleInfo::Camera;
+	const float distances[] = { 5.f, 20.f, 10.f };
+	for (float d : distances) {
+		info.position = glm::vec3(0.f, d, 0.f);
+		info.texture = 2;
+		particles.spawn(info, 0.f);
+		info.texture = 1;
+		particles.spawn(info, 0.f);
+	}
+
+	particles.buildBatches(glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+
+	auto& batches = particles.getBatches();
+	auto& instances = particles.getInstances();
+	BOOST_REQUIRE_EQUAL(batches.size(), 2);
+	BOOST_CHECK_EQUAL(batches[0].texture, 1);
+	BOOST_CHECK_EQUAL(batches[1].texture, 2);
+
+	for (auto& batch : batches) {
+		BOOST_REQUIRE_EQUAL(batch.count, 3);
+		// Furthest first
+		BOOST_CHECK_CLOSE(instances[batch.first + 0].origin.y, 20.f, 1e-3f);
+		BOOST_CHECK_CLOSE(instances[batch.first + 1].origin.y, 10.f, 1e-3f);
+		BOOST_CHECK_CLOSE(instances[batch.first + 2].origin.y, 5.f, 1e-3f);
+	}
+
+	// Camera facing quads are perpendicular to the view direction
+	auto& facing = instances[0];
+	BOOST_CHECK_SMALL(glm::dot(facing.axisX, glm::vec3(0.f, 1.f, 0.f)), 1e-4f);
+	BOOST_CHECK_SMALL(glm::dot(facing.axisY, glm::vec3(0.f, 1.f, 0.f)), 1e-4f);
+}
+
+BOOST_AUTO_TEST_CASE(test_particle_emitter)
+{
+	ParticleSystem particles;
+	RandomStream random;
+
+	EmitterInfo emitter;
+	emitter.position = glm::vec3(1.f, 2.f, 3.f);
+	emitter.rate = 10.f;
+	emitter.duration = 1.f;
+	emitter.particle.lifetime = 0.5f;
+	emitter.particle.velocity = glm::vec3(0.f, 0.f, 1.f);
+	particles.createEmitter(emitter, 0.f);
+	BOOST_CHECK_EQUAL(particles.getEmitterCount(), 1);
+
+	float time = 0.f;
+	for (int i = 0; i < 5; ++i) {
+		time += 0.1f;
+		particles.update(time, 0.1f, random);
+	}
+	// One particle per tick, each having moved up since it was emitted
+	BOOST_CHECK_EQUAL(particles.getParticleCount(), 5);
+	particles.buildBatches(glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+	for (auto& instance : particles.getInstances()) {
+		BOOST_CHECK_GT(instance.origin.z, 3.f);
+	}
+
+	// The emitter stops after its duration, and its particles expire
+	for (int i = 0; i < 15; ++i) {
+		time += 0.1f;
+		particles.update(time, 0.1f, random);
+	}
+	BOOST_CHECK_EQUAL(particles.getEmitterCount(), 0);
+	BOOST_CHECK_EQUAL(particles.getParticleCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+#include <boost/test/unit_test.hpp>
+#include <dynamics/PhysicsWorld.hpp>
+#include <core/WorkerPool.hpp>
+
+#include <btBulletDynamicsCommon.h>
+#if RW_BULLET_THREADS
+#include <LinearMath/btThreads.h>
+#endif
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{
+/**
+ * Stacks of boxes dropped onto a static ground plane, each stack its own
+ * simulation island.
+ */
+struct BoxStacks
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher;
+	btDbvtBroadphase broadphase;
+	PhysicsWorld physics;
+	btStaticPlaneShape groundShape;
+	btBoxShape boxShape;
+	std::vector<std::unique_ptr<btRigidBody>> bodies;
+
+	BoxStacks(WorkerPool* workers)
+		: dispatcher(&config)
+		, physics(&dispatcher, &broadphase, &config, workers)
+		, groundShape(btVector3(0.f, 0.f, 1.f), 0.f)
+		, boxShape(btVector3(0.5f, 0.5f, 0.5f))
+	{
+		auto world = physics.getDynamicsWorld();
+		world->setGravity(btVector3(0.f, 0.f, -9.81f));
+
+		bodies.emplace_back(new btRigidBody(0.f, nullptr, &groundShape));
+		world->addRigidBody(bodies.back().get());
+
+		btVector3 inertia;
+		boxShape.calculateLocalInertia(1.f, inertia);
+		for (int stack = 0; stack < 16; ++stack) {
+			for (int level = 0; level < 4; ++level) {
+				btTransform t;
+				t.setIdentity();
+				t.setOrigin(btVector3(stack * 4.f, 0.f, 0.5f + level * 1.1f));
+				btRigidBody::btRigidBodyConstructionInfo info(1.f, nullptr, &boxShape, inertia);
+				info.m_startWorldTransform = t;
+				bodies.emplace_back(new btRigidBody(info));
+				world->addRigidBody(bodies.back().get());
+			}
+		}
+	}
+
+	~BoxStacks()
+	{
+		for (auto& body : bodies) {
+			physics.getDynamicsWorld()->removeRigidBody(body.get());
+		}
+	}
+
+	std::vector<btVector3> run(int steps)
+	{
+		for (int i = 0; i < steps; ++i) {
+			physics.getDynamicsWorld()->stepSimulation(1.f / 60.f, 1, 1.f / 60.f);
+		}
+		std::vector<btVector3> positions;
+		for (auto& body : bodies) {
+			positions.push_back(body->getWorldTransform().getOrigin());
+		}
+		return positions;
+	}
+};
+}
+
+BOOST_AUTO_TEST_SUITE(PhysicsWorldTests)
+
+BOOST_AUTO_TEST_CASE(test_worker_pool_covers_range)
+{
+	WorkerPool workers(4);
+	std::vector<std::atomic<int>> visits(1000);
+	for (auto& v : visits) {
+		v = 0;
+	}
+
+	workers.parallelFor(0, visits.size(), 7, [&](std::size_t first, std::size_t last) {
+		BOOST_REQUIRE(last - first <= 7);
+		for (auto i = first; i < last; ++i) {
+			visits[i]++;
+		}
+	});
+
+	for (auto& v : visits) {
+		BOOST_CHECK_EQUAL(v.load(), 1);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_worker_pool_nested_runs_inline)
+{
+	WorkerPool workers(4);
+	std::atomic<int> total(0);
+
+	workers.parallelFor(0, 8, 1, [&](std::size_t, std::size_t) {
+		workers.parallelFor(0, 100, 10, [&](std::size_t first, std::size_t last) {
+			total += int(last - first);
+		});
+	});
+
+	BOOST_CHECK_EQUAL(total.load(), 800);
+}
+
+BOOST_AUTO_TEST_CASE(test_physics_world_single_thread)
+{
+	WorkerPool workers(1);
+	BoxStacks scene(&workers);
+
+	BOOST_CHECK(! scene.physics.isThreaded());
+
+	auto positions = scene.run(120);
+	// Boxes come to rest on the ground rather than falling through it
+	for (std::size_t i = 1; i < positions.size(); ++i) {
+		BOOST_CHECK_GT(positions[i].z(), 0.f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_physics_world_deterministic)
+{
+#if RW_BULLET_THREADS
+	std::vector<btVector3> serial;
+	{
+		WorkerPool workers(1);
+		BoxStacks scene(&workers);
+		BOOST_REQUIRE(! scene.physics.isThreaded());
+		serial = scene.run(120);
+	}
+
+	for (unsigned int threads : { 2u, 4u }) {
+		WorkerPool workers(threads);
+
+		std::vector<btVector3> first;
+		{
+			BoxStacks scene(&workers);
+			BOOST_REQUIRE(scene.physics.isThreaded());
+			first = scene.run(120);
+		}
+
+		std::vector<btVector3> second;
+		{
+			BoxStacks scene(&workers);
+			second = scene.run(120);
+		}
+
+		// Repeated runs with the same thread count match exactly
+		BOOST_REQUIRE_EQUAL(first.size(), second.size());
+		for (std::size_t i = 0; i < first.size(); ++i) {
+			BOOST_CHECK(first[i] == second[i]);
+		}
+
+		// The threaded solver settles the stacks where the serial one does
+		BOOST_REQUIRE_EQUAL(first.size(), serial.size());
+		for (std::size_t i = 0; i < first.size(); ++i) {
+			BOOST_CHECK_SMALL((first[i] - serial[i]).length(), btScalar(1e-3));
+		}
+	}
+#else
+	BOOST_TEST_MESSAGE("Skipping threaded physics determinism: built without ENABLE_BULLET_THREADS");
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(test_physics_world_out_of_order_destruction)
+{
+#if RW_BULLET_THREADS
+	auto original = btGetTaskScheduler();
+	{
+		WorkerPool workers(2);
+		std::unique_ptr<BoxStacks> first(new BoxStacks(&workers));
+		std::unique_ptr<BoxStacks> second(new BoxStacks(&workers));
+
+		// Destroying the older world first must not leave the newer one's
+		// scheduler pointing at it
+		first.reset();
+		second->run(10);
+		second.reset();
+	}
+	BOOST_CHECK(btGetTaskScheduler() == original);
+#else
+	BOOST_TEST_MESSAGE("Skipping task scheduler restore: built without ENABLE_BULLET_THREADS");
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,8 +11,8 @@ class TestPickup : public PickupObject
 public:
 	bool picked_up = false;
 
-	TestPickup(GameWorld* engine, const glm::vec3& position)
-		: PickupObject(engine, position, 0, OnStreet)
+	TestPickup(GameWorld* engine, const glm::vec3& position, PickupType type = OnStreet)
+		: PickupObject(engine, position, 0, type)
 	{}
 
 	bool onCharacterTouch(CharacterObject *character) {
@@ -61,6 +61,33 @@ BOOST_AUTO_TEST_CASE(test_pickup_interaction)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(test_pickup_active)
+{
+	{
+		auto character = Global::get().e->createPedestrian(1, { 35.1f, 0.f, 0.f });
+		BOOST_REQUIRE( character != nullptr );
+
+		TestPickup* p = new TestPickup(Global::get().e, { 35.f, 0.f, 0.f }, PickupObject::Once);
+
+		Global::get().e->pickupPool.insert(p);
+		Global::get().e->allObjects.push_back(p);
+
+		BOOST_CHECK( p->isActive() );
+		auto activeCount = Global::get().e->getActiveObjectCount();
+
+		Global::get().e->dynamicsWorld->stepSimulation(0.016f);
+		p->tick(0.f);
+
+		// Once collected, non-respawning pickups have nothing left to do
+		BOOST_CHECK( p->picked_up );
+		BOOST_CHECK( ! p->isActive() );
+		BOOST_CHECK_EQUAL( Global::get().e->getActiveObjectCount(), activeCount - 1 );
+
+		Global::get().e->destroyObject(p);
+		Global::get().e->destroyObject(character);
+	}
+}
+
 BOOST_AUTO_TEST_CASE(test_item_pickup)
 {
 	{
@@ -0,0 +1,67 @@
+#include <boost/test/unit_test.hpp>
+#include <engine/RandomService.hpp>
+
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(RandomServiceTests)
+
+BOOST_AUTO_TEST_CASE(test_reproducible)
+{
+	RandomService a(42), b(42);
+
+	for (int i = 0; i < 100; ++i) {
+		BOOST_CHECK_EQUAL( a.stream(RandomService::AI)(), b.stream(RandomService::AI)() );
+	}
+
+	// Reseeding restarts the sequence
+	auto first = a.stream(RandomService::Traffic)();
+	a.seed(42);
+	BOOST_CHECK_EQUAL( a.stream(RandomService::Traffic)(), first );
+	BOOST_CHECK_EQUAL( a.getSeed(), 42 );
+}
+
+BOOST_AUTO_TEST_CASE(test_independent_streams)
+{
+	RandomService a(42), b(42);
+
+	// Drawing from one stream doesn't affect another
+	for (int i = 0; i < 10; ++i) {
+		a.stream(RandomService::Traffic)();
+	}
+	BOOST_CHECK_EQUAL( a.stream(RandomService::AI)(), b.stream(RandomService::AI)() );
+
+	auto traffic = RandomStream(42, RandomService::Traffic);
+	auto ai = RandomStream(42, RandomService::AI);
+	int same = 0;
+	for (int i = 0; i < 100; ++i) {
+		same += traffic() == ai() ? 1 : 0;
+	}
+	BOOST_CHECK_LT( same, 5 );
+
+	auto thread0 = a.makeStream(0);
+	auto thread0again = b.makeStream(0);
+	auto thread1 = a.makeStream(1);
+	BOOST_CHECK_EQUAL( thread0(), thread0again() );
+	BOOST_CHECK_NE( thread0(), thread1() );
+}
+
+BOOST_AUTO_TEST_CASE(test_ranges)
+{
+	RandomStream stream(7);
+
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK_LT( stream.below(5), 5 );
+		float f = stream.unit();
+		BOOST_CHECK( f >= 0.f && f < 1.f );
+	}
+	BOOST_CHECK_EQUAL( stream.below(0), 0 );
+
+	// Works with the standard distributions
+	std::uniform_int_distribution<int> d(-3, 3);
+	for (int i = 0; i < 100; ++i) {
+		int v = d(stream);
+		BOOST_CHECK( v >= -3 && v <= 3 );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
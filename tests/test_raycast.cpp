@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+#include <dynamics/RaycastService.hpp>
+#include <core/WorkerPool.hpp>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+/**
+ * A collision world with a row of boxes along the X axis
+ */
+struct RaycastWorld
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher;
+	btDbvtBroadphase broadphase;
+	btCollisionWorld world;
+	btBoxShape box;
+	std::vector<std::unique_ptr<btCollisionObject>> objects;
+
+	RaycastWorld()
+		: dispatcher(&config)
+		, world(&dispatcher, &broadphase, &config)
+		, box(btVector3(1.f, 1.f, 1.f))
+	{
+		for (int i = 0; i < 10; ++i) {
+			objects.emplace_back(new btCollisionObject);
+			auto& object = objects.back();
+			object->setCollisionShape(&box);
+			object->getWorldTransform().setOrigin(btVector3(i * 10.f, 0.f, 0.f));
+			world.addCollisionObject(object.get());
+		}
+		world.updateAabbs();
+	}
+
+	~RaycastWorld()
+	{
+		for (auto& object : objects) {
+			world.removeCollisionObject(object.get());
+		}
+	}
+};
+}
+
+BOOST_AUTO_TEST_SUITE(RaycastServiceTests)
+
+BOOST_AUTO_TEST_CASE(test_raycast_single)
+{
+	RaycastWorld w;
+	RaycastService service(&w.broadphase);
+
+	auto hit = service.cast({ glm::vec3(20.f, 0.f, 10.f), glm::vec3(20.f, 0.f, -10.f) });
+	BOOST_REQUIRE( hit.hit );
+	BOOST_CHECK( hit.object == w.objects[2].get() );
+	BOOST_CHECK_CLOSE( hit.point.z, 1.f, 0.1f );
+	BOOST_CHECK_CLOSE( hit.normal.z, 1.f, 0.1f );
+
+	auto miss = service.cast({ glm::vec3(25.f, 0.f, 10.f), glm::vec3(25.f, 0.f, -10.f) });
+	BOOST_CHECK( ! miss.hit );
+
+	// The ignored object is passed through
+	auto through = service.cast({ glm::vec3(-5.f, 0.f, 0.f), glm::vec3(100.f, 0.f, 0.f),
+								  w.objects[0].get() });
+	BOOST_REQUIRE( through.hit );
+	BOOST_CHECK( through.object == w.objects[1].get() );
+}
+
+BOOST_AUTO_TEST_CASE(test_raycast_batch_matches_world)
+{
+	RaycastWorld w;
+	WorkerPool workers(4);
+	RaycastService service(&w.broadphase, &workers);
+
+	std::vector<RaycastService::Ray> rays;
+	for (int i = 0; i < 1000; ++i) {
+		float x = i * 0.1f - 5.f;
+		rays.push_back({ glm::vec3(x, 0.f, 10.f), glm::vec3(x, 0.f, -10.f) });
+	}
+	std::vector<RaycastService::Hit> hits(rays.size());
+	service.castBatch(rays.data(), hits.data(), rays.size());
+
+	for (int i = 0; i < 1000; ++i) {
+		float x = i * 0.1f - 5.f;
+		btVector3 from(x, 0.f, 10.f), to(x, 0.f, -10.f);
+		btCollisionWorld::ClosestRayResultCallback expected(from, to);
+		w.world.rayTest(from, to, expected);
+
+		auto& result = hits[i];
+		BOOST_CHECK_EQUAL( result.hit, expected.hasHit() );
+		if (result.hit && expected.hasHit()) {
+			BOOST_CHECK( result.object == expected.m_collisionObject );
+			BOOST_CHECK_CLOSE( result.fraction, expected.m_closestHitFraction, 0.01f );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_raycast_radius)
+{
+	RaycastWorld w;
+	RaycastService service(&w.broadphase);
+
+	std::vector<const btCollisionObject*> found;
+	service.queryRadius(glm::vec3(15.f, 0.f, 0.f), 5.f, found);
+	BOOST_CHECK_EQUAL( found.size(), 2 );
+
+	found.clear();
+	service.queryRadius(glm::vec3(15.f, 0.f, 0.f), 3.f, found);
+	BOOST_CHECK_EQUAL( found.size(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,15 @@
 #include <boost/test/unit_test.hpp>
 #include "test_globals.hpp"
 #include <render/GameRenderer.hpp>
+#include <render/NullRenderer.hpp>
+#include <render/OcclusionBuffer.hpp>
+#include <render/ObjectRenderer.hpp>
+#include <render/RingAllocator.hpp>
+#include <data/Model.hpp>
+#include <gl/GeometryArena.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <limits>
 
 BOOST_AUTO_TEST_SUITE(RendererTests)
 
@@ -25,4 +34,261 @@ BOOST_AUTO_TEST_CASE(frustum_test_visible)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(frustum_test_packed)
+{
+	ViewFrustum f(0.1f, 100.f, glm::half_pi<float>(), 1.f);
+	f.update(f.projection());
+
+	// Not a multiple of any SIMD width, so the scalar tail is tested too
+	PackedSpheres spheres;
+	uint32_t seed = 1;
+	auto random = [&](float range) {
+		seed = seed * 1664525u + 1013904223u;
+		return (float(seed >> 8) / float(1 << 24) * 2.f - 1.f) * range;
+	};
+	for (size_t i = 0; i < 1001; ++i) {
+		spheres.add({random(120.f), random(120.f), random(120.f)}, std::abs(random(10.f)));
+	}
+	spheres.add({0.f, 0.f, 1000.f}, std::numeric_limits<float>::infinity());
+
+	ViewFrustum::VisibilityMask mask { 0xFFFFFFFF };
+	f.intersects(spheres, mask);
+	BOOST_REQUIRE_EQUAL(mask.size(), (spheres.size() + 31) / 32);
+
+	size_t visible = 0;
+	for (size_t i = 0; i < spheres.size(); ++i) {
+		glm::vec3 center(spheres.x[i], spheres.y[i], spheres.z[i]);
+		bool expected = f.intersects(center, spheres.radius[i]);
+		BOOST_CHECK_EQUAL(ViewFrustum::isVisible(mask, i), expected);
+		visible += expected ? 1 : 0;
+	}
+	BOOST_CHECK(visible > 1 && visible < spheres.size());
+	BOOST_CHECK(ViewFrustum::isVisible(mask, spheres.size() - 1));
+	// Bits past the last sphere are left clear
+	BOOST_CHECK_EQUAL(mask.back() >> (spheres.size() % 32), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(geometry_arena_test)
+{
+	GeometryArenas arenas(Model::CompactGeometryVertex::vertex_attributes(),
+						  sizeof(Model::CompactGeometryVertex),
+						  1000, 3000);
+	GeometryArena::Allocation a, b, c, d;
+
+	auto first = arenas.allocate(GL_TRIANGLES, 400, 1200, a);
+	BOOST_REQUIRE(first != nullptr);
+	BOOST_CHECK_EQUAL(a.baseVertex, 0);
+	BOOST_CHECK_EQUAL(a.firstIndex, 0);
+
+	BOOST_CHECK_EQUAL(arenas.allocate(GL_TRIANGLES, 400, 1200, b), first);
+	BOOST_CHECK_EQUAL(b.baseVertex, 400);
+	BOOST_CHECK_EQUAL(b.firstIndex, 1200);
+
+	// Doesn't fit in the first arena any more
+	auto second = arenas.allocate(GL_TRIANGLES, 400, 300, c);
+	BOOST_REQUIRE(second != nullptr);
+	BOOST_CHECK(second != first);
+	BOOST_CHECK_EQUAL(c.baseVertex, 0);
+
+	// Strips can't be drawn from the same arena as triangles
+	auto strips = arenas.allocate(GL_TRIANGLE_STRIP, 10, 10, d);
+	BOOST_REQUIRE(strips != nullptr);
+	BOOST_CHECK(strips != first && strips != second);
+	BOOST_CHECK_EQUAL(strips->getFaceType(), GL_TRIANGLE_STRIP);
+
+	BOOST_CHECK(arenas.allocate(GL_TRIANGLES, 2000, 10, d) == nullptr);
+	BOOST_CHECK_EQUAL(arenas.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(null_renderer_batching_test)
+{
+	const size_t kModels = 64;
+	const size_t kInstances = 4000;
+
+	std::vector<DrawBuffer> modelBuffers(kModels);
+	DrawBuffer arenaBuffer;
+
+	// A dense scene of instances in depth order, which is unrelated to
+	// their model. Each model's first two subgeometries share a material.
+	auto buildScene = [&](bool arena, RenderList& list) {
+		uint32_t seed = 1;
+		for (size_t i = 0; i < kInstances; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			size_t m = (seed >> 8) % kModels;
+			glm::mat4 matrix = glm::translate(glm::mat4(), glm::vec3(i, 0.f, 0.f));
+			for (size_t sg = 0; sg < 3; ++sg) {
+				Renderer::DrawParameters dp;
+				dp.start = sg * 100;
+				dp.count = 100;
+				dp.baseVertex = arena ? m * 1000 : 0;
+				dp.textures = {GLuint(m * 2 + (sg == 2 ? 1 : 0) + 1)};
+				dp.colour = {255, 255, 255, 255};
+				list.emplace_back(0, matrix, arena ? &arenaBuffer : &modelBuffers[m], dp);
+			}
+		}
+	};
+
+	RenderList separate, shared;
+	buildScene(false, separate);
+	buildScene(true, shared);
+
+	NullRenderer renderer;
+	renderer.drawBatched(separate);
+	auto separateDraws = renderer.getDrawCount();
+	auto separateBinds = renderer.getBufferCount();
+	auto separateTextures = renderer.getTextureCount();
+
+	renderer.swap();
+	renderer.invalidate();
+	renderer.drawBatched(shared);
+
+	// Subgeometries sharing a material are merged into one draw
+	BOOST_CHECK_EQUAL(separateDraws, kInstances * 2);
+	BOOST_CHECK_EQUAL(renderer.getDrawCount(), kInstances * 2);
+
+	// Each model had its own vertex array, now there's one for the frame
+	BOOST_CHECK_GT(separateBinds, kInstances / 2);
+	BOOST_CHECK_EQUAL(renderer.getBufferCount(), 1);
+
+	BOOST_CHECK_EQUAL(renderer.getTextureCount(), separateTextures);
+}
+
+BOOST_AUTO_TEST_CASE(instanced_batching_test)
+{
+	const size_t kModels = 64;
+	const size_t kInstances = 4000;
+
+	DrawBuffer arenaBuffer;
+
+	// Instances of a few models scattered in depth, each model has three
+	// subgeometries and the first two share a material
+	RenderList list;
+	uint32_t seed = 1;
+	for (size_t i = 0; i < kInstances; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		size_t m = (seed >> 8) % kModels;
+		float depth = float(seed & 0xFF) / 255.f;
+		glm::mat4 matrix = glm::translate(glm::mat4(), glm::vec3(i, 0.f, 0.f));
+		for (size_t sg = 0; sg < 3; ++sg) {
+			Renderer::DrawParameters dp;
+			dp.start = sg * 100;
+			dp.count = 100;
+			dp.baseVertex = m * 1000;
+			dp.textures = {GLuint(m * 2 + (sg == 2 ? 1 : 0) + 1)};
+			dp.colour = {255, 255, 255, 255};
+			auto key = ObjectRenderer::createKey(false, depth, &arenaBuffer, dp);
+			list.emplace_back(key, matrix, &arenaBuffer, dp);
+		}
+	}
+	std::sort(list.begin(), list.end(),
+			  [](const Renderer::RenderInstruction& a,
+				 const Renderer::RenderInstruction& b) {
+				  return a.sortKey < b.sortKey;
+			  });
+
+	NullRenderer renderer;
+	renderer.drawBatched(list);
+	auto batchedDraws = renderer.getDrawCount();
+
+	std::unique_ptr<Renderer::ShaderProgram> instancedProgram(renderer.createShader("", ""));
+	renderer.setInstancedProgram(instancedProgram.get());
+	renderer.swap();
+	renderer.invalidate();
+	renderer.drawBatched(list);
+
+	// Every subgeometry of a model is one instanced draw
+	BOOST_CHECK_EQUAL(batchedDraws, kInstances * 3);
+	BOOST_CHECK_EQUAL(renderer.getDrawCount(), kModels * 3);
+
+	// Transparent instructions are still back to front
+	Renderer::DrawParameters dp;
+	dp.textures = {1};
+	BOOST_CHECK_LT(ObjectRenderer::createKey(true, 0.9f, &arenaBuffer, dp),
+				   ObjectRenderer::createKey(true, 0.1f, &arenaBuffer, dp));
+	BOOST_CHECK_LT(ObjectRenderer::createKey(false, 0.9f, &arenaBuffer, dp),
+				   ObjectRenderer::createKey(true, 0.1f, &arenaBuffer, dp));
+}
+
+BOOST_AUTO_TEST_CASE(occlusion_buffer_test)
+{
+	OcclusionBuffer buffer(64, 32);
+	auto viewProjection = glm::perspective(1.f, 2.f, 0.1f, 1000.f) *
+			glm::lookAt(glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f));
+
+	{
+		// A wall filling the view
+		buffer.begin(viewProjection);
+		buffer.drawBox(glm::mat4(), {20.f, -50.f, -20.f}, {22.f, 50.f, 20.f});
+		BOOST_CHECK_EQUAL(buffer.getTriangleCount(), 12u);
+
+		// Both halves of each face are drawn right up to the diagonal
+		for (int y = 0; y < buffer.getHeight(); ++y) {
+			for (int x = 0; x < buffer.getWidth(); ++x) {
+				BOOST_REQUIRE_LT(buffer.getDepth(x, y), 1.f);
+			}
+		}
+
+		BOOST_CHECK(!buffer.isVisible(glm::vec3(50.f, 0.f, 0.f), 2.f));
+		BOOST_CHECK(buffer.isVisible(glm::vec3(10.f, 0.f, 0.f), 2.f));
+		// Partly in front of the wall
+		BOOST_CHECK(buffer.isVisible(glm::vec3(21.f, 0.f, 0.f), 3.f));
+		// Reaching the near plane
+		BOOST_CHECK(buffer.isVisible(glm::vec3(0.f), 1.f));
+	}
+
+	{
+		// A small occluder only hides what is entirely behind it
+		buffer.begin(viewProjection);
+		buffer.drawBox(glm::mat4(), {20.f, -2.f, -2.f}, {22.f, 2.f, 2.f});
+		BOOST_CHECK(!buffer.isVisible(glm::vec3(50.f, 0.f, 0.f), 0.5f));
+		BOOST_CHECK(buffer.isVisible(glm::vec3(50.f, 0.f, 0.f), 10.f));
+		BOOST_CHECK(buffer.isVisible(glm::vec3(50.f, 20.f, 0.f), 2.f));
+	}
+
+	{
+		// Occluders that cross the near plane are clipped, not dropped
+		buffer.begin(viewProjection);
+		buffer.drawBox(glm::mat4(), {-5.f, -5.f, -5.f}, {5.f, 5.f, 5.f});
+		BOOST_CHECK_LT(buffer.getDepth(32, 16), 1.f);
+		BOOST_CHECK(!buffer.isVisible(glm::vec3(50.f, 0.f, 0.f), 2.f));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ring_allocator_test)
+{
+	// Three regions of 768 bytes, the largest multiple of 256 that fits
+	RingAllocator ring(3000, 256);
+	BOOST_CHECK_EQUAL(ring.getRegionSize(), 768);
+
+	std::size_t offset = 0;
+	BOOST_REQUIRE(ring.allocate(100, offset));
+	BOOST_CHECK_EQUAL(offset, 0);
+	BOOST_REQUIRE(ring.allocate(100, offset));
+	BOOST_CHECK_EQUAL(offset, 256);
+	BOOST_CHECK(!ring.allocate(300, offset));
+	BOOST_REQUIRE(ring.allocate(200, offset));
+	BOOST_CHECK_EQUAL(offset, 512);
+	BOOST_CHECK_EQUAL(ring.getUsed(), 712);
+
+	int fences[3];
+	BOOST_CHECK(ring.advance(&fences[0]) == nullptr);
+	BOOST_REQUIRE(ring.allocate(10, offset));
+	BOOST_CHECK_EQUAL(offset, 768);
+
+	BOOST_CHECK(ring.advance(&fences[1]) == nullptr);
+	BOOST_REQUIRE(ring.allocate(10, offset));
+	BOOST_CHECK_EQUAL(offset, 1536);
+
+	// Back to the first region, whose fence has to be waited on
+	BOOST_CHECK(ring.advance(&fences[2]) == &fences[0]);
+	BOOST_CHECK_EQUAL(ring.getRegion(), 0);
+	BOOST_REQUIRE(ring.allocate(768, offset));
+	BOOST_CHECK_EQUAL(offset, 0);
+
+	// Fences are only handed back once
+	BOOST_CHECK(ring.advance(nullptr) == &fences[1]);
+	BOOST_CHECK(ring.advance(nullptr) == &fences[2]);
+	BOOST_CHECK(ring.advance(nullptr) == nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
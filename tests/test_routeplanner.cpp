@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+#include <ai/RoutePlanner.hpp>
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+/**
+ * Builds a small graph:
+ *
+ *   0 --- 1 --- 2
+ *    \         /
+ *     3 ----- 4     5 (vehicle, connected to 0 and 2)
+ */
+void createTestGraph(AIGraph& graph)
+{
+	PathData peds {
+		PathData::PATH_PED,
+		0, "",
+		{
+			{ PathNode::INTERNAL, -1, { 0.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, -1, { 10.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, -1, { 20.f, 0.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, -1, { 0.f, -10.f, 0.f }, 1.f, 0, 0 },
+			{ PathNode::INTERNAL, -1, { 20.f, -10.f, 0.f }, 1.f, 0, 0 },
+		}
+	};
+	PathData cars {
+		PathData::PATH_CAR,
+		0, "",
+		{
+			{ PathNode::INTERNAL, -1, { 10.f, 5.f, 0.f }, 1.f, 0, 0 },
+		}
+	};
+	graph.createPathNodes(glm::vec3(), glm::quat(), peds);
+	graph.createPathNodes(glm::vec3(), glm::quat(), cars);
+
+	graph.connect(0, 1);
+	graph.connect(1, 2);
+	graph.connect(0, 3);
+	graph.connect(3, 4);
+	graph.connect(4, 2);
+	graph.connect(0, 5);
+	graph.connect(5, 2);
+}
+
+RouteRef waitForRoute(const RouteRequestRef& request)
+{
+	auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (! request->isReady() && std::chrono::steady_clock::now() < timeout) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	BOOST_REQUIRE( request->isReady() );
+	return request->route;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(RoutePlannerTests)
+
+BOOST_AUTO_TEST_CASE(test_shortest_route)
+{
+	AIGraph graph;
+	createTestGraph(graph);
+	RoutePlanner planner(graph);
+
+	auto route = planner.planRoute(0, 2, AIGraphNode::Pedestrian);
+	BOOST_REQUIRE_EQUAL( route->nodes.size(), 3 );
+	BOOST_CHECK_EQUAL( route->nodes[0], 0 );
+	BOOST_CHECK_EQUAL( route->nodes[1], 1 );
+	BOOST_CHECK_EQUAL( route->nodes[2], 2 );
+
+	// Nodes of the wrong type can't be passed through or routed to
+	BOOST_CHECK( ! planner.planRoute(0, 5, AIGraphNode::Pedestrian)->found() );
+	BOOST_CHECK( ! planner.planRoute(0, 2, AIGraphNode::Vehicle)->found() );
+}
+
+BOOST_AUTO_TEST_CASE(test_disabled_nodes)
+{
+	AIGraph graph;
+	createTestGraph(graph);
+	RoutePlanner planner(graph);
+
+	graph.setNodeDisabled(1, true);
+
+	auto route = planner.planRoute(0, 2, AIGraphNode::Pedestrian);
+	BOOST_REQUIRE_EQUAL( route->nodes.size(), 4 );
+	BOOST_CHECK_EQUAL( route->nodes[1], 3 );
+	BOOST_CHECK_EQUAL( route->nodes[2], 4 );
+
+	graph.setNodeDisabled(4, true);
+	BOOST_CHECK( ! planner.planRoute(0, 2, AIGraphNode::Pedestrian)->found() );
+}
+
+BOOST_AUTO_TEST_CASE(test_async_requests)
+{
+	AIGraph graph;
+	createTestGraph(graph);
+	RoutePlanner planner(graph);
+
+	auto first = planner.requestRoute(0, 2, AIGraphNode::Pedestrian);
+	auto second = planner.requestRoute(0, 2, AIGraphNode::Pedestrian);
+
+	auto route = waitForRoute(first);
+	BOOST_CHECK_EQUAL( route->nodes.size(), 3 );
+
+	// Either the second request shared the first, or it was already cached
+	BOOST_CHECK( second == first || waitForRoute(second) == route );
+
+	// Once finished, requests are answered from the cache straight away
+	auto cached = planner.requestRoute(0, 2, AIGraphNode::Pedestrian);
+	BOOST_CHECK( cached->isReady() );
+	BOOST_CHECK( cached->route == route );
+	BOOST_CHECK_EQUAL( planner.getCachedCount(), 1 );
+	BOOST_CHECK_EQUAL( planner.getPendingCount(), 0 );
+
+	// Editing the graph invalidates cached routes
+	graph.setNodeDisabled(1, true);
+	auto detour = waitForRoute(planner.requestRoute(0, 2, AIGraphNode::Pedestrian));
+	BOOST_CHECK_EQUAL( detour->nodes.size(), 4 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
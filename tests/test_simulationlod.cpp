@@ -0,0 +1,82 @@
+#include <boost/test/unit_test.hpp>
+#include "test_globals.hpp"
+#include <engine/SimulationLOD.hpp>
+#include <objects/CharacterObject.hpp>
+#include <ai/CharacterController.hpp>
+
+BOOST_AUTO_TEST_SUITE(SimulationLODTests)
+
+BOOST_AUTO_TEST_CASE(test_tier_selection)
+{
+	SimulationLOD lod;
+	lod.reducedDistance = 40.f;
+	lod.kinematicDistance = 80.f;
+	lod.hysteresis = 5.f;
+
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationFull, 10.f), SimulationFull );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationFull, 60.f), SimulationReduced );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationFull, 100.f), SimulationKinematic );
+
+	// Objects near a boundary stay in their current tier
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationFull, 42.f), SimulationFull );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationReduced, 38.f), SimulationReduced );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationReduced, 82.f), SimulationReduced );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationKinematic, 78.f), SimulationKinematic );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationKinematic, 70.f), SimulationReduced );
+
+	// Some objects can't be simulated any less than a given tier
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationFull, 100.f, SimulationReduced), SimulationReduced );
+	BOOST_CHECK_EQUAL( lod.selectTier(SimulationKinematic, 100.f, SimulationFull), SimulationFull );
+}
+
+BOOST_AUTO_TEST_CASE(test_update_ticks)
+{
+	SimulationLOD lod;
+	lod.reducedInterval = 4;
+
+	// Every object updates once per interval, on different ticks
+	int updates = 0;
+	for (uint32_t tick = 0; tick < 4; ++tick) {
+		updates += lod.isUpdateTick(tick, 7) ? 1 : 0;
+	}
+	BOOST_CHECK_EQUAL( updates, 1 );
+	BOOST_CHECK( lod.isUpdateTick(1, 7) != lod.isUpdateTick(1, 8) );
+
+	lod.reducedInterval = 1;
+	BOOST_CHECK( lod.isUpdateTick(3, 7) );
+}
+
+#if RW_TEST_WITH_DATA
+BOOST_AUTO_TEST_CASE(test_kinematic_characters)
+{
+	auto world = Global::get().e;
+	auto character = world->createPedestrian(1, {100.f, 100.f, 50.f});
+	BOOST_REQUIRE( character != nullptr );
+	character->controller->setGoal(CharacterController::TrafficWander);
+
+	world->setSimulationFocus({ 100.f, 100.f + world->simulationLOD.kinematicDistance * 2.f, 50.f });
+	world->updateSimulationTiers();
+	BOOST_CHECK_EQUAL( character->getSimulationTier(), SimulationKinematic );
+
+	// Walks in the direction it's facing without the physics world
+	auto start = character->getPosition();
+	character->setHeading(0.f);
+	character->setMovement({ 1.f, 0.f, 0.f });
+	for (int i = 0; i < 60; ++i) {
+		character->tickSimulation(1.f / 60.f);
+	}
+	BOOST_CHECK_GT( character->getPosition().y, start.y + 1.f );
+	BOOST_CHECK_CLOSE( character->getPosition().z, start.z, 0.1f );
+
+	// And is handed back to it when the focus returns
+	world->setSimulationFocus(character->getPosition());
+	world->updateSimulationTiers();
+	BOOST_CHECK_EQUAL( character->getSimulationTier(), SimulationFull );
+
+	character->setMovement({ 0.f, 0.f, 0.f });
+	world->clearSimulationFocus();
+	world->destroyObject(character);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
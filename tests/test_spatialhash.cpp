@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+#include <engine/SpatialHash.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <objects/GameObject.hpp>
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+
+#include <algorithm>
+
+namespace
+{
+class HashedObject : public GameObject
+{
+public:
+	HashedObject(GameWorld* engine)
+		: GameObject(engine, glm::vec3(), glm::quat(), nullptr)
+	{}
+
+	void tick(float) {}
+};
+
+bool contains(const std::vector<GameObject*>& objects, GameObject* object)
+{
+	return std::find(objects.begin(), objects.end(), object) != objects.end();
+}
+}
+
+BOOST_AUTO_TEST_SUITE(SpatialHashTests)
+
+BOOST_AUTO_TEST_CASE(test_spatialhash_queries)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	HashedObject a(&world), b(&world), c(&world);
+
+	SpatialHash hash(10.f);
+	hash.insert(&a, glm::vec3(0.f, 0.f, 0.f));
+	hash.insert(&b, glm::vec3(15.f, 0.f, 0.f));
+	hash.insert(&c, glm::vec3(-100.f, 50.f, 5.f));
+	BOOST_CHECK_EQUAL( hash.size(), 3 );
+
+	{
+		std::vector<GameObject*> found;
+		hash.queryRadius(glm::vec3(5.f, 0.f, 0.f), 11.f, found);
+		BOOST_CHECK_EQUAL( found.size(), 2 );
+		BOOST_CHECK( contains(found, &a) );
+		BOOST_CHECK( contains(found, &b) );
+	}
+
+	BOOST_CHECK( hash.anyWithin(glm::vec3(-95.f, 50.f, 5.f), 6.f) );
+	BOOST_CHECK( ! hash.anyWithin(glm::vec3(-95.f, 50.f, 5.f), 4.f) );
+
+	{
+		std::vector<GameObject*> found;
+		hash.queryBox(glm::vec3(-200.f, 0.f, 0.f), glm::vec3(1.f, 100.f, 10.f), found);
+		BOOST_CHECK_EQUAL( found.size(), 2 );
+		BOOST_CHECK( contains(found, &a) );
+		BOOST_CHECK( contains(found, &c) );
+	}
+
+	{
+		std::vector<GameObject*> found;
+		hash.queryNearest(glm::vec3(12.f, 0.f, 0.f), 2, 1000.f, found);
+		BOOST_REQUIRE_EQUAL( found.size(), 2 );
+		BOOST_CHECK( found[0] == &b );
+		BOOST_CHECK( found[1] == &a );
+	}
+
+	{
+		std::vector<GameObject*> found;
+		hash.queryOutside(glm::vec3(0.f, 0.f, 0.f), 20.f, found);
+		BOOST_REQUIRE_EQUAL( found.size(), 1 );
+		BOOST_CHECK( found[0] == &c );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_spatialhash_update)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	HashedObject a(&world), b(&world), outsider(&world);
+
+	SpatialHash hash(10.f);
+	hash.insert(&a, glm::vec3(0.f, 0.f, 0.f));
+	hash.insert(&b, glm::vec3(1.f, 0.f, 0.f));
+
+	// Moving into another cell must leave the remaining entries intact
+	hash.update(&a, glm::vec3(500.f, 0.f, 0.f));
+	BOOST_CHECK( hash.anyWithin(glm::vec3(500.f, 0.f, 0.f), 1.f) );
+	BOOST_CHECK( hash.anyWithin(glm::vec3(1.f, 0.f, 0.f), 0.5f) );
+	BOOST_CHECK( ! hash.anyWithin(glm::vec3(0.f, 0.f, 0.f), 0.5f) );
+
+	// Objects that were never inserted are ignored
+	hash.update(&outsider, glm::vec3(1.f, 0.f, 0.f));
+	BOOST_CHECK( ! hash.contains(&outsider) );
+
+	hash.remove(&b);
+	BOOST_CHECK_EQUAL( hash.size(), 1 );
+	BOOST_CHECK( ! hash.anyWithin(glm::vec3(1.f, 0.f, 0.f), 0.5f) );
+	BOOST_CHECK( hash.contains(&a) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,9 @@
 #include <data/GameTexts.hpp>
 #include <loaders/LoaderGXT.hpp>
 #include <engine/ScreenText.hpp>
+#include <render/TextLayout.hpp>
+#include <render/TextRenderer.hpp>
+#include <cstring>
 
 BOOST_AUTO_TEST_SUITE(TextTests)
 
@@ -169,4 +172,144 @@ BOOST_AUTO_TEST_CASE(format_remove)
 }
 #endif
 
+BOOST_AUTO_TEST_CASE(texts_test)
+{
+	GameTexts texts;
+	texts.addText("B", "Second");
+	texts.addText("C", "Third");
+	// Out of order and duplicate keys
+	texts.addText("A", "First");
+	texts.addText("B", "Duplicate");
+	// Too long to be a GXT key
+	texts.addText("TOOLONGKEY", "Ignored");
+
+	BOOST_CHECK_EQUAL(texts.size(), 3);
+	BOOST_CHECK(texts.hasText("A"));
+	BOOST_CHECK(!texts.hasText("TOOLONGKEY"));
+	BOOST_CHECK_EQUAL(texts.text("A").str(), "First");
+	BOOST_CHECK_EQUAL(texts.text("B").str(), "Second");
+	BOOST_CHECK_EQUAL(texts.text("C").str(), "Third");
+
+	// Missing text returns the key
+	std::string missing("D");
+	BOOST_CHECK(texts.text(missing) == missing);
+	BOOST_CHECK_EQUAL(texts.text(missing).data(), missing.data());
+}
+
+BOOST_AUTO_TEST_CASE(load_gxt_test)
+{
+	// Two keys, the second text has a U+00E9
+	const char gxt[] =
+		"TKEY" "\x18\0\0\0"
+		"\0\0\0\0" "HELLO\0\0\0"
+		"\x06\0\0\0" "CAFE\0\0\0\0"
+		"TDAT" "\x10\0\0\0"
+		"H\0i\0\0\0"
+		"C\0a\0f\0\xe9\0\0\0";
+
+	auto contents = new FileContentsInfo;
+	contents->length = sizeof(gxt) - 1;
+	contents->data = new char[contents->length];
+	std::memcpy(contents->data, gxt, contents->length);
+	FileHandle file(contents);
+
+	GameTexts texts;
+	LoaderGXT loader;
+	loader.load(texts, file);
+
+	BOOST_CHECK_EQUAL(texts.size(), 2);
+	BOOST_CHECK_EQUAL(texts.text("HELLO").str(), "Hi");
+	BOOST_CHECK_EQUAL(texts.text("CAFE").str(), "Caf\xc3\xa9");
+}
+
+BOOST_AUTO_TEST_CASE(layout_test)
+{
+	TextLayoutCache cache;
+	TextLayout layout;
+
+	cache.layoutText("AB", 0, 10.f, 0, layout);
+	BOOST_REQUIRE_EQUAL(layout.glyphs.size(), 2);
+	BOOST_CHECK_CLOSE(layout.glyphs[1].position.x, 7.f, 0.01f);
+	BOOST_CHECK_CLOSE(layout.extents.x, 14.f, 0.01f);
+	BOOST_CHECK_EQUAL(layout.extents.y, 0.f);
+
+	cache.layoutText("a\nb", 0, 10.f, 0, layout);
+	BOOST_REQUIRE_EQUAL(layout.glyphs.size(), 2);
+	BOOST_CHECK_EQUAL(layout.glyphs[1].position.x, 0.f);
+	BOOST_CHECK_EQUAL(layout.glyphs[1].position.y, 10.f);
+
+	// The second word doesn't fit in 5 characters
+	cache.layoutText("aaa bbb", 0, 10.f, 5, layout);
+	BOOST_REQUIRE_EQUAL(layout.glyphs.size(), 7);
+	BOOST_CHECK_EQUAL(layout.glyphs[4].position.x, 0.f);
+	BOOST_CHECK_EQUAL(layout.glyphs[4].position.y, 10.f);
+	BOOST_CHECK_EQUAL(layout.extents.y, 20.f);
+}
+
+BOOST_AUTO_TEST_CASE(layout_markup_test)
+{
+	TextLayoutCache cache;
+	TextLayout layout;
+
+	cache.layoutText("~r~red~h~white", 0, 10.f, 0, layout);
+	BOOST_CHECK_EQUAL(layout.glyphs.size(), 8);
+	BOOST_REQUIRE_EQUAL(layout.runs.size(), 2);
+	BOOST_CHECK(layout.runs[0].markup);
+	BOOST_CHECK_EQUAL(layout.runs[0].colour.r, 1.f);
+	BOOST_CHECK_EQUAL(layout.runs[0].colour.g, 0.f);
+	BOOST_CHECK_EQUAL(layout.runs[1].first, 3);
+
+	// Key markup prints the key's name
+	cache.layoutText("~k~~PED_FIRE~ go", 0, 10.f, 0, layout);
+	BOOST_CHECK_EQUAL(layout.glyphs.size(), 11);
+	BOOST_REQUIRE_EQUAL(layout.runs.size(), 1);
+	BOOST_CHECK(! layout.runs[0].markup);
+}
+
+BOOST_AUTO_TEST_CASE(layout_cache_test)
+{
+	TextLayoutCache cache;
+
+	auto& a = cache.layout("Cached", 1, 20.f, 0);
+	auto& b = cache.layout("Cached", 1, 20.f, 0);
+	BOOST_CHECK_EQUAL(&a, &b);
+	BOOST_CHECK_EQUAL(cache.getLayoutCount(), 1);
+
+	cache.layout("Cached", 1, 30.f, 0);
+	BOOST_CHECK_EQUAL(cache.size(), 2);
+
+	// Keep one layout in use while the other goes stale
+	for (int f = 0; f < 200; ++f) {
+		cache.layout("Cached", 1, 20.f, 0);
+		cache.nextFrame();
+	}
+	BOOST_CHECK_EQUAL(cache.size(), 1);
+	BOOST_CHECK_EQUAL(cache.getLayoutCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(text_vertices_test)
+{
+	TextLayoutCache cache;
+	TextRenderer::TextInfo ti;
+	ti.text = "~r~ab";
+	ti.size = 10.f;
+	ti.font = 1;
+	ti.baseColour = glm::u8vec3(255);
+	ti.backgroundColour = glm::u8vec4(0, 0, 0, 255);
+
+	auto& layout = cache.layout(ti.text, ti.font, ti.size, ti.wrapX);
+
+	std::vector<TextRenderer::TextVertex> vertices;
+	TextRenderer::buildVertices(ti, layout, false, vertices);
+	BOOST_REQUIRE_EQUAL(vertices.size(), 18);
+	// Background first, then the glyphs
+	BOOST_CHECK_EQUAL(vertices[0].texcoord.z, -1.f);
+	BOOST_CHECK_EQUAL(vertices[6].texcoord.z, 1.f);
+	BOOST_CHECK_EQUAL(vertices[6].colour.g, 0.f);
+
+	vertices.clear();
+	TextRenderer::buildVertices(ti, layout, true, vertices);
+	BOOST_CHECK_EQUAL(vertices[6].colour.g, 1.f);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -85,7 +85,7 @@ BOOST_AUTO_TEST_CASE(test_available_nodes)
 	
 	for (auto& v : expected) {
 		BOOST_CHECK(std::find_if(open.begin(), open.end(),
-					[v](AIGraphNode* n) { return n->position == v; }) != open.end());
+					[&](AIGraph::NodeIndex n) { return graph.nodes[n].position == v; }) != open.end());
 	}
 }
 
@@ -1,11 +1,112 @@
 #include <boost/test/unit_test.hpp>
 #include <engine/GameWorld.hpp>
+#include <engine/GameData.hpp>
+#include <core/Logger.hpp>
+#include <job/WorkContext.hpp>
+
+#include <algorithm>
+
+class TestObject : public GameObject
+{
+public:
+	TestObject(GameWorld* engine)
+		: GameObject(engine, glm::vec3(), glm::quat(), nullptr)
+	{}
+
+	void tick(float) {}
+};
 
 BOOST_AUTO_TEST_SUITE(WorldTests)
 
 BOOST_AUTO_TEST_CASE(world_object_destroy)
 {
-	
+
+}
+
+BOOST_AUTO_TEST_CASE(world_object_pool_handles)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	GameWorld::ObjectPool pool;
+	TestObject a(&world), b(&world);
+
+	pool.insert(&a);
+	pool.insert(&b);
+
+	auto idA = a.getGameObjectID();
+	BOOST_CHECK_NE( idA, 0u );
+	BOOST_CHECK_NE( idA, b.getGameObjectID() );
+	BOOST_CHECK( pool.find(idA) == &a );
+	BOOST_CHECK( pool.find(b.getGameObjectID()) == &b );
+
+	pool.remove(&a);
+	BOOST_CHECK( pool.find(idA) == nullptr );
+	BOOST_CHECK( pool.find(b.getGameObjectID()) == &b );
+	BOOST_CHECK_EQUAL( pool.objects.size(), 1 );
+
+	// The slot is reused but the old ID must not resolve to the new object
+	TestObject c(&world);
+	pool.insert(&c);
+	BOOST_CHECK_EQUAL( gameObjectIndex(c.getGameObjectID()), gameObjectIndex(idA) );
+	BOOST_CHECK( pool.find(idA) == nullptr );
+	BOOST_CHECK( pool.find(c.getGameObjectID()) == &c );
+
+	// Objects created with an ID keep it
+	TestObject d(&world);
+	d.setGameObjectID(makeGameObjectID(10, 3));
+	pool.insert(&d);
+	BOOST_CHECK( pool.find(makeGameObjectID(10, 3)) == &d );
+	BOOST_CHECK( pool.find(makeGameObjectID(10, 2)) == nullptr );
+	BOOST_CHECK_EQUAL( pool.objects.size(), 3 );
+
+	// Scripts hold IDs as signed integers, where -1 means no object
+	BOOST_CHECK_GT( int32_t(makeGameObjectID(kGameObjectIndexMask, 0xFFF)), 0 );
+	BOOST_CHECK_EQUAL( gameObjectGeneration(makeGameObjectID(1, kGameObjectGenerationMask)),
+					   kGameObjectGenerationMask );
+}
+
+BOOST_AUTO_TEST_CASE(world_object_pool_active)
+{
+	Logger log;
+	WorkContext work;
+	GameData data(&log, &work, "");
+	GameWorld world(&log, &work, &data);
+
+	GameWorld::ObjectPool pool;
+	TestObject a(&world), b(&world), c(&world);
+	pool.insert(&a);
+	pool.insert(&b);
+	pool.insert(&c);
+	BOOST_CHECK_EQUAL( pool.activeObjects.size(), 3 );
+
+	auto listed = [&](GameObject* object) {
+		return std::find(pool.activeObjects.begin(), pool.activeObjects.end(), object)
+				!= pool.activeObjects.end();
+	};
+
+	a.setActive(false);
+	pool.updateActive(&a);
+	BOOST_CHECK_EQUAL( pool.activeObjects.size(), 2 );
+	BOOST_CHECK( ! listed(&a) && listed(&b) && listed(&c) );
+
+	// Whichever object fills a hole must still be found later
+	pool.remove(&b);
+	BOOST_CHECK_EQUAL( pool.activeObjects.size(), 1 );
+	BOOST_CHECK( listed(&c) );
+
+	a.setActive(true);
+	pool.updateActive(&a);
+	pool.updateActive(&a);
+	BOOST_CHECK_EQUAL( pool.activeObjects.size(), 2 );
+
+	pool.remove(&c);
+	BOOST_REQUIRE_EQUAL( pool.activeObjects.size(), 1 );
+	BOOST_CHECK( pool.activeObjects[0] == &a );
+	pool.remove(&a);
+	BOOST_CHECK( pool.activeObjects.empty() );
 }
 
 BOOST_AUTO_TEST_SUITE_END()